@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 #pragma once
 #include "FEMeshDataInterpolator.h"
+#include <FECore/FEKDTree.h>
 
 //! Helper class for mapping data between two point sets using moving least squares.
 class FELeastSquaresInterpolator : public FEMeshDataInterpolator
@@ -62,7 +63,7 @@ public:
 	void SetSourcePoints(const std::vector<vec3d>& srcPoints);
 
 	//! set the target points
-	void SetTargetPoints(const std::vector<vec3d>& trgPoints);
+	void SetTargetPoints(const std::vector<vec3d>& trgPoints) override;
 	bool SetTargetPoint(const vec3d& trgPoint) override;
 
 	//! initialize MLQ data
@@ -83,6 +84,7 @@ private:
 	bool	m_checkForMatch;
 	std::vector<vec3d>	m_src;	// source points
 	std::vector<vec3d>	m_trg;	// target points
+	FEKDTree			m_tree;	// search tree for source points
 
 	std::vector< Data >			m_data;
 };
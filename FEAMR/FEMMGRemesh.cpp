@@ -459,27 +459,27 @@ bool FEMMGRemesh::MMG::build_new_mesh(MMG5_pMesh mmgMesh, MMG5_pSol mmgSol, FEMo
 	}
 
 	// map nodal positions and nodal data
-	for (int i = 0; i < nodes; ++i)
+	mapper->SetTargetPoints(nodePos0);
+	if (mapper->Init() == false)
 	{
-		vec3d ri = nodePos0[i];
-
-		if (mapper->SetTargetPoint(ri) == false)
-		{
-			assert(false);
-			delete mapper;
-			throw std::runtime_error("Fatal error in MMG remesh during nodal mapping.");
-			return false;
-		}
+		assert(false);
+		delete mapper;
+		throw std::runtime_error("Fatal error in MMG remesh during nodal mapping.");
+		return false;
+	}
 
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < nodes; ++i)
+	{
 		// get the nodal coordinates
-		nodePos[i] = mapper->MapVec3d([&mesh](int sourceNode) {
+		nodePos[i] = mapper->MapVec3d(i, [&mesh](int sourceNode) {
 			return mesh.Node(sourceNode).m_rt;
 		});
 
 		// update values
 		for (int l = 0; l < MAX_DOFS; ++l)
 		{
-			nodeVal[i][l] = mapper->Map([&mesh, l](int sourceNode) {
+			nodeVal[i][l] = mapper->Map(i, [&mesh, l](int sourceNode) {
 				return mesh.Node(sourceNode).get(l);
 			});
 		}
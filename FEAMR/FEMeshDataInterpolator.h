@@ -38,6 +38,9 @@ public:
 	// do one-time initalization
 	virtual bool Init();
 
+	// set all target points. Call Init afterwards.
+	virtual void SetTargetPoints(const std::vector<vec3d>& trgPoints) = 0;
+
 	// set the next target point
 	// should return false if the target point cannot be evaluated
 	virtual bool SetTargetPoint(const vec3d& r) = 0;
@@ -48,8 +48,11 @@ bool FEMeshShapeInterpolator::Init()
 		if (m_os->Init() == false) return false;
 	}
 
+	// the octree search is read-only, so the target points can be located in parallel
 	int nodes = m_trgPoints.size();
 	m_data.resize(nodes);
+	bool bok = true;
+#pragma omp parallel for shared(bok)
 	for (int i = 0; i < nodes; ++i)
 	{
 		Data& di = m_data[i];
@@ -58,14 +61,11 @@ bool FEMeshShapeInterpolator::Init()
 		// find the element
 		di.r[0] = di.r[1] = di.r[2] = 0.0;
 		di.el = (FESolidElement*)m_os->FindElement(ri, di.r);
-		if (di.el == nullptr)
-		{
-			assert(false);
-			return false;
-		}
+		if (di.el == nullptr) bok = false;
 	}
+	assert(bok);
 
-	return true;
+	return bok;
 }
 
 void FEMeshShapeInterpolator::SetTargetPoints(const vector<vec3d>& trgPoints)
@@ -46,7 +46,7 @@ public:
 
 	bool Init() override;
 
-	void SetTargetPoints(const std::vector<vec3d>& trgPoints);
+	void SetTargetPoints(const std::vector<vec3d>& trgPoints) override;
 	bool SetTargetPoint(const vec3d& r) override;
 
 	bool Map(std::vector<double>& tval, std::function<double(int sourceNode)> src) override;
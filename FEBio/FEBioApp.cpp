@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "console.h"
 #include "CommandManager.h"
 #include <FECore/log.h>
+#include <FECore/FEProfiler.h>
 #include "console.h"
 #include "breakpoint.h"
 #include <FEBioLib/febio.h>
@@ -183,8 +184,24 @@ int FEBioApp::RunModel()
 		// apply configuration overrides
 		ApplyConfig(fem);
 
+		// start collecting the profile
+		FEProfiler* prof = FEProfiler::GetInstance();
+		if (m_ops.bprofile)
+		{
+			prof->Reset();
+			prof->SetTracing(m_ops.szprof[0] != 0);
+			prof->Enable(true);
+		}
+
 		bool bret = febio::SolveModel(fem, m_ops.sztask, m_ops.szctrl);
 
+		if (m_ops.bprofile)
+		{
+			prof->Enable(false);
+			if (m_ops.szprof[0] && (prof->WriteTrace(m_ops.szprof) == false))
+				fprintf(stderr, "Failed writing profile trace to %s\n", m_ops.szprof);
+		}
+
 		nret = (bret ? 0 : 1);
 	}
 
@@ -235,6 +252,7 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 	ops.bsplash = true;
 	ops.bsilent = false;
 	ops.binteractive = true;
+	ops.bprofile = false;
 
 	// these flags indicate whether the corresponding file name
 	// was defined on the command line. Otherwise, a default name will be generated.
@@ -243,6 +261,10 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 	bool bdmp = false;
 	bool brun = true;
 
+	// convert the mesh to a binary mesh file (-febm)
+	bool bfebm = false;
+	char szfebm[febio::CMDOPTIONS::MAXFILE] = { 0 };
+
 	// initialize file names
 	ops.szfile[0] = 0;
 	ops.szplt[0] = 0;
@@ -251,6 +273,7 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 	ops.sztask[0] = 0;
 	ops.szctrl[0] = 0;
 	ops.szimp[0] = 0;
+	ops.szprof[0] = 0;
 
 	// set initial configuration file name
 	if (ops.szcnf[0] == 0)
@@ -391,6 +414,21 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 				}
 			}
 		}
+		else if (strncmp(sz, "-profile", 8) == 0)
+		{
+			// -profile prints a timing summary, -profile=file also writes a trace file
+			ops.bprofile = true;
+			if (sz[8] == '=') strcpy(ops.szprof, sz + 9);
+			else if (sz[8] != 0) { fprintf(stderr, "command line error when parsing profile\n"); return false; }
+		}
+		else if (strncmp(sz, "-febm", 5) == 0)
+		{
+			// -febm converts the mesh of the input file to a binary mesh file, 
+			// -febm=file also sets the name of the new input file
+			bfebm = true;
+			if (sz[5] == '=') strcpy(szfebm, sz + 6);
+			else if (sz[5] != 0) { fprintf(stderr, "command line error when parsing febm\n"); return false; }
+		}
 		else if (strcmp(sz, "-break") == 0)
 		{
 			char szbuf[32]={0};
@@ -471,6 +509,42 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 		}
 	}
 
+	// Convert the input file into a new input file that reads its mesh from a
+	// binary mesh file. The model is not run.
+	if (bfebm)
+	{
+		if (ops.szfile[0] == 0)
+		{
+			fprintf(stderr, "FATAL ERROR: no model input file was defined for -febm\n\n");
+			return false;
+		}
+
+		char szout[febio::CMDOPTIONS::MAXFILE];
+		if (szfebm[0]) strcpy(szout, szfebm);
+		else
+		{
+			char szbase[febio::CMDOPTIONS::MAXFILE]; strcpy(szbase, ops.szfile);
+			char* ch = strrchr(szbase, '.');
+			if (ch) *ch = 0;
+			snprintf(szout, sizeof(szout), "%s_febm.feb", szbase);
+		}
+
+		// the mesh file has the same base name as the new input file
+		char szmesh[febio::CMDOPTIONS::MAXFILE]; strcpy(szmesh, szout);
+		char* ch = strrchr(szmesh, '.');
+		if (ch) *ch = 0;
+		strcat(szmesh, ".febm");
+
+		std::string err;
+		if (febio::ConvertToBinaryMesh(ops.szfile, szout, szmesh, err) == false)
+		{
+			fprintf(stderr, "FATAL ERROR: %s\n\n", err.c_str());
+			return false;
+		}
+		fprintf(stdout, "Converted %s to %s and %s\n", ops.szfile, szout, szmesh);
+		brun = false;
+	}
+
 	// do some sanity checks
 	if (strcmp(ops.sztask, "optimize") == 0)
 	{
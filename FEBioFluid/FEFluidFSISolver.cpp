@@ -1205,6 +1205,9 @@ bool FEFluidFSISolver::StiffnessMatrix()
     // constraints enforced with augmented lagrangian
     NonLinearConstraintStiffness(LS, tp);    
    
+    // assemble the rigid body contributions of the element matrices
+    LS.AssembleRigidStiffness();
+
     // add contributions from rigid bodies
     m_rigidSolver.StiffnessMatrix(*m_pK, tp);
     
@@ -1347,6 +1347,9 @@ bool FEMultiphasicFSISolver::StiffnessMatrix()
     // calculate the stiffness contributions for the rigid forces
     for (int i = 0; i<fem.ModelLoads(); ++i) fem.ModelLoad(i)->StiffnessMatrix(LS);
     
+    // assemble the rigid body contributions of the element matrices
+    LS.AssembleRigidStiffness();
+
     // add contributions from rigid bodies
     m_rigidSolver.StiffnessMatrix(*m_pK, tp);
     
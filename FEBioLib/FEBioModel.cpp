@@ -62,10 +62,12 @@ SOFTWARE.*/
 #include <FECore/FEDomain.h>
 #include <FECore/FEMaterial.h>
 #include <FECore/FEPlotDataStore.h>
+#include <FECore/DataStore.h>
 #include <FECore/FETimeStepController.h>
 #include "febio.h"
 #include "version.h"
 #include <iostream>
+#include <FECore/FEProfiler.h>
 #include <sstream>
 #include <fstream>
 #include <functional>
@@ -275,6 +277,51 @@ void FEBioModel::SetDumpFilename(const std::string& sfile)
 	m_sdump = sfile;
 }
 
+//-----------------------------------------------------------------------------
+// inserts the suffix in front of the extension of a file name
+static std::string AddFileSuffix(const std::string& file, const std::string& suffix)
+{
+	size_t ns = file.find_last_of("/\\");
+	size_t ne = file.find_last_of('.');
+	if ((ne == std::string::npos) || ((ns != std::string::npos) && (ne < ns))) return file + suffix;
+	return file.substr(0, ne) + suffix + file.substr(ne);
+}
+
+//-----------------------------------------------------------------------------
+//! This is called in a worker process that was forked from this process. All the
+//! output files get new names, so that the worker does not overwrite the output
+//! of the parent process or of other workers.
+bool FEBioModel::RedirectOutput(const std::string& suffix)
+{
+	// The plot file may be written by a background thread of the parent process, 
+	// which does not exist in this process, so the plot file is left alone, and not 
+	// even deleted. A new plot file is created when the model is reset. 
+	m_plot = nullptr;
+	if (m_splot.empty() == false) m_splot = AddFileSuffix(m_splot, suffix);
+
+	// All files were flushed before the process was forked, so closing them does not write
+	// anything to the parent's files. The log file is recreated when the model is reset.
+	// The worker does not write to the screen, since it shares it with the parent.
+	m_log.close();
+	m_log.SetMode(Logfile::LOG_FILE);
+	if (m_slog.empty() == false) m_slog = AddFileSuffix(m_slog, suffix);
+
+	if (m_sdump.empty() == false) m_sdump = AddFileSuffix(m_sdump, suffix);
+
+	DataStore& data = GetDataStore();
+	for (int i = 0; i < data.Size(); ++i)
+	{
+		DataRecord* pd = data.GetDataRecord(i);
+		std::string sfile = pd->GetFileName();
+		if (sfile.empty() == false)
+		{
+			if (pd->SetFileName(AddFileSuffix(sfile, suffix).c_str()) == false) return false;
+		}
+	}
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //! Return the name of the input file
 const std::string& FEBioModel::GetInputFileName()
@@ -1423,7 +1470,7 @@ void FEBioModel::SerializeIOData(DumpStream &ar)
 
 			m_plot = xplt;
 		}
-		else if (data.GetPlotFileType() == "vtk") m_plot = new VTKPlotFile(this);
+		else if ((data.GetPlotFileType() == "vtk") || (data.GetPlotFileType() == "vtu")) m_plot = new VTKPlotFile(this);
 
 		if (m_plot) m_plot->Serialize(ar);
 
@@ -1528,7 +1575,7 @@ bool FEBioModel::InitPlotFile()
 			SetPlotFilename(sz);
 		}
 	}
-	else if (data.GetPlotFileType() == "vtk")
+	else if ((data.GetPlotFileType() == "vtk") || (data.GetPlotFileType() == "vtu"))
 	{
 		VTKPlotFile* vtk = new VTKPlotFile(this);
 		m_plot = vtk;
@@ -1537,12 +1584,12 @@ bool FEBioModel::InitPlotFile()
 		const std::string& splt = GetPlotFileName();
 		if (splt.empty())
 		{
-			// if not, we take the input file name and set the extension to .vtk
+			// if not, we take the input file name and set the extension to .vtk (or .pvd for vtu files)
 			char sz[1024] = { 0 };
 			strcpy(sz, GetInputFileName().c_str());
 			char* ch = strrchr(sz, '.');
 			if (ch) *ch = 0;
-			strcat(sz, ".vtk");
+			strcat(sz, (data.GetPlotFileType() == "vtu" ? ".pvd" : ".vtk"));
 			SetPlotFilename(sz);
 		}
 	}
@@ -1664,7 +1711,21 @@ bool FEBioModel::Solve()
 	// The total time is usually started on calling Input,
 	// however, in a restart Input is not called, so we start it here.
 	if (!m_TotalTime.isRunning()) m_TotalTime.start();
-	bool b = FEModel::Solve();
+	bool b = false;
+	try {
+		b = FEModel::Solve();
+	}
+	catch (...)
+	{
+		// An exception that leaves the solver skips the CB_SOLVED callback, which 
+		// normally closes the output. Make sure that the plot states that are still 
+		// being written end up in the file, and that the log is complete.
+		m_TotalTime.stop();
+		feLog("\n E R R O R   T E R M I N A T I O N\n\n");
+		if (m_plot) m_plot->Close();
+		m_log.flush();
+		throw;
+	}
 	m_TotalTime.stop();
 	return b;
 }
@@ -1698,7 +1759,7 @@ bool FEBioModel::Reset()
 		{
 			FEPlotDataStore& data = GetPlotDataStore();
 			if      (data.GetPlotFileType() == "febio") m_plot = new FEBioPlotFile(this);
-			else if (data.GetPlotFileType() == "vtk"  ) m_plot = new VTKPlotFile(this);
+			else if ((data.GetPlotFileType() == "vtk") || (data.GetPlotFileType() == "vtu")) m_plot = new VTKPlotFile(this);
 			hint = 0;
 		}
 
@@ -1799,6 +1860,16 @@ void FEBioModel::on_cb_solved()
 	GetSolveTimer().time_str(sztime);
 	feLog("\n Elapsed time : %s\n\n", sztime);
 
+	// print the profiler summary
+	if (FEProfiler::IsEnabled())
+	{
+		std::vector<std::string> lines;
+		FEProfiler::GetInstance()->GetSummary(lines);
+		feLog(" P R O F I L E R   S U M M A R Y\n\n");
+		for (const std::string& line : lines) feLog("%s\n", line.c_str());
+		feLog("\n");
+	}
+
 	// print additional stats to the log file only
 	if (m_log.GetMode() & Logfile::LOG_FILE)
 	{
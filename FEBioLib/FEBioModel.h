@@ -91,6 +91,9 @@ public: // --- I/O functions ---
 	//! add to log 
 	void Log(int ntag, const char* szmsg) override;
 
+	//! write the output of a forked process to its own files
+	bool RedirectOutput(const std::string& suffix) override;
+
 	// get the log file
 	Logfile& GetLogFile() { return m_log; }
 
@@ -68,6 +68,7 @@ bool febio::ProcessOptionsString(const std::string& s, CMDOPTIONS& ops)
 	ops.bsplash = true;
 	ops.bsilent = false;
 	ops.binteractive = true;
+	ops.bprofile = false;
 
 	// these flags indicate whether the corresponding file name
 	// was defined on the command line. Otherwise, a default name will be generated.
@@ -84,6 +85,7 @@ bool febio::ProcessOptionsString(const std::string& s, CMDOPTIONS& ops)
 	ops.sztask[0] = 0;
 	ops.szctrl[0] = 0;
 	ops.szimp[0] = 0;
+	ops.szprof[0] = 0;
 
 	// set initial configuration file name
 	if (ops.szcnf[0] == 0)
@@ -211,6 +213,13 @@ bool febio::ProcessOptionsString(const std::string& s, CMDOPTIONS& ops)
 		{
 			strcpy(ops.szimp, args[++i].c_str());
 		}
+		else if (strncmp(sz, "-profile", 8) == 0)
+		{
+			// -profile prints a timing summary, -profile=file also writes a trace file
+			ops.bprofile = true;
+			if (sz[8] == '=') strcpy(ops.szprof, sz + 9);
+			else if (sz[8] != 0) { fprintf(stderr, "command line error when parsing profile\n"); return false; }
+		}
 		else if (sz[0] == '-')
 		{
 			fprintf(stderr, "FATAL ERROR: Invalid command line option.\n");
@@ -38,6 +38,7 @@ struct FEBIOLIB_API CMDOPTIONS
 	bool	bsplash;			//!< show splash screen or not
 	bool	bsilent;			//!< run FEBio in silent mode (no output to screen)
 	bool	binteractive;		//!< start FEBio interactively
+	bool	bprofile;			//!< collect a per-component timing profile
 
 	int		dumpLevel;		//!< requested restart level
 	int		dumpStride;		//!< (cold) restart file stride
@@ -50,6 +51,7 @@ struct FEBIOLIB_API CMDOPTIONS
 	char	sztask[MAXFILE];	//!< task name
 	char	szctrl[MAXFILE];	//!< control file for tasks
 	char	szimp[MAXFILE];		//!< import file
+	char	szprof[MAXFILE];	//!< trace file for the profiler (optional)
 
 	CMDOPTIONS()
 	{
@@ -62,6 +64,7 @@ struct FEBIOLIB_API CMDOPTIONS
 		bsplash = true;
 		bsilent = false;
 		binteractive = false;
+		bprofile = false;
 		dumpLevel = 0;
 		dumpStride = 1;
 
@@ -73,6 +76,7 @@ struct FEBIOLIB_API CMDOPTIONS
 		sztask[0] = 0;
 		szctrl[0] = 0;
 		szimp[0] = 0;
+		szprof[0] = 0;
 	}
 };
 
@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "febio.h"
 #include <XML/XMLReader.h>
 #include <FEBioXML/xmltool.h>
+#include <FEBioXML/FEBioMeshFile.h>
 #include <FECore/FEModel.h>
 #include <FECore/FECoreTask.h>
 #include <FECore/FEMaterial.h>
@@ -498,6 +499,15 @@ bool write_vector(const vector<double>& a, const char* szfile, int mode)
 	return NumCore::write_vector(a, szfile, mode);
 }
 
+// convert the mesh of an feb file into a binary mesh file
+bool ConvertToBinaryMesh(const char* szfeb, const char* szout, const char* szmesh, std::string& err)
+{
+	FEBioMeshFile file;
+	bool bret = file.ConvertFEBFile(szfeb, szout, szmesh);
+	if (bret == false) err = file.GetErrorString();
+	return bret;
+}
+
 bool RunMaterialTest(FEMaterial* mat, double simtime, int steps, double strain, const char* sztest, std::vector<pair<double, double> >& out)
 {
 	FEModel fem;
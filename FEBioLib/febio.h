@@ -86,6 +86,9 @@ namespace febio
 	// write a vector to file
 	FEBIOLIB_API bool write_vector(const vector<double>& a, const char* szfile, int mode = 0);
 
+	// convert the mesh of an feb file into a binary mesh file
+	FEBIOLIB_API bool ConvertToBinaryMesh(const char* szfeb, const char* szout, const char* szmesh, std::string& err);
+
 	// run a material test
 	FEBIOLIB_API bool RunMaterialTest(FEMaterial* mat, double simtime, int steps, double strain, const char* sztest, std::vector<pair<double, double> >& out);
 }
@@ -119,10 +119,8 @@ void FE3FieldElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
     FEModel& fem = *GetFEModel();
     
     // repeat over all solid elements
-    int NE = (int)m_Elem.size();
-#pragma omp parallel for
-    for (int iel=0; iel<NE; ++iel)
-    {
+    AssembleElements(LS, [&](int iel) {
+
 		FEShellElement& el = m_Elem[iel];
 
         // element stiffness matrix
@@ -146,7 +144,7 @@ void FE3FieldElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
 
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
 }
 
 //-----------------------------------------------------------------------------
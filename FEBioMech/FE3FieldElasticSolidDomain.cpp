@@ -136,10 +136,8 @@ void FE3FieldElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 	FEModel& fem = *GetFEModel();
 
 	// repeat over all solid elements
-	int NE = (int)m_Elem.size();
-	#pragma omp parallel for
-	for (int iel=0; iel<NE; ++iel)
-	{
+	AssembleElements(LS, [&](int iel) {
+
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
@@ -173,7 +171,7 @@ void FE3FieldElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 
 		// assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-	}
+	});
 }
 
 //-----------------------------------------------------------------------------
@@ -463,10 +463,8 @@ void FEElasticANSShellDomain::ElementBodyForceStiffness(FEBodyForce& BF, FEShell
 void FEElasticANSShellDomain::StiffnessMatrix(FELinearSystem& LS)
 {
     // repeat over all shell elements
-    int NS = (int)m_Elem.size();
-#pragma omp parallel for shared (NS)
-    for (int iel=0; iel<NS; ++iel)
-    {
+    AssembleElements(LS, [&](int iel) {
+
 		FEShellElement& el = m_Elem[iel];
 
         // create the element's stiffness matrix
@@ -484,17 +482,15 @@ void FEElasticANSShellDomain::StiffnessMatrix(FELinearSystem& LS)
 
 		// assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
 }
 
 //-----------------------------------------------------------------------------
 void FEElasticANSShellDomain::MassMatrix(FELinearSystem& LS, double scale)
 {
     // repeat over all solid elements
-    int NE = (int)m_Elem.size();
-#pragma omp parallel for shared (NE)
-    for (int iel=0; iel<NE; ++iel)
-    {
+    AssembleElements(LS, [&](int iel) {
+
 		FEShellElementNew& el = m_Elem[iel];
 
         // create the element's stiffness matrix
@@ -513,17 +509,15 @@ void FEElasticANSShellDomain::MassMatrix(FELinearSystem& LS, double scale)
         
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
 }
 
 //-----------------------------------------------------------------------------
 void FEElasticANSShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
 {
     // repeat over all shell elements
-    int NE = (int)m_Elem.size();
-#pragma omp parallel for shared (NE)
-    for (int iel=0; iel<NE; ++iel)
-    {
+    AssembleElements(LS, [&](int iel) {
+
 		FEShellElementNew& el = m_Elem[iel];
         
         // create the element's stiffness matrix
@@ -542,7 +536,7 @@ void FEElasticANSShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce
         
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
 }
 
 //-----------------------------------------------------------------------------
@@ -511,10 +511,8 @@ void FEElasticEASShellDomain::ElementBodyForceStiffness(FEBodyForce& BF, FEShell
 void FEElasticEASShellDomain::StiffnessMatrix(FELinearSystem& LS)
 {
     // repeat over all shell elements
-    int NS = (int)m_Elem.size();
-#pragma omp parallel for shared (NS)
-    for (int iel=0; iel<NS; ++iel)
-    {
+    AssembleElements(LS, [&](int iel) {
+
 		FEShellElement& el = m_Elem[iel];
 
         // create the element's stiffness matrix
@@ -532,17 +530,15 @@ void FEElasticEASShellDomain::StiffnessMatrix(FELinearSystem& LS)
         
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
 }
 
 //-----------------------------------------------------------------------------
 void FEElasticEASShellDomain::MassMatrix(FELinearSystem& LS, double scale)
 {
     // repeat over all solid elements
-    int NE = (int)m_Elem.size();
-#pragma omp parallel for shared (NE)
-    for (int iel=0; iel<NE; ++iel)
-    {
+    AssembleElements(LS, [&](int iel) {
+
 		FEShellElementNew& el = m_Elem[iel];
         
         // create the element's stiffness matrix
@@ -561,17 +557,15 @@ void FEElasticEASShellDomain::MassMatrix(FELinearSystem& LS, double scale)
         
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
 }
 
 //-----------------------------------------------------------------------------
 void FEElasticEASShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
 {
     // repeat over all shell elements
-    int NE = (int)m_Elem.size();
-#pragma omp parallel for shared (NE)
-    for (int iel=0; iel<NE; ++iel)
-    {
+    AssembleElements(LS, [&](int iel) {
+
 		FEShellElementNew& el = m_Elem[iel];
         
         // create the element's stiffness matrix
@@ -590,7 +584,7 @@ void FEElasticEASShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce
         
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
 }
 
 //-----------------------------------------------------------------------------
@@ -455,10 +455,8 @@ void FEElasticShellDomain::ElementBodyForceStiffness(FEBodyForce& BF, FEShellEle
 void FEElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
 {
     // repeat over all shell elements
-    int NS = (int)m_Elem.size();
-#pragma omp parallel for shared (NS)
-    for (int iel=0; iel<NS; ++iel)
-    {
+	AssembleElements(LS, [&](int iel) {
+
 		FEShellElement& el = m_Elem[iel];
 		if (el.isActive())
 		{
@@ -478,17 +476,15 @@ void FEElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
 			// assemble element matrix in global stiffness matrix
 			LS.Assemble(ke);
 		}
-    }
+	});
 }
 
 //-----------------------------------------------------------------------------
 void FEElasticShellDomain::MassMatrix(FELinearSystem& LS, double scale)
 {
     // repeat over all solid elements
-    int NE = (int)m_Elem.size();
-#pragma omp parallel for shared (NE)
-    for (int iel=0; iel<NE; ++iel)
-    {
+    AssembleElements(LS, [&](int iel) {
+
 		FEShellElement& el = m_Elem[iel];
 		if (el.isActive())
 		{
@@ -509,17 +505,15 @@ void FEElasticShellDomain::MassMatrix(FELinearSystem& LS, double scale)
 			// assemble element matrix in global stiffness matrix
 			LS.Assemble(ke);
 		}
-    }
+    });
 }
 
 //-----------------------------------------------------------------------------
 void FEElasticShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
 {
     // repeat over all shell elements
-    int NE = (int)m_Elem.size();
-#pragma omp parallel for shared (NE)
-    for (int iel=0; iel<NE; ++iel)
-    {
+    AssembleElements(LS, [&](int iel) {
+
 		FEShellElement& el = m_Elem[iel];
 		if (el.isActive())
 		{
@@ -540,7 +534,7 @@ void FEElasticShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& b
 			// assemble element matrix in global stiffness matrix
 			LS.Assemble(ke);
 		}
-    }
+    });
 }
 
 //-----------------------------------------------------------------------------
@@ -119,6 +119,25 @@ void FEElasticSolidDomain::Activate()
 	}
 }
 
+//-----------------------------------------------------------------------------
+bool FEElasticSolidDomain::Create(int nsize, FE_Element_Spec espec)
+{
+	// the material point data will be reallocated
+	m_elasticPt.Clear();
+	return FESolidDomain::Create(nsize, espec);
+}
+
+//-----------------------------------------------------------------------------
+bool FEElasticSolidDomain::Init()
+{
+	if (FESolidDomain::Init() == false) return false;
+
+	// cache the elastic material point data for fast lookups
+	m_elasticPt.Create(*this);
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 //! serialization
 void FEElasticSolidDomain::Serialize(DumpStream& ar)
@@ -127,6 +146,9 @@ void FEElasticSolidDomain::Serialize(DumpStream& ar)
 	FESolidDomain::Serialize(ar);
 	if (ar.IsShallow()) return;
 
+	// the material point data was reallocated
+	if (ar.IsLoading()) m_elasticPt.Create(*this);
+
 	// serialize class variables
 	ar & m_alphaf;
 	ar & m_alpham;
@@ -152,7 +174,7 @@ void FEElasticSolidDomain::PreSolveUpdate(const FETimeInfo& timeInfo)
 			for (int j = 0; j < n; ++j)
 			{
 				FEMaterialPoint& mp = *el.GetMaterialPoint(j);
-				FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
+				FEElasticMaterialPoint& pt = ElasticMaterialPoint(el, j);
 				pt.m_Wp = pt.m_Wt;
 
 				mp.Update(timeInfo);
@@ -209,7 +231,7 @@ void FEElasticSolidDomain::ElementInternalForce(FESolidElement& el, vector<doubl
 	for (int n=0; n<nint; ++n)
 	{
 		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+		FEElasticMaterialPoint& pt = ElasticMaterialPoint(el, n);
 
 		// calculate the jacobian
 		double detJt = (m_update_dynamic ? invjact(el, Ji, n, m_alphaf) : invjact(el, Ji, n));
@@ -300,7 +322,7 @@ void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matri
 
 		// get the material point data
 		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+		FEElasticMaterialPoint& pt = ElasticMaterialPoint(el, n);
 
 		// element's Cauchy-stress tensor at gauss point n
 		mat3ds& s = pt.m_s;
@@ -344,6 +366,16 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 	// weights at gauss points
 	const double *gw = el.GaussWeights();
 
+	// evaluate the tangents of all integration points at once, if the material supports it
+	tens4ds Cb[FEElement::MAX_INTPOINTS];
+	bool batch = (!m_secant_tangent && m_pMat->HasBatchEvaluation() && !m_pMat->UseSecantTangent());
+	if (batch)
+	{
+		FEMaterialPoint* mpl[FEElement::MAX_INTPOINTS];
+		for (int n = 0; n < nint; ++n) mpl[n] = el.GetMaterialPoint(n);
+		m_pMat->TangentBatch(mpl, Cb, nint);
+	}
+
 	// calculate element stiffness matrix
 	for (int n=0; n<nint; ++n)
 	{
@@ -356,8 +388,12 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 
 		// get the 'D' matrix
 //		tens4ds C = m_pMat->Tangent(mp);
-        tens4dmm C = (m_secant_tangent ? m_pMat->SecantTangent(mp) : m_pMat->SolidTangent(mp));
-		C.extract(D);
+		if (batch) Cb[n].extract(D);
+		else
+		{
+			tens4dmm C = (m_secant_tangent ? m_pMat->SecantTangent(mp) : m_pMat->SolidTangent(mp));
+			C.extract(D);
+		}
 
 		// we only calculate the upper triangular part
 		// since ke is symmetric. The other part is
@@ -419,11 +455,8 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 {
 	// repeat over all solid elements
-	int NE = Elements();
-	
-	#pragma omp parallel for shared (NE)
-	for (int iel=0; iel<NE; ++iel)
-	{
+	AssembleElements(LS, [&](int iel) {
+
 		FESolidElement& el = m_Elem[iel];
 
 		if (el.isActive()) {
@@ -456,7 +489,7 @@ void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 			// assemble element matrix in global stiffness matrix
 			LS.Assemble(ke);
 		}
-	}
+	});
 }
 
 //-----------------------------------------------------------------------------
@@ -605,35 +638,37 @@ void FEElasticSolidDomain::UpdateElementStress(int iel, const FETimeInfo& tp)
 		}
 	}
 
-	// loop over the integration points and calculate
-	// the stress at the integration point
+	// evaluate the kinematics at the integration points
+	double Jt[FEElement::MAX_INTPOINTS];
+	mat3d Ft[FEElement::MAX_INTPOINTS];
+	FEMaterialPoint* mpl[FEElement::MAX_INTPOINTS];
 	for (int n=0; n<nint; ++n)
 	{
 		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-		FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+		FEElasticMaterialPoint& pt = ElasticMaterialPoint(el, n);
+		mpl[n] = &mp;
 
 		// material point coordinates
 		mp.m_rt = el.Evaluate(r, n);
 
 		// get the deformation gradient and determinant at intermediate time
-        double Jt;
-        mat3d Ft, Fp;
-        Jt = defgrad(el, Ft, n);
+        mat3d Fp;
+        Jt[n] = defgrad(el, Ft[n], n);
         defgradp(el, Fp, n);
 
 		if (m_alphaf == 1.0)
 		{
-			pt.m_F = Ft;
-            pt.m_J = Jt;
+			pt.m_F = Ft[n];
+            pt.m_J = Jt[n];
 		}
 		else
 		{
-			pt.m_F = Ft*m_alphaf + Fp*(1-m_alphaf);
+			pt.m_F = Ft[n]*m_alphaf + Fp*(1-m_alphaf);
             pt.m_J = pt.m_F.det();
 		}
 
         mat3d Fi = pt.m_F.inverse();
-        pt.m_L = (Ft - Fp)*Fi / dt;
+        pt.m_L = (Ft[n] - Fp)*Fi / dt;
 		if (m_update_dynamic)
 		{
 			pt.m_v = el.Evaluate(v, n);
@@ -642,22 +677,40 @@ void FEElasticSolidDomain::UpdateElementStress(int iel, const FETimeInfo& tp)
 
         // update specialized material points
         m_pMat->UpdateSpecializedMaterialPoints(mp, tp);
-        
-		// calculate the stress at this material point
-//		pt.m_s = m_pMat->Stress(mp);
-		pt.m_s = (m_secant_stress ? m_pMat->SecantStress(mp) : m_pMat->Stress(mp));
-        
-        // adjust stress for strain energy conservation
-		// (Apply only for mid-point rule)
-		if (m_alphaf == 0.5)
+	}
+
+	// calculate the stress at the integration points
+	if (!m_secant_stress && m_pMat->HasBatchEvaluation())
+	{
+		mat3ds s[FEElement::MAX_INTPOINTS];
+		m_pMat->StressBatch(mpl, s, nint);
+		for (int n = 0; n < nint; ++n) ElasticMaterialPoint(el, n).m_s = s[n];
+	}
+	else
+	{
+		for (int n = 0; n < nint; ++n)
+		{
+			FEMaterialPoint& mp = *mpl[n];
+//			ElasticMaterialPoint(el, n).m_s = m_pMat->Stress(mp);
+			ElasticMaterialPoint(el, n).m_s = (m_secant_stress ? m_pMat->SecantStress(mp) : m_pMat->Stress(mp));
+		}
+	}
+
+	// adjust stress for strain energy conservation
+	// (Apply only for mid-point rule)
+	if (m_alphaf == 0.5)
+	{
+		FEElasticMaterial* pme = dynamic_cast<FEElasticMaterial*>(m_pMat);
+		for (int n = 0; n < nint; ++n)
 		{
-			FEElasticMaterial* pme = dynamic_cast<FEElasticMaterial*>(m_pMat);
+			FEMaterialPoint& mp = *mpl[n];
+			FEElasticMaterialPoint& pt = ElasticMaterialPoint(el, n);
 
 			// evaluate strain energy at current time
 			mat3d Ftmp = pt.m_F;
 			double Jtmp = pt.m_J;
-			pt.m_F = Ft;
-			pt.m_J = Jt;
+			pt.m_F = Ft[n];
+			pt.m_J = Jt[n];
 			pt.m_Wt = pme->StrainEnergyDensity(mp);
 			pt.m_F = Ftmp;
 			pt.m_J = Jtmp;
@@ -668,8 +721,8 @@ void FEElasticSolidDomain::UpdateElementStress(int iel, const FETimeInfo& tp)
 			{
 				pt.m_s += D * (((pt.m_Wt - pt.m_Wp) / (dt * pt.m_J) - pt.m_s.dotdot(D)) / D2);
 			}
-        }
-    }
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -754,7 +807,7 @@ void FEElasticSolidDomain::ElementInertialForce(FESolidElement& el, vector<doubl
     for (int n=0; n<nint; ++n)
     {
         FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-        FEElasticMaterialPoint& pt = *(mp.ExtractData<FEElasticMaterialPoint>());
+        FEElasticMaterialPoint& pt = ElasticMaterialPoint(el, n);
         double dens = m_pMat->Density(mp);
         double J0 = detJ0(el, n)*gw[n];
         
@@ -30,7 +30,9 @@ SOFTWARE.*/
 #include <FECore/FESolidDomain.h>
 #include "FEElasticDomain.h"
 #include "FESolidMaterial.h"
+#include "FEElasticMaterialPoint.h"
 #include <FECore/FEDofList.h>
+#include <FECore/FEMaterialPointCache.h>
 
 //-----------------------------------------------------------------------------
 //! domain described by Lagrange-type 3D volumetric elements
@@ -44,6 +46,12 @@ public:
 	//! assignment operator
 	FEElasticSolidDomain& operator = (FEElasticSolidDomain& d);
 
+	//! create the elements
+	bool Create(int nsize, FE_Element_Spec espec) override;
+
+	//! initialize the domain
+	bool Init() override;
+
 	//! activate
 	void Activate() override;
 
@@ -115,6 +123,14 @@ public:
 
     //! Calculates the inertial force vector for solid elements
     void ElementInertialForce(FESolidElement& el, vector<double>& fe);
+
+protected:
+	//! get the elastic material point data of integration point n of an element
+	FEElasticMaterialPoint& ElasticMaterialPoint(FESolidElement& el, int n)
+	{
+		if (m_elasticPt.Elements() != Elements()) return *el.GetMaterialPoint(n)->ExtractData<FEElasticMaterialPoint>();
+		return m_elasticPt(el.GetLocalID(), n);
+	}
     
 protected:
     double              m_alphaf;
@@ -135,6 +151,8 @@ protected:
 	FEDofList	m_dof;		// total dof list
 
 	FESolidMaterial*	m_pMat;
+
+	FEMaterialPointCache<FEElasticMaterialPoint>	m_elasticPt;	//!< lookup cache of the elastic material point data
 };
 
 class FEStandardElasticSolidDomain : public FEElasticSolidDomain
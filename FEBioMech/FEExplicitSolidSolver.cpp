@@ -48,12 +48,20 @@ SOFTWARE.*/
 #include "FEResidualVector.h"
 #include "FEBioMech.h"
 #include "FESolidAnalysis.h"
+#include <limits>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
 BEGIN_FECORE_CLASS(FEExplicitSolidSolver, FESolver)
 	ADD_PARAMETER(m_mass_lumping, "mass_lumping");
 	ADD_PARAMETER(m_dyn_damping, "dyn_damping");
+	ADD_PARAMETER(m_auto_dt    , "auto_dt");
+	ADD_PARAMETER(m_dt_safety  , FE_RANGE_LEFT_OPEN(0.0, 1.0), "dt_safety");
+	ADD_PARAMETER(m_dt_interval, FE_RANGE_GREATER_OR_EQUAL(1), "dt_update_interval");
+	ADD_PARAMETER(m_ms_dt      , FE_RANGE_GREATER_OR_EQUAL(0.0), "mass_scaling_dt");
+	ADD_PARAMETER(m_ms_max     , FE_RANGE_GREATER_OR_EQUAL(0.0), "max_added_mass");
+	ADD_PARAMETER(m_subcycling , "subcycling");
+	ADD_PARAMETER(m_nsubcycles , FE_RANGE_GREATER_OR_EQUAL(2), "subcycles");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -69,6 +77,19 @@ FEExplicitSolidSolver::FEExplicitSolidSolver(FEModel* pfem) :
 
 	m_mass_lumping = HRZ_LUMPING;
 
+	m_auto_dt = false;
+	m_dt_safety = 0.9;
+	m_dt_interval = 10;
+	m_ms_dt = 0.0;
+	m_ms_max = 0.05;
+	m_subcycling = false;
+	m_nsubcycles = 4;
+
+	m_dtStable = 0.0;
+	m_addedMass = 0.0;
+	m_nsub = 1;
+	m_brestart = false;
+
 	// Allocate degrees of freedom
 	// TODO: Can this be done in Init, since there is no error checking
 	if (pfem)
@@ -425,6 +446,9 @@ bool FEExplicitSolidSolver::CalculateMassMatrix()
 		return false;
 	}
 
+	// keep the lumped masses for mass scaling
+	m_Mb = massVector;
+
 	// we need the inverse of the lumped masses later
 	// Also, make sure the lumped masses are positive.
 	for (int i = 0; i < massVector.size(); ++i)
@@ -436,6 +460,246 @@ bool FEExplicitSolidSolver::CalculateMassMatrix()
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// Calculates the stable time step of the central difference scheme. The stable
+// time step of an element is estimated as L/c, where L is a characteristic length
+// (element volume divided by the largest face area) and c is the dilatational 
+// wave speed, evaluated from the material tangent. Only elastic solid domains
+// are considered.
+// Elements whose time step is smaller than the mass scaling time step get 
+// additional mass, so that their time step becomes the mass scaling time step.
+// When subcycling, the elements with the smallest time steps are integrated with
+// a fraction of the time step, if they are a small part of the model.
+void FEExplicitSolidSolver::UpdateStableTimeStep()
+{
+	FEModel& fem = *GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+
+	// collect all the elements
+	vector<SubcycledElement> elems;
+	for (int nd = 0; nd < mesh.Domains(); ++nd)
+	{
+		FEElasticSolidDomain* dom = dynamic_cast<FEElasticSolidDomain*>(&mesh.Domain(nd));
+		if (dom && dom->IsActive() && (dynamic_cast<FERigidMaterial*>(dom->GetMaterial()) == nullptr))
+		{
+			for (int i = 0; i < dom->Elements(); ++i)
+			{
+				if (dom->Element(i).isActive()) elems.push_back({ dom, i });
+			}
+		}
+	}
+	int NE = (int)elems.size();
+
+	// evaluate the element time steps and masses
+	const double DTMAX = std::numeric_limits<double>::max();
+	vector<double> dte(NE, DTMAX), me(NE, 0.0);
+#pragma omp parallel for
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElasticSolidDomain& dom = *elems[i].dom;
+		FESolidMaterial* mat = dynamic_cast<FESolidMaterial*>(dom.GetMaterial());
+		FESolidElement& el = dom.Element(elems[i].iel);
+		if (mat == nullptr) continue;
+
+		// evaluate the tangents of all integration points at once
+		int nint = el.GaussPoints();
+		FEMaterialPoint* mpl[FEElement::MAX_INTPOINTS];
+		tens4ds Cb[FEElement::MAX_INTPOINTS];
+		for (int n = 0; n < nint; ++n) mpl[n] = el.GetMaterialPoint(n);
+		mat->TangentBatch(mpl, Cb, nint);
+
+		// element mass and (squared) wave speed
+		double m = 0.0, c2 = 0.0;
+		double* w = el.GaussWeights();
+		for (int n = 0; n < nint; ++n)
+		{
+			FEMaterialPoint& mp = *mpl[n];
+			double rho = mat->Density(mp);
+			m += rho * dom.detJ0(el, n) * w[n];
+
+			const tens4ds& C = Cb[n];
+			double M = C(0, 0);
+			if (C(1, 1) > M) M = C(1, 1);
+			if (C(2, 2) > M) M = C(2, 2);
+			if ((rho > 0) && (M / rho > c2)) c2 = M / rho;
+		}
+		me[i] = m;
+
+		// largest face area
+		double Amax = 0.0;
+		int nf[FEElement::MAX_NODES];
+		for (int j = 0; j < el.Faces(); ++j)
+		{
+			int nn = el.GetFace(j, nf);
+			vec3d r0 = mesh.Node(nf[0]).m_rt;
+			vec3d r1 = mesh.Node(nf[1]).m_rt;
+			vec3d r2 = mesh.Node(nf[2]).m_rt;
+			double A = 0.0;
+			if ((nn == 3) || (nn == 6) || (nn == 7) || (nn == 10))
+				A = 0.5 * ((r1 - r0) ^ (r2 - r0)).norm();
+			else
+			{
+				vec3d r3 = mesh.Node(nf[3]).m_rt;
+				A = 0.5 * ((r2 - r0) ^ (r3 - r1)).norm();
+			}
+			if (A > Amax) Amax = A;
+		}
+
+		// characteristic length
+		double L = (Amax > 0.0 ? dom.CurrentVolume(el) / Amax : 0.0);
+		switch (el.Shape())
+		{
+		case ET_TET4 : case ET_TET5 : case ET_PYRA5 : L *= 3.0; break;
+		case ET_TET10: case ET_TET15: case ET_TET20: case ET_PYRA13: L *= 1.5; break;
+		case ET_PENTA15: case ET_HEX20: case ET_HEX27: L *= 0.5; break;
+		default:
+			break;
+		}
+
+		if ((c2 > 0.0) && (L > 0.0)) dte[i] = L / sqrt(c2);
+	}
+
+	// apply mass scaling
+	if (m_ms_dt > 0.0)
+	{
+		double totalMass = 0.0, addedMass = 0.0;
+		vector<double> dM(m_neq, 0.0);
+		vector<int> lm;
+		for (int i = 0; i < NE; ++i)
+		{
+			totalMass += me[i];
+			if (dte[i] < m_ms_dt)
+			{
+				// scaling the density by (dt_ms/dt)^2 raises the element's time step to dt_ms
+				double s = m_ms_dt / dte[i];
+				double dm = (s * s - 1.0) * me[i];
+
+				// distribute the added mass evenly over the element's nodes
+				FESolidElement& el = elems[i].dom->Element(elems[i].iel);
+				int neln = el.Nodes();
+				elems[i].dom->UnpackLM(el, lm);
+				for (int j = 0; j < 3 * neln; ++j)
+				{
+					if (lm[j] >= 0) dM[lm[j]] += dm / neln;
+				}
+
+				addedMass += dm;
+				dte[i] = m_ms_dt;
+			}
+		}
+
+		for (int i = 0; i < m_neq; ++i)
+		{
+			double M = m_Mb[i] + dM[i];
+			m_data[i].mi = (M != 0.0 ? 1.0 / M : 0.0);
+		}
+
+		double ratio = (totalMass > 0.0 ? addedMass / totalMass : 0.0);
+		feLog("\t mass scaling added mass : %lg (ratio to total mass : %lg)\n", addedMass, ratio);
+		if ((m_ms_max > 0.0) && (ratio > m_ms_max) && (m_addedMass <= m_ms_max * totalMass))
+		{
+			feLogWarning("The ratio of added mass to total mass (%lg) exceeds the max. added mass.", ratio);
+		}
+		m_addedMass = addedMass;
+	}
+
+	// find the smallest time step
+	double dtmin = DTMAX;
+	for (int i = 0; i < NE; ++i) if (dte[i] < dtmin) dtmin = dte[i];
+	if (dtmin == DTMAX)
+	{
+		// no elements, so keep the user's time step
+		m_dtStable = 0.0;
+		m_nsub = 1;
+		return;
+	}
+	double dt = m_dt_safety * dtmin;
+
+	// select the elements for subcycling
+	m_nsub = 1;
+	m_subElem.clear();
+	m_subNode.clear();
+	m_subEq.clear();
+	if (m_subcycling)
+	{
+		// Elements with a time step less than nsub*dtmin take nsub substeps. The nodes
+		// of these elements are integrated with the substeps. The elements that share
+		// these nodes (the interface elements) are also evaluated at the substeps, using
+		// interpolated positions of their other nodes.
+		double dts = m_nsubcycles * dtmin;
+		vector<int> tag(mesh.Nodes(), 0);
+		for (int i = 0; i < NE; ++i)
+		{
+			if (dte[i] < dts)
+			{
+				FESolidElement& el = elems[i].dom->Element(elems[i].iel);
+				for (int j = 0; j < el.Nodes(); ++j) tag[el.m_node[j]] = 1;
+			}
+		}
+
+		vector<SubcycledElement> sub;
+		bool bok = true;
+		for (int i = 0; i < NE; ++i)
+		{
+			FESolidElement& el = elems[i].dom->Element(elems[i].iel);
+			bool bsub = false;
+			for (int j = 0; j < el.Nodes(); ++j) if (tag[el.m_node[j]] == 1) bsub = true;
+			if (bsub)
+			{
+				// we don't subcycle solid-shell interfaces
+				for (int j = 0; j < (int)el.m_bitfc.size(); ++j) if (el.m_bitfc[j]) bok = false;
+				sub.push_back(elems[i]);
+			}
+		}
+
+		// subcycling only pays off when it is a small part of the model
+		if (bok && (2 * (int)sub.size() < NE))
+		{
+			m_nsub = m_nsubcycles;
+			m_subElem = sub;
+			dt = m_dt_safety * dts;
+
+			// collect the nodes (subcycled nodes are tagged with 1, interface nodes with 2)
+			for (SubcycledElement& se : m_subElem)
+			{
+				FESolidElement& el = se.dom->Element(se.iel);
+				for (int j = 0; j < el.Nodes(); ++j)
+				{
+					int n = el.m_node[j];
+					if (tag[n] == 0) tag[n] = 2;
+					if (tag[n] > 0) { m_subNode.push_back(n); tag[n] = -tag[n]; }
+				}
+			}
+
+			// collect the equations of the subcycled nodes
+			m_isSub.assign(m_neq, 0);
+			for (int n : m_subNode)
+			{
+				if (tag[n] != -1) continue;
+				FENode& node = mesh.Node(n);
+				for (int j = 0; j < 3; ++j)
+				{
+					int eq = node.m_ID[m_dofU[j]];
+					if (eq >= 0) { m_isSub[eq] = 1; m_subEq.push_back(eq); }
+				}
+			}
+		}
+	}
+
+	// The element time steps oscillate with the element deformation. Following
+	// them would modulate the time step with the highest frequencies of the
+	// model, which pumps energy into these modes. So the time step may decrease
+	// immediately, but it only grows slowly.
+	const double maxGrowth = 1.01;
+	if ((m_dtStable > 0.0) && (dt > maxGrowth * m_dtStable)) dt = maxGrowth * m_dtStable;
+
+	m_dtStable = dt;
+	if (m_nsub > 1)
+		feLog("\t stable time step : %lg (%d elements subcycled)\n", m_dtStable, (int)m_subElem.size());
+	else
+		feLog("\t stable time step : %lg\n", m_dtStable);
+}
+
 //-----------------------------------------------------------------------------
 //! initialize equations
 bool FEExplicitSolidSolver::InitEquations()
@@ -456,6 +720,13 @@ bool FEExplicitSolidSolver::Init()
 	FEMechModel& fem = dynamic_cast<FEMechModel&>(*GetFEModel());
 	FEMesh& mesh = fem.GetMesh();
 
+	// the substeps are a fraction of the stable time step
+	if (m_subcycling && (m_auto_dt == false))
+	{
+		feLogWarning("Subcycling requires auto_dt and is turned off.");
+		m_subcycling = false;
+	}
+
 	// set the dynamic update flag only if we are running a dynamic analysis
 	// NOTE: I don't think we need to set the dynamic update flag, in fact, we should 
 	//		 turn it off, since it's on by default, and it incurs a significant performance overhead
@@ -472,8 +743,12 @@ bool FEExplicitSolidSolver::Init()
 	int neq = m_neq;
 
 	// allocate vectors
-	m_data.resize(neq);
-	m_Rt.assign(neq, 0);
+	// (on a restart, the nodal data and residual were read from the dump file)
+	if (m_brestart == false)
+	{
+		m_data.resize(neq);
+		m_Rt.assign(neq, 0);
+	}
 	m_Fr.assign(neq, 0);
 	m_Ut.assign(neq, 0);
 	m_ui.assign(neq, 0);
@@ -491,12 +766,25 @@ bool FEExplicitSolidSolver::Init()
 	gather(m_Ut, mesh, m_dofSU[1]);
 	gather(m_Ut, mesh, m_dofSU[2]);
 
-	// calculate the inverse mass vector for the explicit analysis
-	if (CalculateMassMatrix() == false)
+	// On a restart, the (scaled) masses, the stable time step and the subcycling
+	// data were read from the dump file, so they are not reevaluated.
+	if (m_brestart == false)
 	{
-		feLogError("Failed building mass matrix.");
-		return false;
+		// calculate the inverse mass vector for the explicit analysis
+		if (CalculateMassMatrix() == false)
+		{
+			feLogError("Failed building mass matrix.");
+			return false;
+		}
+
+		// calculate the stable time step. This may also modify the mass
+		// vector, so it must be done before the initial accelerations are evaluated.
+		m_dtStable = 0.0;
+		m_addedMass = 0.0;
+		m_nsub = 1;
+		if (m_auto_dt || (m_ms_dt > 0.0)) UpdateStableTimeStep();
 	}
+	m_brestart = false;
 
 	// calculate the initial acceleration
 	// (Only when the totiter == 0, in case of a restart)
@@ -734,9 +1022,86 @@ void FEExplicitSolidSolver::Serialize(DumpStream& ar)
 				ar >> d.v >> d.a >> d.mi;
 			}
 		}
+
+		// stable time step, mass scaling and subcycling data
+		ar & m_Mb & m_dtStable & m_addedMass & m_nsub & m_subNode & m_subEq;
+
+		// the subcycled elements are stored by their domain and local element index
+		FEMesh& mesh = GetFEModel()->GetMesh();
+		if (ar.IsSaving())
+		{
+			int NE = (int)m_subElem.size();
+			ar << NE;
+			for (int i = 0; i < NE; ++i)
+			{
+				int ndom = -1;
+				for (int n = 0; n < mesh.Domains(); ++n) if (&mesh.Domain(n) == m_subElem[i].dom) ndom = n;
+				ar << ndom << m_subElem[i].iel;
+			}
+		}
+		else if (ar.IsLoading())
+		{
+			int NE = 0;
+			ar >> NE;
+			m_subElem.resize(NE);
+			for (int i = 0; i < NE; ++i)
+			{
+				int ndom, iel;
+				ar >> ndom >> iel;
+				m_subElem[i].dom = dynamic_cast<FEElasticSolidDomain*>(&mesh.Domain(ndom));
+				m_subElem[i].iel = iel;
+				assert(m_subElem[i].dom);
+			}
+
+			m_isSub.assign(m_neq, 0);
+			for (int eq : m_subEq) m_isSub[eq] = 1;
+
+			// Init must not overwrite this data
+			m_brestart = true;
+		}
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! When the stable time step is used, this replaces the time increment before
+//! the step is initialized. Mass scaling is also applied when the user's time
+//! step is used, since it is then the only way to keep the step stable.
+bool FEExplicitSolidSolver::InitStep(double time)
+{
+	FEModel& fem = *GetFEModel();
+	FETimeInfo& tp = fem.GetTime();
+
+	// update the stable time step and the mass scaling
+	if ((m_auto_dt || (m_ms_dt > 0.0)) && (tp.timeStep > 0) && (tp.timeStep % m_dt_interval == 0))
+	{
+		UpdateStableTimeStep();
+
+		// the masses may have changed, so update the accelerations
+		if (m_ms_dt > 0.0)
+		{
+			for (int i = 0; i < m_neq; ++i) m_data[i].a = m_Rt[i] * m_data[i].mi;
+		}
+	}
+
+	if (m_auto_dt)
+	{
+		if (m_dtStable > 0.0)
+		{
+			FEAnalysis* step = fem.GetCurrentStep();
+			double t0 = tp.currentTime - tp.timeIncrement;
+			double dt = m_dtStable;
+			if (t0 + dt > step->m_tend) dt = step->m_tend - t0;
+
+			step->m_dt = m_dtStable;
+			tp.timeIncrement = dt;
+			tp.currentTime = t0 + dt;
+			time = tp.currentTime;
+		}
+	}
+
+	return FESolver::InitStep(time);
+}
+
 //-----------------------------------------------------------------------------
 //!  This function mainly calls the DoSolve routine 
 //!  and deals with exceptions that require the immediate termination of
@@ -1002,15 +1367,22 @@ bool FEExplicitSolidSolver::DoSolve()
 		if ((n = rb.m_LM[5]) >= 0) { m_data[n].v = Wn.z; m_data[n].a = An.z; }
 	}
 
+	// the subcycled equations are integrated first, since they
+	// need the state at the start of the time step
+	if (m_nsub > 1) Subcycle(dt);
+
 	double Dnorm = 0.0;
 #pragma omp parallel for reduction(+: Dnorm)
 	for (int i = 0; i < m_neq; ++i)
 	{
-		// velocity predictor
-		m_data[i].v += m_data[i].a * dt*0.5;
+		if ((m_nsub == 1) || (m_isSub[i] == 0))
+		{
+			// velocity predictor
+			m_data[i].v += m_data[i].a * dt * 0.5;
 
-		// update displacements
-		m_ui[i] = dt * m_data[i].v;
+			// update displacements
+			m_ui[i] = dt * m_data[i].v;
+		}
 
 		// update norm
 		Dnorm += m_ui[i] * m_ui[i];
@@ -1061,8 +1433,9 @@ bool FEExplicitSolidSolver::DoSolve()
 		{
 			m_data[i].a = m_Rt[i] * m_data[i].mi;
 
-			// update velocity
-			m_data[i].v = m_dyn_damping * (m_data[i].v + m_data[i].a * dt * 0.5);
+			// update velocity (subcycled equations complete their last substep)
+			double dti = ((m_nsub > 1) && m_isSub[i] ? dt / m_nsub : dt);
+			m_data[i].v = m_dyn_damping * (m_data[i].v + m_data[i].a * dti * 0.5);
 		}
 
 		// scatter velocity and accelerations
@@ -1144,6 +1517,149 @@ bool FEExplicitSolidSolver::DoSolve()
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// Integrates the equations of the subcycled nodes over the time step with m_nsub 
+// substeps. In the substeps, only the internal forces of the subcycled elements
+// (including the interface elements) are evaluated. The other nodes of these
+// elements are interpolated linearly over the time step. All other forces on the
+// subcycled nodes are kept at their values at the start of the time step. The last
+// substep is completed at the end of the time step, when the forces of the whole
+// model are evaluated.
+void FEExplicitSolidSolver::Subcycle(double dt)
+{
+	FEModel& fem = *GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+	const FETimeInfo& tp = fem.GetTime();
+
+	int NE = (int)m_subElem.size();
+	int NN = (int)m_subNode.size();
+	int NQ = (int)m_subEq.size();
+	double h = dt / m_nsub;
+
+	// forces that are not updated in the substeps
+	vector<double> Rs(m_neq, 0.0);
+	SubcycledForces(Rs);
+	vector<double> R0(NQ);
+	for (int i = 0; i < NQ; ++i) R0[i] = m_Rt[m_subEq[i]] - Rs[m_subEq[i]];
+
+	// All other displacements of the nodes are interpolated over the substeps. 
+	// (PrepStep stored the increments of the prescribed displacements in m_ui.)
+	vector<double> u0(3 * NN, 0.0), du(3 * NN, 0.0);
+	for (int i = 0; i < NN; ++i)
+	{
+		FENode& node = mesh.Node(m_subNode[i]);
+		for (int j = 0; j < 3; ++j)
+		{
+			int n = node.m_ID[m_dofU[j]];
+			if ((n >= 0) && (m_isSub[n] == 0))
+			{
+				u0[3 * i + j] = m_Ut[n];
+				du[3 * i + j] = dt * (m_data[n].v + m_data[n].a * dt * 0.5);
+			}
+			else if (n < -1)
+			{
+				u0[3 * i + j] = node.get(m_dofU[j]);
+				du[3 * i + j] = m_ui[-n - 2];
+			}
+		}
+	}
+
+	FETimeInfo tps = tp;
+	double t0 = tp.currentTime - dt;
+	for (int k = 0; k < m_nsub; ++k)
+	{
+		// velocity predictor and displacement update
+#pragma omp parallel for
+		for (int i = 0; i < NQ; ++i)
+		{
+			int n = m_subEq[i];
+			m_data[n].v += m_data[n].a * h * 0.5;
+			m_ui[n] += h * m_data[n].v;
+		}
+
+		// the last substep is completed with the rest of the model
+		if (k == m_nsub - 1) break;
+
+		// update the subcycled nodes
+#pragma omp parallel for
+		for (int i = 0; i < NN; ++i)
+		{
+			FENode& node = mesh.Node(m_subNode[i]);
+			for (int j = 0; j < 3; ++j)
+			{
+				int n = node.m_ID[m_dofU[j]];
+				if ((n >= 0) && m_isSub[n]) node.set(m_dofU[j], m_Ut[n] + m_ui[n]);
+				else if (n != -1) node.set(m_dofU[j], u0[3 * i + j] + du[3 * i + j] * (k + 1) / m_nsub);
+			}
+			if (node.m_rid == -1) node.m_rt = node.m_r0 + node.get_vec3d(m_dofU[0], m_dofU[1], m_dofU[2]);
+		}
+
+		// update the stresses of the subcycled elements
+		// (the increment is relative to the start of the time step)
+		tps.currentTime = t0 + (k + 1) * h;
+		tps.timeIncrement = (k + 1) * h;
+		bool berr = false;
+#pragma omp parallel for shared(berr)
+		for (int i = 0; i < NE; ++i)
+		{
+			try
+			{
+				m_subElem[i].dom->UpdateElementStress(m_subElem[i].iel, tps);
+			}
+			catch (NegativeJacobian& e)
+			{
+#pragma omp critical
+				{
+					berr = true;
+					if (e.DoOutput()) feLogError(e.what());
+				}
+			}
+		}
+		if (berr) throw NegativeJacobianDetected();
+
+		// update accelerations and velocities
+		SubcycledForces(Rs);
+#pragma omp parallel for
+		for (int i = 0; i < NQ; ++i)
+		{
+			int n = m_subEq[i];
+			m_data[n].a = (R0[i] + Rs[n]) * m_data[n].mi;
+			m_data[n].v += m_data[n].a * h * 0.5;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Evaluates the internal forces of the subcycled elements. Only the 
+//! entries of the subcycled equations are modified.
+void FEExplicitSolidSolver::SubcycledForces(vector<double>& R)
+{
+	for (int n : m_subEq) R[n] = 0.0;
+
+	int NE = (int)m_subElem.size();
+#pragma omp parallel for
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElasticSolidDomain& dom = *m_subElem[i].dom;
+		FESolidElement& el = dom.Element(m_subElem[i].iel);
+
+		vector<double> fe(3 * el.Nodes(), 0.0);
+		vector<int> lm;
+		dom.ElementInternalForce(el, fe);
+		dom.UnpackLM(el, lm);
+
+		for (int j = 0; j < (int)fe.size(); ++j)
+		{
+			int n = lm[j];
+			if ((n >= 0) && m_isSub[n])
+			{
+#pragma omp atomic
+				R[n] += fe[j];
+			}
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! calculates the residual vector
 //! Note that the concentrated nodal forces are not calculated here.
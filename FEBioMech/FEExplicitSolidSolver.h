@@ -33,6 +33,8 @@ SOFTWARE.*/
 #include <FECore/FEDofList.h>
 #include "FERigidSolver.h"
 
+class FEElasticSolidDomain;
+
 //-----------------------------------------------------------------------------
 //! This class implements a nonlinear explicit solver for solid mechanics
 //! problems.
@@ -74,6 +76,9 @@ public:
 	//! Serialize data
 	void Serialize(DumpStream& ar) override;
 
+	//! initialize the time step
+	bool InitStep(double time) override;
+
 	//! initialize equations
 	bool InitEquations() override;
 
@@ -98,10 +103,27 @@ public:
 private:
 	bool CalculateMassMatrix();
 
+	//! calculate the stable time step, and apply mass scaling and subcycling
+	void UpdateStableTimeStep();
+
+	//! integrate the subcycled equations over the time step
+	void Subcycle(double dt);
+
+	//! internal forces of the subcycled elements
+	void SubcycledForces(vector<double>& R);
+
 public:
 	int			m_mass_lumping;	//!< specify mass lumping method
 	double		m_dyn_damping;	//!< velocity damping for the explicit solver
 
+	bool		m_auto_dt;		//!< use the stable time step instead of the step size
+	double		m_dt_safety;	//!< safety factor applied to the stable time step
+	int			m_dt_interval;	//!< nr of time steps between stable time step (and mass scaling) updates
+	double		m_ms_dt;		//!< target time step for mass scaling (0 = no mass scaling)
+	double		m_ms_max;		//!< max ratio of added mass to total mass
+	bool		m_subcycling;	//!< subcycle the elements with the smallest time steps
+	int			m_nsubcycles;	//!< nr of substeps of the subcycled elements
+
 public:
 	// equation numbers
 	int		m_nreq;			//!< start of rigid body equations
@@ -111,6 +133,23 @@ public:
 	vector<double> m_Ut;	//!< Total dispalcement vector at time t (incl all previous timesteps)
 	vector<double> m_Rt;	//!< residual loads
 	vector<double> m_Fr;	//!< nodal reaction forces
+	vector<double> m_Mb;	//!< lumped masses, without mass scaling
+
+	double	m_dtStable;		//!< stable time step (0 if not evaluated)
+	double	m_addedMass;	//!< mass added by mass scaling
+	bool	m_brestart;		//!< set when the solver data was read from a dump file
+
+	// subcycling data
+	struct SubcycledElement
+	{
+		FEElasticSolidDomain*	dom;
+		int						iel;
+	};
+	int		m_nsub;							//!< nr of substeps (1 = no subcycling)
+	vector<SubcycledElement>	m_subElem;	//!< subcycled and interface elements
+	vector<int>					m_subNode;	//!< nodes of subcycled and interface elements
+	vector<int>					m_subEq;	//!< equations of subcycled nodes
+	vector<char>				m_isSub;	//!< flags subcycled equations
 
 protected:
 	FEDofList	m_dofU, m_dofV, m_dofQ, m_dofRQ;
@@ -55,6 +55,7 @@ BEGIN_FECORE_CLASS(FEFacet2FacetSliding, FEContactInterface)
 	BEGIN_PARAM_GROUP("Projection");
 		ADD_PARAMETER(m_stol     , "search_tol"   );
         ADD_PARAMETER(m_srad     , "search_radius")->setUnits(UNIT_LENGTH);;
+		ADD_PARAMETER(m_searchMethod, "search_method")->setEnums("octree\0bvh\0");
 		ADD_PARAMETER(m_nsegup   , "seg_up"       )->setLongName("max. segment updates");
 		ADD_PARAMETER(m_breloc   , "node_reloc")->setLongName("node relocation");
 	END_PARAM_GROUP();
@@ -274,6 +275,7 @@ FEFacet2FacetSliding::FEFacet2FacetSliding(FEModel* pfem) : FEContactInterface(p
 	m_breloc = false;
     m_bsmaug = false;
 	m_srad = 0.0;
+	m_searchMethod = 0;
 
 	m_atol = 0.01;
 	m_gtol = 0;
@@ -286,6 +288,8 @@ FEFacet2FacetSliding::FEFacet2FacetSliding(FEModel* pfem) : FEContactInterface(p
 	m_mu = 0;
 	m_epsf = 0;
 
+	m_cpm = m_cps = nullptr;
+
 	// set parents
 	m_ss.SetContactInterface(this);
 	m_ms.SetContactInterface(this);
@@ -294,6 +298,19 @@ FEFacet2FacetSliding::FEFacet2FacetSliding(FEModel* pfem) : FEContactInterface(p
 	m_ms.SetSibling(&m_ss);
 }
 
+//-----------------------------------------------------------------------------
+FEFacet2FacetSliding::~FEFacet2FacetSliding()
+{
+	ClearProjections();
+}
+
+//-----------------------------------------------------------------------------
+void FEFacet2FacetSliding::ClearProjections()
+{
+	delete m_cpm; m_cpm = nullptr;
+	delete m_cps; m_cps = nullptr;
+}
+
 //-----------------------------------------------------------------------------
 //! build the matrix profile for use in the stiffness matrix
 void FEFacet2FacetSliding::BuildMatrixProfile(FEGlobalMatrix& K)
@@ -372,6 +389,9 @@ bool FEFacet2FacetSliding::Init()
 	m_bfirst = true;
 	m_normg0 = 0.0;
 
+	// the search structures are rebuilt on the next projection
+	ClearProjections();
+
 	// initialize surface data
 	if (m_ss.Init() == false) return false;
 	if (m_ms.Init() == false) return false;
@@ -444,11 +464,20 @@ void FEFacet2FacetSliding::CalcAutoPenalty(FEFacetSlidingSurface& s)
 //
 void FEFacet2FacetSliding::ProjectSurface(FEFacetSlidingSurface &ss, FEFacetSlidingSurface &ms, bool bsegup, bool bmove)
 {
-	FEClosestPointProjection cpp(ms);
-	cpp.HandleSpecialCases(true);
-	cpp.SetSearchRadius(m_srad);
-	cpp.SetTolerance(m_stol);
-	cpp.Init();
+	// The projection is kept between calls. With the octree search it is rebuilt
+	// on each call, with the BVH search the boxes are only refitted.
+	FEClosestPointProjection*& pcp = (&ms == &m_ms ? m_cpm : m_cps);
+	if (pcp == nullptr)
+	{
+		pcp = new FEClosestPointProjection(ms);
+		pcp->HandleSpecialCases(true);
+		pcp->SetSearchRadius(m_srad);
+		pcp->SetTolerance(m_stol);
+		pcp->UseBVH(m_searchMethod == 1);
+		pcp->Init();
+	}
+	else pcp->Update();
+	FEClosestPointProjection& cpp = *pcp;
 
 	// if we need to project the nodes onto the secondary surface,
 	// let's do this first
@@ -477,6 +506,9 @@ void FEFacet2FacetSliding::ProjectSurface(FEFacetSlidingSurface &ss, FEFacetSlid
 		for (int i=0; i<NN; ++i) normal[i].unit();
 
 		// loop over all nodes
+		// (with self-contact a thread may move nodes that others project onto, so then this is done serially)
+		bool bparallel = (ss.SharesNodes(ms) == false);
+#pragma omp parallel for schedule(dynamic) if(bparallel)
 		for (int i=0; i<NN; ++i)
 		{
 			FENode& node = ss.Node(i);
@@ -500,7 +532,7 @@ void FEFacet2FacetSliding::ProjectSurface(FEFacetSlidingSurface &ss, FEFacetSlid
 	// loop over all primary surface elements
 	int NE = ss.Elements();
 
-#pragma omp parallel for shared(cpp) schedule(dynamic)
+#pragma omp parallel for schedule(dynamic)
 	for (int i=0; i<NE; ++i)
 	{
 		// get the next element
@@ -1320,6 +1352,7 @@ void FEFacet2FacetSliding::Serialize(DumpStream &ar)
 {
 	// store contact data
 	FEContactInterface::Serialize(ar);
+	if (ar.IsLoading()) ClearProjections();
 
 	// store contact surface data
 	m_ms.Serialize(ar);
@@ -31,6 +31,8 @@ SOFTWARE.*/
 #include "FEContactInterface.h"
 #include "FEContactSurface.h"
 
+class FEClosestPointProjection;
+
 //-----------------------------------------------------------------------------
 //! Contact surface for facet-to-facet sliding interfaces
 class FEFacetSlidingSurface : public FEContactSurface
@@ -94,6 +96,9 @@ public:
 	//! constructor
 	FEFacet2FacetSliding(FEModel* pfem);
 
+	//! destructor
+	~FEFacet2FacetSliding();
+
 	//! initialization routine
 	bool Init() override;
 
@@ -138,6 +143,9 @@ protected:
     
 	void CalcAutoPenalty(FEFacetSlidingSurface& s);
 
+	//! clear the projection search structures
+	void ClearProjections();
+
 public:
 	double	m_epsn;			//!< normal penalty factor
 	double	m_knmult;		//!< normal stiffness multiplier
@@ -146,6 +154,7 @@ public:
 	bool	m_bautopen;		//!< auto-penalty flag
     bool    m_bupdtpen;     //!< update penalty at each time step
 	double	m_srad;			//!< search radius (% of model size)
+	int		m_searchMethod;	//!< candidate search method (0 = octree, 1 = bounding volume hierarchy)
 	int		m_nsegup;		//!< segment update parameter
 	bool	m_breloc;       //!< node relocation on initialization
     bool    m_bsmaug;       //!< smooth augmentation
@@ -167,6 +176,9 @@ private:
 	bool	m_bfirst;
 	double	m_normg0;
 
+	FEClosestPointProjection*	m_cpm;	//!< projection onto the secondary surface
+	FEClosestPointProjection*	m_cps;	//!< projection onto the primary surface (two-pass)
+
 public:
 	DECLARE_FECORE_CLASS();
 };
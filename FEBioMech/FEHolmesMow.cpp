@@ -108,6 +108,108 @@ tens4ds FEHolmesMow::Tangent(FEMaterialPoint& mp)
 	return c;
 }
 
+//-----------------------------------------------------------------------------
+// The batched functions copy the left Cauchy-Green tensors into local arrays, one
+// array per component, so that the compiler can vectorize the loops over the
+// material points.
+void FEHolmesMow::StressBatch(FEMaterialPoint** mp, mat3ds* s, int n)
+{
+	const int NB = 32;
+	double b[6][NB], J[NB], S[6][NB];
+	for (int i0 = 0; i0 < n; i0 += NB)
+	{
+		const int m = (n - i0 < NB ? n - i0 : NB);
+
+		// gather the material point data
+		for (int i = 0; i < m; ++i)
+		{
+			FEElasticMaterialPoint& pt = *mp[i0 + i]->ExtractData<FEElasticMaterialPoint>();
+			mat3ds bi = pt.LeftCauchyGreen();
+			b[0][i] = bi.xx(); b[1][i] = bi.yy(); b[2][i] = bi.zz();
+			b[3][i] = bi.xy(); b[4][i] = bi.yz(); b[5][i] = bi.xz();
+			J[i] = pt.m_J;
+		}
+
+		// evaluate the stress
+		#pragma omp simd
+		for (int i = 0; i < m; ++i)
+		{
+			// b2 = b*b
+			double b2xx = b[0][i]*b[0][i] + b[3][i]*b[3][i] + b[5][i]*b[5][i];
+			double b2yy = b[3][i]*b[3][i] + b[1][i]*b[1][i] + b[4][i]*b[4][i];
+			double b2zz = b[5][i]*b[5][i] + b[4][i]*b[4][i] + b[2][i]*b[2][i];
+			double b2xy = b[0][i]*b[3][i] + b[3][i]*b[1][i] + b[5][i]*b[4][i];
+			double b2yz = b[3][i]*b[5][i] + b[1][i]*b[4][i] + b[4][i]*b[2][i];
+			double b2xz = b[0][i]*b[5][i] + b[3][i]*b[4][i] + b[5][i]*b[2][i];
+
+			// invariants of b
+			double I1 = b[0][i] + b[1][i] + b[2][i];
+			double I2 = (I1*I1 - (b2xx + b2yy + b2zz))/2.;
+			double I3 = b[0][i]*(b[1][i]*b[2][i] - b[4][i]*b[4][i])
+				      - b[3][i]*(b[3][i]*b[2][i] - b[4][i]*b[5][i])
+				      + b[5][i]*(b[3][i]*b[4][i] - b[1][i]*b[5][i]);
+
+			// exponential term
+			double eQ = exp(m_b*((2*mu-lam)*(I1-3) + lam*(I2-3))/Ha - m_b*log(I3));
+
+			double a = 0.5*eQ/J[i];
+			double c1 = 2*mu+lam*(I1-1);
+			S[0][i] = a*(c1*b[0][i] - lam*b2xx - Ha);
+			S[1][i] = a*(c1*b[1][i] - lam*b2yy - Ha);
+			S[2][i] = a*(c1*b[2][i] - lam*b2zz - Ha);
+			S[3][i] = a*(c1*b[3][i] - lam*b2xy);
+			S[4][i] = a*(c1*b[4][i] - lam*b2yz);
+			S[5][i] = a*(c1*b[5][i] - lam*b2xz);
+		}
+
+		// scatter the results
+		for (int i = 0; i < m; ++i) s[i0 + i] = mat3ds(S[0][i], S[1][i], S[2][i], S[3][i], S[4][i], S[5][i]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEHolmesMow::TangentBatch(FEMaterialPoint** mp, tens4ds* c, int n)
+{
+	const int NB = 32;
+	mat3ds b[NB], s[NB];
+	double J[NB], I1[NB], I2[NB], I3[NB], eQ[NB];
+	mat3ds identity(1.,1.,1.,0.,0.,0.);
+	tens4ds I4 = dyad4s(identity);
+	for (int i0 = 0; i0 < n; i0 += NB)
+	{
+		const int m = (n - i0 < NB ? n - i0 : NB);
+
+		// gather the material point data and the invariants
+		for (int i = 0; i < m; ++i)
+		{
+			FEElasticMaterialPoint& pt = *mp[i0 + i]->ExtractData<FEElasticMaterialPoint>();
+			b[i] = pt.LeftCauchyGreen();
+			s[i] = b[i].sqr();
+			J[i] = pt.m_J;
+			I1[i] = b[i].tr();
+			I2[i] = (I1[i]*I1[i] - s[i].tr())*0.5;
+			I3[i] = b[i].det();
+		}
+
+		// exponential term
+		#pragma omp simd
+		for (int i = 0; i < m; ++i)
+		{
+			eQ[i] = exp(m_b*((2*mu-lam)*(I1[i]-3) + lam*(I2[i]-3))/Ha - m_b*log(I3[i]));
+		}
+
+		// calculate stress and elasticity tensor
+		for (int i = 0; i < m; ++i)
+		{
+			double detFi = 1.0/J[i];
+			s[i] = 0.5*detFi*eQ[i]*((2*mu+lam*(I1[i]-1))*b[i] - lam*s[i] - Ha*identity);
+
+			c[i0 + i] = 4.*m_b/Ha*J[i]/eQ[i]*dyad1s(s[i])
+				+ detFi*eQ[i]*(lam*(dyad1s(b[i]) - dyad4s(b[i])) + Ha*I4);
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 double FEHolmesMow::StrainEnergyDensity(FEMaterialPoint& mp)
 {
@@ -52,6 +52,15 @@ public:
 		
 	//! calculate strain energy density at material point
 	virtual double StrainEnergyDensity(FEMaterialPoint& pt) override;
+
+	//! this material implements the batched stress and tangent
+	bool HasBatchEvaluation() const override { return true; }
+
+	//! calculate stress at n material points
+	void StressBatch(FEMaterialPoint** mp, mat3ds* s, int n) override;
+
+	//! calculate tangent stiffness at n material points
+	void TangentBatch(FEMaterialPoint** mp, tens4ds* c, int n) override;
     
 	//! data initialization and checking
 	bool Validate() override;
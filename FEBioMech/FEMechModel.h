@@ -68,6 +68,8 @@ public:
 	//! serialize data for restarts
 	void SerializeGeometry(DumpStream& ar) override;
 
+	void SerializeState(DumpStream& ar) override;
+
 	//! Build the matrix profile for this model
 	void BuildMatrixProfile(FEGlobalMatrix& G, bool breset) override;
 
@@ -76,6 +76,70 @@ mat3ds FEMooneyRivlin::DevStress(FEMaterialPoint& mp)
 	return T.dev()*(2.0/J);
 }
 
+//-----------------------------------------------------------------------------
+//! Calculate the deviatoric stress at n material points. The data is copied into
+//! local arrays, one array per component, so that the compiler can vectorize the
+//! loop over the material points.
+void FEMooneyRivlin::DevStressBatch(FEMaterialPoint** mp, mat3ds* s, int n)
+{
+	const int NB = 32;
+	double b[6][NB], J[NB], c1[NB], c2[NB], S[6][NB];
+	for (int i0 = 0; i0 < n; i0 += NB)
+	{
+		const int m = (n - i0 < NB ? n - i0 : NB);
+
+		// gather the material point data
+		for (int i = 0; i < m; ++i)
+		{
+			FEMaterialPoint& mpi = *mp[i0 + i];
+			FEElasticMaterialPoint& pt = *mpi.ExtractData<FEElasticMaterialPoint>();
+			mat3ds bi = pt.LeftCauchyGreen();
+			b[0][i] = bi.xx(); b[1][i] = bi.yy(); b[2][i] = bi.zz();
+			b[3][i] = bi.xy(); b[4][i] = bi.yz(); b[5][i] = bi.xz();
+			J[i] = pt.m_J;
+		}
+		m_c1(mp + i0, m, c1);
+		m_c2(mp + i0, m, c2);
+
+		// evaluate the stress
+		#pragma omp simd
+		for (int i = 0; i < m; ++i)
+		{
+			// deviatoric left Cauchy-Green tensor
+			double Jm23 = exp(-2.0/3.0*log(J[i]));
+			double Bxx = Jm23*b[0][i], Byy = Jm23*b[1][i], Bzz = Jm23*b[2][i];
+			double Bxy = Jm23*b[3][i], Byz = Jm23*b[4][i], Bxz = Jm23*b[5][i];
+
+			// B2 = B*B
+			double B2xx = Bxx*Bxx + Bxy*Bxy + Bxz*Bxz;
+			double B2yy = Bxy*Bxy + Byy*Byy + Byz*Byz;
+			double B2zz = Bxz*Bxz + Byz*Byz + Bzz*Bzz;
+			double B2xy = Bxx*Bxy + Bxy*Byy + Bxz*Byz;
+			double B2yz = Bxy*Bxz + Byy*Byz + Byz*Bzz;
+			double B2xz = Bxx*Bxz + Bxy*Byz + Bxz*Bzz;
+
+			// T = B*(W1 + W2*I1) - B2*W2
+			double I1 = Bxx + Byy + Bzz;
+			double a = c1[i] + c2[i]*I1;
+			double Txx = a*Bxx - c2[i]*B2xx;
+			double Tyy = a*Byy - c2[i]*B2yy;
+			double Tzz = a*Bzz - c2[i]*B2zz;
+			double p = (Txx + Tyy + Tzz)/3.0;
+
+			double f = 2.0/J[i];
+			S[0][i] = (Txx - p)*f;
+			S[1][i] = (Tyy - p)*f;
+			S[2][i] = (Tzz - p)*f;
+			S[3][i] = (a*Bxy - c2[i]*B2xy)*f;
+			S[4][i] = (a*Byz - c2[i]*B2yz)*f;
+			S[5][i] = (a*Bxz - c2[i]*B2xz)*f;
+		}
+
+		// scatter the results
+		for (int i = 0; i < m; ++i) s[i0 + i] = mat3ds(S[0][i], S[1][i], S[2][i], S[3][i], S[4][i], S[5][i]);
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! Calculate the deviatoric tangent
 tens4ds FEMooneyRivlin::DevTangent(FEMaterialPoint& mp)
@@ -135,6 +199,128 @@ tens4ds FEMooneyRivlin::DevTangent(FEMaterialPoint& mp)
 	return c;
 }
 
+//-----------------------------------------------------------------------------
+//! Calculate the deviatoric tangent at n material points. This evaluates the same
+//! expression as DevTangent, but component by component, so that the loops over the 
+//! material points can be vectorized. 
+void FEMooneyRivlin::DevTangentBatch(FEMaterialPoint** mp, tens4ds* c, int n)
+{
+	// Voigt index pairs (xx, yy, zz, xy, yz, xz) and the Voigt index of a tensor index pair
+	const int V[6][2] = { {0,0}, {1,1}, {2,2}, {0,1}, {1,2}, {0,2} };
+	const int M[3][3] = { {0,3,5}, {3,1,4}, {5,4,2} };
+
+	const int NB = 32;
+	double b[6][NB], J[NB], c1[NB], c2[NB];
+	double B[6][NB], S[6][NB], W[6][NB], sBB[NB], sW[NB], sI[NB], sI4[NB], C[21][NB];
+	for (int i0 = 0; i0 < n; i0 += NB)
+	{
+		const int m = (n - i0 < NB ? n - i0 : NB);
+
+		// gather the material point data
+		for (int i = 0; i < m; ++i)
+		{
+			FEMaterialPoint& mpi = *mp[i0 + i];
+			FEElasticMaterialPoint& pt = *mpi.ExtractData<FEElasticMaterialPoint>();
+			mat3ds bi = pt.LeftCauchyGreen();
+			b[0][i] = bi.xx(); b[1][i] = bi.yy(); b[2][i] = bi.zz();
+			b[3][i] = bi.xy(); b[4][i] = bi.yz(); b[5][i] = bi.xz();
+			J[i] = pt.m_J;
+		}
+		m_c1(mp + i0, m, c1);
+		m_c2(mp + i0, m, c2);
+
+		// evaluate the tensors and coefficients that the tangent is composed of
+		#pragma omp simd
+		for (int i = 0; i < m; ++i)
+		{
+			// deviatoric left Cauchy-Green tensor
+			double Jm23 = exp(-2.0/3.0*log(J[i]));
+			double Bxx = Jm23*b[0][i], Byy = Jm23*b[1][i], Bzz = Jm23*b[2][i];
+			double Bxy = Jm23*b[3][i], Byz = Jm23*b[4][i], Bxz = Jm23*b[5][i];
+
+			// B2 = B*B
+			double B2xx = Bxx*Bxx + Bxy*Bxy + Bxz*Bxz;
+			double B2yy = Bxy*Bxy + Byy*Byy + Byz*Byz;
+			double B2zz = Bxz*Bxz + Byz*Byz + Bzz*Bzz;
+			double B2xy = Bxx*Bxy + Bxy*Byy + Bxz*Byz;
+			double B2yz = Bxy*Bxz + Byy*Byz + Byz*Bzz;
+			double B2xz = Bxx*Bxz + Bxy*Byz + Bxz*Bzz;
+
+			// invariants and strain energy derivatives
+			double I1 = Bxx + Byy + Bzz;
+			double I2 = 0.5*(I1*I1 - (B2xx + B2yy + B2zz));
+			double W1 = c1[i], W2 = c2[i];
+			double WC = W1*I1 + 2*W2*I2;
+			double CWWC = 2*I2*W2;
+			double Ji = 1.0/J[i];
+
+			// deviatoric Cauchy stress: devs = dev(B*(W1 + W2*I1) - B2*W2)*2/J
+			double a = W1 + W2*I1;
+			double Txx = a*Bxx - W2*B2xx;
+			double Tyy = a*Byy - W2*B2yy;
+			double Tzz = a*Bzz - W2*B2zz;
+			double p = (Txx + Tyy + Tzz)/3.0;
+			S[0][i] = (Txx - p)*2.0*Ji;
+			S[1][i] = (Tyy - p)*2.0*Ji;
+			S[2][i] = (Tzz - p)*2.0*Ji;
+			S[3][i] = (a*Bxy - W2*B2xy)*2.0*Ji;
+			S[4][i] = (a*Byz - W2*B2yz)*2.0*Ji;
+			S[5][i] = (a*Bxz - W2*B2xz)*2.0*Ji;
+
+			// d2W/dCdC:C = B*(W2*I1) - B2*W2
+			W[0][i] = W2*(I1*Bxx - B2xx);
+			W[1][i] = W2*(I1*Byy - B2yy);
+			W[2][i] = W2*(I1*Bzz - B2zz);
+			W[3][i] = W2*(I1*Bxy - B2xy);
+			W[4][i] = W2*(I1*Byz - B2yz);
+			W[5][i] = W2*(I1*Bxz - B2xz);
+
+			B[0][i] = Bxx; B[1][i] = Byy; B[2][i] = Bzz;
+			B[3][i] = Bxy; B[4][i] = Byz; B[5][i] = Bxz;
+
+			sBB[i] = W2*4.0*Ji;
+			sW[i]  = 4.0/3.0*Ji;
+			sI[i]  = 4.0/9.0*Ji*CWWC;
+			sI4[i] = 4.0/3.0*Ji*WC;
+		}
+
+		// c = -2/3*(devs x I + I x devs) + (I4 - IxI/3)*sI4 + (BxB - B4)*sBB - (W x I + I x W)*sW + IxI*sI
+		// where (A4)_ijkl = (A_ik A_jl + A_il A_jk)/2
+		int k = 0;
+		for (int q = 0; q < 6; ++q)
+			for (int r = 0; r <= q; ++r, ++k)
+			{
+				const int ri = V[r][0], rj = V[r][1], qk = V[q][0], ql = V[q][1];
+				const double dr = (r < 3 ? 1.0 : 0.0), dq = (q < 3 ? 1.0 : 0.0);
+				const double i4 = 0.5*((ri == qk ? 1.0 : 0.0)*(rj == ql ? 1.0 : 0.0) + (ri == ql ? 1.0 : 0.0)*(rj == qk ? 1.0 : 0.0));
+				const double* Bik = B[M[ri][qk]]; const double* Bjl = B[M[rj][ql]];
+				const double* Bil = B[M[ri][ql]]; const double* Bjk = B[M[rj][qk]];
+				const double* Br = B[r]; const double* Bq = B[q];
+				const double* Sr = S[r]; const double* Sq = S[q];
+				const double* Wr = W[r]; const double* Wq = W[q];
+				double* Ck = C[k];
+
+				#pragma omp simd
+				for (int i = 0; i < m; ++i)
+				{
+					double B4 = 0.5*(Bik[i]*Bjl[i] + Bil[i]*Bjk[i]);
+					Ck[i] = -2.0/3.0*(Sr[i]*dq + dr*Sq[i])
+						+ (i4 - dr*dq/3.0)*sI4[i]
+						+ (Br[i]*Bq[i] - B4)*sBB[i]
+						- (Wr[i]*dq + dr*Wq[i])*sW[i]
+						+ dr*dq*sI[i];
+				}
+			}
+
+		// scatter the results
+		for (int i = 0; i < m; ++i)
+		{
+			double* d = c[i0 + i].d;
+			for (int l = 0; l < 21; ++l) d[l] = C[l][i];
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! calculate deviatoric strain energy density
 double FEMooneyRivlin::DevStrainEnergyDensity(FEMaterialPoint& mp)
@@ -51,6 +51,15 @@ public:
 
 	//! calculate deviatoric strain energy density
 	double DevStrainEnergyDensity(FEMaterialPoint& mp) override;
+
+	//! this material implements the batched stress and tangent
+	bool HasBatchEvaluation() const override { return true; }
+
+	//! calculate deviatoric stress at n material points
+	void DevStressBatch(FEMaterialPoint** mp, mat3ds* s, int n) override;
+
+	//! calculate deviatoric tangent at n material points
+	void DevTangentBatch(FEMaterialPoint** mp, tens4ds* c, int n) override;
     
 	// declare the parameter list
 	DECLARE_FECORE_CLASS();
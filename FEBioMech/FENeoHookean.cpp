@@ -92,6 +92,105 @@ tens4ds FENeoHookean::Tangent(FEMaterialPoint& mp)
 	return dyad1s(I)*lam1 + dyad4s(I)*(2*mu1);
 }
 
+//-----------------------------------------------------------------------------
+// The batched functions copy the material point data into local arrays, one
+// array per component, so that the compiler can vectorize the loops over the
+// material points.
+void FENeoHookean::StressBatch(FEMaterialPoint** mp, mat3ds* s, int n)
+{
+	const int NB = 32;
+	double F[9][NB], J[NB], E[NB], v[NB], S[6][NB];
+	for (int i0 = 0; i0 < n; i0 += NB)
+	{
+		const int m = (n - i0 < NB ? n - i0 : NB);
+
+		// gather the material point data
+		for (int i = 0; i < m; ++i)
+		{
+			FEMaterialPoint& mpi = *mp[i0 + i];
+			FEElasticMaterialPoint& pt = *mpi.ExtractData<FEElasticMaterialPoint>();
+			const mat3d& Fi = pt.m_F;
+			F[0][i] = Fi[0][0]; F[1][i] = Fi[0][1]; F[2][i] = Fi[0][2];
+			F[3][i] = Fi[1][0]; F[4][i] = Fi[1][1]; F[5][i] = Fi[1][2];
+			F[6][i] = Fi[2][0]; F[7][i] = Fi[2][1]; F[8][i] = Fi[2][2];
+			J[i] = pt.m_J;
+		}
+		m_E(mp + i0, m, E);
+		m_v(mp + i0, m, v);
+
+		// evaluate the stress
+		#pragma omp simd
+		for (int i = 0; i < m; ++i)
+		{
+			double lam = v[i]*E[i]/((1+v[i])*(1-2*v[i]));
+			double mu  = 0.5*E[i]/(1+v[i]);
+
+			double detFi = 1.0/J[i];
+			double p = lam*log(J[i])*detFi;
+			double mJ = mu*detFi;
+
+			// left Cauchy-Green tensor
+			double bxx = F[0][i]*F[0][i] + F[1][i]*F[1][i] + F[2][i]*F[2][i];
+			double byy = F[3][i]*F[3][i] + F[4][i]*F[4][i] + F[5][i]*F[5][i];
+			double bzz = F[6][i]*F[6][i] + F[7][i]*F[7][i] + F[8][i]*F[8][i];
+			double bxy = F[0][i]*F[3][i] + F[1][i]*F[4][i] + F[2][i]*F[5][i];
+			double byz = F[3][i]*F[6][i] + F[4][i]*F[7][i] + F[5][i]*F[8][i];
+			double bxz = F[0][i]*F[6][i] + F[1][i]*F[7][i] + F[2][i]*F[8][i];
+
+			S[0][i] = (bxx - 1.0)*mJ + p;
+			S[1][i] = (byy - 1.0)*mJ + p;
+			S[2][i] = (bzz - 1.0)*mJ + p;
+			S[3][i] = bxy*mJ;
+			S[4][i] = byz*mJ;
+			S[5][i] = bxz*mJ;
+		}
+
+		// scatter the results
+		for (int i = 0; i < m; ++i) s[i0 + i] = mat3ds(S[0][i], S[1][i], S[2][i], S[3][i], S[4][i], S[5][i]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FENeoHookean::TangentBatch(FEMaterialPoint** mp, tens4ds* c, int n)
+{
+	const int NB = 32;
+	double J[NB], E[NB], v[NB], lam1[NB], mu1[NB];
+	for (int i0 = 0; i0 < n; i0 += NB)
+	{
+		const int m = (n - i0 < NB ? n - i0 : NB);
+
+		// gather the material point data
+		for (int i = 0; i < m; ++i)
+		{
+			FEMaterialPoint& mpi = *mp[i0 + i];
+			FEElasticMaterialPoint& pt = *mpi.ExtractData<FEElasticMaterialPoint>();
+			J[i] = pt.m_J;
+		}
+		m_E(mp + i0, m, E);
+		m_v(mp + i0, m, v);
+
+		// evaluate the tangent coefficients
+		#pragma omp simd
+		for (int i = 0; i < m; ++i)
+		{
+			double lam = v[i]*E[i]/((1+v[i])*(1-2*v[i]));
+			double mu  = 0.5*E[i]/(1+v[i]);
+			lam1[i] = lam / J[i];
+			mu1[i]  = (mu - lam*log(J[i])) / J[i];
+		}
+
+		// C = lam1*IxI + 2*mu1*I4
+		for (int i = 0; i < m; ++i)
+		{
+			tens4ds& C = c[i0 + i];
+			C.zero();
+			C.d[0] = C.d[2] = C.d[5] = lam1[i] + 2*mu1[i];
+			C.d[1] = C.d[3] = C.d[4] = lam1[i];
+			C.d[9] = C.d[14] = C.d[20] = mu1[i];
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 double FENeoHookean::StrainEnergyDensity(FEMaterialPoint& mp)
 {
@@ -81,15 +81,12 @@ bool FERemodelingElasticDomain::Init()
 //! calculates the global stiffness matrix for this domain
 void FERemodelingElasticDomain::StiffnessMatrix(FELinearSystem& LS)
 {
-	// repeat over all solid elements
-	int NE = (int)m_Elem.size();
-
 	// I only need this for the element density stiffness
 	double dt = GetFEModel()->GetTime().timeIncrement;
 
-	#pragma omp parallel for
-	for (int iel=0; iel<NE; ++iel)
-	{
+	// repeat over all solid elements
+	AssembleElements(LS, [&](int iel) {
+
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
@@ -121,7 +118,7 @@ void FERemodelingElasticDomain::StiffnessMatrix(FELinearSystem& LS)
 
 		// assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-	}
+	});
 }
 
 //-----------------------------------------------------------------------------
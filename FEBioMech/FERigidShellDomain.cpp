@@ -247,10 +247,8 @@ void FERigidShellDomain::StiffnessMatrix(FELinearSystem& LS)
 void FERigidShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
 {
 	// repeat over all shell elements
-	int NE = (int)m_Elem.size();
-#pragma omp parallel for shared (NE)
-	for (int iel = 0; iel < NE; ++iel)
-	{
+	AssembleElements(LS, [&](int iel) {
+
 		FEShellElement& el = m_Elem[iel];
 
 		// create the element's stiffness matrix
@@ -269,7 +267,7 @@ void FERigidShellDomain::BodyForceStiffness(FELinearSystem& LS, FEBodyForce& bf)
 
 		// assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-	}
+	});
 }
 
 //-----------------------------------------------------------------------------
@@ -316,7 +316,7 @@ void FERigidSolver::PrepStep(const FETimeInfo& timeInfo, vector<double>& ui)
 
 //-----------------------------------------------------------------------------
 //! This function calculates the rigid stiffness matrices
-void FERigidSolver::RigidStiffness(SparseMatrix& K, vector<double>& ui, vector<double>& F, const FEElementMatrix& ke, double alpha)
+void FERigidSolver::RigidStiffness(FERigidStiffnessBuffer& buf, const FEElementMatrix& ke, double alpha)
 {
 	if (m_fem == nullptr) return;
 
@@ -324,28 +324,34 @@ void FERigidSolver::RigidStiffness(SparseMatrix& K, vector<double>& ui, vector<d
     int n = (int)en.size();
     FEMesh& mesh = m_fem->GetMesh();
     
+	// most elements are not attached to a rigid body, so check this first
+	bool brigid = false;
     bool bclamped_shell = false;
     for (int j = 0; j<n; ++j) 
 	{
 		if (en[j] >= 0)
 		{
-			if (mesh.Node(en[j]).HasFlags(FENode::SHELL) && mesh.Node(en[j]).HasFlags(FENode::RIGID_CLAMP)) {
+			FENode& node = mesh.Node(en[j]);
+			if (node.m_rid >= 0) brigid = true;
+			if (node.HasFlags(FENode::SHELL) && node.HasFlags(FENode::RIGID_CLAMP)) {
 				bclamped_shell = true;
 				break;
 			}
 		}
     }
+	if (brigid == false) return;
+
     if (bclamped_shell)
-        RigidStiffnessShell(K, ui, F, en, ke.RowIndices(), ke.ColumnsIndices(), ke, alpha);
+        RigidStiffnessShell(buf, en, ke.RowIndices(), ke.ColumnsIndices(), ke, alpha);
     else
-        RigidStiffnessSolid(K, ui, F, en, ke.RowIndices(), ke.ColumnsIndices(), ke, alpha);
+        RigidStiffnessSolid(buf, en, ke.RowIndices(), ke.ColumnsIndices(), ke, alpha);
     return;
 }
 
 //-----------------------------------------------------------------------------
 //! This function calculates the rigid stiffness matrices
 //! correct stiffness matrix for rigid-solid interfaces
-void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vector<double>& F, const vector<int>& en, const vector<int>& elmi, const std::vector<int>& elmj, const matrix& ke, double alpha)
+void FERigidSolver::RigidStiffnessSolid(FERigidStiffnessBuffer& buf, const vector<int>& en, const vector<int>& elmi, const std::vector<int>& elmj, const matrix& ke, double alpha)
 {
 	if (m_fem == nullptr) return;
 	FEMechModel& fem = *m_fem;
@@ -380,8 +386,6 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
 				// get the rigid body this node is attached to
 				FERigidBody& RBj = *fem.GetRigidBody(nodej.m_rid);
 
-				// get the rigid body equation nrs.
-				int* lmj = RBj.m_LM;
 
 				// get the relative distance to the center of mass
 				vec3d zj = nodej.m_rt - RBj.m_rt;
@@ -409,8 +413,6 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
 							// get the rigid body this node is attached to
 							FERigidBody& RBi = *fem.GetRigidBody(nodei.m_rid);
 
-							int* lmi = RBi.m_LM;
-
 							// get the relative distance (use alpha rule)
 							vec3d zi = (nodei.m_rt - RBi.m_rt)*alpha + (nodei.m_rp - RBi.m_rp)*(1 - alpha);
 							mat3d Zi; Zi.skew(zi);
@@ -445,22 +447,7 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
 							KR[5][3] = M[2][0]; KR[5][4] = M[2][1]; KR[5][5] = M[2][2];
 
 							// add the stiffness components to the Krr matrix
-							for (int k = 0; k < 6; ++k)
-								for (int l = 0; l < 6; ++l)
-								{
-									int J = lmj[k];
-									int I = lmi[l];
-
-									if (I >= 0)
-									{
-										// multiply KR by alpha for alpha rule
-										if (J < -1) {
-											#pragma omp atomic
-											F[I] -= KR[l][k] * ui[-J - 2];
-										}
-										else if (J >= 0) K.add(I, J, KR[l][k]);
-									}
-								}
+							buf.AddKrr(nodei.m_rid, nodej.m_rid, KR);
 
 							// we still need to couple the non-rigid degrees of node i to the
 							// rigid dofs of node j
@@ -472,22 +459,7 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
 								KF[k][3] = m.x; KF[k][4] = m.y; KF[k][5] = m.z;
 							}
 
-							for (int k = 0; k < 6; ++k)
-								for (int l = 3; l < ndof; ++l)
-								{
-									int J = lmj[k];
-									int I = elmi[ndof*i + l];
-
-									if (I >= 0)
-									{
-										// multiply KF by alpha for alpha rule
-										if (J < -1) {
-											#pragma omp atomic
-											F[I] -= KF[l][k] * ui[-J - 2];
-											}
-										else if (J >= 0) K.add(I, J, KF[l][k]);
-									}
-								}
+							for (int l = 3; l < ndof; ++l) buf.AddKfr(elmi[ndof*i + l], nodej.m_rid, KF[l]);
 
 							// now the transpose location
 							for (int l = 3; l < ndof; ++l) {
@@ -497,21 +469,7 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
 								KF[l][3] = m.x; KF[l][4] = m.y; KF[l][5] = m.z;
 							}
 
-							for (int k = 0; k < 6; ++k)
-								for (int l = 3; l < ndof; ++l)
-								{
-									int J = elmj[ndof*j + l];
-									int I = lmi[k];
-
-									if (I >= 0)
-									{
-										if (J < -1) {
-											#pragma omp atomic
-											F[I] -= KF[l][k] * ui[-J - 2];
-										}
-										else if (J >= 0) K.add(I, J, KF[l][k]);
-									}
-								}
+							for (int l = 3; l < ndof; ++l) buf.AddKrf(nodei.m_rid, elmj[ndof*j + l], KF[l]);
 
 						}
 						else
@@ -528,22 +486,7 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
 								KF[k][3] = m.x; KF[k][4] = m.y; KF[k][5] = m.z;
 							}
 
-							for (int k = 0; k < 6; ++k)
-								for (int l = 0; l < ndof; ++l)
-								{
-									int J = lmj[k];
-									int I = elmi[ndof*i + l];
-
-									if (I >= 0)
-									{
-										// multiply KF by alpha for alpha rule
-										if (J < -1) {
-											#pragma omp atomic
-											F[I] -= KF[l][k] * ui[-J - 2];
-										}
-										else if (J >= 0) K.add(I, J, KF[l][k]);
-									}
-								}
+							for (int l = 0; l < ndof; ++l) buf.AddKfr(elmi[ndof*i + l], nodej.m_rid, KF[l]);
 						}
 					}
 				}
@@ -562,8 +505,6 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
 							// get the rigid body this node is attached to
 							FERigidBody& RBi = *fem.GetRigidBody(nodei.m_rid);
 
-							// get the rigid body equation nrs.
-							int* lmi = RBi.m_LM;
 
 							// get the relative distance (use alpha rule)
 							vec3d zi = (nodei.m_rt - RBi.m_rt)*alpha + (nodei.m_rp - RBi.m_rp)*(1 - alpha);
@@ -584,21 +525,7 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
 								KF[k][3] = m.x; KF[k][4] = m.y; KF[k][5] = m.z;
 							}
 
-							for (int k = 0; k < 6; ++k)
-								for (int l = 0; l < ndof; ++l)
-								{
-									int I = lmi[k];
-									int J = elmj[ndof*j + l];
-
-									if (I >= 0)
-									{
-										if (J < -1) {
-											#pragma omp atomic
-											F[I] -= KF[l][k] * ui[-J - 2];
-										}
-										else if (J >= 0) K.add(I, J, KF[l][k]);
-									}
-								}
+							for (int l = 0; l < ndof; ++l) buf.AddKrf(nodei.m_rid, elmj[ndof*j + l], KF[l]);
 						}
 					}
 				}
@@ -610,7 +537,7 @@ void FERigidSolver::RigidStiffnessSolid(SparseMatrix& K, vector<double>& ui, vec
 //-----------------------------------------------------------------------------
 //! This function calculates the rigid stiffness matrices
 //! correct stiffness matrix for rigid bodies accounting for rigid-body-deformable-shell interfaces
-void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vector<double>& F, const vector<int>& en, const vector<int>& elmi, const vector<int>& elmj, const matrix& ke, double alpha)
+void FERigidSolver::RigidStiffnessShell(FERigidStiffnessBuffer& buf, const vector<int>& en, const vector<int>& elmi, const vector<int>& elmj, const matrix& ke, double alpha)
 {
 	if (m_fem == nullptr) return;
 	FEMechModel& fem = *m_fem;
@@ -628,8 +555,6 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
     vector< vector<double> > KF; KF.assign(MAX_NDOFS, vector<double>(6));
     double KR[6][6];
     
-    int *lmi, *lmj;
-    int I, J;
     
     vec3d ai, aj, bi, bj;
     mat3d Ai, Aj, Bi, Bj;
@@ -648,9 +573,7 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
             // get the rigid body this node is attached to
             FERigidBody& RBj = *fem.GetRigidBody(nodej.m_rid);
             
-            // get the rigid body equation nrs.
-            lmj = RBj.m_LM;
-            
+
             // get the relative distance to the center of mass
             aj = nodej.m_rt - RBj.m_rt;
             Aj.skew(aj);
@@ -691,8 +614,6 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                     // get the rigid body this node is attached to
                     FERigidBody& RBi = *fem.GetRigidBody(nodei.m_rid);
                     
-                    lmi = RBi.m_LM;
-                    
                     // get the relative distance (use alpha rule)
                     ai = (nodei.m_rt - RBi.m_rt)*alpha + (nodei.m_rp - RBi.m_rp)*(1 - alpha);
                     Ai.skew(ai);
@@ -731,22 +652,7 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                     KR[5][3] = M[2][0]; KR[5][4] = M[2][1]; KR[5][5] = M[2][2];
                     
                     // add the stiffness components to the Krr matrix
-                    for (k = 0; k<6; ++k)
-                        for (l = 0; l<6; ++l)
-                        {
-                            J = lmj[k];
-                            I = lmi[l];
-                            
-                            if (I >= 0)
-                            {
-                                // multiply KR by alpha for alpha rule
-								if (J < -1) {
-									#pragma omp atomic
-									F[I] -= KR[l][k] * ui[-J - 2];
-								}
-                                else if (J >= 0) K.add(I, J, KR[l][k]);
-                            }
-                        }
+                    buf.AddKrr(nodei.m_rid, nodej.m_rid, KR);
                     
                     // we still need to couple the non-rigid degrees of node i to the
                     // rigid dofs of node j
@@ -759,22 +665,7 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                         KF[k][3] = m.x; KF[k][4] = m.y; KF[k][5] = m.z;
                     }
                     
-                    for (k = 0; k<6; ++k)
-                        for (l = 6; l<ndof; ++l)
-                        {
-                            J = lmj[k];
-                            I = elmi[ndof*i + l];
-                            
-                            if (I >= 0)
-                            {
-                                // multiply KF by alpha for alpha rule
-								if (J < -1) {
-									#pragma omp atomic
-									F[I] -= KF[l][k] * ui[-J - 2];
-								}
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
-                            }
-                        }
+                    for (l = 6; l < ndof; ++l) buf.AddKfr(elmi[ndof*i + l], nodej.m_rid, &KF[l][0]);
                     
                     // now the transpose location
                     for (l = 6; l<ndof; ++l) {
@@ -786,21 +677,7 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                         KF[l][3] = m.x; KF[l][4] = m.y; KF[l][5] = m.z;
                     }
                     
-                    for (k = 0; k<6; ++k)
-                        for (l = 6; l<ndof; ++l)
-                        {
-                            J = elmj[ndof*j + l];
-                            I = lmi[k];
-                            
-                            if (I >= 0)
-                            {
-								if (J < -1) {
-									#pragma omp atomic
-									F[I] -= KF[l][k] * ui[-J - 2];
-								}
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
-                            }
-                        }
+                    for (l = 6; l < ndof; ++l) buf.AddKrf(nodei.m_rid, elmj[ndof*j + l], &KF[l][0]);
                     
                 }
                 else
@@ -818,22 +695,7 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                         KF[k][3] = m.x; KF[k][4] = m.y; KF[k][5] = m.z;
                     }
                     
-                    for (k = 0; k<6; ++k)
-                        for (l = 0; l<ndof; ++l)
-                        {
-                            J = lmj[k];
-                            I = elmi[ndof*i + l];
-                            
-                            if (I >= 0)
-                            {
-                                // multiply KF by alpha for alpha rule
-								if (J < -1) {
-									#pragma omp atomic
-									F[I] -= KF[l][k] * ui[-J - 2];
-								}
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
-                            }
-                        }
+                    for (l = 0; l < ndof; ++l) buf.AddKfr(elmi[ndof*i + l], nodej.m_rid, &KF[l][0]);
                 }
             }
         }
@@ -849,9 +711,6 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                     // get the rigid body this node is attached to
                     FERigidBody& RBi = *fem.GetRigidBody(nodei.m_rid);
                     
-                    // get the rigid body equation nrs.
-                    lmi = RBi.m_LM;
-                    
                     // get the relative distance (use alpha rule)
                     ai = (nodei.m_rt - RBi.m_rt)*alpha + (nodei.m_rp - RBi.m_rp)*(1 - alpha);
                     Ai.skew(ai);
@@ -877,27 +736,116 @@ void FERigidSolver::RigidStiffnessShell(SparseMatrix& K, vector<double>& ui, vec
                         KF[k][3] = m.x; KF[k][4] = m.y; KF[k][5] = m.z;
                     }
                     
-                    for (k = 0; k<6; ++k)
-                        for (l = 0; l<ndof; ++l)
-                        {
-                            I = lmi[k];
-                            J = elmj[ndof*j + l];
-                            
-                            if (I >= 0)
-                            {
-								if (J < -1) {
-									#pragma omp atomic
-									F[I] -= KF[l][k] * ui[-J - 2];
-								}
-                                else if (J >= 0) K.add(I, J, KF[l][k]);
-                            }
-                        }
+                    for (l = 0; l < ndof; ++l) buf.AddKrf(nodei.m_rid, elmj[ndof*j + l], &KF[l][0]);
                 }
             }
         }
     }
 }
 
+//-----------------------------------------------------------------------------
+//! Assemble the buffered contributions of RigidStiffness into the global matrix.
+//! This is where the rigid body equation numbers are resolved. Contributions to
+//! prescribed rigid dofs (J < -1) are moved to the right-hand side.
+void FERigidSolver::AssembleRigidStiffness(SparseMatrix& K, vector<double>& ui, vector<double>& F, const FERigidStiffnessBuffer& buf)
+{
+	if (m_fem == nullptr) return;
+	FEMechModel& fem = *m_fem;
+
+	// Krr blocks
+	for (auto it = buf.m_Krr.begin(); it != buf.m_Krr.end(); ++it)
+	{
+		const int* lmi = fem.GetRigidBody(it->first.first)->m_LM;
+		const int* lmj = fem.GetRigidBody(it->first.second)->m_LM;
+		const double (&KR)[6][6] = it->second.v;
+		for (int k = 0; k < 6; ++k)
+			for (int l = 0; l < 6; ++l)
+			{
+				int J = lmj[k];
+				int I = lmi[l];
+				if (I >= 0)
+				{
+					if (J < -1) F[I] -= KR[l][k] * ui[-J - 2];
+					else if (J >= 0) K.add(I, J, KR[l][k]);
+				}
+			}
+	}
+
+	// Kfr rows
+	for (auto it = buf.m_Kfr.begin(); it != buf.m_Kfr.end(); ++it)
+	{
+		int I = it->first.first;
+		const int* lmj = fem.GetRigidBody(it->first.second)->m_LM;
+		const double* kf = it->second.v;
+		for (int k = 0; k < 6; ++k)
+		{
+			int J = lmj[k];
+			if (J < -1) F[I] -= kf[k] * ui[-J - 2];
+			else if (J >= 0) K.add(I, J, kf[k]);
+		}
+	}
+
+	// Krf columns
+	for (auto it = buf.m_Krf.begin(); it != buf.m_Krf.end(); ++it)
+	{
+		const int* lmi = fem.GetRigidBody(it->first.first)->m_LM;
+		int J = it->first.second;
+		const double* kf = it->second.v;
+		for (int k = 0; k < 6; ++k)
+		{
+			int I = lmi[k];
+			if (I >= 0)
+			{
+				if (J < -1) F[I] -= kf[k] * ui[-J - 2];
+				else if (J >= 0) K.add(I, J, kf[k]);
+			}
+		}
+	}
+}
+
+//=============================================================================
+void FERigidStiffnessBuffer::AddKrr(int rbi, int rbj, const double KR[6][6])
+{
+	BLOCK& b = m_Krr[std::pair<int, int>(rbi, rbj)];
+	for (int l = 0; l < 6; ++l)
+		for (int k = 0; k < 6; ++k) b.v[l][k] += KR[l][k];
+}
+
+void FERigidStiffnessBuffer::AddKfr(int I, int rbj, const double* kf)
+{
+	// rows of fixed or prescribed dofs are not assembled
+	if (I < 0) return;
+	ROW& r = m_Kfr[std::pair<int, int>(I, rbj)];
+	for (int k = 0; k < 6; ++k) r.v[k] += kf[k];
+}
+
+void FERigidStiffnessBuffer::AddKrf(int rbi, int J, const double* kf)
+{
+	// columns of fixed dofs are not assembled
+	if (J == -1) return;
+	ROW& r = m_Krf[std::pair<int, int>(rbi, J)];
+	for (int k = 0; k < 6; ++k) r.v[k] += kf[k];
+}
+
+void FERigidStiffnessBuffer::Merge(const FERigidStiffnessBuffer& buf)
+{
+	for (auto it = buf.m_Krr.begin(); it != buf.m_Krr.end(); ++it) AddKrr(it->first.first, it->first.second, it->second.v);
+	for (auto it = buf.m_Kfr.begin(); it != buf.m_Kfr.end(); ++it) AddKfr(it->first.first, it->first.second, it->second.v);
+	for (auto it = buf.m_Krf.begin(); it != buf.m_Krf.end(); ++it) AddKrf(it->first.first, it->first.second, it->second.v);
+}
+
+void FERigidStiffnessBuffer::Clear()
+{
+	m_Krr.clear();
+	m_Kfr.clear();
+	m_Krf.clear();
+}
+
+bool FERigidStiffnessBuffer::IsEmpty() const
+{
+	return (m_Krr.empty() && m_Kfr.empty() && m_Krf.empty());
+}
+
 //-----------------------------------------------------------------------------
 void FERigidSolver::AssembleResidual(int node_id, int dof, double f, vector<double>& R)
 {
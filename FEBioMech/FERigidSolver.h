@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include <FECore/FETimeInfo.h>
 #include <FECore/FESolver.h>
 #include <vector>
+#include <map>
 
 //-----------------------------------------------------------------------------
 class matrix;
@@ -43,6 +44,41 @@ class DumpStream;
 class FEElementMatrix;
 class FEMechModel;
 
+//-----------------------------------------------------------------------------
+//! Buffer for the stiffness contributions of elements that are attached to rigid bodies.
+//! The contributions are condensed into 6x6 blocks that couple the dofs of two rigid 
+//! bodies (Krr), and rows of 6 that couple an equation to the dofs of a rigid body 
+//! (Kfr and Krf). Each assembly thread uses its own buffer, so that no synchronization
+//! is needed. The buffers are then assembled with FERigidSolver::AssembleRigidStiffness.
+class FEBIOMECH_API FERigidStiffnessBuffer
+{
+public:
+	struct BLOCK { double v[6][6]; };
+	struct ROW { double v[6]; };
+
+public:
+	//! add a block that couples the dofs of rigid body rbi (rows) to those of rigid body rbj (columns)
+	void AddKrr(int rbi, int rbj, const double KR[6][6]);
+
+	//! add a row that couples equation I to the dofs of rigid body rbj
+	void AddKfr(int I, int rbj, const double* kf);
+
+	//! add a column that couples the dofs of rigid body rbi to equation J
+	void AddKrf(int rbi, int J, const double* kf);
+
+	//! add the contributions of another buffer
+	void Merge(const FERigidStiffnessBuffer& buf);
+
+	void Clear();
+
+	bool IsEmpty() const;
+
+public:
+	std::map<std::pair<int, int>, BLOCK>	m_Krr;	//!< key = (rbi, rbj)
+	std::map<std::pair<int, int>, ROW>		m_Kfr;	//!< key = (I, rbj)
+	std::map<std::pair<int, int>, ROW>		m_Krf;	//!< key = (rbi, J)
+};
+
 //-----------------------------------------------------------------------------
 //! This is a helper class that helps the solid deformables solvers update the 
 //! state of the rigid system.
@@ -63,13 +99,18 @@ public:
 	void PrepStep(const FETimeInfo& timeInfo, vector<double>& ui);
 
 	// correct stiffness matrix for rigid bodies
-	void RigidStiffness(SparseMatrix& K, std::vector<double>& ui, std::vector<double>& F, const FEElementMatrix& ke, double alpha);
+	// The contributions are added to the buffer, which is later assembled with AssembleRigidStiffness.
+	void RigidStiffness(FERigidStiffnessBuffer& buf, const FEElementMatrix& ke, double alpha);
 
     // correct stiffness matrix for rigid bodies accounting for rigid-body-deformable-shell interfaces
-    void RigidStiffnessSolid(SparseMatrix& K, std::vector<double>& ui, std::vector<double>& F, const std::vector<int>& en, const std::vector<int>& lmi, const std::vector<int>& lmj, const matrix& ke, double alpha);
+    void RigidStiffnessSolid(FERigidStiffnessBuffer& buf, const std::vector<int>& en, const std::vector<int>& lmi, const std::vector<int>& lmj, const matrix& ke, double alpha);
     
     // correct stiffness matrix for rigid bodies accounting for rigid-body-deformable-shell interfaces
-    void RigidStiffnessShell(SparseMatrix& K, std::vector<double>& ui, std::vector<double>& F, const std::vector<int>& en, const std::vector<int>& lmi, const std::vector<int>& lmj, const matrix& ke, double alpha);
+    void RigidStiffnessShell(FERigidStiffnessBuffer& buf, const std::vector<int>& en, const std::vector<int>& lmi, const std::vector<int>& lmj, const matrix& ke, double alpha);
+
+	// assemble the buffered rigid stiffness contributions into the global matrix.
+	// Contributions of prescribed rigid dofs are stored in F.
+	void AssembleRigidStiffness(SparseMatrix& K, std::vector<double>& ui, std::vector<double>& F, const FERigidStiffnessBuffer& buf);
     
 	// adjust residual for rigid-deformable interface nodes
 	void AssembleResidual(int node_id, int dof, double f, std::vector<double>& R);
@@ -53,6 +53,8 @@ BEGIN_FECORE_CLASS(FESlidingElasticInterface, FEContactInterface)
 	ADD_PARAMETER(m_naugmin  , "minaug"             );
 	ADD_PARAMETER(m_naugmax  , "maxaug"             );
 	ADD_PARAMETER(m_breloc   , "node_reloc"         );
+	ADD_PARAMETER(m_bincremental, "incremental_search");
+	ADD_PARAMETER(m_searchMethod, "search_method"   )->setEnums("octree\0bvh\0");
 	ADD_PARAMETER(m_mu       , "fric_coeff"         );
 	ADD_PARAMETER(m_bsmaug   , "smooth_aug"         );
 	ADD_PARAMETER(m_bflips   , "flip_primary"       );
@@ -304,6 +306,8 @@ FESlidingElasticInterface::FESlidingElasticInterface(FEModel* pfem) : FEContactI
 	m_bupdtpen = false;
     m_btension = false;
     m_breloc = false;
+    m_bincremental = false;
+    m_searchMethod = 0;
     m_bsmaug = false;
     m_mu = 0.0;
     
@@ -316,6 +320,8 @@ FESlidingElasticInterface::FESlidingElasticInterface(FEModel* pfem) : FEContactI
     
     m_offset = 0;
 
+    m_npm = m_nps = nullptr;
+
     // set parents
     m_ss.SetContactInterface(this);
     m_ms.SetContactInterface(this);
@@ -327,13 +333,22 @@ FESlidingElasticInterface::FESlidingElasticInterface(FEModel* pfem) : FEContactI
 //-----------------------------------------------------------------------------
 FESlidingElasticInterface::~FESlidingElasticInterface()
 {
+	ClearProjections();
+}
+
+//-----------------------------------------------------------------------------
+void FESlidingElasticInterface::ClearProjections()
+{
+	delete m_npm; m_npm = nullptr;
+	delete m_nps; m_nps = nullptr;
 }
 
 //-----------------------------------------------------------------------------
 bool FESlidingElasticInterface::Init()
 {
-    
-    
+	// the search structures are rebuilt on the next projection
+	ClearProjections();
+
     // check friction and tension parameters
     // since they cannot be used simultaneously
 	if ((m_mu != 0) && m_btension) {
@@ -487,10 +502,20 @@ void FESlidingElasticInterface::ProjectSurface(FESlidingElasticSurface& ss, FESl
     FEMesh& mesh = GetFEModel()->GetMesh();
     
     // initialize projection data
-    FENormalProjection np(ms);
-    np.SetTolerance(m_stol);
-    np.SetSearchRadius(m_srad);
-    np.Init();
+    // The projection is kept between calls. With the octree search it is rebuilt
+    // on each call, with the BVH search the boxes are only refitted.
+    FENormalProjection*& pnp = (&ms == &m_ms ? m_npm : m_nps);
+    if (pnp == nullptr)
+    {
+        pnp = new FENormalProjection(ms);
+        pnp->SetTolerance(m_stol);
+        pnp->SetSearchRadius(m_srad);
+        pnp->SetIncrementalSearch(m_bincremental);
+        pnp->UseBVH(m_searchMethod == 1);
+        pnp->Init();
+    }
+    else pnp->Update();
+    FENormalProjection& np = *pnp;
     
     double psf = GetPenaltyScaleFactor();
     
@@ -527,6 +552,9 @@ void FESlidingElasticInterface::ProjectSurface(FESlidingElasticSurface& ss, FESl
         if (ss.IsShellBottom()) for (int i=0; i<NN; ++i) normal[i] = -normal[i];
         
         // loop over all nodes
+        // (with self-contact a thread may move nodes that others project onto, so then this is done serially)
+        bool bparallel = (ss.SharesNodes(ms) == false);
+#pragma omp parallel for schedule(dynamic) if(bparallel)
         for (int i=0; i<NN; ++i)
         {
             FENode& node = ss.Node(i);
@@ -603,7 +631,7 @@ void FESlidingElasticInterface::ProjectSurface(FESlidingElasticSurface& ss, FESl
 				}
 
 				// find the intersection point with the secondary surface
-				if (pme == 0 && bupseg) pme = np.Project(r, nu, rs);
+				if (pme == 0 && bupseg) pme = np.Project(r, nu, rs, data.m_pme);
 
 				data.m_pme = pme;
 				data.m_nu = nu;
@@ -1828,6 +1856,7 @@ void FESlidingElasticInterface::Serialize(DumpStream &ar)
     // serialize contact data
     FEContactInterface::Serialize(ar);
 	ar & m_bfreeze;
+	if (ar.IsLoading()) ClearProjections();
     
     // serialize contact surface data
     m_ms.Serialize(ar);
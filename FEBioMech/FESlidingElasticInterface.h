@@ -95,6 +95,9 @@ public:
     vec3d    m_Ft;     //!< total contact force (from equivalent nodal forces)
 };
 
+//-----------------------------------------------------------------------------
+class FENormalProjection;
+
 //-----------------------------------------------------------------------------
 class FESlidingElasticInterface : public FEContactInterface
 {
@@ -154,6 +157,9 @@ protected:
     
     void CalcAutoPenalty(FESlidingElasticSurface& s);
 
+	//! clear the projection search structures
+	void ClearProjections();
+
 public:
     FESlidingElasticSurface	m_ss;	//!< primary surface
 	FESlidingElasticSurface	m_ms;	//!< secondary surface
@@ -165,6 +171,8 @@ public:
     double			m_stol;			//!< search tolerance
     bool			m_bsymm;		//!< use symmetric stiffness components only
     double			m_srad;			//!< contact search radius
+    bool			m_bincremental;	//!< search neighbors of previous secondary element first
+    int				m_searchMethod;	//!< candidate search method (0 = octree, 1 = bounding volume hierarchy)
     int				m_naugmax;		//!< maximum nr of augmentations
     int				m_naugmin;		//!< minimum nr of augmentations
     int				m_nsegup;		//!< segment update parameter
@@ -187,5 +195,9 @@ public:
 
     double          m_offset;       //!< allow an offset that separates the contact surfaces
 
+private:
+	FENormalProjection*	m_npm;	//!< projection onto the secondary surface
+	FENormalProjection*	m_nps;	//!< projection onto the primary surface (two-pass)
+
     DECLARE_FECORE_CLASS();
 };
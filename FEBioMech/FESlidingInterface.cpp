@@ -88,6 +88,7 @@ BEGIN_FECORE_CLASS(FESlidingInterface, FEContactInterface)
 	ADD_PARAMETER(m_naugmin      , "minaug"       );
 	ADD_PARAMETER(m_naugmax      , "maxaug"       );
 	ADD_PARAMETER(m_stol         , "search_tol"   );
+	ADD_PARAMETER(m_searchMethod , "search_method")->setEnums("octree\0bvh\0");
 	ADD_PARAMETER(m_ktmult       , "ktmult"       );
 	ADD_PARAMETER(m_knmult       , "knmult"       );
 	ADD_PARAMETER(m_breloc       , "node_reloc"   );
@@ -429,6 +430,9 @@ FESlidingInterface::FESlidingInterface(FEModel* pfem) : FEContactInterface(pfem)
 	m_bautopen = false;	// don't use auto-penalty
 	m_btwo_pass = false; // don't use two-pass
 	m_sradius = 0;				// no search radius limitation
+	m_searchMethod = 0;			// octree search
+
+	m_cpm = m_cps = nullptr;
 
 	// set parents
 	m_ms.SetContactInterface(this);
@@ -439,6 +443,19 @@ FESlidingInterface::FESlidingInterface(FEModel* pfem) : FEContactInterface(pfem)
 	m_ss.SetSibling(&m_ms);
 };
 
+//-----------------------------------------------------------------------------
+FESlidingInterface::~FESlidingInterface()
+{
+	ClearProjections();
+}
+
+//-----------------------------------------------------------------------------
+void FESlidingInterface::ClearProjections()
+{
+	delete m_cpm; m_cpm = nullptr;
+	delete m_cps; m_cps = nullptr;
+}
+
 //-----------------------------------------------------------------------------
 //! Calculates the auto penalty factor
 
@@ -484,6 +501,9 @@ bool FESlidingInterface::Init()
 	m_bfirst = true;
 	m_normg0 = 0.0;
 
+	// the search structures are rebuilt on the next projection
+	ClearProjections();
+
 	// create the surfaces
 	if (m_ss.Init() == false) return false;
 	if (m_ms.Init() == false) return false;
@@ -524,19 +544,32 @@ void FESlidingInterface::Activate()
 
 void FESlidingInterface::ProjectSurface(FESlidingSurface& ss, FESlidingSurface& ms, bool bupseg, bool bmove)
 {
-	// node projection data
-	double r, s;
-	vec3d q;
-
-	FEClosestPointProjection cpp(ms);
-	cpp.SetTolerance(m_stol);
-	cpp.SetSearchRadius(m_sradius);
-	cpp.HandleSpecialCases(true);
-	cpp.Init();
+	// The projection is kept between calls. With the octree search it is rebuilt
+	// on each call, with the BVH search the boxes are only refitted.
+	FEClosestPointProjection*& pcp = (&ms == &m_ms ? m_cpm : m_cps);
+	if (pcp == nullptr)
+	{
+		pcp = new FEClosestPointProjection(ms);
+		pcp->SetTolerance(m_stol);
+		pcp->SetSearchRadius(m_sradius);
+		pcp->HandleSpecialCases(true);
+		pcp->UseBVH(m_searchMethod == 1);
+		pcp->Init();
+	}
+	else pcp->Update();
+	FEClosestPointProjection& cpp = *pcp;
 
 	// loop over all primary surface nodes
+	// (each node only modifies its own data, so this can be done in parallel, unless
+	// nodes are moved onto a surface that shares nodes with this one, e.g. self-contact)
+	bool bparallel = ((bmove == false) || (ss.SharesNodes(ms) == false));
+#pragma omp parallel for schedule(dynamic) if(bparallel)
 	for (int i=0; i<ss.Nodes(); ++i)
 	{
+		// node projection data
+		double r, s;
+		vec3d q;
+
 		// get the node
 		FENode& node = ss.Node(i);
 
@@ -1883,6 +1916,7 @@ void FESlidingInterface::Serialize(DumpStream& ar)
 {
 	// store contact data
 	FEContactInterface::Serialize(ar);
+	if (ar.IsLoading()) ClearProjections();
 
 	// store contact surface data
 	m_ms.Serialize(ar);
@@ -83,6 +83,8 @@ public:
 	vector<FESlidingPoint>		m_data;	//!< sliding contact surface data
 };
 
+class FEClosestPointProjection;
+
 //-----------------------------------------------------------------------------
 //! This class implements a sliding interface
 
@@ -95,7 +97,7 @@ public:
 	FESlidingInterface(FEModel* pfem);
 
 	//! destructor
-	virtual ~FESlidingInterface(){}
+	virtual ~FESlidingInterface();
 
 	//! Initializes sliding interface
 	bool Init() override;
@@ -154,6 +156,9 @@ protected:
 private:
 	void SerializePointers(FESlidingSurface& ss, FESlidingSurface& ms, DumpStream& ar);
 
+	//! clear the projection search structures
+	void ClearProjections();
+
 public:
 	FESlidingSurface	m_ss;	//!< primary surface
 	FESlidingSurface	m_ms;	//!< secondary surface
@@ -170,6 +175,7 @@ public:
 	double			m_knmult;	//!< multiplier for normal stiffness
 
 	double			m_stol;		//!< search tolerance
+	int				m_searchMethod;	//!< candidate search method (0 = octree, 1 = bounding volume hierarchy)
 
 	bool			m_bautopen;	//!< auto penalty calculation
 	double			m_eps;		//!< penalty scale factor 
@@ -186,6 +192,9 @@ private:
 	bool	m_bfirst;	//!< flag to indicate the first time we enter Update
 	double	m_normg0;	//!< initial gap norm
 
+	FEClosestPointProjection*	m_cpm;	//!< projection onto the secondary surface
+	FEClosestPointProjection*	m_cps;	//!< projection onto the primary surface (two-pass)
+
 public:
 	DECLARE_FECORE_CLASS();
 };
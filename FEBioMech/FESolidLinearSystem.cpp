@@ -30,6 +30,9 @@ SOFTWARE.*/
 #include "FESolidSolver.h"
 #include <FECore/FELinearConstraintManager.h>
 #include <FECore/FEModel.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 FESolidLinearSystem::FESolidLinearSystem(FEModel* fem, FERigidSolver* rigidSolver, FEGlobalMatrix& K, std::vector<double>& F, std::vector<double>& u, bool bsymm, double alpha, int nreq) : FELinearSystem(fem, K, F, u, bsymm)
 {
@@ -38,6 +41,21 @@ FESolidLinearSystem::FESolidLinearSystem(FEModel* fem, FERigidSolver* rigidSolve
 	m_alpha = alpha;
 	m_nreq = nreq;
 	m_stiffnessScale = 1.0;
+
+#ifdef _OPENMP
+	m_rigidBuf.resize(omp_get_max_threads());
+#else
+	m_rigidBuf.resize(1);
+#endif
+}
+
+// The solvers should call AssembleRigidStiffness before the matrix is used. If a solver
+// did not, the contributions are assembled here, so that they are not lost when the 
+// linear system goes out of scope before the matrix is factored. (This is also reached
+// when the assembly was interrupted by an error, so we don't assert on it.)
+FESolidLinearSystem::~FESolidLinearSystem()
+{
+	if (HasPendingRigidStiffness()) AssembleRigidStiffness();
 }
 
 // scale factor for stiffness matrix
@@ -121,7 +139,68 @@ void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 		}
 
 		// see if there are any rigid body dofs here
-		#pragma omp critical (rigidStiffness)
-		m_rigidSolver->RigidStiffness(m_K, m_u, m_F, ke, m_alpha);
+		// Each thread collects these in its own buffer. When nested parallel regions
+		// are active, several threads share a buffer, so it is locked.
+		bool bshared = false;
+		int tid = rigidBufferIndex(bshared);
+		if (bshared)
+		{
+			#pragma omp critical (rigid_buffer)
+			m_rigidSolver->RigidStiffness(m_rigidBuf[tid], ke, m_alpha);
+		}
+		else m_rigidSolver->RigidStiffness(m_rigidBuf[tid], ke, m_alpha);
+	}
+}
+
+// Find the rigid stiffness buffer of the calling thread. The buffers are indexed by the
+// thread number in the outermost active parallel region, since omp_get_thread_num only 
+// returns the number in the innermost region (which is zero if that region is inactive).
+// bshared is set when the buffer can also be used by other threads, i.e. when nested 
+// regions are active, or when the team is larger than the number of buffers.
+int FESolidLinearSystem::rigidBufferIndex(bool& bshared) const
+{
+	bshared = false;
+#ifdef _OPENMP
+	int level = omp_get_level();
+	for (int l = 1; l <= level; ++l)
+	{
+		if (omp_get_team_size(l) > 1)
+		{
+			int tid = omp_get_ancestor_thread_num(l);
+			int nbuf = (int)m_rigidBuf.size();
+			bshared = ((omp_get_active_level() > 1) || (omp_get_team_size(l) > nbuf));
+			return tid % nbuf;
+		}
+	}
+#endif
+	return 0;
+}
+
+bool FESolidLinearSystem::HasPendingRigidStiffness() const
+{
+	for (const FERigidStiffnessBuffer& buf : m_rigidBuf)
+	{
+		if (buf.IsEmpty() == false) return true;
+	}
+	return false;
+}
+
+void FESolidLinearSystem::AssembleRigidStiffness()
+{
+	// reduce the thread buffers in a fixed order
+	FERigidStiffnessBuffer& buf = m_rigidBuf[0];
+	for (size_t i = 1; i < m_rigidBuf.size(); ++i)
+	{
+		if (m_rigidBuf[i].IsEmpty() == false)
+		{
+			buf.Merge(m_rigidBuf[i]);
+			m_rigidBuf[i].Clear();
+		}
+	}
+
+	if (buf.IsEmpty() == false)
+	{
+		m_rigidSolver->AssembleRigidStiffness(m_K, m_u, m_F, buf);
+		buf.Clear();
 	}
 }
@@ -28,15 +28,17 @@ SOFTWARE.*/
 #pragma once
 
 #include <FECore/FELinearSystem.h>
+#include "FERigidSolver.h"
 #include "febiomech_api.h"
 
-class FERigidSolver;
-
 class FEBIOMECH_API FESolidLinearSystem : public FELinearSystem
 {
 public:
 	FESolidLinearSystem(FEModel* fem, FERigidSolver* rigidSolver, FEGlobalMatrix& K, std::vector<double>& F, std::vector<double>& u, bool bsymm, double alpha, int nreq);
 
+	// assembles any rigid body contributions that were not assembled yet
+	~FESolidLinearSystem();
+
 	// Assembly routine
 	// This assembles the element stiffness matrix ke into the global matrix.
 	// The contributions of prescribed degrees of freedom will be stored in m_F
@@ -45,6 +47,18 @@ public:
 	// scale factor for stiffness matrix
 	void StiffnessAssemblyScaleFactor(double a);
 
+	// Assemble the rigid body contributions into the global matrix.
+	// The rigid body contributions of Assemble are collected in per-thread buffers,
+	// so this must be called after all element matrices are assembled.
+	void AssembleRigidStiffness();
+
+	// see if there are rigid body contributions that were not assembled yet
+	bool HasPendingRigidStiffness() const;
+
+private:
+	// get the rigid stiffness buffer of the calling thread
+	int rigidBufferIndex(bool& bshared) const;
+
 private:
 	FEModel* fem;
 	FERigidSolver*	m_rigidSolver;
@@ -52,4 +66,6 @@ private:
 	int				m_nreq;
 
 	double	m_stiffnessScale;
+
+	std::vector<FERigidStiffnessBuffer>	m_rigidBuf;	// per-thread rigid stiffness buffers
 };
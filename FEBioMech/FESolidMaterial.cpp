@@ -52,6 +52,20 @@ double FESolidMaterial::Density(FEMaterialPoint& pt)
 	return m_density(pt);
 }
 
+//-----------------------------------------------------------------------------
+//! The default implementation evaluates the material points one at a time. 
+//! Materials that return true in HasBatchEvaluation should override this.
+void FESolidMaterial::StressBatch(FEMaterialPoint** mp, mat3ds* s, int n)
+{
+	for (int i = 0; i < n; ++i) s[i] = Stress(*mp[i]);
+}
+
+//-----------------------------------------------------------------------------
+void FESolidMaterial::TangentBatch(FEMaterialPoint** mp, tens4ds* c, int n)
+{
+	for (int i = 0; i < n; ++i) c[i] = Tangent(*mp[i]);
+}
+
 tens4dmm FESolidMaterial::SolidTangent(FEMaterialPoint& mp)
 {
 	return (UseSecantTangent() ? SecantTangent(mp) : Tangent(mp));
@@ -47,6 +47,16 @@ public:
 	//! calculate tangent stiffness at material point
 	virtual tens4ds Tangent(FEMaterialPoint& pt) = 0;
 
+	//! Returns true if the material implements an optimized version of
+	//! the batched stress and tangent functions below.
+	virtual bool HasBatchEvaluation() const { return false; }
+
+	//! calculate stress at n material points
+	virtual void StressBatch(FEMaterialPoint** mp, mat3ds* s, int n);
+
+	//! calculate tangent stiffness at n material points
+	virtual void TangentBatch(FEMaterialPoint** mp, tens4ds* c, int n);
+
 	//! calculate the 2nd Piola-Kirchhoff stress at material point
 	virtual mat3ds PK2Stress(FEMaterialPoint& pt, const mat3ds E);
 
@@ -588,6 +588,9 @@ bool FESolidSolver::StiffnessMatrix()
 	// calculate the stiffness contributions for the rigid forces
 	for (int i = 0; i<fem.ModelLoads(); ++i) fem.ModelLoad(i)->StiffnessMatrix(LS);
 
+	// assemble the rigid body contributions of the element matrices
+	LS.AssembleRigidStiffness();
+
 	// we still need to set the diagonal elements to 1
 	// for the prescribed rigid body dofs.
 	m_rigidSolver.StiffnessMatrix(*m_pK, tp);
@@ -58,6 +58,7 @@ SOFTWARE.*/
 #include "FELinearTrussDomain.h"
 #include "FEMechModel.h"
 #include "FERigidBody.h"
+#include <FECore/FEProfiler.h>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -297,6 +298,7 @@ bool FESolidSolver2::InitAccelerations()
 			if (edom) edom->MassMatrix(LS, 1.0);
 		}
 		m_rigidSolver.RigidMassMatrix(LS, tp);
+		LS.AssembleRigidStiffness();
 
 		// Don't forget to factor the matrix first!
 		if (m_plinsolve == nullptr) return false;
@@ -637,7 +639,11 @@ void FESolidSolver2::UpdateKinematics(vector<double>& ui)
 	for (int i = 0; i < fem.SurfacePairConstraints(); ++i)
 	{
 		FESurfacePairConstraint* spc = fem.SurfacePairConstraint(i);
-		if (spc->IsActive()) spc->Update(ui);
+		if (spc->IsActive())
+		{
+			FE_PROFILE_COMPONENT(spc, "Update");
+			spc->Update(ui);
+		}
 	}
 }
 
@@ -1331,6 +1337,7 @@ bool FESolidSolver2::StiffnessMatrix()
 	{
 		if (mesh.Domain(i).IsActive()) 
 		{
+			FE_PROFILE_COMPONENT(&mesh.Domain(i), "StiffnessMatrix");
 			FEElasticDomain& dom = dynamic_cast<FEElasticDomain&>(mesh.Domain(i));
 			dom.StiffnessMatrix(LS);
 		}
@@ -1386,6 +1393,9 @@ bool FESolidSolver2::StiffnessMatrix()
 	// constrainst enforced with augmented lagrangian
 	NonLinearConstraintStiffness(LS, tp);
 
+	// assemble the rigid body contributions of the element matrices
+	LS.AssembleRigidStiffness();
+
 	// add contributions from rigid bodies
 	m_rigidSolver.StiffnessMatrix(*m_pK, tp);
 
@@ -1401,7 +1411,11 @@ void FESolidSolver2::NonLinearConstraintStiffness(FELinearSystem& LS, const FETi
 	for (int i=0; i<N; ++i) 
 	{
 		FENLConstraint* plc = fem.NonlinearConstraint(i);
-		if (plc->IsActive()) plc->StiffnessMatrix(LS, tp);
+		if (plc->IsActive())
+		{
+			FE_PROFILE_COMPONENT(plc, "StiffnessMatrix");
+			plc->StiffnessMatrix(LS, tp);
+		}
 	}
 }
 
@@ -1415,7 +1429,11 @@ void FESolidSolver2::ContactStiffness(FELinearSystem& LS)
 	for (int i = 0; i<fem.SurfacePairConstraints(); ++i)
 	{
 		FEContactInterface* pci = dynamic_cast<FEContactInterface*>(fem.SurfacePairConstraint(i));
-		if (pci->IsActive()) pci->StiffnessMatrix(LS, tp);
+		if (pci->IsActive())
+		{
+			FE_PROFILE_COMPONENT(pci, "StiffnessMatrix");
+			pci->StiffnessMatrix(LS, tp);
+		}
 	}
 }
 
@@ -1428,7 +1446,11 @@ void FESolidSolver2::ContactForces(FEGlobalVector& R)
 	for (int i = 0; i<fem.SurfacePairConstraints(); ++i)
 	{
 		FEContactInterface* pci = dynamic_cast<FEContactInterface*>(fem.SurfacePairConstraint(i));
-		if (pci->IsActive()) pci->LoadVector(R, tp);
+		if (pci->IsActive())
+		{
+			FE_PROFILE_COMPONENT(pci, "LoadVector");
+			pci->LoadVector(R, tp);
+		}
 	}
 }
 
@@ -1527,7 +1549,11 @@ void FESolidSolver2::InternalForces(FEGlobalVector& R)
 	for (int i = 0; i<mesh.Domains(); ++i)
 	{
 		FEElasticDomain* edom = dynamic_cast<FEElasticDomain*>(&mesh.Domain(i));
-		if (edom) edom->InternalForces(R);
+		if (edom)
+		{
+			FE_PROFILE_COMPONENT(&mesh.Domain(i), "InternalForces");
+			edom->InternalForces(R);
+		}
 	}
 }
 
@@ -1618,6 +1644,10 @@ void FESolidSolver2::NonLinearConstraintForces(FEGlobalVector& R, const FETimeIn
 	for (int i=0; i<N; ++i) 
 	{
 		FENLConstraint* plc = fem.NonlinearConstraint(i);
-		if (plc->IsActive()) plc->LoadVector(R, tp);
+		if (plc->IsActive())
+		{
+			FE_PROFILE_COMPONENT(plc, "LoadVector");
+			plc->LoadVector(R, tp);
+		}
 	}
 }
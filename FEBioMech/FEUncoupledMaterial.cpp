@@ -120,6 +120,47 @@ tens4ds FEUncoupledMaterial::Tangent(FEMaterialPoint &mp)
 	return DevTangent(mp) + (IxI - I4*2)*pt.m_p + IxI*(UJJ(pt.m_J)*pt.m_J);
 }
 
+//-----------------------------------------------------------------------------
+void FEUncoupledMaterial::StressBatch(FEMaterialPoint** mp, mat3ds* s, int n)
+{
+	DevStressBatch(mp, s, n);
+	for (int i = 0; i < n; ++i)
+	{
+		FEElasticMaterialPoint& pt = *mp[i]->ExtractData<FEElasticMaterialPoint>();
+		pt.m_p = UJ(pt.m_J);
+		s[i] += mat3dd(pt.m_p);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEUncoupledMaterial::TangentBatch(FEMaterialPoint** mp, tens4ds* c, int n)
+{
+	mat3dd I(1);
+	tens4ds IxI = dyad1s(I);
+	tens4ds I4  = dyad4s(I);
+
+	DevTangentBatch(mp, c, n);
+	for (int i = 0; i < n; ++i)
+	{
+		FEElasticMaterialPoint& pt = *mp[i]->ExtractData<FEElasticMaterialPoint>();
+		pt.m_p = UJ(pt.m_J);
+		c[i] += (IxI - I4*2)*pt.m_p + IxI*(UJJ(pt.m_J)*pt.m_J);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! The default implementation evaluates the material points one at a time.
+void FEUncoupledMaterial::DevStressBatch(FEMaterialPoint** mp, mat3ds* s, int n)
+{
+	for (int i = 0; i < n; ++i) s[i] = DevStress(*mp[i]);
+}
+
+//-----------------------------------------------------------------------------
+void FEUncoupledMaterial::DevTangentBatch(FEMaterialPoint** mp, tens4ds* c, int n)
+{
+	for (int i = 0; i < n; ++i) c[i] = DevTangent(*mp[i]);
+}
+
 //-----------------------------------------------------------------------------
 //! The strain energy density function calculates the total sed as a sum of
 //! two terms, namely the deviatoric sed and U(J).
@@ -72,6 +72,12 @@ public:
 
 	//! Deviatoric strain energy density
 	virtual double DevStrainEnergyDensity(FEMaterialPoint& mp) { return 0; }
+
+	//! Deviatoric Cauchy stress at n material points
+	virtual void DevStressBatch(FEMaterialPoint** mp, mat3ds* s, int n);
+
+	//! Deviatoric spatial tangent at n material points
+	virtual void DevTangentBatch(FEMaterialPoint** mp, tens4ds* c, int n);
     
 public:
     virtual double StrongBondDevSED(FEMaterialPoint& pt) { return DevStrainEnergyDensity(pt); }
@@ -126,6 +132,12 @@ public:
 	//! total spatial tangent (do not overload!)
 	tens4ds Tangent(FEMaterialPoint& mp) final;
 
+	//! total Cauchy stress at n material points (do not overload!)
+	void StressBatch(FEMaterialPoint** mp, mat3ds* s, int n) final;
+
+	//! total spatial tangent at n material points (do not overload!)
+	void TangentBatch(FEMaterialPoint** mp, tens4ds* c, int n) final;
+
 	//! calculate strain energy (do not overload!)
 	double StrainEnergyDensity(FEMaterialPoint& pt) final;
     double StrongBondSED(FEMaterialPoint& pt) final;
@@ -538,6 +538,9 @@ bool FEBiphasicSoluteSolver::StiffnessMatrix()
 	// constrainst enforced with augmented lagrangian
 	NonLinearConstraintStiffness(LS, tp);
 
+	// assemble the rigid body contributions of the element matrices
+	LS.AssembleRigidStiffness();
+
 	// add contributions from rigid bodies
 	m_rigidSolver.StiffnessMatrix(*m_pK, tp);
 
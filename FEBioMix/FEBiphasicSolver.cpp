@@ -658,6 +658,9 @@ bool FEBiphasicSolver::StiffnessMatrix()
 	// constrainst enforced with augmented lagrangian
 	NonLinearConstraintStiffness(LS, tp);
 
+	// assemble the rigid body contributions of the element matrices
+	LS.AssembleRigidStiffness();
+
 	// add contributions from rigid bodies
 	m_rigidSolver.StiffnessMatrix(*m_pK, tp);
 
@@ -810,6 +810,9 @@ bool FEMultiphasicSolver::StiffnessMatrix()
 	// constrainst enforced with augmented lagrangian
 	NonLinearConstraintStiffness(LS, tp);
 
+	// assemble the rigid body contributions of the element matrices
+	LS.AssembleRigidStiffness();
+
 	// add contributions from rigid bodies
 	m_rigidSolver.StiffnessMatrix(*m_pK, tp);
 
@@ -55,6 +55,7 @@ BEGIN_FECORE_CLASS(FESlidingInterfaceBiphasic, FEContactInterface)
 	ADD_PARAMETER(m_naugmin  , "minaug"             );
 	ADD_PARAMETER(m_naugmax  , "maxaug"             );
 	ADD_PARAMETER(m_breloc   , "node_reloc"         );
+	ADD_PARAMETER(m_bincremental, "incremental_search");
 	ADD_PARAMETER(m_mu       , "fric_coeff"         );
 	ADD_PARAMETER(m_phi      , "contact_frac"       );
 	ADD_PARAMETER(m_bsmaug   , "smooth_aug"         );
@@ -501,6 +502,7 @@ FESlidingInterfaceBiphasic::FESlidingInterfaceBiphasic(FEModel* pfem) : FEContac
     m_nsegup = 0;
     m_bautopen = false;
     m_breloc = false;
+    m_bincremental = false;
     m_bsmaug = false;
     m_bsmfls = false;
     m_bupdtpen = false;
@@ -515,6 +517,8 @@ FESlidingInterfaceBiphasic::FESlidingInterfaceBiphasic(FEModel* pfem) : FEContac
     m_bshellbm = m_bshellbs = false;
 
     m_dofP = pfem->GetDOFIndex("p");
+
+    m_npm = m_nps = nullptr;
     
     // set parents
     m_ss.SetContactInterface(this);
@@ -528,11 +532,22 @@ FESlidingInterfaceBiphasic::FESlidingInterfaceBiphasic(FEModel* pfem) : FEContac
 
 FESlidingInterfaceBiphasic::~FESlidingInterfaceBiphasic()
 {
+	ClearProjections();
+}
+
+//-----------------------------------------------------------------------------
+void FESlidingInterfaceBiphasic::ClearProjections()
+{
+	delete m_npm; m_npm = nullptr;
+	delete m_nps; m_nps = nullptr;
 }
 
 //-----------------------------------------------------------------------------
 bool FESlidingInterfaceBiphasic::Init()
 {
+	// the search structures are rebuilt on the next projection
+	ClearProjections();
+
     // initialize surface data
     if (m_ss.Init() == false) return false;
     if (m_ms.Init() == false) return false;
@@ -752,10 +767,19 @@ void FESlidingInterfaceBiphasic::ProjectSurface(FESlidingSurfaceBiphasic& ss, FE
     FEMesh& mesh = GetFEModel()->GetMesh();
 
     // initialize projection data
-    FENormalProjection np(ms);
-    np.SetTolerance(m_stol);
-    np.SetSearchRadius(m_srad);
-    np.Init();
+    // The projection is kept between calls, so that the element neighbor list of the
+    // incremental search is only built once. The octree is rebuilt on each call.
+    FENormalProjection*& pnp = (&ms == &m_ms ? m_npm : m_nps);
+    if (pnp == nullptr)
+    {
+        pnp = new FENormalProjection(ms);
+        pnp->SetTolerance(m_stol);
+        pnp->SetSearchRadius(m_srad);
+        pnp->SetIncrementalSearch(m_bincremental);
+        pnp->Init();
+    }
+    else pnp->Update();
+    FENormalProjection& np = *pnp;
     double psf = GetPenaltyScaleFactor();
     
     // if we need to project the nodes onto the secondary surface,
@@ -782,6 +806,9 @@ void FESlidingInterfaceBiphasic::ProjectSurface(FESlidingSurfaceBiphasic& ss, FE
         for (int i=0; i<NN; ++i) normal[i].unit();
         
         // loop over all nodes
+        // (with self-contact a thread may move nodes that others project onto, so then this is done serially)
+        bool bparallel = (ss.SharesNodes(ms) == false);
+#pragma omp parallel for schedule(dynamic) if(bparallel)
         for (int i=0; i<NN; ++i)
         {
             FENode& node = ss.Node(i);
@@ -811,7 +838,7 @@ void FESlidingInterfaceBiphasic::ProjectSurface(FESlidingSurfaceBiphasic& ss, FE
     }
     
     // loop over all integration points
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
     for (int i=0; i<ss.Elements(); ++i)
     {
         FESurfaceElement& el = ss.Element(i);
@@ -861,7 +888,7 @@ void FESlidingInterfaceBiphasic::ProjectSurface(FESlidingSurfaceBiphasic& ss, FE
             }
             
             // find the intersection point with the secondary surface
-            if (pme == 0 && bupseg) pme = np.Project(r, nu, rs);
+            if (pme == 0 && bupseg) pme = np.Project(r, nu, rs, pt.m_pme);
             
             pt.m_pme = pme;
             pt.m_nu = nu;
@@ -2540,6 +2567,7 @@ void FESlidingInterfaceBiphasic::Serialize(DumpStream &ar)
 {
     // serialize contact data
     FEContactInterface::Serialize(ar);
+	if (ar.IsLoading()) ClearProjections();
     
     // serialize contact surface data
     m_ms.Serialize(ar);
@@ -90,6 +90,9 @@ public:
     vec3d    m_Ft;     //!< total contact force (from equivalent nodal forces)
 };
 
+//-----------------------------------------------------------------------------
+class FENormalProjection;
+
 //-----------------------------------------------------------------------------
 class FEBIOMIX_API FESlidingInterfaceBiphasic :	public FEContactInterface
 {
@@ -157,6 +160,9 @@ protected:
     
     void CalcAutoPressurePenalty(FESlidingSurfaceBiphasic& s);
     double AutoPressurePenalty(FESurfaceElement& el, FESlidingSurfaceBiphasic& s);
+
+	//! clear the projection search structures
+	void ClearProjections();
     
 public:
 	FESlidingSurfaceBiphasic	m_ss;	//!< primary surface
@@ -170,6 +176,7 @@ public:
     double			m_stol;			//!< search tolerance
     bool			m_bsymm;		//!< use symmetric stiffness components only
     double			m_srad;			//!< contact search radius
+    bool			m_bincremental;	//!< search neighbors of previous secondary element first
     int				m_naugmax;		//!< maximum nr of augmentations
     int				m_naugmin;		//!< minimum nr of augmentations
     int				m_nsegup;		//!< segment update parameter
@@ -194,6 +201,10 @@ public:
     
 protected:
     int	m_dofP;
+
+private:
+	FENormalProjection*	m_npm;	//!< projection onto the secondary surface
+	FENormalProjection*	m_nps;	//!< projection onto the primary surface (two-pass)
     
     DECLARE_FECORE_CLASS();
 };
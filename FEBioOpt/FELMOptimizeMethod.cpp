@@ -39,6 +39,7 @@ BEGIN_FECORE_CLASS(FELMOptimizeMethod, FEOptimizeMethod)
 	ADD_PARAMETER(m_fdiff , "f_diff_scale");
 	ADD_PARAMETER(m_nmax  , "max_iter"    );
 	ADD_PARAMETER(m_bcov  , "print_cov"   );
+	ADD_PARAMETER(m_nwidth, "parallel_width");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -196,30 +197,33 @@ void FELMOptimizeMethod::ObjFun(vector<double>& x, vector<double>& a, vector<dou
 		}
 	}
 	
-	// evaluate at a
-	if (opt.FESolve(a) == false) throw FEErrorTermination();
-	
-	opt.GetObjective().Evaluate(y);
-	m_yopt = y;
-
-	// now calculate the derivatives using forward differences
-	int ndata = (int)x.size();
-	vector<double> a1(a);
-	vector<double> y1(ndata);
+	// We evaluate the model at a, and at a with each parameter perturbed 
+	// in turn for calculating the derivatives using forward differences.
+	// These solves are independent, so they can run at the same time. 
 	int ma = (int)a.size();
+	vector< vector<double> > as(ma + 1, a);
 	for (int i=0; i<ma; ++i)
 	{
 		FEInputParameter& var = *opt.GetInputParameter(i);
 
 		double b = var.ScaleFactor();
 
-		a1[i] = a1[i] + dir*m_fdiff*(fabs(b) + fabs(a[i]));
-		assert(a1[i] != a[i]);
+		as[i + 1][i] = a[i] + dir*m_fdiff*(fabs(b) + fabs(a[i]));
+		assert(as[i + 1][i] != a[i]);
+	}
+
+	vector< vector<double> > ys;
+	vector<double> obj;
+	if (opt.FESolve(as, ys, obj, m_nwidth) == false) throw FEErrorTermination();
 
-		if (opt.FESolve(a1) == false) throw FEErrorTermination();
-		opt.GetObjective().Evaluate(y1);
-		for (int j=0; j<ndata; ++j) dyda[j][i] = (y1[j] - y[j])/(a1[i] - a[i]);
-		a1[i] = a[i];
+	y = ys[0];
+	m_yopt = y;
+
+	int ndata = (int)x.size();
+	for (int i=0; i<ma; ++i)
+	{
+		vector<double>& y1 = ys[i + 1];
+		for (int j=0; j<ndata; ++j) dyda[j][i] = (y1[j] - y[j])/(as[i + 1][i] - a[i]);
 	}
 }
 
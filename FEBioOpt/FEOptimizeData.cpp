@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FEOptimizeData.h"
 #include "FELMOptimizeMethod.h"
 #include "FEOptimizeInput.h"
+#include "FEParallelSolve.h"
 #include <FECore/FECoreKernel.h>
 #include <FECore/FEModel.h>
 #include <FECore/FEAnalysis.h>
@@ -254,3 +255,84 @@ bool FEOptimizeData::FESolve(const vector<double>& a)
 
 	return bret;
 }
+
+//-----------------------------------------------------------------------------
+//! solve the FE problem for several sets of parameters
+bool FEOptimizeData::FESolve(const vector< vector<double> >& a, vector< vector<double> >& y, vector<double>& obj, int nwidth)
+{
+	int nsets = (int)a.size();
+	y.resize(nsets);
+	obj.assign(nsets, 0.0);
+
+	// run the solves one after another if we can't run them concurrently
+	if ((nwidth <= 1) || (nsets <= 1) || (FEParallelSolve::IsSupported() == false))
+	{
+		for (int i = 0; i < nsets; ++i)
+		{
+			if (FESolve(a[i]) == false) return false;
+			obj[i] = GetObjective().Evaluate(y[i]);
+		}
+		return true;
+	}
+
+	// report the values of all the solves
+	int nvar = InputParameters();
+	int niter0 = m_niter;
+	for (int i = 0; i < nsets; ++i)
+	{
+		if (nvar != (int)a[i].size()) return false;
+
+		feLog("\n----- Iteration: %d -----\n", niter0 + i + 1);
+		for (int j = 0; j < nvar; ++j)
+		{
+			FEInputParameter& var = *GetInputParameter(j);
+			string name = var.GetName();
+			feLog("%-15s = %lg\n", name.c_str(), a[i][j]);
+		}
+	}
+	m_niter += nsets;
+
+	// Each job solves the model and returns the function values, followed by the objective value.
+	// Note that all but the first job run in a worker process, so they only modify their own copy of the model.
+	FEModel& fem = *GetFEModel();
+	FEParallelSolve::JobFunction job = [&](int i, vector<double>& r) {
+		fem.BlockLog();
+
+		GetObjective().Reset();
+		for (int j = 0; j < nvar; ++j) GetInputParameter(j)->SetValue(a[i][j]);
+		fem.Reset();
+		bool bret = RunTask();
+		if (bret)
+		{
+			double fobj = GetObjective().Evaluate(r);
+			r.push_back(fobj);
+		}
+
+		fem.UnBlockLog();
+		return bret;
+	};
+
+	// the workers write their output to their own files, named after the iteration
+	FEParallelSolve::WorkerFunction worker = [&](int i) {
+		char sz[32] = { 0 };
+		snprintf(sz, sizeof(sz), "_%d", niter0 + i + 1);
+		return fem.RedirectOutput(sz);
+	};
+
+	vector< vector<double> > r;
+	vector<bool> ok;
+	bool bret = FEParallelSolve::Run(nsets, nwidth, job, worker, r, ok);
+
+	for (int i = 0; i < nsets; ++i)
+	{
+		if (ok[i])
+		{
+			y[i].assign(r[i].begin(), r[i].end() - 1);
+			obj[i] = r[i].back();
+			feLog("iteration %d: objective value: %lg\n", niter0 + i + 1, obj[i]);
+		}
+		else feLogError("Iteration %d failed.", niter0 + i + 1);
+	}
+
+	return bret;
+}
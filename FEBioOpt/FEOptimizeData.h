@@ -141,6 +141,10 @@ public:
 	//! solve the FE problem with a new set of parameters
 	bool FESolve(const std::vector<double>& a);
 
+	//! Solve the FE problem for several sets of parameters and evaluate the objective 
+	//! function for each. Up to nwidth solves are run concurrently in worker processes.
+	bool FESolve(const std::vector< std::vector<double> >& a, std::vector< std::vector<double> >& y, std::vector<double>& obj, int nwidth);
+
 public:
 	// return the number of input parameters
 	int InputParameters() { return (int)m_Var.size(); }
@@ -30,4 +30,5 @@ FEOptimizeMethod::FEOptimizeMethod(FEModel* fem) : FECoreClass(fem)
 { 
 	m_loglevel = LogLevel::LOG_NEVER;
 	m_print_level = PRINT_ITERATIONS;
+	m_nwidth = 1;
 }
@@ -66,4 +66,5 @@ public:
 public:
 	int		m_loglevel;		//!< log file output level
 	int		m_print_level;	//!< level of detailed output
+	int		m_nwidth;		//!< max nr of forward solves that run concurrently
 };
@@ -0,0 +1,233 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEParallelSolve.h"
+#include <stdio.h>
+#include <list>
+#ifndef WIN32
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef PARDISO
+#include <mkl_service.h>
+#endif
+
+#ifndef WIN32
+//-----------------------------------------------------------------------------
+// helper functions for writing and reading the entire buffer through a pipe
+static bool write_all(int fd, const void* pd, size_t nsize)
+{
+	const char* pc = (const char*)pd;
+	while (nsize > 0)
+	{
+		ssize_t n = write(fd, pc, nsize);
+		if (n <= 0) return false;
+		pc += n;
+		nsize -= (size_t)n;
+	}
+	return true;
+}
+
+static bool read_all(int fd, void* pd, size_t nsize)
+{
+	char* pc = (char*)pd;
+	while (nsize > 0)
+	{
+		ssize_t n = read(fd, pc, nsize);
+		if (n <= 0) return false;
+		pc += n;
+		nsize -= (size_t)n;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// a running worker process
+struct FEWorker
+{
+	int		job;	// the job that is run by this worker
+	pid_t	pid;	// the process ID
+	int		fd;		// the read end of the pipe
+};
+
+//-----------------------------------------------------------------------------
+// Starts a worker process for job i. Returns false if the process could not be
+// created, in which case the job should be run in the calling process. 
+static bool start_worker(int i, FEParallelSolve::JobFunction& f, FEParallelSolve::WorkerFunction& w, FEWorker& worker)
+{
+	int fd[2];
+	if (pipe(fd) != 0) return false;
+
+	// flush the output buffers so that they are not written twice
+	fflush(nullptr);
+
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		close(fd[0]);
+		close(fd[1]);
+		return false;
+	}
+
+	if (pid == 0)
+	{
+		// This is the worker process. 
+		close(fd[0]);
+
+		// The workers already keep the cores busy. Running OpenMP regions with
+		// more than one thread is also not safe in a process that was forked
+		// from a process that used OpenMP. 
+#ifdef _OPENMP
+		omp_set_num_threads(1);
+#endif
+#ifdef PARDISO
+		mkl_set_num_threads(1);
+#endif
+
+		std::vector<double> r;
+		int status = 0;
+		try {
+			if ((w == nullptr) || w(i)) status = (f(i, r) ? 1 : 0);
+		}
+		catch (...)
+		{
+			status = 0;
+		}
+
+		// send the results
+		int n = (int)r.size();
+		bool b = write_all(fd[1], &status, sizeof(int)) && write_all(fd[1], &n, sizeof(int));
+		if (b && (n > 0)) write_all(fd[1], &r[0], n * sizeof(double));
+		close(fd[1]);
+
+		// don't run any destructors or exit handlers of the copied process
+		_exit(0);
+	}
+
+	close(fd[1]);
+	worker.job = i;
+	worker.pid = pid;
+	worker.fd = fd[0];
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Reads the results of a worker and waits for it to finish
+static bool finish_worker(FEWorker& worker, std::vector<double>& r)
+{
+	int status = 0, n = 0;
+	bool b = read_all(worker.fd, &status, sizeof(int)) && read_all(worker.fd, &n, sizeof(int)) && (n >= 0);
+	if (b)
+	{
+		r.resize(n);
+		if (n > 0) b = read_all(worker.fd, &r[0], n * sizeof(double));
+	}
+	close(worker.fd);
+
+	int wstatus = 0;
+	waitpid(worker.pid, &wstatus, 0);
+
+	return (b && (status == 1));
+}
+#endif
+
+//-----------------------------------------------------------------------------
+bool FEParallelSolve::IsSupported()
+{
+#ifdef WIN32
+	return false;
+#else
+	return true;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+bool FEParallelSolve::Run(int njobs, int nwidth, JobFunction f, WorkerFunction w, std::vector< std::vector<double> >& r, std::vector<bool>& ok)
+{
+	r.assign(njobs, std::vector<double>());
+	ok.assign(njobs, false);
+	if (njobs <= 0) return true;
+
+	// run the first job in this process, concurrently with the workers
+	auto runLocal = [&](int i) {
+		try {
+			ok[i] = f(i, r[i]);
+		}
+		catch (...)
+		{
+			ok[i] = false;
+		}
+	};
+
+#ifdef WIN32
+	// no worker processes, so run all the jobs in sequence
+	for (int i = 0; i < njobs; ++i) runLocal(i);
+#else
+	if (nwidth < 1) nwidth = 1;
+
+	// the calling process counts as one of the workers
+	std::list<FEWorker> active;
+	int next = 1;
+	auto startJobs = [&]() {
+		while ((next < njobs) && ((int)active.size() < nwidth - 1))
+		{
+			FEWorker worker;
+			if (start_worker(next, f, w, worker)) active.push_back(worker);
+			else runLocal(next);
+			next++;
+		}
+	};
+
+	startJobs();
+	runLocal(0);
+
+	// collect the workers in the order they were started and replace them by new ones
+	while (active.empty() == false)
+	{
+		FEWorker worker = active.front();
+		active.pop_front();
+		ok[worker.job] = finish_worker(worker, r[worker.job]);
+		startJobs();
+	}
+
+	// If we can only run one job at a time, the remaining jobs were not started.
+	while (next < njobs) runLocal(next++);
+#endif
+
+	for (int i = 0; i < njobs; ++i)
+	{
+		if (ok[i] == false) return false;
+	}
+	return true;
+}
@@ -0,0 +1,69 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <vector>
+#include <functional>
+
+//-----------------------------------------------------------------------------
+//! This class runs independent forward solves of the same model concurrently.
+//! Each job runs in a worker process that is forked from the calling process, 
+//! so that it starts from a private copy of the fully initialized model. The 
+//! workers send their results back to the calling process through a pipe. 
+//! Worker processes are only available on POSIX systems. 
+//!
+//! A worker inherits the open files of the calling process. The worker function,
+//! which runs in the worker before the job, must make sure that the job writes
+//! its output to its own files (see FEModel::RedirectOutput).
+//!
+//! The calling process has usually run OpenMP regions before the workers are forked.
+//! Not all OpenMP runtimes support new threads in a forked process (e.g. GNU libgomp
+//! does not), so the workers run with a single OpenMP (and MKL) thread. Code that
+//! runs in a worker must not request more threads explicitly.
+class FEParallelSolve
+{
+public:
+	//! The function that is executed for job i. The results of the job are
+	//! returned in r and the function should return false if the job failed.
+	typedef std::function<bool(int i, std::vector<double>& r)> JobFunction;
+
+	//! The function that is executed in the worker process of job i, before the job 
+	//! itself. It should return false if the job cannot be run in the worker.
+	typedef std::function<bool(int i)> WorkerFunction;
+
+public:
+	//! returns true if worker processes are supported on this platform
+	static bool IsSupported();
+
+	//! Runs the jobs 0 to njobs-1 with at most nwidth jobs running at the same time.
+	//! The first job is run in the calling process, while the other jobs are run in 
+	//! worker processes, where w (if not null) is called before the job. The results 
+	//! of job i are returned in r[i] and ok[i] is set to false if that job failed. 
+	//! The function returns false if any job failed.
+	static bool Run(int njobs, int nwidth, JobFunction f, WorkerFunction w, std::vector< std::vector<double> >& r, std::vector<bool>& ok);
+};
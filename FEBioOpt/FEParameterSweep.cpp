@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 #include "stdafx.h"
 #include "FEParameterSweep.h"
+#include "FEParallelSolve.h"
 #include <XML/XMLReader.h>
 #include <FECore/FEModel.h>
 #include <FECore/FEAnalysis.h>
@@ -62,6 +63,7 @@ void FESweepParam::SetValue(double v)
 FEParameterSweep::FEParameterSweep(FEModel* fem) : FECoreTask(fem)
 {
 	m_niter = 0;
+	m_nwidth = 1;
 }
 
 //! initialization
@@ -80,6 +82,12 @@ bool FEParameterSweep::Init(const char* szfile)
 	GetFEModel()->GetCurrentStep()->SetPlotHint(FE_PLOT_APPEND);
 	GetFEModel()->GetCurrentStep()->SetPlotLevel(FE_PLOT_FINAL);
 
+	// The concurrent solves cannot all append to the same plot file
+	if ((m_nwidth > 1) && FEParallelSolve::IsSupported())
+	{
+		feLogWarning("The solves run concurrently. Solves that run in worker processes write their\nplot output to separate files, whose names end with the iteration number.");
+	}
+
 	return true;
 }
 
@@ -163,6 +171,11 @@ bool FEParameterSweep::Input(const char* szfile)
 			// looks good, so throw it on the pile
 			m_params.push_back(p);
 		}
+		else if (tag == "parallel_width")
+		{
+			tag.value(m_nwidth);
+			if (m_nwidth < 1) throw XMLReader::InvalidValue(tag);
+		}
 		else throw XMLReader::InvalidTag(tag);
 		++tag;
 	} while (!tag.isend());
@@ -185,21 +198,29 @@ bool FEParameterSweep::Run()
 	}
 
 	// run the parameter sweep
+	// The points are solved in batches, so that the solves in a batch can run at the same time.
 	bool bdone = false;
 	do
 	{
-		// solve the problem with the new input parameters
-		if (FESolve(a) == false) return false;
-
-		// update indices
-		for (size_t i = 0; i<ma; ++i)
+		// collect the next batch of points
+		vector< vector<double> > as;
+		while ((bdone == false) && ((int)as.size() < m_nwidth))
 		{
-			FESweepParam& pi = m_params[i];
-			a[i] += pi.m_step;
-			if (a[i] <= pi.m_max) break;
-			else if (i<ma - 1) a[i] = pi.m_min;
-			else { bdone = true; }
+			as.push_back(a);
+
+			// update indices
+			for (size_t i = 0; i<ma; ++i)
+			{
+				FESweepParam& pi = m_params[i];
+				a[i] += pi.m_step;
+				if (a[i] <= pi.m_max) break;
+				else if (i<ma - 1) a[i] = pi.m_min;
+				else { bdone = true; }
+			}
 		}
+
+		// solve the problem with the new input parameters
+		if (FESolve(as) == false) return false;
 	}
 	while (!bdone);
 
@@ -237,3 +258,58 @@ bool FEParameterSweep::FESolve(const vector<double>& a)
 
 	return bret;
 }
+
+bool FEParameterSweep::FESolve(const vector< vector<double> >& a)
+{
+	int nsets = (int)a.size();
+	if ((m_nwidth <= 1) || (nsets <= 1) || (FEParallelSolve::IsSupported() == false))
+	{
+		for (int i = 0; i < nsets; ++i)
+		{
+			if (FESolve(a[i]) == false) return false;
+		}
+		return true;
+	}
+
+	// report the values of all the solves
+	size_t nvar = m_params.size();
+	for (int i = 0; i < nsets; ++i)
+	{
+		feLog("\n----- Iteration: %d -----\n", m_niter + i + 1);
+		for (size_t j = 0; j < nvar; ++j)
+		{
+			string name = m_params[j].m_paramName;
+			feLog("%-15s = %lg\n", name.c_str(), a[i][j]);
+		}
+	}
+	int niter0 = m_niter;
+	m_niter += nsets;
+
+	// all but the first solve run in worker processes, on their own copy of the model
+	FEModel& fem = *GetFEModel();
+	FEParallelSolve::JobFunction job = [&](int i, vector<double>& r) {
+		fem.BlockLog();
+		for (size_t j = 0; j < nvar; ++j) m_params[j].SetValue(a[i][j]);
+		fem.Reset();
+		bool bret = fem.Solve();
+		fem.UnBlockLog();
+		return bret;
+	};
+
+	// the workers write their output to their own files, named after the iteration
+	FEParallelSolve::WorkerFunction worker = [&](int i) {
+		char sz[32] = { 0 };
+		snprintf(sz, sizeof(sz), "_%d", niter0 + i + 1);
+		return fem.RedirectOutput(sz);
+	};
+
+	vector< vector<double> > r;
+	vector<bool> ok;
+	bool bret = FEParallelSolve::Run(nsets, m_nwidth, job, worker, r, ok);
+	for (int i = 0; i < nsets; ++i)
+	{
+		if (ok[i] == false) feLogError("Iteration %d failed.", niter0 + i + 1);
+	}
+
+	return bret;
+}
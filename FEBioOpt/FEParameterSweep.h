@@ -60,8 +60,10 @@ private:
 	bool Input(const char* szfile);
 	bool InitParams();
 	bool FESolve(const vector<double>& a);
+	bool FESolve(const vector< vector<double> >& a);
 
 private:
 	vector<FESweepParam>	m_params;
 	int						m_niter;
+	int						m_nwidth;	// max nr of solves that run concurrently
 };
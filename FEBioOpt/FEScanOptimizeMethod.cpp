@@ -32,7 +32,7 @@ SOFTWARE.*/
 #include "FECore/log.h"
 
 BEGIN_FECORE_CLASS(FEScanOptimizeMethod, FEOptimizeMethod)
-
+	ADD_PARAMETER(m_nwidth, "parallel_width");
 END_FECORE_CLASS();
 
 FEScanOptimizeMethod::FEScanOptimizeMethod(FEModel* fem) : FEOptimizeMethod(fem)
@@ -44,7 +44,6 @@ bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vec
 {
 	if (pOpt == 0) return false;
 	FEOptimizeData& opt = *pOpt;
-	FEObjectiveFunction& obj = opt.GetObjective();
 
 	// set the intial values for the variables
 	int ma = opt.InputParameters();
@@ -56,33 +55,44 @@ bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vec
 	}
 
 	// loop until done
-	vector<double> y(ma, 0.0);
+	// The points are solved in batches, so that the solves in a batch can run at the same time.
+	int nbatch = (m_nwidth > 1 ? m_nwidth : 1);
 	bool bdone = false;
 	double fmin = 0.0;
 	do
 	{
-		// solve the problem with the new input parameters
-		if (opt.FESolve(a) == false) return false;
-
-		// calculate objective function
-		double fobj = obj.Evaluate(y);
-
-		// update minimum
-		if ((fmin == 0.0) || (fobj < fmin))
+		// collect the next batch of points
+		vector< vector<double> > as;
+		while ((bdone == false) && ((int)as.size() < nbatch))
 		{
-			fmin = fobj;
-			amin = a;
-			ymin = y;
+			as.push_back(a);
+
+			// update indices
+			for (int i=0; i<ma; ++i)
+			{
+				FEInputParameter& vi = *opt.GetInputParameter(i);
+				a[i] += vi.ScaleFactor();
+				if (a[i] <= vi.MaxValue()) break;
+				else if (i<ma-1) a[i] = vi.MinValue();
+				else { bdone = true; }
+			}
 		}
 
-		// update indices
-		for (int i=0; i<ma; ++i)
+		// solve the problem with the new input parameters
+		// and calculate the objective function
+		vector< vector<double> > ys;
+		vector<double> fobj;
+		if (opt.FESolve(as, ys, fobj, m_nwidth) == false) return false;
+
+		// update minimum
+		for (int k=0; k<(int)as.size(); ++k)
 		{
-			FEInputParameter& vi = *opt.GetInputParameter(i);
-			a[i] += vi.ScaleFactor();
-			if (a[i] <= vi.MaxValue()) break;
-			else if (i<ma-1) a[i] = vi.MinValue();
-			else { bdone = true; }
+			if ((fmin == 0.0) || (fobj[k] < fmin))
+			{
+				fmin = fobj[k];
+				amin = as[k];
+				ymin = ys[k];
+			}
 		}
 	}
 	while (!bdone);
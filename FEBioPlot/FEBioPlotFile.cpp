@@ -37,6 +37,7 @@ SOFTWARE.*/
 #include <FECore/log.h>
 #include <FECore/FEPIDController.h>
 #include <sstream>
+#include <algorithm>
 
 FEBioPlotFile::DICTIONARY_ITEM::DICTIONARY_ITEM()
 {
@@ -46,6 +47,7 @@ FEBioPlotFile::DICTIONARY_ITEM::DICTIONARY_ITEM()
 	m_arraySize = 0;
 	m_szname[0] = 0;
 	m_szunit[0] = 0;
+	m_encError = 0.f;
 }
 
 FEBioPlotFile::DICTIONARY_ITEM::DICTIONARY_ITEM(const FEBioPlotFile::DICTIONARY_ITEM& item)
@@ -59,6 +61,9 @@ FEBioPlotFile::DICTIONARY_ITEM::DICTIONARY_ITEM(const FEBioPlotFile::DICTIONARY_
 	m_szunit[0] = 0;
 	if (item.m_szname[0]) strcpy(m_szname, item.m_szname);
 	if (item.m_szunit[0]) strcpy(m_szunit, item.m_szunit);
+	m_encoding = item.m_encoding;
+	m_encError = item.m_encError;
+	m_encNodeSet = item.m_encNodeSet;
 }
 
 class FEPlotSurfaceDataExport : public FEPlotData
@@ -446,6 +451,7 @@ bool FEBioPlotFile::Dictionary::AddGlobalVariable(FEPlotData* ps, const char* sz
 			strcpy(it.m_szunit, ps->GetUnits());
 		}
 		m_Glob.push_back(it);
+		m_last = &m_Glob.back();
 		return true;
 	}
 	return false;
@@ -475,6 +481,7 @@ bool FEBioPlotFile::Dictionary::AddNodalVariable(FEPlotData* ps, const char* szn
 			strcpy(it.m_szunit, ps->GetUnits());
 		}
 		m_Node.push_back(it);
+		m_last = &m_Node.back();
 		return true;
 	}
 	return false;
@@ -498,6 +505,7 @@ bool FEBioPlotFile::Dictionary::AddDomainVariable(FEPlotData* ps, const char* sz
 			strcpy(it.m_szunit, ps->GetUnits());
 		}
 		m_Elem.push_back(it);
+		m_last = &m_Elem.back();
 		return true;
 	}
 	return false;
@@ -521,6 +529,7 @@ bool FEBioPlotFile::Dictionary::AddSurfaceVariable(FEPlotData* ps, const char* s
 			strcpy(it.m_szunit, ps->GetUnits());
 		}
 		m_Face.push_back(it);
+		m_last = &m_Face.back();
 		return true;
 	}
 	return false;
@@ -564,6 +573,8 @@ void FEBioPlotFile::Dictionary::Defaults(FEModel& fem)
 //-----------------------------------------------------------------------------
 void FEBioPlotFile::Dictionary::Clear()
 {
+	m_last = nullptr;
+
 	list<DICTIONARY_ITEM>::iterator it = m_Glob.begin();
 	for (int i = 0; i < (int)m_Glob.size(); ++i, ++it) delete it->m_psave;
 	m_Glob.clear();
@@ -610,11 +621,19 @@ void FEBioPlotFile::PlotObject::AddData(const char* szname, Var_Type type, FEPlo
 FEBioPlotFile::FEBioPlotFile(FEModel* fem) : PlotFile(fem)
 {
 	m_ncompress = 0;
+	m_blockSize = 0;
 	m_meshesWritten = 0;
 	m_exportUnitsFlag = false;
 	m_exportErodedElements = true;
 }
 
+//-----------------------------------------------------------------------------
+FEBioPlotFile::~FEBioPlotFile()
+{
+	for (auto& it : m_encoders) delete it.second;
+	m_encoders.clear();
+}
+
 //-----------------------------------------------------------------------------
 int FEBioPlotFile::PointObjects()
 {
@@ -667,6 +686,12 @@ void FEBioPlotFile::SetCompression(int n)
 	m_ncompress = n;
 }
 
+//-----------------------------------------------------------------------------
+void FEBioPlotFile::SetBlockSize(size_t n)
+{
+	m_blockSize = n;
+}
+
 //-----------------------------------------------------------------------------
 //! set the version string
 void FEBioPlotFile::SetSoftwareString(const std::string& softwareString)
@@ -683,7 +708,11 @@ bool FEBioPlotFile::IsValid() const
 //-----------------------------------------------------------------------------
 void FEBioPlotFile::Close()
 {
+	if ((m_blockSize > 0) && m_ar.IsValid()) WriteStateIndex();
 	m_ar.Close();
+
+	// report errors of states that were still being written
+	if (m_ar.WriteFailed()) feLogError("Failed writing data to the plot file.");
 }
 
 //-----------------------------------------------------------------------------
@@ -692,8 +721,12 @@ void FEBioPlotFile::Clear()
 	PlotFile::Dictionary& dic = GetDictionary();
 	dic.Clear();
 	m_Surf.clear();
-	for (PointObject* p : m_Points) delete p; m_Points.clear();
-	for (LineObject* l : m_Lines) delete l; m_Lines.clear();
+	for (PointObject* p : m_Points) delete p;
+	m_Points.clear();
+	for (LineObject* l : m_Lines) delete l;
+	m_Lines.clear();
+	for (auto& it : m_encoders) delete it.second;
+	m_encoders.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -710,6 +743,19 @@ bool FEBioPlotFile::Open(const char *szfile)
 	FEPlotDataStore& pltData = fem->GetPlotDataStore();
 	SetCompression(pltData.GetPlotCompression());
 
+	// block compression (only used when compression is on)
+	m_stateIndex.clear();
+	m_stateTimes.clear();
+	SetBlockSize(0);
+	if (m_ncompress && (pltData.GetPlotBlockSize() > 0))
+	{
+		if (PltArchive::SupportsBlockCompression()) SetBlockSize(pltData.GetPlotBlockSize());
+		else feLogWarning("Block compression of the plot file is not supported in this build.");
+	}
+
+	// let a background thread write the states
+	m_ar.SetAsync(pltData.GetPlotAsyncQueue());
+
 	BuildDictionary();
 
 	try
@@ -760,12 +806,22 @@ bool FEBioPlotFile::WriteHeader(FEModel& fem)
 {
 	// setup the header
 	unsigned int nversion = PLT_VERSION;
+	if (HasEncodedVariables()) nversion = PLT_VERSION_ENCODING;
+	else if (m_blockSize > 0) nversion = PLT_VERSION_BLOCKS;
 
 	// output header
 	m_ar.WriteChunk(PLT_HDR_VERSION, nversion);
 
 	// compression flag
-	m_ar.WriteChunk(PLT_HDR_COMPRESSION, m_ncompress);
+	// (with block compression, the states are not compressed as one stream)
+	if (m_blockSize > 0)
+	{
+		int ncompress = 0;
+		m_ar.WriteChunk(PLT_HDR_COMPRESSION, ncompress);
+		unsigned int blockSize = (unsigned int)m_blockSize;
+		m_ar.WriteChunk(PLT_HDR_BLOCK_SIZE, blockSize);
+	}
+	else m_ar.WriteChunk(PLT_HDR_COMPRESSION, m_ncompress);
 
 	// software flag
 	if (m_softwareString.empty() == false)
@@ -873,6 +929,88 @@ void FEBioPlotFile::WriteDictionaryItem(DICTIONARY_ITEM& it)
 	{
 		m_ar.WriteChunk(PLT_DIC_ITEM_UNITS, it.m_szunit, STR_SIZE);
 	}
+
+	PltFieldEncoder* enc = GetEncoder(it);
+	if (enc)
+	{
+		int encoding = enc->GetEncoding();
+		m_ar.WriteChunk(PLT_DIC_ITEM_ENCODING, encoding);
+		m_ar.WriteChunk(PLT_DIC_ITEM_ENC_ERROR, it.m_encError);
+		vector<int> items = enc->GetFullPrecisionItems();
+		if (items.empty() == false) m_ar.WriteChunk(PLT_DIC_ITEM_ENC_ITEMS, items);
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioPlotFile::HasEncodedVariables()
+{
+	PlotFile::Dictionary& dic = GetDictionary();
+	const list<DICTIONARY_ITEM>* lists[] = { &dic.GlobalVariableList(), &dic.NodalVariableList(), &dic.DomainVariableList(), &dic.SurfaceVariableList() };
+	for (const list<DICTIONARY_ITEM>* l : lists)
+	{
+		for (const DICTIONARY_ITEM& it : *l)
+		{
+			if (it.m_encoding.empty() == false) return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// returns the encoder of a variable, or null if the variable is not encoded.
+// The encoder is created the first time it is requested.
+PltFieldEncoder* FEBioPlotFile::GetEncoder(DICTIONARY_ITEM& it)
+{
+	if (it.m_encoding.empty()) return nullptr;
+
+	auto p = m_encoders.find(&it);
+	if (p != m_encoders.end()) return p->second;
+
+	int encoding = PltFieldEncoder::FromString(it.m_encoding.c_str());
+	if (encoding <= 0) return nullptr;
+
+	// the farfield encoding needs the node set that is stored with full precision
+	vector<int> fullItems;
+	if (encoding == PltFieldEncoder::FARFIELD)
+	{
+		FEMesh& mesh = GetFEModel()->GetMesh();
+		FENodeSet* nset = mesh.FindNodeSet(it.m_encNodeSet);
+		FEPlotData* pd = it.m_psave;
+		if (pd && nset && (pd->RegionType() == FE_REGION_NODE))
+		{
+			int ndata = pd->VarSize(pd->DataType());
+			for (int i = 0; i < nset->Size(); ++i)
+			{
+				int n = (*nset)[i];
+				for (int k = 0; k < ndata; ++k) fullItems.push_back(n*ndata + k);
+			}
+		}
+		else
+		{
+			feLogWarning("The farfield encoding of \"%s\" requires a nodal variable and a node set.\nThe variable will be quantized.", it.m_szname);
+			encoding = PltFieldEncoder::QUANTIZE;
+		}
+	}
+
+	PltFieldEncoder* enc = new PltFieldEncoder(encoding, it.m_encError);
+	if (encoding == PltFieldEncoder::FARFIELD) enc->SetFullPrecisionItems(fullItems);
+	m_encoders[&it] = enc;
+	return enc;
+}
+
+//-----------------------------------------------------------------------------
+void FEBioPlotFile::WriteFieldData(DICTIONARY_ITEM& it, int nid, std::vector<float>& data)
+{
+	PltFieldEncoder* enc = GetEncoder(it);
+	if (enc == nullptr)
+	{
+		m_ar.WriteData(nid, data);
+		return;
+	}
+
+	vector<unsigned char> buf;
+	enc->Encode(nid, data, buf);
+	m_ar.WriteChunk(nid, buf);
 }
 
 //-----------------------------------------------------------------------------
@@ -881,6 +1019,13 @@ bool FEBioPlotFile::WriteMeshSection(FEModel& fem)
 	// get the mesh
 	FEMesh& m = fem.GetMesh();
 
+	// with block compression, mesh sections are not compressed so that the file can be scanned
+	if (m_blockSize > 0)
+	{
+		m_ar.SetCompression(0);
+		m_ar.SetBlockCompression(0, 0, 0);
+	}
+
 	m_ar.BeginChunk(PLT_MESH);
 	{
 		// node section
@@ -1581,7 +1726,13 @@ bool FEBioPlotFile::Write(float ftime, int flag)
 	PlotFile::Dictionary& dic = GetDictionary();
 
 	// compress these sections if requested
+	// (with block compression, this sets the compression level of the blocks)
 	m_ar.SetCompression(m_ncompress);
+	if (m_blockSize > 0)
+	{
+		m_ar.SetBlockCompression(PLT_STATE_BLOCKS, PLT_STATE_BLOCK, m_blockSize);
+		m_stateTimes.push_back(ftime);
+	}
 	m_ar.BeginChunk(PLT_STATE);
 	{
 		// state header
@@ -1654,6 +1805,13 @@ bool FEBioPlotFile::Write(float ftime, int flag)
 	}
 	m_ar.EndChunk();
 
+	// This reports a failure of this state, or (when writing asynchronously) of a previous state.
+	if (m_ar.WriteFailed())
+	{
+		feLogError("Failed writing data to the plot file.");
+		return false;
+	}
+
 	return true;
 }
 
@@ -1671,7 +1829,7 @@ void FEBioPlotFile::WriteGlobalData(FEModel& fem)
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
-				if (it->m_psave) WriteGlobalDataField(fem, it->m_psave);
+				if (it->m_psave) WriteGlobalDataField(fem, *it);
 			}
 			m_ar.EndChunk();
 		}
@@ -1693,7 +1851,7 @@ void FEBioPlotFile::WriteNodeData(FEModel& fem)
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
-				if (it->m_psave) WriteNodeDataField(fem, it->m_psave);
+				if (it->m_psave) WriteNodeDataField(fem, *it);
 			}
 			m_ar.EndChunk();
 		}
@@ -1715,7 +1873,7 @@ void FEBioPlotFile::WriteDomainData(FEModel& fem)
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
-				if (it->m_psave) WriteDomainDataField(fem, it->m_psave);
+				if (it->m_psave) WriteDomainDataField(fem, *it);
 			}
 			m_ar.EndChunk();
 		}
@@ -1737,7 +1895,7 @@ void FEBioPlotFile::WriteSurfaceData(FEModel& fem)
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
-				if (it->m_psave) WriteSurfaceDataField(fem, it->m_psave);
+				if (it->m_psave) WriteSurfaceDataField(fem, *it);
 			}
 			m_ar.EndChunk();
 		}
@@ -1746,8 +1904,10 @@ void FEBioPlotFile::WriteSurfaceData(FEModel& fem)
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteGlobalDataField(FEModel& fem, FEPlotData* pd)
+void FEBioPlotFile::WriteGlobalDataField(FEModel& fem, DICTIONARY_ITEM& it)
 {
+	FEPlotData* pd = it.m_psave;
+
 	int ndata = pd->VarSize(pd->DataType());
 	FEDataStream a; a.reserve(ndata);
 	if (pd->Save(a))
@@ -1755,13 +1915,15 @@ void FEBioPlotFile::WriteGlobalDataField(FEModel& fem, FEPlotData* pd)
 		// pad mismatches
 		assert(a.size() == ndata);
 		if (a.size() != ndata) a.resize(ndata, 0.f);
-		m_ar.WriteData(0, a.data());
+		WriteFieldData(it, 0, a.data());
 	}
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteNodeDataField(FEModel &fem, FEPlotData* pd)
+void FEBioPlotFile::WriteNodeDataField(FEModel& fem, DICTIONARY_ITEM& it)
 {
+	FEPlotData* pd = it.m_psave;
+
 	// loop over all node sets
 	// right now there is only one, namely the node set of all mesh nodes
 	// so we just pass the mesh
@@ -1774,13 +1936,15 @@ void FEBioPlotFile::WriteNodeDataField(FEModel &fem, FEPlotData* pd)
 		// pad mismatches
 		assert(a.size() == N*ndata);
 		if (a.size() != N * ndata) a.resize(N*ndata, 0.f);
-		m_ar.WriteData(0, a.data());
+		WriteFieldData(it, 0, a.data());
 	}
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
+void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, DICTIONARY_ITEM& it)
 {
+	FEPlotData* pd = it.m_psave;
+
 	// get the domain name (if any)
 	string domName;
 	const char* szdom = pd->GetDomainName();
@@ -1830,7 +1994,7 @@ void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
 					if (a.size() == nsize)
 					{
 						// assumed padding is already there, or not needed
-						m_ar.WriteData(i + 1, a.data());
+						WriteFieldData(it, i + 1, a.data());
 					}
 					else
 					{
@@ -1852,7 +2016,7 @@ void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
 						}
 
 						// write the padded data
-						m_ar.WriteData(i + 1, b.data());
+						WriteFieldData(it, i + 1, b.data());
 					}
 				}
 			}
@@ -1861,8 +2025,10 @@ void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteDomainDataField(FEModel &fem, FEPlotData* pd)
+void FEBioPlotFile::WriteDomainDataField(FEModel& fem, DICTIONARY_ITEM& it)
 {
+	FEPlotData* pd = it.m_psave;
+
 	FEMesh& m = fem.GetMesh();
 	int ND = m.Domains();
 
@@ -1923,7 +2089,7 @@ void FEBioPlotFile::WriteDomainDataField(FEModel &fem, FEPlotData* pd)
 			if (pd->Save(D, a))
 			{
 				assert(a.size() == nsize);
-				m_ar.WriteData(item[i] + 1, a.data());
+				WriteFieldData(it, item[i] + 1, a.data());
 			}
 		}
 	}
@@ -1937,20 +2103,51 @@ bool FEBioPlotFile::Append(const char *szfile)
 
 	FEModel* fem = GetFEModel();
 	FEPlotDataStore& pltData = fem->GetPlotDataStore();
-	SetCompression(pltData.GetPlotCompression());
 
-	// add plot variables
-	for (int n = 0; n < pltData.PlotVariables(); ++n)
+	// The new states must be written like the states that are already in the file,
+	// so we take the layout from the file's header instead of the current settings.
+	FileLayout layout;
+	if (ReadFileLayout(szfile, layout) == false)
+	{
+		feLogError("Failed reading the header of the plot file %s.", szfile);
+		return false;
+	}
+
+	// With block compression, we keep the states that are already in the file in the index.
+	m_stateIndex.clear();
+	m_stateTimes.clear();
+	SetBlockSize(0);
+	if (layout.blockSize > 0)
 	{
-		FEPlotVariable& vi = pltData.GetPlotVariable(n);
-		const std::string& varName = vi.Name();
-		const std::string& domName = vi.DomainName();
+		if (PltArchive::SupportsBlockCompression() == false)
+		{
+			feLogError("The plot file %s uses block compression, which is not supported in this build.", szfile);
+			return false;
+		}
+
+		// (the compression setting only affects the compression level of the blocks)
+		SetCompression(pltData.GetPlotCompression());
+		SetBlockSize(layout.blockSize);
+		if (ReadStateIndex(szfile, m_stateIndex) == false)
+		{
+			feLogWarning("Failed reading the state index of the plot file. Previous states will not be indexed.");
+			m_stateIndex.clear();
+		}
+	}
+	else SetCompression(layout.ncompress);
+
+	// add plot variables
+	BuildDictionary();
 
-		// add the plot output variable
-		if (AddVariable(varName.c_str(), vi.m_item, domName.c_str()) == false)
+	// only files that were written with encoded variables can store encoded data
+	if ((layout.version < PLT_VERSION_ENCODING) && HasEncodedVariables())
+	{
+		feLogWarning("The plot file %s does not support encoded variables. Variables will be stored without encoding.", szfile);
+		PlotFile::Dictionary& dic = GetDictionary();
+		list<DICTIONARY_ITEM>* lists[] = { &dic.GlobalVariableList(), &dic.NodalVariableList(), &dic.DomainVariableList(), &dic.SurfaceVariableList() };
+		for (list<DICTIONARY_ITEM>* l : lists)
 		{
-			feLog("FATAL ERROR: Output variable \"%s\" is not defined\n", varName.c_str());
-			throw "FATAL ERROR";
+			for (DICTIONARY_ITEM& it : *l) it.m_encoding.clear();
 		}
 	}
 
@@ -1983,11 +2180,279 @@ bool FEBioPlotFile::Append(const char *szfile)
 	BuildSurfaceTable();
 
 	// ... and open for appending
-	if (bok) return m_ar.Append(szfile);
+	if (bok && m_ar.Append(szfile))
+	{
+		m_ar.SetAsync(pltData.GetPlotAsyncQueue());
+		return true;
+	}
 
 	return false;
 }
 
+//-----------------------------------------------------------------------------
+// Write the state index at the end of the file. This is followed by a footer, 
+// which stores the file offset of the index.
+void FEBioPlotFile::WriteStateIndex()
+{
+	// we need the file offsets of the states, so wait for the writer
+	m_ar.Sync();
+	vector<int64_t> offsets;
+	m_ar.GetChunkOffsets(PLT_STATE_BLOCKS, offsets);
+	assert(offsets.size() == m_stateTimes.size());
+	size_t nstates = std::min(offsets.size(), m_stateTimes.size());
+
+	vector<int64_t> pos;
+	vector<float> time;
+	for (const StateIndex& si : m_stateIndex) { pos.push_back(si.offset); time.push_back(si.time); }
+	for (size_t i = 0; i < nstates; ++i)
+	{
+		// skip the states that could not be written
+		if (offsets[i] < 0) continue;
+		pos.push_back(offsets[i]);
+		time.push_back(m_stateTimes[i]);
+	}
+
+	m_ar.SetCompression(0);
+	m_ar.SetBlockCompression(0, 0, 0);
+	m_ar.BeginChunk(PLT_STATE_INDEX);
+	{
+		m_ar.WriteChunk(PLT_STATE_INDEX_OFFSET, pos);
+		m_ar.WriteChunk(PLT_STATE_INDEX_TIME, time);
+	}
+	m_ar.EndChunk();
+
+	m_ar.Sync();
+	m_ar.GetChunkOffsets(PLT_STATE_INDEX, offsets);
+	if (offsets.empty()) return;
+	int64_t indexPos = offsets.back();
+
+	m_ar.BeginChunk(PLT_STATE_INDEX_FOOTER);
+	{
+		m_ar.WriteChunk(PLT_STATE_INDEX_POS, indexPos);
+	}
+	m_ar.EndChunk();
+}
+
+//-----------------------------------------------------------------------------
+namespace {
+
+	int plt_seek(FILE* fp, int64_t off, int origin)
+	{
+#ifdef WIN32
+		return _fseeki64(fp, off, origin);
+#else
+		return fseeko(fp, (off_t)off, origin);
+#endif
+	}
+
+	int64_t plt_tell(FILE* fp)
+	{
+#ifdef WIN32
+		return _ftelli64(fp);
+#else
+		return (int64_t)ftello(fp);
+#endif
+	}
+
+	// Find a chunk in a buffer of chunks. The returned size is clamped to the buffer, 
+	// so this can be used on partial data.
+	bool find_chunk(const unsigned char* buf, size_t n, unsigned int id, const unsigned char*& data, size_t& size)
+	{
+		size_t off = 0;
+		while (off + 2 * sizeof(unsigned int) <= n)
+		{
+			unsigned int nid, nsize;
+			memcpy(&nid, buf + off, sizeof(unsigned int));
+			memcpy(&nsize, buf + off + sizeof(unsigned int), sizeof(unsigned int));
+			off += 2 * sizeof(unsigned int);
+			if (nid == id)
+			{
+				data = buf + off;
+				size = std::min((size_t)nsize, n - off);
+				return true;
+			}
+			off += nsize;
+		}
+		return false;
+	}
+
+	// read the time from the data of a PLT_STATE chunk
+	bool read_state_time(const unsigned char* buf, size_t n, float& time)
+	{
+		const unsigned char* hdr = nullptr; size_t nhdr = 0;
+		if (find_chunk(buf, n, FEBioPlotFile::PLT_STATE_HEADER, hdr, nhdr) == false) return false;
+
+		const unsigned char* pt = nullptr; size_t nt = 0;
+		if (find_chunk(hdr, nhdr, FEBioPlotFile::PLT_STATE_HDR_TIME, pt, nt) == false) return false;
+		if (nt < sizeof(float)) return false;
+		memcpy(&time, pt, sizeof(float));
+		return true;
+	}
+
+	// read the state index from the footer
+	bool read_index_from_footer(FILE* fp, std::vector<FEBioPlotFile::StateIndex>& index)
+	{
+		// the footer is the last 24 bytes
+		unsigned int tag[4];
+		int64_t indexPos;
+		if (plt_seek(fp, -(int64_t)(4*sizeof(unsigned int) + sizeof(int64_t)), SEEK_END) != 0) return false;
+		if (fread(tag, sizeof(unsigned int), 4, fp) != 4) return false;
+		if (fread(&indexPos, sizeof(int64_t), 1, fp) != 1) return false;
+		if ((tag[0] != FEBioPlotFile::PLT_STATE_INDEX_FOOTER) || (tag[2] != FEBioPlotFile::PLT_STATE_INDEX_POS) || (tag[3] != sizeof(int64_t))) return false;
+
+		// read the index
+		unsigned int hdr[2];
+		if (plt_seek(fp, indexPos, SEEK_SET) != 0) return false;
+		if (fread(hdr, sizeof(unsigned int), 2, fp) != 2) return false;
+		if (hdr[0] != FEBioPlotFile::PLT_STATE_INDEX) return false;
+		std::vector<unsigned char> buf(hdr[1]);
+		if (fread(buf.data(), 1, buf.size(), fp) != buf.size()) return false;
+
+		const unsigned char* po = nullptr; size_t no = 0;
+		const unsigned char* pt = nullptr; size_t nt = 0;
+		if (find_chunk(buf.data(), buf.size(), FEBioPlotFile::PLT_STATE_INDEX_OFFSET, po, no) == false) return false;
+		if (find_chunk(buf.data(), buf.size(), FEBioPlotFile::PLT_STATE_INDEX_TIME  , pt, nt) == false) return false;
+		size_t nstates = no / sizeof(int64_t);
+		if (nt != nstates * sizeof(float)) return false;
+
+		index.resize(nstates);
+		for (size_t i = 0; i < nstates; ++i)
+		{
+			memcpy(&index[i].offset, po + i * sizeof(int64_t), sizeof(int64_t));
+			memcpy(&index[i].time  , pt + i * sizeof(float  ), sizeof(float));
+		}
+		return true;
+	}
+
+	// build the state index by going through the top-level chunks of the file
+	bool scan_state_index(FILE* fp, std::vector<FEBioPlotFile::StateIndex>& index)
+	{
+		index.clear();
+		if (plt_seek(fp, sizeof(unsigned int), SEEK_SET) != 0) return false;
+
+		unsigned int hdr[2];
+		std::vector<unsigned char> buf, raw;
+		while (fread(hdr, sizeof(unsigned int), 2, fp) == 2)
+		{
+			int64_t pos = plt_tell(fp) - 2 * sizeof(unsigned int);
+			unsigned int nid = hdr[0], nsize = hdr[1];
+			switch (nid)
+			{
+			case FEBioPlotFile::PLT_ROOT:
+			{
+				// if the states are compressed as one stream, we cannot scan them
+				buf.resize(nsize);
+				if (fread(buf.data(), 1, nsize, fp) != nsize) return false;
+				const unsigned char* ph = nullptr; size_t nh = 0;
+				const unsigned char* pc = nullptr; size_t nc = 0;
+				if (find_chunk(buf.data(), nsize, FEBioPlotFile::PLT_HEADER, ph, nh) &&
+					find_chunk(ph, nh, FEBioPlotFile::PLT_HDR_COMPRESSION, pc, nc) && (nc >= sizeof(int)))
+				{
+					int ncompress = 0;
+					memcpy(&ncompress, pc, sizeof(int));
+					if (ncompress != 0) return false;
+				}
+			}
+			break;
+			case FEBioPlotFile::PLT_STATE:
+			{
+				buf.resize(nsize);
+				if (fread(buf.data(), 1, nsize, fp) != nsize) return false;
+				FEBioPlotFile::StateIndex si = { pos, 0.f };
+				if (read_state_time(buf.data(), nsize, si.time) == false) return false;
+				index.push_back(si);
+			}
+			break;
+			case FEBioPlotFile::PLT_STATE_BLOCKS:
+			{
+				buf.resize(nsize);
+				if (fread(buf.data(), 1, nsize, fp) != nsize) return false;
+
+				// the state header is in the first block
+				const unsigned char* pb = nullptr; size_t nb = 0;
+				if (find_chunk(buf.data(), nsize, FEBioPlotFile::PLT_STATE_BLOCK, pb, nb) == false) return false;
+				if (PltArchive::UncompressBlock(pb, nb, raw) == false) return false;
+
+				const unsigned char* ps = nullptr; size_t ns = 0;
+				if (find_chunk(raw.data(), raw.size(), FEBioPlotFile::PLT_STATE, ps, ns) == false) return false;
+				FEBioPlotFile::StateIndex si = { pos, 0.f };
+				if (read_state_time(ps, ns, si.time) == false) return false;
+				index.push_back(si);
+			}
+			break;
+			default:
+				if (plt_seek(fp, nsize, SEEK_CUR) != 0) return false;
+			}
+		}
+		return true;
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioPlotFile::ReadStateIndex(const char* szfile, std::vector<StateIndex>& index)
+{
+	index.clear();
+	FILE* fp = fopen(szfile, "rb");
+	if (fp == nullptr) return false;
+
+	unsigned int ntag = 0;
+	bool bok = ((fread(&ntag, sizeof(unsigned int), 1, fp) == 1) && (ntag == 0x00464542));
+	if (bok)
+	{
+		// use the index at the end of the file, or scan the file if there is none
+		bok = read_index_from_footer(fp, index);
+		if (bok == false) bok = scan_state_index(fp, index);
+	}
+	fclose(fp);
+
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioPlotFile::ReadFileLayout(const char* szfile, FileLayout& layout)
+{
+	layout.version = 0;
+	layout.ncompress = 0;
+	layout.blockSize = 0;
+
+	FILE* fp = fopen(szfile, "rb");
+	if (fp == nullptr) return false;
+
+	// the header is in the root chunk, which is the first chunk of the file
+	unsigned int ntag = 0, hdr[2];
+	std::vector<unsigned char> buf;
+	bool bok = ((fread(&ntag, sizeof(unsigned int), 1, fp) == 1) && (ntag == 0x00464542));
+	bok = bok && (fread(hdr, sizeof(unsigned int), 2, fp) == 2) && (hdr[0] == PLT_ROOT);
+	if (bok)
+	{
+		buf.resize(hdr[1]);
+		bok = (fread(buf.data(), 1, buf.size(), fp) == buf.size());
+	}
+	fclose(fp);
+	if (bok == false) return false;
+
+	const unsigned char* ph = nullptr; size_t nh = 0;
+	if (find_chunk(buf.data(), buf.size(), PLT_HEADER, ph, nh) == false) return false;
+
+	const unsigned char* pd = nullptr; size_t nd = 0;
+	if (find_chunk(ph, nh, PLT_HDR_VERSION, pd, nd) == false) return false;
+	if (nd < sizeof(unsigned int)) return false;
+	memcpy(&layout.version, pd, sizeof(unsigned int));
+
+	if (find_chunk(ph, nh, PLT_HDR_COMPRESSION, pd, nd) && (nd >= sizeof(int)))
+		memcpy(&layout.ncompress, pd, sizeof(int));
+
+	// the block size is only stored in files with block compression
+	if (find_chunk(ph, nh, PLT_HDR_BLOCK_SIZE, pd, nd) && (nd >= sizeof(unsigned int)))
+	{
+		unsigned int blockSize = 0;
+		memcpy(&blockSize, pd, sizeof(unsigned int));
+		layout.blockSize = blockSize;
+	}
+
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 bool FEBioPlotFile::ReadDictionary()
 {
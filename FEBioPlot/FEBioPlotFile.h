@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "PlotFile.h"
 #include "PltArchive.h"
+#include "PltFieldEncoder.h"
 #include "FECore/FESolidDomain.h"
 #include "FECore/FEShellDomain.h"
 #include "FECore/FEBeamDomain.h"
@@ -47,7 +48,11 @@ public:
 	// 3.2: added PLT_ELEMENTSET_SECTION
 	// 3.3: node IDs are now stored in Node Section
 	// 3.4: added PLT_ELEM_LINE3
-	enum { PLT_VERSION = 0x0034 };
+	// 3.5: states can be stored as independently compressed blocks, followed by a state index.
+	//      (Only files that use block compression are written as 3.5.)
+	// 3.6: the data of a variable can be encoded (see PltFieldEncoder)
+	//      (Only files with encoded variables are written as 3.6.)
+	enum { PLT_VERSION = 0x0034, PLT_VERSION_BLOCKS = 0x0035, PLT_VERSION_ENCODING = 0x0036 };
 
 	// file tags
 	enum { 
@@ -60,6 +65,7 @@ public:
 			PLT_HDR_AUTHOR				= 0x01010005,	// new in 2.0
 			PLT_HDR_SOFTWARE			= 0x01010006,	// new in 2.0
 			PLT_HDR_UNITS				= 0x01010007,	// new in 4.0
+			PLT_HDR_BLOCK_SIZE			= 0x01010008,	// new in 3.5
 		PLT_DICTIONARY					= 0x01020000,
 			PLT_DIC_ITEM				= 0x01020001,
 			PLT_DIC_ITEM_TYPE			= 0x01020002,
@@ -68,6 +74,9 @@ public:
 			PLT_DIC_ITEM_ARRAYSIZE		= 0x01020005,	// added in version 0x05
 			PLT_DIC_ITEM_ARRAYNAME		= 0x01020006,	// added in version 0x05
 			PLT_DIC_ITEM_UNITS			= 0x01020007,	// added in version 4.0
+			PLT_DIC_ITEM_ENCODING		= 0x01020008,	// added in version 3.6
+			PLT_DIC_ITEM_ENC_ERROR		= 0x01020009,	// added in version 3.6
+			PLT_DIC_ITEM_ENC_ITEMS		= 0x0102000A,	// added in version 3.6 (values stored with full precision)
 			PLT_DIC_GLOBAL				= 0x01021000,
 //			PLT_DIC_MATERIAL			= 0x01022000,	// this was removed
 			PLT_DIC_NODAL				= 0x01023000,
@@ -163,7 +172,16 @@ public:
 				PLT_FACE_DATA			= 0x02020500,
 			PLT_MESH_STATE				= 0x02030000,
 				PLT_ELEMENT_STATE		= 0x02030001,
-			PLT_OBJECTS_STATE			= 0x02040000
+			PLT_OBJECTS_STATE			= 0x02040000,
+
+		// block compressed states and the state index were added in 3.5
+		PLT_STATE_BLOCKS				= 0x03000000,	// a PLT_STATE chunk, stored as compressed blocks
+			PLT_STATE_BLOCK				= 0x03000001,
+		PLT_STATE_INDEX					= 0x04000000,
+			PLT_STATE_INDEX_OFFSET		= 0x04000001,	// file offsets of the states (64-bit)
+			PLT_STATE_INDEX_TIME		= 0x04000002,	// times of the states
+		PLT_STATE_INDEX_FOOTER			= 0x04010000,	// last chunk in the file
+			PLT_STATE_INDEX_POS			= 0x04010001	// file offset of the state index (64-bit)
 	};
 	// --- element types ---
 	enum Elem_Type { 
@@ -234,8 +252,24 @@ public:
 		vec3d	m_r2;	// point 2
 	};
 
+	// entry of the state index
+	struct StateIndex
+	{
+		int64_t	offset;	// file offset of the state chunk
+		float	time;	// time of the state
+	};
+
+	// layout of the states of a plot file, as stored in the header
+	struct FileLayout
+	{
+		unsigned int	version;	// version number of the file
+		int				ncompress;	// compression flag of the states (zero with block compression)
+		size_t			blockSize;	// block size of compressed states (0 = no blocks)
+	};
+
 public:
 	FEBioPlotFile(FEModel* fem);
+	~FEBioPlotFile();
 
 	//! Open the plot database
 	bool Open(const char* szfile) override;
@@ -256,6 +290,17 @@ public:
 	//! Set the compression level
 	void SetCompression(int n);
 
+	//! Store the states as independently compressed blocks of the given size (0 = one compressed stream)
+	void SetBlockSize(size_t n);
+
+	//! Read the state index of a plot file. This uses the index at the end of the file
+	//! if there is one, and scans the file otherwise. Note that this fails for files
+	//! that compress the states as one stream.
+	static bool ReadStateIndex(const char* szfile, std::vector<StateIndex>& index);
+
+	//! Read the version and the layout of the states from the header of a plot file.
+	static bool ReadFileLayout(const char* szfile, FileLayout& layout);
+
 	// Write a mesh section
 	bool WriteMeshSection(FEModel& fem);
 
@@ -302,13 +347,20 @@ protected:
 	void WriteObjectsState();
 	void WriteObjectData(PlotObject* po);
 
-	void WriteGlobalDataField(FEModel& fem, FEPlotData* pd);
-	void WriteNodeDataField(FEModel& fem, FEPlotData* pd);
-	void WriteDomainDataField(FEModel& fem, FEPlotData* pd);
-	void WriteSurfaceDataField(FEModel& fem, FEPlotData* pd);
+	void WriteGlobalDataField(FEModel& fem, DICTIONARY_ITEM& it);
+	void WriteNodeDataField(FEModel& fem, DICTIONARY_ITEM& it);
+	void WriteDomainDataField(FEModel& fem, DICTIONARY_ITEM& it);
+	void WriteSurfaceDataField(FEModel& fem, DICTIONARY_ITEM& it);
+
+	// write the data of a region, using the encoding of the variable (if any)
+	void WriteFieldData(DICTIONARY_ITEM& it, int nid, std::vector<float>& data);
+	PltFieldEncoder* GetEncoder(DICTIONARY_ITEM& it);
+	bool HasEncodedVariables();
 
 	void WriteMeshState(FEMesh& mesh);
 
+	void WriteStateIndex();
+
 protected:
 	bool ReadDictionary();
 	bool ReadDicList();
@@ -318,6 +370,7 @@ protected:
 protected:
 	PltArchive	m_ar;	// the data archive
 	int			m_ncompress;	// compression level
+	size_t		m_blockSize;	// block size for compressing states (0 = no blocks)
 	int			m_meshesWritten;	// nr of meshes written
 	string		m_softwareString;	// the software string
 	bool		m_exportUnitsFlag;	// flag that indicates whether to write units
@@ -327,6 +380,11 @@ protected:
 
 	std::vector<PointObject*>	m_Points;
 	std::vector<LineObject*>		m_Lines;
+
+	std::vector<StateIndex>	m_stateIndex;	// index of the states that were in the file before appending
+	std::vector<float>		m_stateTimes;	// times of the states that were written
+
+	std::map<DICTIONARY_ITEM*, PltFieldEncoder*>	m_encoders;	// encoders of the encoded variables
 };
 
 //-----------------------------------------------------------------------------
@@ -111,5 +111,14 @@ void PlotFile::BuildDictionary()
 			feLog("FATAL ERROR: Output variable \"%s\" is not defined\n", varName.c_str());
 			throw "FATAL ERROR";
 		}
+
+		// copy the encoding
+		DICTIONARY_ITEM* it = m_dic.LastItem();
+		if (it && (vi.m_encoding.empty() == false))
+		{
+			it->m_encoding = vi.m_encoding;
+			it->m_encError = (float)vi.m_encError;
+			it->m_encNodeSet = vi.m_encNodeSet;
+		}
 	}
 }
@@ -57,6 +57,11 @@ public:
 		std::vector<string>	m_arrayNames;	// names of array components (optional)
 		char			m_szname[STR_SIZE];
 		char			m_szunit[STR_SIZE];
+
+		// optional encoding of the data (see FEPlotVariable)
+		std::string		m_encoding;
+		float			m_encError;
+		std::string		m_encNodeSet;
 	};
 
 	class Dictionary
@@ -73,6 +78,9 @@ public:
 
 		void Clear();
 
+		//! the item that was added last
+		DICTIONARY_ITEM* LastItem() { return m_last; }
+
 	public:
 		list<DICTIONARY_ITEM>& GlobalVariableList() { return m_Glob; }
 		list<DICTIONARY_ITEM>& MaterialVariableList() { return m_Mat; }
@@ -94,6 +102,8 @@ public:
 		list<DICTIONARY_ITEM>	m_Elem;		// Domain variables
 		list<DICTIONARY_ITEM>	m_Face;		// Surface variables
 
+		DICTIONARY_ITEM*	m_last = nullptr;
+
 		friend class PlotFile;
 	};
 
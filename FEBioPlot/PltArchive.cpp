@@ -29,10 +29,10 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "PltArchive.h"
 #include <assert.h>
+#include <algorithm>
 
 #ifdef HAVE_ZLIB
 #include "zlib.h"
-static z_stream strm;
 #endif
 
 //=============================================================================
@@ -47,6 +47,12 @@ FileStream::FileStream(FILE* fp, bool owner)
 	m_ncompress = 0;
 	m_fp = fp;
 	m_fileOwner = owner;
+	m_mem = nullptr;
+	m_strm = nullptr;
+	m_berror = false;
+#ifdef HAVE_ZLIB
+	m_strm = new z_stream;
+#endif
 }
 
 FileStream::~FileStream()
@@ -56,6 +62,10 @@ FileStream::~FileStream()
 	delete [] m_pout;
 	m_buf = 0;
 	m_pout = 0;
+#ifdef HAVE_ZLIB
+	delete m_strm;
+#endif
+	m_strm = nullptr;
 }
 
 bool FileStream::Open(const char* szfile)
@@ -68,7 +78,11 @@ bool FileStream::Open(const char* szfile)
 bool FileStream::Append(const char* szfile)
 {
 	m_fp = fopen(szfile, "a+b");
-	return (m_fp != 0);
+	if (m_fp == 0) return false;
+
+	// make sure the file position is reported correctly before anything is written
+	fseek(m_fp, 0, SEEK_END);
+	return true;
 }
 
 bool FileStream::Create(const char* szfile)
@@ -77,6 +91,17 @@ bool FileStream::Create(const char* szfile)
 	return (m_fp != 0);
 }
 
+int64_t FileStream::Position()
+{
+	Flush();
+	if (m_fp == nullptr) return 0;
+#ifdef WIN32
+	return _ftelli64(m_fp);
+#else
+	return ftello(m_fp);
+#endif
+}
+
 void FileStream::Close()
 {
 	if (m_fp)
@@ -92,6 +117,7 @@ void FileStream::BeginStreaming()
 #ifdef HAVE_ZLIB
 	if (m_ncompress)
 	{
+		z_stream& strm = *m_strm;
 		strm.zalloc = Z_NULL;
 		strm.zfree = Z_NULL;
 		strm.opaque = Z_NULL;
@@ -106,6 +132,7 @@ void FileStream::EndStreaming()
 #ifdef HAVE_ZLIB
 	if (m_ncompress)
 	{
+		z_stream& strm = *m_strm;
 		strm.avail_in = 0;
 		strm.next_in = 0;
 
@@ -116,8 +143,9 @@ void FileStream::EndStreaming()
 			strm.next_out = m_pout;
 			int ret = deflate(&strm, Z_FINISH);    /* no bad return value */
 			assert(ret != Z_STREAM_ERROR);  /* state not clobbered */
-			int have = m_bufsize - strm.avail_out;
-			fwrite(m_pout, 1, have, m_fp);
+			if (ret == Z_STREAM_ERROR) { m_berror = true; break; }
+			size_t have = m_bufsize - strm.avail_out;
+			if (fwrite(m_pout, 1, have, m_fp) != have) m_berror = true;
 		} while (strm.avail_out == 0);
 		assert(strm.avail_in == 0);     /* all input will be used */
 
@@ -154,9 +182,17 @@ void FileStream::Write(void* pd, size_t Size, size_t Count)
 
 void FileStream::Flush()
 {
+	if (m_mem)
+	{
+		m_mem->insert(m_mem->end(), m_buf, m_buf + m_current);
+		m_current = 0;
+		return;
+	}
+
 #ifdef HAVE_ZLIB
 	if (m_ncompress)
 	{
+		z_stream& strm = *m_strm;
 		strm.avail_in = m_current;
 		strm.next_in = m_buf;
 
@@ -167,17 +203,18 @@ void FileStream::Flush()
 			strm.next_out = m_pout;
 			int ret = deflate(&strm, Z_NO_FLUSH);    /* no bad return value */
 			assert(ret != Z_STREAM_ERROR);  /* state not clobbered */
-			int have = m_bufsize - strm.avail_out;
-			fwrite(m_pout, 1, have, m_fp);
+			if (ret == Z_STREAM_ERROR) { m_berror = true; break; }
+			size_t have = m_bufsize - strm.avail_out;
+			if (fwrite(m_pout, 1, have, m_fp) != have) m_berror = true;
 		} while (strm.avail_out == 0);
 		assert(strm.avail_in == 0);     /* all input will be used */
 	}
 	else
 	{
-		if (m_fp) fwrite(m_buf, m_current, 1, m_fp);
+		if (m_fp && m_current && (fwrite(m_buf, m_current, 1, m_fp) != 1)) m_berror = true;
 	}
 #else
-	if (m_fp) fwrite(m_buf, m_current, 1, m_fp);
+	if (m_fp && m_current && (fwrite(m_buf, m_current, 1, m_fp) != 1)) m_berror = true;
 #endif
 
 	// flush the file
@@ -213,6 +250,13 @@ PltArchive::PltArchive()
 	m_pRoot = 0;
 	m_pChunk = 0;
 	m_bSaving = true;
+	m_ncompress = 0;
+	m_blocks.wrapperId = m_blocks.blockId = 0;
+	m_blocks.blockSize = 0;
+	m_maxQueue = 0;
+	m_bwriting = false;
+	m_bstop = false;
+	m_bfailed = false;
 }
 
 PltArchive::~PltArchive()
@@ -225,6 +269,9 @@ void PltArchive::Close()
 	if (m_bSaving)
 	{
 		if (m_pRoot) Flush();
+
+		// make sure all data is written before the file is closed
+		StopWriter();
 	}
 	else 
 	{
@@ -243,28 +290,255 @@ void PltArchive::Close()
 
 void PltArchive::SetCompression(int n)
 {
-	if (m_fp) m_fp->SetCompression(n);
+	// The compression is applied when the chunk tree is written, 
+	// which may be after other trees were queued. 
+	m_ncompress = n;
+}
+
+void PltArchive::SetAsync(int maxQueue)
+{
+	Sync();
+	m_maxQueue = (maxQueue > 0 ? maxQueue : 0);
 }
 
 void PltArchive::Flush()
 {
-	if (m_fp && m_pRoot)
+	if ((m_fp == nullptr) || (m_pRoot == nullptr))
 	{
-		m_fp->BeginStreaming();
-		m_pRoot->Write(m_fp);
-		m_fp->EndStreaming();
+		delete m_pRoot;
+		m_pRoot = 0;
+		m_pChunk = 0;
+		return;
+	}
+
+	// Blocks are only compressed in parallel on the calling thread. The background writer
+	// runs while the solver uses the cores, so it compresses them serially.
+	WriteJob job = { m_pRoot, m_ncompress, m_blocks, (m_maxQueue == 0) };
+	if (m_maxQueue == 0)
+	{
+		if (WriteTree(job) == false) m_bfailed = true;
+	}
+	else
+	{
+		std::unique_lock<std::mutex> lock(m_mtx);
+
+		// start the writer the first time it is needed
+		if (m_writer.joinable() == false)
+		{
+			m_bstop = false;
+			m_writer = std::thread(&PltArchive::WriterThread, this);
+		}
+
+		// wait until there is room in the queue
+		m_cv.wait(lock, [this]() { return ((int)m_queue.size() < m_maxQueue); });
+
+		// the writer takes ownership of the tree
+		m_queue.push_back(job);
+		lock.unlock();
+		m_cv.notify_all();
 	}
-	delete m_pRoot;
 	m_pRoot = 0;
 	m_pChunk = 0;
 }
 
+bool PltArchive::WriteTree(const WriteJob& job)
+{
+	// record where this chunk starts
+	m_fp->ClearError();
+	m_fp->SetCompression(0);
+	int64_t pos = m_fp->Position();
+	unsigned int nid = (job.blocks.blockSize > 0 ? job.blocks.wrapperId : job.root->GetID());
+	size_t noff = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		noff = m_offsets.size();
+		m_offsets.push_back(std::pair<unsigned int, int64_t>(nid, pos));
+	}
+
+	bool bok = true;
+	if (job.blocks.blockSize > 0)
+	{
+		bok = WriteBlocks(job);
+	}
+	else
+	{
+		m_fp->SetCompression(job.ncompress);
+		m_fp->BeginStreaming();
+		job.root->Write(m_fp);
+		m_fp->EndStreaming();
+	}
+	delete job.root;
+
+	// the offset of a tree that was not written is set to -1
+	if (m_fp->HasError()) bok = false;
+	if (bok == false)
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		m_offsets[noff].second = -1;
+	}
+
+	return bok;
+}
+
+bool PltArchive::WriteBlocks(const WriteJob& job)
+{
+	// serialize the tree
+	std::vector<unsigned char> raw;
+	raw.reserve(job.root->Size() + 2 * sizeof(unsigned int));
+	FileStream mem;
+	mem.WriteToMemory(&raw);
+	job.root->Write(&mem);
+	mem.Flush();
+
+	// compress the blocks
+	const size_t blockSize = job.blocks.blockSize;
+	const int nblocks = (int)((raw.size() + blockSize - 1) / blockSize);
+	std::vector< std::vector<unsigned char> > blocks(nblocks);
+	bool bok = true;
+#pragma omp parallel for schedule(dynamic) reduction(&&:bok) if(job.bparallel)
+	for (int i = 0; i < nblocks; ++i)
+	{
+		const unsigned char* src = raw.data() + i*blockSize;
+		size_t n = std::min(blockSize, raw.size() - i*blockSize);
+		std::vector<unsigned char>& dst = blocks[i];
+#ifdef HAVE_ZLIB
+		// the compression level is clamped to the range that zlib accepts
+		int level = (job.ncompress > 0 ? std::min(job.ncompress, (int)Z_BEST_COMPRESSION) : Z_DEFAULT_COMPRESSION);
+		uLongf nout = compressBound((uLong)n);
+		dst.resize(nout);
+		int ret = compress2(dst.data(), &nout, src, (uLong)n, level);
+		if (ret != Z_OK) bok = false;
+		dst.resize(nout);
+#else
+		dst.assign(src, src + n);
+#endif
+		// prepend the uncompressed size
+		unsigned int nraw = (unsigned int)n;
+		dst.insert(dst.begin(), (unsigned char*)&nraw, (unsigned char*)&nraw + sizeof(unsigned int));
+	}
+
+	// don't write anything if a block could not be compressed
+	if (bok == false) return false;
+
+	// write the wrapper chunk
+	unsigned int nsize = 0;
+	for (int i = 0; i < nblocks; ++i) nsize += (unsigned int)blocks[i].size() + 2 * sizeof(unsigned int);
+
+	unsigned int nid = job.blocks.wrapperId;
+	m_fp->Write(&nid, sizeof(unsigned int), 1);
+	m_fp->Write(&nsize, sizeof(unsigned int), 1);
+	for (int i = 0; i < nblocks; ++i)
+	{
+		nid = job.blocks.blockId;
+		unsigned int nblock = (unsigned int)blocks[i].size();
+		m_fp->Write(&nid, sizeof(unsigned int), 1);
+		m_fp->Write(&nblock, sizeof(unsigned int), 1);
+		m_fp->Write(blocks[i].data(), 1, nblock);
+	}
+	m_fp->Flush();
+
+	return true;
+}
+
+void PltArchive::SetBlockCompression(unsigned int wrapperId, unsigned int blockId, size_t blockSize)
+{
+	m_blocks.wrapperId = wrapperId;
+	m_blocks.blockId = blockId;
+	m_blocks.blockSize = blockSize;
+}
+
+void PltArchive::GetChunkOffsets(unsigned int id, std::vector<int64_t>& offsets)
+{
+	offsets.clear();
+	std::lock_guard<std::mutex> lock(m_mtx);
+	for (auto& it : m_offsets)
+	{
+		if (it.first == id) offsets.push_back(it.second);
+	}
+}
+
+bool PltArchive::SupportsBlockCompression()
+{
+#ifdef HAVE_ZLIB
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool PltArchive::UncompressBlock(const unsigned char* src, size_t srcSize, std::vector<unsigned char>& dst)
+{
+#ifdef HAVE_ZLIB
+	if (srcSize < sizeof(unsigned int)) return false;
+	unsigned int nraw = 0;
+	memcpy(&nraw, src, sizeof(unsigned int));
+	dst.resize(nraw);
+	uLongf nout = nraw;
+	int ret = uncompress(dst.data(), &nout, src + sizeof(unsigned int), (uLong)(srcSize - sizeof(unsigned int)));
+	return ((ret == Z_OK) && (nout == nraw));
+#else
+	return false;
+#endif
+}
+
+void PltArchive::WriterThread()
+{
+	std::unique_lock<std::mutex> lock(m_mtx);
+	while (true)
+	{
+		m_cv.wait(lock, [this]() { return (m_queue.empty() == false) || m_bstop; });
+		if (m_queue.empty()) break;
+
+		WriteJob job = m_queue.front();
+		m_queue.pop_front();
+		m_bwriting = true;
+		lock.unlock();
+		m_cv.notify_all();
+
+		bool bok = WriteTree(job);
+
+		lock.lock();
+		if (bok == false) m_bfailed = true;
+		m_bwriting = false;
+		m_cv.notify_all();
+	}
+}
+
+void PltArchive::Sync()
+{
+	if (m_writer.joinable() == false) return;
+	std::unique_lock<std::mutex> lock(m_mtx);
+	m_cv.wait(lock, [this]() { return m_queue.empty() && (m_bwriting == false); });
+}
+
+bool PltArchive::WriteFailed()
+{
+	std::lock_guard<std::mutex> lock(m_mtx);
+	bool bfailed = m_bfailed;
+	m_bfailed = false;
+	return bfailed;
+}
+
+void PltArchive::StopWriter()
+{
+	if (m_writer.joinable() == false) return;
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		m_bstop = true;
+	}
+	m_cv.notify_all();
+	m_writer.join();
+	m_bstop = false;
+}
+
 bool PltArchive::Create(const char* szfile)
 {
 	// attempt to create the file
 	assert(m_fp == 0);
 	m_fp = new FileStream();
 	if (m_fp->Create(szfile) == false) return false;
+	m_offsets.clear();
+	m_bfailed = false;
 
 	// write the root tag 
 	unsigned int ntag = 0x00464542;
@@ -333,6 +607,8 @@ bool PltArchive::Append(const char* szfile)
 	assert(m_fp == 0);
 	m_fp = new FileStream();
 	if (m_fp->Append(szfile) == false) return false;
+	m_offsets.clear();
+	m_bfailed = false;
 	m_bSaving = true;
 	return true;
 }
@@ -409,3 +685,10 @@ unsigned int PltArchive::GetChunkID()
 	assert(pc);
 	return pc->id;
 }
+
+unsigned int PltArchive::GetChunkSize()
+{
+	CHUNK* pc = m_Chunk.top();
+	assert(pc);
+	return pc->nsize;
+}
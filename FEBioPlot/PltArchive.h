@@ -34,10 +34,17 @@ SOFTWARE.*/
 #include <list>
 #include <vector>
 #include <stack>
+#include <cstdint>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 //-----------------------------------------------------------------------------
 enum IOResult { IO_ERROR, IO_OK, IO_END };
 
+struct z_stream_s;
+
 //-----------------------------------------------------------------------------
 //! helper class for writing buffered data to file
 class FileStream
@@ -65,10 +72,20 @@ public:
 
 	void SetCompression(int n) { m_ncompress = n; }
 
+	//! write to a memory buffer instead of a file
+	void WriteToMemory(std::vector<unsigned char>* buf) { m_mem = buf; }
+
+	//! flush the buffer and return the file position (as 64-bit value)
+	int64_t Position();
+
 	FILE* FilePtr() { return m_fp; }
 
 	bool IsValid() { return (m_fp != nullptr); }
 
+	//! returns true if writing or compressing data failed since the last call to ClearError
+	bool HasError() const { return m_berror; }
+	void ClearError() { m_berror = false; }
+
 private:
 	FILE*	m_fp;
 	bool	m_fileOwner;
@@ -77,6 +94,9 @@ private:
 	unsigned char*	m_buf;	//!< buffer
 	unsigned char*	m_pout;	//!< temp buffer when writing
 	int		m_ncompress;	//!< compression level
+	z_stream_s*	m_strm;		//!< compression stream
+	std::vector<unsigned char>*	m_mem;	//!< memory target (instead of file)
+	bool	m_berror;		//!< a write error occurred
 };
 
 class OBranch;
@@ -241,6 +261,9 @@ protected:
 
 //-----------------------------------------------------------------------------
 //! Implementation of an archiving class. Will be used by the FEBioPlotFile class.
+//! When writing, the data is collected in a chunk tree which is written to file
+//! when the root chunk is ended. Optionally, the chunk trees can be written 
+//! by a background thread, so that the caller only needs to collect the data. 
 class PltArchive
 {
 protected:
@@ -265,6 +288,37 @@ public:
 	// flush data to file
 	void Flush();
 
+	// Write the chunk trees on a background thread. At most maxQueue trees can
+	// be waiting to be written. When the queue is full, Flush blocks until the
+	// writer has caught up. Set maxQueue to zero to write on the calling thread.
+	void SetAsync(int maxQueue);
+
+	// wait until all queued data was written to file
+	void Sync();
+
+	// Returns true if a chunk tree could not be written since the last call. Chunk trees
+	// that are written by the background thread are reported by the next call after the 
+	// failure, so this should be checked after each write and after closing the archive.
+	bool WriteFailed();
+
+	// Write the next chunk trees as a sequence of independently compressed blocks
+	// of (at most) blockSize bytes. The compressed blocks are wrapped in a chunk with 
+	// ID wrapperId, and each block is stored in a chunk with ID blockId. The block data 
+	// starts with the uncompressed size of the block. Uncompressing and joining the 
+	// blocks gives the chunk tree. Set blockSize to zero to turn this off. 
+	void SetBlockCompression(unsigned int wrapperId, unsigned int blockId, size_t blockSize);
+
+	// Get the file offsets of the root chunks with the given ID that were written since 
+	// the archive was created or opened for appending. (Call Sync first when writing asynchronously.)
+	// The offset is -1 for chunks that could not be written.
+	void GetChunkOffsets(unsigned int id, std::vector<int64_t>& offsets);
+
+	// see if block compression is supported
+	static bool SupportsBlockCompression();
+
+	// uncompress a block that was written with block compression
+	static bool UncompressBlock(const unsigned char* src, size_t srcSize, std::vector<unsigned char>& dst);
+
 public:
 	// --- Writing ---
 
@@ -320,6 +374,9 @@ public:
 	// Get the current chunk ID
 	unsigned int GetChunkID();
 
+	// Get the size of the current chunk (in bytes)
+	unsigned int GetChunkSize();
+
 	// Close a chunk
 	void CloseChunk();
 
@@ -352,6 +409,28 @@ public:
 
 	bool IsValid() const { return (m_fp != 0); }
 
+protected:
+	struct BlockLayout
+	{
+		unsigned int	wrapperId;
+		unsigned int	blockId;
+		size_t			blockSize;	// 0 = no block compression
+	};
+
+	// data written by the background thread
+	struct WriteJob
+	{
+		OBranch*	root;
+		int			ncompress;
+		BlockLayout	blocks;
+		bool		bparallel;	// compress the blocks with OpenMP threads
+	};
+
+	bool WriteTree(const WriteJob& job);
+	bool WriteBlocks(const WriteJob& job);
+	void WriterThread();
+	void StopWriter();
+
 protected:
 	FileStream*	m_fp;		// pointer to file stream
 	bool		m_bSaving;	// read or write mode?
@@ -359,6 +438,21 @@ protected:
 	// write data
 	OBranch*	m_pRoot;	// chunk tree root
 	OBranch*	m_pChunk;	// current chunk
+	int			m_ncompress;	// compression level of the next chunk tree
+	BlockLayout	m_blocks;		// block layout of the next chunk tree
+
+	// offsets of root chunks that were written
+	std::vector<std::pair<unsigned int, int64_t> >	m_offsets;
+
+	// background writer
+	int						m_maxQueue;	// max nr of queued chunk trees (0 = no background writer)
+	std::thread				m_writer;
+	std::mutex				m_mtx;
+	std::condition_variable	m_cv;
+	std::deque<WriteJob>	m_queue;
+	bool					m_bwriting;	// writer is busy with a job
+	bool					m_bstop;
+	bool					m_bfailed;	// a chunk tree could not be written
 
 	// read data
 	bool			m_bend;		// chunk end flag
@@ -0,0 +1,247 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "PltFieldEncoder.h"
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+namespace {
+
+	// For the delta encoding, the quantized values are limited to 22 bits, so that the 
+	// previous quantized values can be recovered exactly from the decoded floats.
+	const long long MAX_QUANTIZED = 4194303;
+
+	template <typename T> void append(std::vector<unsigned char>& out, const T& v)
+	{
+		const unsigned char* p = (const unsigned char*)&v;
+		out.insert(out.end(), p, p + sizeof(T));
+	}
+
+	template <typename T> bool extract(const unsigned char*& p, const unsigned char* end, T& v)
+	{
+		if (p + sizeof(T) > end) return false;
+		memcpy(&v, p, sizeof(T));
+		p += sizeof(T);
+		return true;
+	}
+
+	unsigned int float_bits(float f) { unsigned int n; memcpy(&n, &f, sizeof(float)); return n; }
+	float bits_float(unsigned int n) { float f; memcpy(&f, &n, sizeof(float)); return f; }
+}
+
+//-----------------------------------------------------------------------------
+PltFieldEncoder::PltFieldEncoder(int encoding, float maxError, int keyInterval)
+{
+	m_encoding = encoding;
+	m_maxError = maxError;
+	m_keyInterval = (keyInterval > 0 ? keyInterval : 1);
+}
+
+//-----------------------------------------------------------------------------
+void PltFieldEncoder::SetFullPrecisionItems(const std::vector<int>& items)
+{
+	m_fullItems = items;
+	std::sort(m_fullItems.begin(), m_fullItems.end());
+	m_fullItems.erase(std::unique(m_fullItems.begin(), m_fullItems.end()), m_fullItems.end());
+}
+
+//-----------------------------------------------------------------------------
+int PltFieldEncoder::FromString(const char* sz)
+{
+	if (sz == nullptr) return -1;
+	if (strcmp(sz, "none"          ) == 0) return NONE;
+	if (strcmp(sz, "delta"         ) == 0) return DELTA;
+	if (strcmp(sz, "quantize"      ) == 0) return QUANTIZE;
+	if (strcmp(sz, "delta_quantize") == 0) return DELTA_QUANTIZE;
+	if (strcmp(sz, "farfield"      ) == 0) return FARFIELD;
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+void PltFieldEncoder::Encode(int region, const std::vector<float>& data, std::vector<unsigned char>& out)
+{
+	const int n = (int)data.size();
+	Region& r = m_region[region];
+
+	// see if we need a key frame
+	int keyFrame = 0;
+	if (((r.states % m_keyInterval) == 0) || ((int)r.prev.size() != n))
+	{
+		keyFrame = 1;
+		r.states = 0;
+	}
+	r.states++;
+
+	std::vector<unsigned char> payload;
+	if (m_encoding == DELTA)
+	{
+		r.prev.resize(n);
+		payload.reserve(n * sizeof(unsigned int));
+		for (int i = 0; i < n; ++i)
+		{
+			unsigned int bits = float_bits(data[i]);
+			unsigned int v = (keyFrame ? bits : bits ^ (unsigned int)r.prev[i]);
+			append(payload, v);
+			r.prev[i] = (int)bits;
+		}
+	}
+	else if ((m_encoding == QUANTIZE) || (m_encoding == DELTA_QUANTIZE) || (m_encoding == FARFIELD))
+	{
+		// figure out which values are quantized
+		std::vector<bool> full(n, false);
+		if (m_encoding == FARFIELD)
+		{
+			for (int i : m_fullItems) if ((i >= 0) && (i < n)) full[i] = true;
+		}
+
+		// quantize
+		const float step = 2.f * m_maxError;
+		const long long qmax = (m_encoding == DELTA_QUANTIZE ? MAX_QUANTIZED : 2147483647LL);
+		bool bok = (step > 0.f);
+		std::vector<long long> q; q.reserve(n);
+		if (m_encoding == DELTA_QUANTIZE) r.prev.resize(n);
+		long long dmax = 0;
+		for (int i = 0; (i < n) && bok; ++i)
+		{
+			if (full[i]) continue;
+			double v = (double)data[i] / step;
+			if ((std::isfinite(v) == false) || (std::fabs(v) > (double)qmax)) { bok = false; break; }
+			long long qi = std::llround(v);
+			long long di = ((m_encoding == DELTA_QUANTIZE) && (keyFrame == 0) ? qi - r.prev[i] : qi);
+			dmax = std::max(dmax, (di < 0 ? -di : di));
+			q.push_back(di);
+			if (m_encoding == DELTA_QUANTIZE) r.prev[i] = (int)qi;
+		}
+
+		if (bok)
+		{
+			int width = (dmax <= 127 ? 1 : (dmax <= 32767 ? 2 : 4));
+			append(payload, step);
+			append(payload, width);
+			payload.reserve(payload.size() + q.size() * width);
+			for (long long qi : q)
+			{
+				if      (width == 1) append(payload, (signed char)qi);
+				else if (width == 2) append(payload, (short)qi);
+				else append(payload, (int)qi);
+			}
+		}
+		else
+		{
+			// store the values as floats. This is also a key frame for the delta encoding.
+			keyFrame = 1;
+			r.states = 1;
+			append(payload, step);
+			append(payload, (int)0);
+			for (int i = 0; i < n; ++i) if (full[i] == false) append(payload, data[i]);
+			if (m_encoding == DELTA_QUANTIZE)
+			{
+				// the next state can only refer to this state if it was quantized
+				r.prev.clear();
+			}
+		}
+
+		// the full precision values
+		for (int i = 0; i < n; ++i) if (full[i]) append(payload, data[i]);
+	}
+	else
+	{
+		payload.reserve(n * sizeof(float));
+		for (int i = 0; i < n; ++i) append(payload, data[i]);
+	}
+
+	out.clear();
+	out.reserve(payload.size() + 3 * sizeof(unsigned int));
+	append(out, (unsigned int)m_encoding);
+	append(out, (unsigned int)n);
+	append(out, (unsigned int)keyFrame);
+	out.insert(out.end(), payload.begin(), payload.end());
+}
+
+//-----------------------------------------------------------------------------
+bool PltFieldEncoder::Decode(const unsigned char* buf, size_t size, const std::vector<float>& prev, const std::vector<int>& fullItems, std::vector<float>& data)
+{
+	const unsigned char* p = buf;
+	const unsigned char* end = buf + size;
+	unsigned int encoding, n, keyFrame;
+	if (!extract(p, end, encoding) || !extract(p, end, n) || !extract(p, end, keyFrame)) return false;
+	if ((keyFrame == 0) && (prev.size() != n)) return false;
+
+	data.resize(n);
+	if (encoding == DELTA)
+	{
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			unsigned int v;
+			if (!extract(p, end, v)) return false;
+			data[i] = bits_float(keyFrame ? v : v ^ float_bits(prev[i]));
+		}
+	}
+	else if ((encoding == QUANTIZE) || (encoding == DELTA_QUANTIZE) || (encoding == FARFIELD))
+	{
+		std::vector<bool> full(n, false);
+		if (encoding == FARFIELD)
+		{
+			for (int i : fullItems) if ((i >= 0) && (i < (int)n)) full[i] = true;
+		}
+
+		float step; int width;
+		if (!extract(p, end, step) || !extract(p, end, width)) return false;
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			if (full[i]) continue;
+			if (width == 0)
+			{
+				if (!extract(p, end, data[i])) return false;
+				continue;
+			}
+
+			long long qi = 0;
+			if (width == 1) { signed char c; if (!extract(p, end, c)) return false; qi = c; }
+			else if (width == 2) { short s; if (!extract(p, end, s)) return false; qi = s; }
+			else { int k; if (!extract(p, end, k)) return false; qi = k; }
+
+			if ((encoding == DELTA_QUANTIZE) && (keyFrame == 0)) qi += std::llround((double)prev[i] / step);
+			data[i] = (float)(qi * (double)step);
+		}
+
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			if (full[i] && !extract(p, end, data[i])) return false;
+		}
+	}
+	else
+	{
+		for (unsigned int i = 0; i < n; ++i) if (!extract(p, end, data[i])) return false;
+	}
+
+	return (p == end);
+}
@@ -0,0 +1,99 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <map>
+
+//-----------------------------------------------------------------------------
+//! Encodes the data of a plot variable before it is written to the plot file.
+//! The encoded data of a region starts with a header of three 32-bit values:
+//! the encoding, the number of values, and a key frame flag. What follows depends 
+//! on the encoding:
+//!  - DELTA: the bits of each value, XOR-ed with the bits of the value of the previous
+//!    state. This is lossless, but compresses much better than the values themselves.
+//!  - QUANTIZE: the quantization step (float) and the integer width w (1, 2 or 4; 0 if 
+//!    the values are stored as floats since they can't be quantized), followed by the 
+//!    values, rounded to a multiple of the step and stored as w-byte integers. 
+//!    The step is twice the error bound.
+//!  - DELTA_QUANTIZE: as QUANTIZE, but the integers are the difference with the 
+//!    quantized values of the previous state. 
+//!  - FARFIELD: as QUANTIZE for all values that are not in the list of full precision
+//!    items, followed by the full precision values as floats.
+//! For the delta encodings, the previous state is only used if the key frame flag
+//! is zero. A key frame is written at regular intervals, so that a reader only has to 
+//! go back to the last key frame to decode a state.
+class PltFieldEncoder
+{
+public:
+	enum Encoding {
+		NONE			= 0,
+		DELTA			= 1,
+		QUANTIZE		= 2,
+		DELTA_QUANTIZE	= 3,
+		FARFIELD		= 4
+	};
+
+public:
+	PltFieldEncoder(int encoding, float maxError, int keyInterval = 10);
+
+	//! Set the values that are stored with full precision (only used by FARFIELD). 
+	//! The items are given as indices in the data array of a region.
+	void SetFullPrecisionItems(const std::vector<int>& items);
+
+	//! the encoding that is used
+	int GetEncoding() const { return m_encoding; }
+
+	//! the values that are stored with full precision
+	const std::vector<int>& GetFullPrecisionItems() const { return m_fullItems; }
+
+	//! encode the data of a region
+	void Encode(int region, const std::vector<float>& data, std::vector<unsigned char>& out);
+
+	//! Decode the data of a region. For the delta encodings, prev must contain the decoded 
+	//! values of the previous state, unless this is a key frame. 
+	static bool Decode(const unsigned char* buf, size_t size, const std::vector<float>& prev, const std::vector<int>& fullItems, std::vector<float>& data);
+
+	//! return the encoding that corresponds to a string, or -1 if the string is not a valid encoding
+	static int FromString(const char* sz);
+
+private:
+	struct Region
+	{
+		int					states = 0;	// nr of states since the last key frame
+		std::vector<int>	prev;		// bits or quantized values of the previous state
+	};
+
+	int		m_encoding;
+	float	m_maxError;
+	int		m_keyInterval;
+	std::vector<int>	m_fullItems;	// sorted
+	std::map<int, Region>	m_region;
+};
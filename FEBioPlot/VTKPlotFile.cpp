@@ -28,7 +28,11 @@ SOFTWARE.*/
 #include <FECore/FEModel.h>
 #include <FECore/FEPlotDataStore.h>
 #include <FECore/FEDomain.h>
+#include <FECore/log.h>
 #include <sstream>
+#ifdef HAVE_ZLIB
+#include "zlib.h"
+#endif
 
 enum VTK_CELLTYPE {
 	VTK_VERTEX = 1,
@@ -54,21 +58,73 @@ enum VTK_CELLTYPE {
 	VTK_QUADRATIC_PYRAMID = 27
 };
 
+// returns the VTK cell type of an element shape (or -1 if the shape is not supported)
+static int vtk_cell_type(int shape)
+{
+	switch (shape)
+	{
+	case ET_HEX8   : return VTK_HEXAHEDRON;
+	case ET_TET4   : return VTK_TETRA;
+	case ET_PENTA6 : return VTK_WEDGE;
+	case ET_PYRA5  : return VTK_PYRAMID;
+	case ET_QUAD4  : return VTK_QUAD;
+	case ET_TRI3   : return VTK_TRIANGLE;
+	case ET_TRUSS2 : return VTK_LINE;
+	case ET_HEX20  : return VTK_QUADRATIC_HEXAHEDRON;
+	case ET_QUAD8  : return VTK_QUADRATIC_QUAD;
+//	case ET_BEAM3  : return VTK_QUADRATIC_EDGE;
+	case ET_TET10  : return VTK_QUADRATIC_TETRA;
+	case ET_TET15  : return VTK_QUADRATIC_TETRA;
+	case ET_PENTA15: return VTK_QUADRATIC_WEDGE;
+	case ET_HEX27  : return VTK_QUADRATIC_HEXAHEDRON;
+	case ET_PYRA13 : return VTK_QUADRATIC_PYRAMID;
+	case ET_TRI6   : return VTK_QUADRATIC_TRIANGLE;
+	case ET_QUAD9  : return VTK_QUADRATIC_QUAD;
+	}
+	return -1;
+}
+
 
 VTKPlotFile::VTKPlotFile(FEModel* fem) : PlotFile(fem)
 {
 	m_fp = nullptr;
 	m_count = 0;
 	m_valid = false;
+	m_xml = false;
+	m_base64 = false;
+	m_compress = 0;
+	m_encodeError = false;
 }
 
-//! Open the plot database
-bool VTKPlotFile::Open(const char* szfile)
+//! Set the file name (without extension) and the output format
+void VTKPlotFile::SetFileName(const char* szfile)
 {
 	m_filename = szfile;
 	size_t n = m_filename.rfind('.');
 	if (n != std::string::npos) m_filename.erase(n, std::string::npos);
 
+	FEPlotDataStore& pltData = GetFEModel()->GetPlotDataStore();
+	m_xml = (pltData.GetPlotFileType() == "vtu");
+	m_base64 = (pltData.GetPlotDataEncoding() == "base64");
+	m_compress = pltData.GetPlotCompression();
+#ifndef HAVE_ZLIB
+	if (m_xml && m_compress)
+	{
+		feLogWarning("Compression of vtu files is not supported in this build.");
+		m_compress = 0;
+	}
+#endif
+
+	// the mesh is encoded again with the next state
+	m_meshArrays.clear();
+}
+
+//! Open the plot database
+bool VTKPlotFile::Open(const char* szfile)
+{
+	SetFileName(szfile);
+	m_times.clear();
+
 	BuildDictionary();
 	m_valid = true;
 	return true;
@@ -77,9 +133,7 @@ bool VTKPlotFile::Open(const char* szfile)
 //! Open for appending
 bool VTKPlotFile::Append(const char* szfile)
 {
-	m_filename = szfile;
-	size_t n = m_filename.rfind('.');
-	if (n != std::string::npos) m_filename.erase(n, std::string::npos);
+	SetFileName(szfile);
 
 	BuildDictionary();
 	m_valid = true;
@@ -96,11 +150,14 @@ void VTKPlotFile::Serialize(DumpStream& ar)
 {
 	if (ar.IsShallow()) return;
 	ar& m_count;
+	ar& m_times;
 }
 
 //! Write current FE state to plot database
 bool VTKPlotFile::Write(float ftime, int flag)
 {
+	if (m_xml) return WriteXML(ftime);
+
 	FEModel& fem = *GetFEModel();
 
 	std::stringstream ss;
@@ -177,32 +234,33 @@ void VTKPlotFile::WriteCells()
 	for (int j = 0; j<m.Elements(); ++j)
     {
 		FEElement& el = *m.Element(j);
-		int vtk_type;
-        switch (el.Shape()) {
-            case ET_HEX8   : vtk_type = VTK_HEXAHEDRON; break;
-            case ET_TET4   : vtk_type = VTK_TETRA; break;
-            case ET_PENTA6 : vtk_type = VTK_WEDGE; break;
-            case ET_PYRA5  : vtk_type = VTK_PYRAMID; break;
-            case ET_QUAD4  : vtk_type = VTK_QUAD; break;
-            case ET_TRI3   : vtk_type = VTK_TRIANGLE; break;
-            case ET_TRUSS2 : vtk_type = VTK_LINE; break;
-            case ET_HEX20  : vtk_type = VTK_QUADRATIC_HEXAHEDRON; break;
-            case ET_QUAD8  : vtk_type = VTK_QUADRATIC_QUAD; break;
-//            case ET_BEAM3  : vtk_type = VTK_QUADRATIC_EDGE; break;
-            case ET_TET10  : vtk_type = VTK_QUADRATIC_TETRA; break;
-            case ET_TET15  : vtk_type = VTK_QUADRATIC_TETRA; break;
-            case ET_PENTA15: vtk_type = VTK_QUADRATIC_WEDGE; break;
-            case ET_HEX27  : vtk_type = VTK_QUADRATIC_HEXAHEDRON; break;
-            case ET_PYRA13 : vtk_type = VTK_QUADRATIC_PYRAMID; break;
-            case ET_TRI6   : vtk_type = VTK_QUADRATIC_TRIANGLE; break;
-            case ET_QUAD9  : vtk_type = VTK_QUADRATIC_QUAD; break;
-            default: vtk_type = -1; break;
-        }
-            
+		int vtk_type = vtk_cell_type(el.Shape());
         fprintf(m_fp, "%d\n", vtk_type);
     }
 }
 
+// write a data array in the format of the plot file
+void VTKPlotFile::WriteData(std::vector<float>& val, const std::string& name, FEPlotData* pd)
+{
+	if (m_xml)
+	{
+		WriteXMLData(val, name, pd);
+		return;
+	}
+
+	switch (pd->DataType())
+	{
+	case PLT_FLOAT : WriteScalarData(val, name); break;
+	case PLT_VEC3F : WriteVectorData(val, name); break;
+	case PLT_MAT3FS: WriteMat3FSData(val, name); break;
+	case PLT_MAT3FD: WriteMat3FDData(val, name); break;
+	case PLT_ARRAY : WriteArrayData (val, name, pd); break;
+	case PLT_ARRAY_VEC3F: WriteArrayVec3fData(val, name, pd); break;
+	default:
+		assert(false);
+	}
+}
+
 void VTKPlotFile::WriteScalarData(std::vector<float>& val, const std::string& name)
 {
 	fprintf(m_fp, "%s %s %s\n", "SCALARS", name.c_str(), "float");
@@ -306,7 +364,7 @@ void VTKPlotFile::WritePointData()
 	}
 	if ((nodalVars + domainVars) == 0) return;
 
-	fprintf(m_fp, "\nPOINT_DATA %d\n", nodes);
+	if (m_xml == false) fprintf(m_fp, "\nPOINT_DATA %d\n", nodes);
 	auto& nodeData = dic.NodalVariableList();
 	it = nodeData.begin();
 	for (int n = 0; n < nodeData.size(); ++n, ++it)
@@ -332,15 +390,7 @@ void VTKPlotFile::WritePointData()
 
 				// write the value array
 				std::vector<float>& val = a.data();
-				switch (pd->DataType())
-				{
-				case PLT_FLOAT : WriteScalarData(val, szname); break;
-				case PLT_VEC3F : WriteVectorData(val, szname); break;
-				case PLT_MAT3FS: WriteMat3FSData(val, szname); break;
-				case PLT_MAT3FD: WriteMat3FDData(val, szname); break;
-				default:
-					assert(false);
-				}
+				WriteData(val, szname, pd);
 			}
 		}
 	}
@@ -385,17 +435,7 @@ void VTKPlotFile::WritePointData()
 				}
 
 				// write the value array
-				switch (pd->DataType())
-				{
-				case PLT_FLOAT : WriteScalarData(val, szname); break;
-				case PLT_VEC3F : WriteVectorData(val, szname); break;
-				case PLT_MAT3FS: WriteMat3FSData(val, szname); break;
-				case PLT_MAT3FD: WriteMat3FDData(val, szname); break;
-				case PLT_ARRAY : WriteArrayData (val, szname, pd); break;
-				case PLT_ARRAY_VEC3F: WriteArrayVec3fData(val, szname, pd); break;
-				default:
-					assert(false);
-				}
+				WriteData(val, szname, pd);
 			}
 		}
 	}
@@ -410,17 +450,30 @@ void VTKPlotFile::WriteCellData()
 	PlotFile::Dictionary& dic = GetDictionary();
 	if (dic.DomainVariables() == 0) return;
 
-	// write cell data
-	fprintf(m_fp, "\nCELL_DATA %d\n", totalElements);
-
 	// write the part IDs first
-	fprintf(m_fp, "SCALARS part_id int\n");
-	fprintf(m_fp, "LOOKUP_TABLE default\n");
-	for (int i = 0; i < mesh.Domains(); ++i)
+	if (m_xml)
+	{
+		std::vector<int> partId; partId.reserve(totalElements);
+		for (int i = 0; i < mesh.Domains(); ++i)
+		{
+			FEDomain& dom = mesh.Domain(i);
+			partId.insert(partId.end(), dom.Elements(), i);
+		}
+		WriteXMLArray("part_id", "Int32", 1, partId.data(), partId.size() * sizeof(int));
+	}
+	else
 	{
-		FEDomain& dom = mesh.Domain(i);
-		int NE = dom.Elements();
-		for (int n = 0; n < NE; ++n) fprintf(m_fp, "%d\n", i);
+		// write cell data
+		fprintf(m_fp, "\nCELL_DATA %d\n", totalElements);
+
+		fprintf(m_fp, "SCALARS part_id int\n");
+		fprintf(m_fp, "LOOKUP_TABLE default\n");
+		for (int i = 0; i < mesh.Domains(); ++i)
+		{
+			FEDomain& dom = mesh.Domain(i);
+			int NE = dom.Elements();
+			for (int n = 0; n < NE; ++n) fprintf(m_fp, "%d\n", i);
+		}
 	}
 
 	auto& elemData = dic.DomainVariableList();
@@ -472,18 +525,293 @@ void VTKPlotFile::WriteCellData()
 				const char* szname = dataName.c_str();
 
 				// write the value array
-				switch (pd->DataType())
-				{
-				case PLT_FLOAT : WriteScalarData(val, szname); break;
-				case PLT_VEC3F : WriteVectorData(val, szname); break;
-				case PLT_MAT3FS: WriteMat3FSData(val, szname); break;
-				case PLT_MAT3FD: WriteMat3FDData(val, szname); break;
-				case PLT_ARRAY : WriteArrayData (val, szname, pd); break;
-				case PLT_ARRAY_VEC3F: WriteArrayVec3fData(val, szname, pd); break;
-				default:
-					assert(false);
-				}
+				WriteData(val, szname, pd);
 			}
 		}
 	}
 }
+
+//=============================================================================
+// XML (.vtu) format
+//
+// All arrays are stored in the appended data section, using the header type UInt64. 
+// Without compression, an array is stored as its size in bytes, followed by the data. 
+// With compression, the data is split in blocks that are compressed independently 
+// (as with VTK's vtkZLibDataCompressor) and the array starts with a header that 
+// stores the nr of blocks, the block size, the size of the last block and the 
+// compressed size of each block.
+// The points and cells are only encoded once, and the encoded arrays are copied
+// into the files of all the following states. 
+
+static const size_t VTU_BLOCK_SIZE = 1 << 16;
+
+static void base64_encode(const unsigned char* d, size_t n, std::vector<unsigned char>& out)
+{
+	static const char* table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	size_t m = out.size();
+	out.resize(m + 4 * ((n + 2) / 3));
+	unsigned char* c = out.data() + m;
+	for (size_t i = 0; i < n; i += 3)
+	{
+		unsigned int a = d[i];
+		unsigned int b = (i + 1 < n ? d[i + 1] : 0);
+		unsigned int e = (i + 2 < n ? d[i + 2] : 0);
+		unsigned int v = (a << 16) | (b << 8) | e;
+		*c++ = table[(v >> 18) & 0x3F];
+		*c++ = table[(v >> 12) & 0x3F];
+		*c++ = (i + 1 < n ? table[(v >> 6) & 0x3F] : '=');
+		*c++ = (i + 2 < n ? table[v & 0x3F] : '=');
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool VTKPlotFile::WriteXML(float ftime)
+{
+	FEModel& fem = *GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+
+	std::stringstream ss;
+	ss << m_filename << "." << m_count << ".vtu";
+	string fileName = ss.str();
+
+	// the mesh arrays are only encoded once
+	if (m_meshArrays.empty() && (BuildXMLMesh() == false))
+	{
+		m_meshArrays.clear();
+		return false;
+	}
+
+	// collect the arrays of this state
+	m_body.clear();
+	m_appended.clear();
+	m_encodeError = false;
+	m_body += "<PointData>\n";
+	WritePointData();
+	m_body += "</PointData>\n<CellData>\n";
+	WriteCellData();
+	if (m_encodeError) return false;
+	m_body += "</CellData>\n<Points>\n";
+	WriteXMLArray(m_meshArrays[0]);
+	m_body += "</Points>\n<Cells>\n";
+	for (size_t i = 1; i < m_meshArrays.size(); ++i) WriteXMLArray(m_meshArrays[i]);
+	m_body += "</Cells>\n";
+
+	m_fp = fopen(fileName.c_str(), "wb");
+	if (m_fp == nullptr) return false;
+
+	fprintf(m_fp, "<?xml version=\"1.0\"?>\n");
+	fprintf(m_fp, "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\"%s>\n", (m_compress ? " compressor=\"vtkZLibDataCompressor\"" : ""));
+	fprintf(m_fp, "<UnstructuredGrid>\n");
+	fprintf(m_fp, "<Piece NumberOfPoints=\"%d\" NumberOfCells=\"%d\">\n", mesh.Nodes(), mesh.Elements());
+	fwrite(m_body.data(), 1, m_body.size(), m_fp);
+	fprintf(m_fp, "</Piece>\n");
+	fprintf(m_fp, "</UnstructuredGrid>\n");
+	fprintf(m_fp, "<AppendedData encoding=\"%s\">\n_", (m_base64 ? "base64" : "raw"));
+	fwrite(m_appended.data(), 1, m_appended.size(), m_fp);
+	fprintf(m_fp, "\n</AppendedData>\n");
+	fprintf(m_fp, "</VTKFile>\n");
+	fclose(m_fp);
+	m_fp = nullptr;
+
+	m_body.clear();
+	m_appended.clear();
+
+	m_count++;
+	m_times.push_back(ftime);
+
+	// update the collection file, so that it is valid even if the run is interrupted
+	return WriteCollection();
+}
+
+//-----------------------------------------------------------------------------
+// encode the points and cells
+bool VTKPlotFile::BuildXMLMesh()
+{
+	FEMesh& m = GetFEModel()->GetMesh();
+	m_meshArrays.assign(4, XMLArray());
+
+	int nodes = m.Nodes();
+	std::vector<float> r(3 * nodes);
+	for (int i = 0; i < nodes; ++i)
+	{
+		vec3d& ri = m.Node(i).m_r0;
+		r[3 * i    ] = (float)ri.x;
+		r[3 * i + 1] = (float)ri.y;
+		r[3 * i + 2] = (float)ri.z;
+	}
+	if (EncodeXMLArray(m_meshArrays[0], "Points", "Float32", 3, r.data(), r.size() * sizeof(float)) == false) return false;
+
+	int NE = m.Elements();
+	std::vector<int> conn, offset(NE);
+	std::vector<unsigned char> types(NE);
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = *m.Element(i);
+		for (int k = 0; k < el.Nodes(); ++k) conn.push_back(el.m_node[k]);
+		offset[i] = (int)conn.size();
+		int vtk_type = vtk_cell_type(el.Shape());
+		types[i] = (unsigned char)(vtk_type < 0 ? 0 : vtk_type);
+	}
+	if (EncodeXMLArray(m_meshArrays[1], "connectivity", "Int32", 1, conn.data(), conn.size() * sizeof(int)) == false) return false;
+	if (EncodeXMLArray(m_meshArrays[2], "offsets", "Int32", 1, offset.data(), offset.size() * sizeof(int)) == false) return false;
+	if (EncodeXMLArray(m_meshArrays[3], "types", "UInt8", 1, types.data(), types.size()) == false) return false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void VTKPlotFile::WriteXMLData(std::vector<float>& val, const std::string& name, FEPlotData* pd)
+{
+	switch (pd->DataType())
+	{
+	case PLT_FLOAT: WriteXMLArray(name, "Float32", 1, val.data(), val.size() * sizeof(float)); break;
+	case PLT_VEC3F: WriteXMLArray(name, "Float32", 3, val.data(), val.size() * sizeof(float)); break;
+	case PLT_MAT3FS:
+	{
+		// tensors are stored with all 9 components
+		size_t n = val.size() / 6;
+		std::vector<float> t(9 * n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			const float* v = &val[6 * i];
+			float* ti = &t[9 * i];
+			ti[0] = v[0]; ti[1] = v[3]; ti[2] = v[5];
+			ti[3] = v[3]; ti[4] = v[1]; ti[5] = v[4];
+			ti[6] = v[5]; ti[7] = v[4]; ti[8] = v[2];
+		}
+		WriteXMLArray(name, "Float32", 9, t.data(), t.size() * sizeof(float));
+	}
+	break;
+	case PLT_MAT3FD:
+	{
+		size_t n = val.size() / 3;
+		std::vector<float> t(9 * n, 0.f);
+		for (size_t i = 0; i < n; ++i)
+		{
+			t[9 * i    ] = val[3 * i    ];
+			t[9 * i + 4] = val[3 * i + 1];
+			t[9 * i + 8] = val[3 * i + 2];
+		}
+		WriteXMLArray(name, "Float32", 9, t.data(), t.size() * sizeof(float));
+	}
+	break;
+	case PLT_ARRAY:
+	case PLT_ARRAY_VEC3F:
+	{
+		// each array item is stored as a separate array
+		int ncomp = (pd->DataType() == PLT_ARRAY ? 1 : 3);
+		int arraySize = pd->GetArraysize();
+		std::vector<string> arrayNames = pd->GetArrayNames();
+		size_t n = val.size() / (ncomp * arraySize);
+		std::vector<float> a(ncomp * n);
+		for (int j = 0; j < arraySize; ++j)
+		{
+			for (size_t i = 0; i < n; ++i)
+				for (int k = 0; k < ncomp; ++k) a[ncomp * i + k] = val[ncomp * (arraySize * i + j) + k];
+
+			string arrayName = name + "." + (j < (int)arrayNames.size() ? arrayNames[j] : std::to_string(j));
+			Space2_(arrayName);
+			WriteXMLArray(arrayName, "Float32", ncomp, a.data(), a.size() * sizeof(float));
+		}
+	}
+	break;
+	default:
+		assert(false);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void VTKPlotFile::WriteXMLArray(const std::string& name, const char* sztype, int ncomp, const void* pd, size_t bytes)
+{
+	XMLArray a;
+	if (EncodeXMLArray(a, name, sztype, ncomp, pd, bytes)) WriteXMLArray(a);
+	else m_encodeError = true;
+}
+
+//-----------------------------------------------------------------------------
+// add an encoded array to the piece that is being written
+void VTKPlotFile::WriteXMLArray(const XMLArray& a)
+{
+	m_body += "<DataArray " + a.attributes + " format=\"appended\" offset=\"" + std::to_string(m_appended.size()) + "\"/>\n";
+	m_appended.insert(m_appended.end(), a.data.begin(), a.data.end());
+}
+
+//-----------------------------------------------------------------------------
+// Encodes an array of the .vtu file. Returns false if the data could not be compressed.
+bool VTKPlotFile::EncodeXMLArray(XMLArray& a, const std::string& name, const char* sztype, int ncomp, const void* pd, size_t bytes)
+{
+	a.attributes = string("type=\"") + sztype + "\" Name=\"" + name + "\" NumberOfComponents=\"" + std::to_string(ncomp) + "\"";
+	a.data.clear();
+
+	const unsigned char* src = (const unsigned char*)pd;
+	std::vector<unsigned char> raw;
+	if (m_compress == 0)
+	{
+		uint64_t n = bytes;
+		raw.resize(sizeof(n) + bytes);
+		memcpy(raw.data(), &n, sizeof(n));
+		if (bytes) memcpy(raw.data() + sizeof(n), src, bytes);
+		if (m_base64) base64_encode(raw.data(), raw.size(), a.data); else a.data.swap(raw);
+		return true;
+	}
+
+#ifdef HAVE_ZLIB
+	// compress the blocks in parallel
+	int nblocks = (int)((bytes + VTU_BLOCK_SIZE - 1) / VTU_BLOCK_SIZE);
+	std::vector< std::vector<unsigned char> > block(nblocks);
+	bool bok = true;
+#pragma omp parallel for schedule(dynamic) reduction(&&:bok)
+	for (int i = 0; i < nblocks; ++i)
+	{
+		size_t n0 = i * VTU_BLOCK_SIZE;
+		size_t n = (n0 + VTU_BLOCK_SIZE <= bytes ? VTU_BLOCK_SIZE : bytes - n0);
+		uLongf nout = compressBound((uLong)n);
+		block[i].resize(nout);
+		if (compress2(block[i].data(), &nout, src + n0, (uLong)n, Z_DEFAULT_COMPRESSION) != Z_OK) bok = false;
+		block[i].resize(nout);
+	}
+	if (bok == false) return false;
+
+	std::vector<uint64_t> header(3 + nblocks);
+	header[0] = nblocks;
+	header[1] = VTU_BLOCK_SIZE;
+	header[2] = bytes % VTU_BLOCK_SIZE;
+	for (int i = 0; i < nblocks; ++i) header[3 + i] = block[i].size();
+
+	// in base64 encoding, the header and the blocks are encoded separately
+	const unsigned char* ph = (const unsigned char*)header.data();
+	size_t nh = header.size() * sizeof(uint64_t);
+	if (m_base64) base64_encode(ph, nh, a.data); else a.data.insert(a.data.end(), ph, ph + nh);
+	for (int i = 0; i < nblocks; ++i) raw.insert(raw.end(), block[i].begin(), block[i].end());
+	if (m_base64) base64_encode(raw.data(), raw.size(), a.data); else a.data.insert(a.data.end(), raw.begin(), raw.end());
+	return true;
+#else
+	return false;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// write the .pvd file that lists all the states
+bool VTKPlotFile::WriteCollection()
+{
+	string fileName = m_filename + ".pvd";
+
+	// the states are referenced relative to the .pvd file
+	string baseName = m_filename;
+	size_t n = baseName.find_last_of("/\\");
+	if (n != std::string::npos) baseName.erase(0, n + 1);
+
+	FILE* fp = fopen(fileName.c_str(), "wt");
+	if (fp == nullptr) return false;
+	fprintf(fp, "<?xml version=\"1.0\"?>\n");
+	fprintf(fp, "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"LittleEndian\">\n");
+	fprintf(fp, "<Collection>\n");
+	int first = m_count - (int)m_times.size();
+	for (size_t i = 0; i < m_times.size(); ++i)
+	{
+		fprintf(fp, "<DataSet timestep=\"%.9lg\" group=\"\" part=\"0\" file=\"%s.%d.vtu\"/>\n", m_times[i], baseName.c_str(), first + (int)i);
+	}
+	fprintf(fp, "</Collection>\n");
+	fprintf(fp, "</VTKFile>\n");
+	fclose(fp);
+	return true;
+}
@@ -26,8 +26,13 @@ SOFTWARE.*/
 #pragma once
 #include "PlotFile.h"
 #include <stdio.h>
+#include <vector>
+#include <string>
 
 //! This class stores the FEBio results to a family of VTK files. 
+//! Two formats are supported: the legacy ASCII format (one .vtk file per state), 
+//! and the XML format (one .vtu file per state with the arrays in an appended
+//! binary section, and a .pvd file that collects the states).
 class VTKPlotFile : public PlotFile
 {
 public:
@@ -48,12 +53,16 @@ public:
 	void Serialize(DumpStream& ar) override;
 
 private:
+	void SetFileName(const char* szfile);
+
 	void WriteHeader();
 	void WritePoints();
 	void WriteCells();
 	void WritePointData();
 	void WriteCellData();
 
+	void WriteData(std::vector<float>& val, const std::string& name, FEPlotData* pd);
+
 	void WriteScalarData(std::vector<float>& val, const std::string& szname);
 	void WriteVectorData(std::vector<float>& val, const std::string& szname);
 	void WriteMat3FSData(std::vector<float>& val, const std::string& szname);
@@ -61,9 +70,35 @@ private:
 	void WriteArrayData (std::vector<float>& val, const std::string& name, FEPlotData* pd);
 	void WriteArrayVec3fData(std::vector<float>& val, const std::string& name, FEPlotData* pd);
 
+private:
+	// an encoded data array of a .vtu file
+	struct XMLArray
+	{
+		std::string					attributes;
+		std::vector<unsigned char>	data;
+	};
+
+	bool WriteXML(float ftime);
+	bool BuildXMLMesh();
+	void WriteXMLData(std::vector<float>& val, const std::string& name, FEPlotData* pd);
+	void WriteXMLArray(const std::string& name, const char* sztype, int ncomp, const void* pd, size_t bytes);
+	void WriteXMLArray(const XMLArray& a);
+	bool EncodeXMLArray(XMLArray& a, const std::string& name, const char* sztype, int ncomp, const void* pd, size_t bytes);
+	bool WriteCollection();
+
 private:
 	FILE*	m_fp;
 	int		m_count;
 	bool	m_valid;
 	std::string	m_filename;
+
+	// XML format
+	bool	m_xml;			//!< write XML (.vtu) files instead of legacy files
+	bool	m_base64;		//!< base64 encoding of the appended data (instead of raw)
+	int		m_compress;		//!< compress the arrays with zlib
+	std::vector<double>			m_times;		//!< times of the states written so far (for the .pvd file)
+	std::vector<XMLArray>		m_meshArrays;	//!< encoded points and cells (these don't change between states)
+	std::string					m_body;			//!< XML of the piece that is being written
+	std::vector<unsigned char>	m_appended;		//!< appended data of the piece that is being written
+	bool						m_encodeError;	//!< an array of the piece could not be encoded
 };
@@ -31,7 +31,9 @@ SOFTWARE.*/
 #include "FEMicroMaterial.h"
 #include "FECore/mat3d.h"
 #include "FECore/tens6d.h"
+#include "FERVEProbe.h"
 #include <FECore/log.h>
+#include <FECore/FEException.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -53,6 +55,9 @@ bool FEElasticMultiscaleDomain1O::Init()
 	// get the parent RVE
 	FERVEModel& rve = pmat->m_mrve;
 
+	// the first RVE copy of this domain
+	FERVEModel* firstRVE = nullptr;
+
 	// loop over all elements
 	for (size_t i=0; i<m_Elem.size(); ++i)
 	{
@@ -71,8 +76,71 @@ bool FEElasticMultiscaleDomain1O::Init()
 
 			// initialize RCI solve
 			if (mmpt.m_rve.RCI_Init() == false) return false;
+
+			// All RVE copies share the static matrix profile of the parent RVE.
+			// (This is not essential, so we can continue if this fails.)
+			mmpt.m_rve.ShareStaticProfile(rve);
+
+			// The copies also share the linear solver's symbolic factorization, 
+			// which is done by the first copy that is solved.
+			// (This only works for the supernodal solver. Other solvers ignore this.)
+			if (firstRVE) mmpt.m_rve.ShareLinearSolverPreProcess(*firstRVE);
+			else firstRVE = &mmpt.m_rve;
 		}
 	}
 
 	return true;
 }
+
+//-----------------------------------------------------------------------------
+// The RVE problems are solved when the stresses are evaluated. These solves are 
+// independent, so they run concurrently. Since the time it takes to solve an RVE can 
+// vary a lot between integration points, the elements are scheduled dynamically. 
+void FEElasticMultiscaleDomain1O::Update(const FETimeInfo& tp)
+{
+	bool berr = false;
+	bool bfail = false;
+	int NE = Elements();
+	#pragma omp parallel for schedule(dynamic) shared(NE, berr, bfail)
+	for (int i = 0; i < NE; ++i)
+	{
+		// exceptions cannot leave the parallel region, so we catch them here
+		try
+		{
+			FESolidElement& el = Element(i);
+			if (el.isActive())
+			{
+				UpdateElementStress(i, tp);
+			}
+		}
+		catch (NegativeJacobian e)
+		{
+			#pragma omp critical
+			{
+				berr = true;
+				if (e.DoOutput()) feLogError(e.what());
+			}
+		}
+		catch (FEMultiScaleException)
+		{
+			#pragma omp critical
+			bfail = true;
+		}
+	}
+
+	if (berr) throw NegativeJacobianDetected();
+
+	if (bfail)
+	{
+		// store all the probes
+		FEMicroMaterial* pmat = dynamic_cast<FEMicroMaterial*>(m_pMat);
+		int NP = (pmat ? pmat->Probes() : 0);
+		for (int i = 0; i < NP; ++i)
+		{
+			FERVEProbe& p = pmat->Probe(i);
+			if (p.GetDebugFlag()) p.Save();
+		}
+
+		throw FEMultiScaleException(-1, -1);
+	}
+}
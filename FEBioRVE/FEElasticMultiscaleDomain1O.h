@@ -39,4 +39,7 @@ public:
 
 	//! initialize class
 	bool Init();
+
+	//! Update the element stresses. This is where the RVE problems are solved.
+	void Update(const FETimeInfo& tp) override;
 };
@@ -41,6 +41,9 @@ SOFTWARE.*/
 #include <FECore/FECube.h>
 #include <FECore/FEPointFunction.h>
 #include <FECore/FECoreKernel.h>
+#include <FECore/FENewtonSolver.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/LinearSolver.h>
 
 //-----------------------------------------------------------------------------
 FERVEModel::FERVEModel()
@@ -74,6 +77,47 @@ void FERVEModel::CopyFrom(FERVEModel& rve)
 	m_BN = rve.m_BN;
 }
 
+//-----------------------------------------------------------------------------
+// All the RVE copies have the same mesh and boundary conditions, and thus the 
+// same equation numbers. So, instead of each copy building and storing its own
+// static matrix profile, the profile is only built once. 
+bool FERVEModel::ShareStaticProfile(FERVEModel& master)
+{
+	FEAnalysis* step = GetCurrentStep();
+	FENewtonSolver* solver = (step ? dynamic_cast<FENewtonSolver*>(step->GetFESolver()) : nullptr);
+	if ((solver == nullptr) || (solver->GetStiffnessMatrix() == nullptr)) return false;
+	FEGlobalMatrix& K = *solver->GetStiffnessMatrix();
+
+	if (master.m_profile == nullptr)
+	{
+		K.BuildProfile(this, solver->m_neq, true);
+		master.m_profile = std::make_shared<SparseMatrixProfile>(K.StaticProfile());
+	}
+	else if (master.m_profile->Rows() != solver->m_neq) return false;
+
+	K.SetSharedStaticProfile(master.m_profile);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The RVE copies also have the same sparsity pattern, so the linear solver's 
+// preprocessing only needs to be done once as well.
+bool FERVEModel::ShareLinearSolverPreProcess(FERVEModel& rve)
+{
+	FEAnalysis* step = GetCurrentStep();
+	FEAnalysis* rveStep = rve.GetCurrentStep();
+	FENewtonSolver* solver = (step ? dynamic_cast<FENewtonSolver*>(step->GetFESolver()) : nullptr);
+	FENewtonSolver* rveSolver = (rveStep ? dynamic_cast<FENewtonSolver*>(rveStep->GetFESolver()) : nullptr);
+	if ((solver == nullptr) || (rveSolver == nullptr)) return false;
+
+	LinearSolver* ls = solver->GetLinearSolver();
+	LinearSolver* rvels = rveSolver->GetLinearSolver();
+	if ((ls == nullptr) || (rvels == nullptr)) return false;
+
+	return ls->SharePreProcess(rvels);
+}
+
 //-----------------------------------------------------------------------------
 bool FERVEModel::Init()
 {
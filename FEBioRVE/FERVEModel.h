@@ -29,6 +29,8 @@ SOFTWARE.*/
 #pragma once
 #include "FECore/FEModel.h"
 #include <FECore/tens4d.h>
+#include <FECore/MatrixProfile.h>
+#include <memory>
 #include "febiorve_api.h"
 
 //-----------------------------------------------------------------------------
@@ -75,6 +77,17 @@ public:
 	// set the parent FEModel
 	void SetParentModel(FEModel* fem);
 
+	//! Let the solver of this RVE copy use the static matrix profile of the master RVE. 
+	//! The profile is built by the first copy and is then shared by all copies. 
+	bool ShareStaticProfile(FERVEModel& master);
+
+	//! Let the linear solver of this RVE copy share the preprocessing (e.g. symbolic factorization)
+	//! of the linear solver of another copy. Returns false if the linear solver does not support this.
+	//! Currently, only the supernodal solver supports this. With the skyline solver the profile is
+	//! the only structural data, and it is already shared by ShareStaticProfile. With PARDISO, each
+	//! copy still does its own symbolic factorization.
+	bool ShareLinearSolverPreProcess(FERVEModel& rve);
+
 	//! Calculate the stress average
 	mat3ds StressAverage(mat3d& F, FEMaterialPoint& mp);
 	mat3ds StressAverage(FEMaterialPoint& mp);
@@ -107,4 +120,6 @@ protected:
 	int				m_bctype;			//!< RVE type
 	FEBoundingBox	m_bb;				//!< bounding box of mesh
 	vector<int>		m_BN;				//!< boundary node flags
+
+	std::shared_ptr<const SparseMatrixProfile>	m_profile;	//!< static matrix profile shared by all RVE copies
 };
@@ -36,6 +36,11 @@ SOFTWARE.*/
 #include "FEMaterialTest.h"
 #include "FEResetTest.h"
 #include "FEStiffnessDiagnostic.h"
+#include "FEContactSearchBenchmark.h"
+#include "FEPlotEncodingTest.h"
+#include "FESupernodalSolverTest.h"
+#include "FEScatterMapTest.h"
+#include "FEMathExpressionTest.h"
 
 namespace FEBioTest
 {
@@ -48,5 +53,10 @@ void InitModule()
 	REGISTER_FECORE_CLASS(FEResetTest, "reset_test");
 	REGISTER_FECORE_CLASS(FEMaterialTest, "material test");
 	REGISTER_FECORE_CLASS(FEStiffnessDiagnostic, "stiffness_test");
+	REGISTER_FECORE_CLASS(FEContactSearchBenchmark, "contact_search_benchmark");
+	REGISTER_FECORE_CLASS(FEPlotEncodingTest, "plot_encoding_test");
+	REGISTER_FECORE_CLASS(FESupernodalSolverTest, "supernodal_solver_test");
+	REGISTER_FECORE_CLASS(FEScatterMapTest, "scatter_map_test");
+	REGISTER_FECORE_CLASS(FEMathExpressionTest, "math_expression_test");
 }
 }
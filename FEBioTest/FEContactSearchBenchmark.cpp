@@ -0,0 +1,204 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEContactSearchBenchmark.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <FECore/FESurfacePairConstraint.h>
+#include <FECore/FEOctree.h>
+#include <FECore/FENNQuery.h>
+#include <FECore/FESurfaceBVH.h>
+#include <FECore/FENormalProjection.h>
+#include <FECore/Timer.h>
+#include <iostream>
+#include <iomanip>
+using namespace std;
+
+// nr of times each operation is repeated
+#define BENCHMARK_REPEAT	10
+
+// tolerances used for the search
+#define BENCHMARK_STOL	0.01
+#define BENCHMARK_SRAD	1.0
+
+//-----------------------------------------------------------------------------
+FEContactSearchBenchmark::FEContactSearchBenchmark(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FEContactSearchBenchmark::Init(const char* sz)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	Logfile& log = fem.GetLogFile();
+	log.SetMode(Logfile::MODE::LOG_FILE);
+
+	// do the FE initialization
+	return fem.Init();
+}
+
+//-----------------------------------------------------------------------------
+static void benchmark_surface_pair(FESurface& ss, FESurface& ms)
+{
+	const int NR = BENCHMARK_REPEAT;
+
+	// collect the integration points of the primary surface
+	vector<vec3d> r, n;
+	for (int i = 0; i < ss.Elements(); ++i)
+	{
+		FESurfaceElement& el = ss.Element(i);
+		for (int j = 0; j < el.GaussPoints(); ++j)
+		{
+			r.push_back(ss.Local2Global(el, j));
+			n.push_back(ss.SurfaceNormal(el, j));
+		}
+	}
+	const int NP = (int)r.size();
+	cerr << "  secondary elements  : " << ms.Elements() << endl;
+	cerr << "  integration points  : " << NP << endl;
+
+	// build and update times
+	FEOctree ot(&ms);
+	Timer tot; tot.start();
+	for (int k = 0; k < NR; ++k) ot.Init(BENCHMARK_STOL);
+	tot.stop();
+
+	FESurfaceBVH bvh(&ms);
+	Timer tbvh; tbvh.start();
+	for (int k = 0; k < NR; ++k) bvh.Init(BENCHMARK_STOL);
+	tbvh.stop();
+
+	Timer trefit; trefit.start();
+	for (int k = 0; k < NR; ++k) bvh.Refit();
+	trefit.stop();
+
+	cerr << "  octree build        : " << tot.GetTime() / NR << " s" << endl;
+	cerr << "  BVH build           : " << tbvh.GetTime() / NR << " s" << endl;
+	cerr << "  BVH refit           : " << trefit.GetTime() / NR << " s" << endl;
+
+	// ray-cast queries
+	size_t ncand_ot = 0, ncand_bvh = 0;
+	Timer tqot; tqot.start();
+	for (int i = 0; i < NP; ++i)
+	{
+		set<int> sel;
+		ot.FindCandidateSurfaceElements(r[i], n[i], sel, BENCHMARK_SRAD);
+		ncand_ot += sel.size();
+	}
+	tqot.stop();
+
+	Timer tqbvh; tqbvh.start();
+	for (int i = 0; i < NP; ++i)
+	{
+		set<int> sel;
+		bvh.FindCandidateSurfaceElements(r[i], n[i], sel, BENCHMARK_SRAD);
+		ncand_bvh += sel.size();
+	}
+	tqbvh.stop();
+
+	vector< vector<int> > selb;
+	Timer tqbatch; tqbatch.start();
+	bvh.FindCandidateSurfaceElements(r, n, selb, BENCHMARK_SRAD);
+	tqbatch.stop();
+
+	cerr << "  octree ray queries  : " << tqot.GetTime() << " s (" << (double)ncand_ot / NP << " candidates/query)" << endl;
+	cerr << "  BVH ray queries     : " << tqbvh.GetTime() << " s (" << (double)ncand_bvh / NP << " candidates/query)" << endl;
+	cerr << "  BVH batched queries : " << tqbatch.GetTime() << " s" << endl;
+
+	// closest-node queries
+	FENNQuery nnq(&ms);
+	nnq.Init();
+	vector<int> nodes_nnq(NP), nodes_bvh;
+	Timer tnnq; tnnq.start();
+	for (int i = 0; i < NP; ++i) nodes_nnq[i] = nnq.Find(r[i]);
+	tnnq.stop();
+
+	Timer tcbvh; tcbvh.start();
+	bvh.FindClosestNodes(r, nodes_bvh);
+	tcbvh.stop();
+
+	int nnode_diff = 0;
+	for (int i = 0; i < NP; ++i)
+	{
+		double d1 = (ms.Node(nodes_nnq[i]).m_rt - r[i]).norm2();
+		double d2 = (ms.Node(nodes_bvh[i]).m_rt - r[i]).norm2();
+		if (d1 != d2) nnode_diff++;
+	}
+
+	cerr << "  NN-query closest    : " << tnnq.GetTime() << " s" << endl;
+	cerr << "  BVH closest (batch) : " << tcbvh.GetTime() << " s" << endl;
+	cerr << "  closest mismatches  : " << nnode_diff << endl;
+
+	// compare the normal projections
+	FENormalProjection npo(ms), npb(ms);
+	npo.SetTolerance(BENCHMARK_STOL); npo.SetSearchRadius(BENCHMARK_SRAD);
+	npb.SetTolerance(BENCHMARK_STOL); npb.SetSearchRadius(BENCHMARK_SRAD);
+	npb.UseBVH(true);
+	npo.Init();
+	npb.Init();
+	int nproj_diff = 0, nproj = 0;
+	for (int i = 0; i < NP; ++i)
+	{
+		double rso[2] = { 0, 0 }, rsb[2] = { 0, 0 };
+		FESurfaceElement* peo = npo.Project(r[i], n[i], rso);
+		FESurfaceElement* peb = npb.Project(r[i], n[i], rsb);
+		if (peo) nproj++;
+		if (peo != peb) nproj_diff++;
+	}
+	cerr << "  projections found   : " << nproj << endl;
+	cerr << "  projection mismatches : " << nproj_diff << endl;
+}
+
+//-----------------------------------------------------------------------------
+bool FEContactSearchBenchmark::Run()
+{
+	FEModel& fem = *GetFEModel();
+
+	int NC = fem.SurfacePairConstraints();
+	if (NC == 0)
+	{
+		cerr << "This model has no contact interfaces.\nBenchmark aborted.\n\n";
+		return false;
+	}
+
+	for (int i = 0; i < NC; ++i)
+	{
+		FESurfacePairConstraint* pc = fem.SurfacePairConstraint(i);
+		FESurface* ss = pc->GetPrimarySurface();
+		FESurface* ms = pc->GetSecondarySurface();
+		if ((ss == nullptr) || (ms == nullptr) || (ms->Elements() == 0)) continue;
+
+		cerr << "Contact interface " << i + 1;
+		if (pc->GetName().empty() == false) cerr << " (" << pc->GetName() << ")";
+		cerr << ":" << endl;
+		benchmark_surface_pair(*ss, *ms);
+	}
+
+	return true;
+}
@@ -0,0 +1,180 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEMathExpressionTest.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <FECore/MathObject.h>
+#include <FECore/MCompiledExpression.h>
+#include <FECore/FEMesh.h>
+#include <iostream>
+#include <cmath>
+using namespace std;
+
+// nr of time values at which the expressions are evaluated
+#define EXPR_TEST_TIMES		4
+
+//-----------------------------------------------------------------------------
+FEMathExpressionTest::FEMathExpressionTest(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FEMathExpressionTest::Init(const char* sz)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	Logfile& log = fem.GetLogFile();
+	log.SetMode(Logfile::MODE::LOG_FILE);
+
+	// do the FE initialization
+	return fem.Init();
+}
+
+//-----------------------------------------------------------------------------
+// An expression whose evaluation needs more stack than the fixed-size buffer.
+static string deep_expression(int levels)
+{
+	const char* szvar[] = { "X", "Y", "Z", "t" };
+	string s;
+	for (int i = 0; i < levels; ++i) s += string(szvar[i % 4]) + "+(";
+	s += "1";
+	for (int i = 0; i < levels; ++i) s += ")";
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+static bool test_expression(const string& expr, const vector<double>& var, int npoints)
+{
+	MSimpleExpression e;
+	e.AddVariable("X");
+	e.AddVariable("Y");
+	e.AddVariable("Z");
+	e.AddVariable("t");
+	if ((e.Create(expr, true) == false) || (e.Variables() != 4))
+	{
+		cerr << "  Failed parsing expression" << endl;
+		return false;
+	}
+
+	MCompiledExpression code;
+	if (code.Compile(e) == false)
+	{
+		cerr << "  Failed compiling expression" << endl;
+		return false;
+	}
+	cerr << "  instructions : " << code.Size() << (code.IsConst() ? " (constant)" : "") << endl;
+
+	// evaluate all points at once
+	vector<double> batch(npoints);
+	code.value(npoints, var.data(), 4, batch.data());
+
+	double maxDiff = 0.0;
+	int nerr = 0;
+	vector<double> v(4);
+	for (int i = 0; i < npoints; ++i)
+	{
+		for (int k = 0; k < 4; ++k) v[k] = var[4 * i + k];
+
+		double a = e.value_s(v);
+		double b = code.value(v.data());
+		double c = batch[i];
+
+		// both evaluators must agree on values that are not finite
+		if (isfinite(a) == false)
+		{
+			if ((isfinite(b) == true) || (isfinite(c) == true)) nerr++;
+			continue;
+		}
+
+		double tol = 1e-12 * (1.0 + fabs(a));
+		double d = fmax(fabs(a - b), fabs(a - c));
+		if ((d > tol) || (isfinite(b) == false) || (isfinite(c) == false)) nerr++;
+		if (d / (1.0 + fabs(a)) > maxDiff) maxDiff = d / (1.0 + fabs(a));
+	}
+
+	cerr << "  max difference : " << maxDiff << endl;
+	cerr << "  mismatches : " << nerr << endl;
+
+	return (nerr == 0);
+}
+
+//-----------------------------------------------------------------------------
+bool FEMathExpressionTest::Run()
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+	FEMesh& mesh = fem.GetMesh();
+	if (mesh.Nodes() == 0) return false;
+
+	// the variable values (X, Y, Z, t) of all points. The points are the nodes of
+	// the model at a few different times.
+	const int NN = mesh.Nodes();
+	const int npoints = NN * EXPR_TEST_TIMES;
+	vector<double> var(4 * npoints);
+	for (int n = 0; n < EXPR_TEST_TIMES; ++n)
+	{
+		double t = (double)n / (EXPR_TEST_TIMES - 1);
+		for (int i = 0; i < NN; ++i)
+		{
+			vec3d r = mesh.Node(i).m_r0;
+			double* v = &var[4 * (n * NN + i)];
+			v[0] = r.x;
+			v[1] = r.y;
+			v[2] = r.z;
+			v[3] = t;
+		}
+	}
+
+	vector<string> expressions = {
+		"X + Y*Z - t",
+		"2*X^2 - 3*Y^3 + Z/(1 + t)",
+		"-X*(Y - 2)/(Z + 3) - (t - X)/Y",
+		"(X + 1)^(Y + 0.5) + X^t",
+		"sin(X)*cos(Y) + exp(-t*Z)",
+		"sqrt(X^2 + Y^2 + Z^2 + 1)",
+		"ln(X + 2) + log(Y + 3) + tanh(Z*t)",
+		"abs(X - Y) + H(Z - 0.5) + sgn(t - 0.5)",
+		"atan2(Y - 0.5, X + 0.1) + pow(Z + 2, t) + mod(X + 7, 3)",
+		"max(X, Y, Z) - min(X, t) + avg(X, Y, Z, t)",
+		"2*pi*e + 3/4 - sqrt(2)*cos(pi/3)",
+		"X*(2*pi - 1) + sin(pi/6)*Y",
+		deep_expression(2 * MCompiledExpression::MAX_STACK)
+	};
+
+	bool bok = true;
+	for (const string& expr : expressions)
+	{
+		cerr << "Expression " << (expr.size() > 60 ? expr.substr(0, 57) + "..." : expr) << ":" << endl;
+		bool b = test_expression(expr, var, npoints);
+		cerr << "  " << (b ? "passed" : "FAILED") << endl;
+		if (b == false) bok = false;
+	}
+
+	return bok;
+}
@@ -0,0 +1,254 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEPlotEncodingTest.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <FEBioPlot/PltArchive.h>
+#include <FEBioPlot/PltFieldEncoder.h>
+#include <FECore/FEMesh.h>
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+using namespace std;
+
+// nr of states that are written for each encoding
+#define ENCODING_TEST_STATES	25
+
+// the state in which a value is written that cannot be quantized
+#define ENCODING_TEST_OUTLIER	7
+
+// chunk IDs of the test file
+#define ENCODING_TEST_ROOT		0x01
+#define ENCODING_TEST_STATE		0x02
+
+//-----------------------------------------------------------------------------
+FEPlotEncodingTest::FEPlotEncodingTest(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FEPlotEncodingTest::Init(const char* sz)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	Logfile& log = fem.GetLogFile();
+	log.SetMode(Logfile::MODE::LOG_FILE);
+
+	// do the FE initialization
+	return fem.Init();
+}
+
+//-----------------------------------------------------------------------------
+// The data of a state. Region 0 contains a vector for each node, region 1 a
+// scalar for each node.
+static void state_data(FEMesh& mesh, int nstate, vector<float>& a, vector<float>& b)
+{
+	int N = mesh.Nodes();
+	double t = 0.1 * nstate;
+	a.resize(3 * N);
+	b.resize(N);
+	for (int i = 0; i < N; ++i)
+	{
+		vec3d r = mesh.Node(i).m_r0;
+		a[3 * i    ] = (float)(t * r.x + 0.01 * sin(t + i));
+		a[3 * i + 1] = (float)(t * r.y - 0.01 * cos(t + i));
+		a[3 * i + 2] = (float)(t * t * r.z);
+		b[i] = (float)(1.0 + t * r.norm());
+	}
+
+	if (nstate == ENCODING_TEST_OUTLIER) a[0] = 1e30f;
+}
+
+//-----------------------------------------------------------------------------
+// read the data of all the states from the test file
+static bool read_states(const char* szfile, vector< vector< vector<unsigned char> > >& states)
+{
+	PltArchive ar;
+	if (ar.Open(szfile) == false) return false;
+
+	if ((ar.OpenChunk() != IO_OK) || (ar.GetChunkID() != ENCODING_TEST_ROOT)) return false;
+	while (ar.OpenChunk() == IO_OK)
+	{
+		if (ar.GetChunkID() != ENCODING_TEST_STATE) return false;
+		vector< vector<unsigned char> > regions;
+		while (ar.OpenChunk() == IO_OK)
+		{
+			unsigned int nid = ar.GetChunkID();
+			if (nid >= regions.size()) regions.resize(nid + 1);
+			vector<unsigned char>& buf = regions[nid];
+			buf.resize(ar.GetChunkSize());
+			if (buf.empty() == false)
+			{
+				if (ar.read((char*)buf.data(), (int)buf.size()) != IO_OK) return false;
+			}
+			ar.CloseChunk();
+		}
+		states.push_back(regions);
+		ar.CloseChunk();
+	}
+	ar.Close();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+static bool test_encoding(FEMesh& mesh, const char* szfile, int encoding, float maxError, const vector<int>& fullItems)
+{
+	const int NS = ENCODING_TEST_STATES;
+
+	PltFieldEncoder enc(encoding, maxError);
+	if (encoding == PltFieldEncoder::FARFIELD) enc.SetFullPrecisionItems(fullItems);
+
+	// write the encoded states
+	PltArchive ar;
+	if (ar.Create(szfile) == false)
+	{
+		cerr << "  Failed creating file " << szfile << endl;
+		return false;
+	}
+
+	size_t rawSize = 0, encSize = 0;
+	vector<float> a, b;
+	vector<unsigned char> bufa, bufb;
+	ar.BeginChunk(ENCODING_TEST_ROOT);
+	for (int n = 0; n < NS; ++n)
+	{
+		state_data(mesh, n, a, b);
+		enc.Encode(0, a, bufa);
+		enc.Encode(1, b, bufb);
+		rawSize += (a.size() + b.size()) * sizeof(float);
+		encSize += bufa.size() + bufb.size();
+
+		ar.BeginChunk(ENCODING_TEST_STATE);
+		{
+			ar.WriteChunk(0, bufa);
+			ar.WriteChunk(1, bufb);
+		}
+		ar.EndChunk();
+	}
+	ar.EndChunk();
+	ar.Close();
+
+	// read them back
+	vector< vector< vector<unsigned char> > > states;
+	if ((read_states(szfile, states) == false) || (states.size() != NS))
+	{
+		cerr << "  Failed reading file " << szfile << endl;
+		return false;
+	}
+
+	// decode and compare
+	bool lossless = ((encoding == PltFieldEncoder::NONE) || (encoding == PltFieldEncoder::DELTA));
+	// (the encoder applies the full precision items to each region)
+	vector<bool> full(3 * mesh.Nodes(), false);
+	if (encoding == PltFieldEncoder::FARFIELD)
+	{
+		for (int i : fullItems) full[i] = true;
+	}
+
+	double maxDiff = 0.0;
+	int nerr = 0;
+	vector<float> preva, prevb, da, db;
+	for (int n = 0; n < NS; ++n)
+	{
+		const vector<unsigned char>& ea = states[n][0];
+		const vector<unsigned char>& eb = states[n][1];
+		if ((PltFieldEncoder::Decode(ea.data(), ea.size(), preva, fullItems, da) == false) ||
+			(PltFieldEncoder::Decode(eb.data(), eb.size(), prevb, fullItems, db) == false))
+		{
+			cerr << "  Failed decoding state " << n + 1 << endl;
+			return false;
+		}
+
+		state_data(mesh, n, a, b);
+		if ((da.size() != a.size()) || (db.size() != b.size()))
+		{
+			cerr << "  Size mismatch in state " << n + 1 << endl;
+			return false;
+		}
+
+		for (int k = 0; k < 2; ++k)
+		{
+			const vector<float>& x = (k == 0 ? a : b);
+			const vector<float>& y = (k == 0 ? da : db);
+			for (size_t i = 0; i < x.size(); ++i)
+			{
+				double d = fabs((double)x[i] - (double)y[i]);
+				bool exact = lossless || full[i] || (fabs(x[i]) > 1e20f);
+				double tol = (exact ? 0.0 : maxError + 1e-6 * fabs(x[i]));
+				if (d > tol) nerr++;
+				if (!exact && (d > maxDiff)) maxDiff = d;
+			}
+		}
+
+		preva = da;
+		prevb = db;
+	}
+
+	cerr << "  max error  : " << maxDiff << " (bound " << maxError << ")" << endl;
+	cerr << "  data size  : " << encSize << " bytes (" << 100.0 * encSize / rawSize << "% of raw)" << endl;
+	cerr << "  mismatches : " << nerr << endl;
+
+	return (nerr == 0);
+}
+
+//-----------------------------------------------------------------------------
+bool FEPlotEncodingTest::Run()
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+	FEMesh& mesh = fem.GetMesh();
+	if (mesh.Nodes() == 0) return false;
+
+	// the test file is written next to the plot file
+	string fileName = fem.GetPlotFileName() + ".enctest";
+
+	// the error bound is relative to the model size
+	FEBoundingBox box = mesh.GetBoundingBox();
+	float maxError = (float)(1e-4 * box.radius());
+
+	// the farfield encoding stores every tenth node with full precision
+	vector<int> fullItems;
+	for (int i = 0; i < mesh.Nodes(); i += 10)
+	{
+		for (int k = 0; k < 3; ++k) fullItems.push_back(3 * i + k);
+	}
+
+	const char* encodings[] = { "none", "delta", "quantize", "delta_quantize", "farfield" };
+	bool bok = true;
+	for (const char* sz : encodings)
+	{
+		cerr << "Encoding " << sz << ":" << endl;
+		bool b = test_encoding(mesh, fileName.c_str(), PltFieldEncoder::FromString(sz), maxError, fullItems);
+		cerr << "  " << (b ? "passed" : "FAILED") << endl;
+		if (b == false) bok = false;
+	}
+	remove(fileName.c_str());
+
+	return bok;
+}
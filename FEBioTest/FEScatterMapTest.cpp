@@ -0,0 +1,217 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEScatterMapTest.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FENewtonSolver.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/CompactUnSymmMatrix.h>
+#include <iostream>
+#include <cmath>
+using namespace std;
+
+// tolerance on the relative difference of the matrix values. The scatter maps
+// add the same values to the same entries, but the order of the additions may 
+// differ when the domains are assembled in parallel.
+#define SCATTER_TEST_TOL	1e-12
+
+// value that marks the scatter maps, to see if they were kept
+#define SCATTER_TEST_TAG	-12345
+
+//-----------------------------------------------------------------------------
+FEScatterMapTest::FEScatterMapTest(FEModel* pfem) : FECoreTask(pfem)
+{
+	m_bdone = false;
+	m_bok = false;
+}
+
+//-----------------------------------------------------------------------------
+bool FEScatterMapTest::Init(const char* sz)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	Logfile& log = fem.GetLogFile();
+	log.SetMode(Logfile::MODE::LOG_FILE);
+
+	// do the FE initialization
+	return fem.Init();
+}
+
+//-----------------------------------------------------------------------------
+static bool scatter_map_test_cb(FEModel* fem, unsigned int when, void* pd)
+{
+	FEScatterMapTest* test = (FEScatterMapTest*)pd;
+	return test->Compare();
+}
+
+//-----------------------------------------------------------------------------
+bool FEScatterMapTest::Run()
+{
+	FEModel& fem = *GetFEModel();
+
+	fem.AddCallback(scatter_map_test_cb, CB_MATRIX_REFORM, (void*)this);
+
+	fem.BlockLog();
+	bool bret = fem.Solve();
+	fem.UnBlockLog();
+
+	if (m_bdone == false)
+	{
+		cerr << "the stiffness matrix was not reformed  FAILED" << endl;
+		return false;
+	}
+
+	return bret && m_bok;
+}
+
+//-----------------------------------------------------------------------------
+// global matrix that reports whether the scatter maps were built
+class ScatterMapTestMatrix : public FEGlobalMatrix
+{
+public:
+	ScatterMapTestMatrix(SparseMatrix* A) : FEGlobalMatrix(A, true) {}
+
+	bool HasScatterMaps() const { return (m_scatter.empty() == false); }
+
+	// Mark the maps by changing the LM vector of the first map. This only disables
+	// that map (the element is then assembled without it), so the values are unaffected.
+	void TagScatterMaps() { if (m_scatterLM.empty() == false) m_scatterLM[0] = SCATTER_TEST_TAG; }
+
+	bool IsTagged() const { return ((m_scatterLM.empty() == false) && (m_scatterLM[0] == SCATTER_TEST_TAG)); }
+};
+
+//-----------------------------------------------------------------------------
+// Assemble the solver's stiffness matrix into the sparse matrix A and return
+// a copy of its values. The solver's own matrix and rhs adjustment are restored.
+// The matrix is created twice, the second time with the same profile, in which 
+// case the scatter maps must be kept.
+static bool assemble(FENewtonSolver* ns, SparseMatrix* A, Matrix_Type mtype, bool bscatter, vector<double>& val, bool& bmaps)
+{
+	ScatterMapTestMatrix K(A);
+	K.SetScatterMaps(bscatter);
+	if (K.Create(ns->GetFEModel(), ns->m_neq, true) == false) return false;
+
+	K.TagScatterMaps();
+	K.Clear();
+	if (K.Create(ns->GetFEModel(), ns->m_neq, false) == false) return false;
+	bool bkept = K.IsTagged();
+	K.Zero();
+
+	FEGlobalMatrix* K0 = ns->m_pK;
+	int msymm = ns->m_msymm;
+	vector<double> Fd(ns->m_Fd);
+
+	ns->m_pK = &K;
+	ns->m_msymm = mtype;
+	bool bret = ns->StiffnessMatrix();
+	ns->m_pK = K0;
+	ns->m_msymm = msymm;
+	ns->m_Fd = Fd;
+
+	bmaps = K.HasScatterMaps() && bkept;
+	val.assign(A->Values(), A->Values() + A->NonZeroes());
+	return bret;
+}
+
+//-----------------------------------------------------------------------------
+bool FEScatterMapTest::Compare()
+{
+	// only compare at the first reformation
+	if (m_bdone) return true;
+	m_bdone = true;
+	m_bok = false;
+
+	FEModel* fem = GetFEModel();
+	FEAnalysis* step = fem->GetCurrentStep();
+	FENewtonSolver* ns = (step ? dynamic_cast<FENewtonSolver*>(step->GetFESolver()) : nullptr);
+	if (ns == nullptr)
+	{
+		cerr << "the model does not use a Newton solver  FAILED" << endl;
+		return true;
+	}
+
+	cerr << "domains     : " << fem->GetMesh().Domains() << ", neq = " << ns->m_neq << endl;
+
+	bool bok = true;
+	for (int n = 0; n < 3; ++n)
+	{
+		const char* szname = nullptr;
+		Matrix_Type mtype = REAL_SYMMETRIC;
+		SparseMatrix* A[2] = { nullptr, nullptr };
+		for (int k = 0; k < 2; ++k)
+		{
+			switch (n)
+			{
+			case 0: szname = "symmetric  "; mtype = REAL_SYMMETRIC  ; A[k] = new CompactSymmMatrix(1); break;
+			case 1: szname = "unsymm. CRS"; mtype = REAL_UNSYMMETRIC; A[k] = new CRSSparseMatrix(1); break;
+			case 2: szname = "unsymm. CCS"; mtype = REAL_UNSYMMETRIC; A[k] = new CCSSparseMatrix(0); break;
+			}
+		}
+
+		// the global matrices delete the sparse matrices
+		vector<double> v0, v1;
+		bool bmaps0 = false, bmaps1 = false;
+		bool b0 = assemble(ns, A[0], mtype, false, v0, bmaps0);
+		bool b1 = assemble(ns, A[1], mtype, true , v1, bmaps1);
+		if ((b0 == false) || (b1 == false))
+		{
+			cerr << szname << " : assembly failed  FAILED" << endl;
+			bok = false;
+			continue;
+		}
+
+		if (v0.size() != v1.size())
+		{
+			cerr << szname << " : nonzeroes differ (" << v0.size() << ", " << v1.size() << ")  FAILED" << endl;
+			bok = false;
+			continue;
+		}
+
+		double vmax = 0.0, dmax = 0.0;
+		for (size_t i = 0; i < v0.size(); ++i)
+		{
+			if (fabs(v0[i]) > vmax) vmax = fabs(v0[i]);
+			double d = fabs(v1[i] - v0[i]);
+			if (d > dmax) dmax = d;
+		}
+		double err = (vmax > 0.0 ? dmax / vmax : dmax);
+
+		// the test is meaningless if the maps were not used (or not kept)
+		bool bpass = bmaps1 && (vmax > 0.0) && (err <= SCATTER_TEST_TOL);
+		cerr << szname << " : nonzeroes = " << v0.size() << ", scatter maps built and kept = " << (bmaps1 ? "yes" : "no") << ", difference = " << err << (bpass ? "  passed" : "  FAILED") << endl;
+		if (bpass == false) bok = false;
+	}
+
+	m_bok = bok;
+	return true;
+}
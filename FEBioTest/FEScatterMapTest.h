@@ -0,0 +1,60 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <FECore/FECoreTask.h>
+
+//-----------------------------------------------------------------------------
+//! This task checks the assembly with scatter maps (see the solver's
+//! cache_scatter_maps parameter). At the first stiffness reformation of the 
+//! model, the global stiffness matrix is assembled twice for each of the 
+//! symmetric and unsymmetric matrix formats, once with and once without 
+//! scatter maps. The values of the two matrices must be identical, and the
+//! maps must be kept when the matrix is created again with the same profile. Run this
+//! on a model with solid and shell domains that share nodes to cover the 
+//! element matrices that only use part of the domain's LM vectors.
+class FEScatterMapTest : public FECoreTask
+{
+public:
+	// constructor
+	FEScatterMapTest(FEModel* pfem);
+
+	// initialize the model
+	bool Init(const char* sz) override;
+
+	// run the test
+	bool Run() override;
+
+	// compare the assembled matrices
+	bool Compare();
+
+private:
+	bool	m_bdone;	//!< set after the matrices were compared
+	bool	m_bok;		//!< result of the comparison
+};
@@ -0,0 +1,263 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FESupernodalSolverTest.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioLib/Logfile.h>
+#include <FECore/LinearSolver.h>
+#include <FECore/SparseMatrix.h>
+#include <FECore/matrix.h>
+#include <iostream>
+#include <cmath>
+using namespace std;
+
+// nr of lattice nodes in each direction
+#define SOLVER_TEST_SIZE	8
+
+// tolerance on the relative residual and relative solution difference
+#define SOLVER_TEST_TOL		1e-10
+
+//-----------------------------------------------------------------------------
+FESupernodalSolverTest::FESupernodalSolverTest(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FESupernodalSolverTest::Init(const char* sz)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	Logfile& log = fem.GetLogFile();
+	log.SetMode(Logfile::MODE::LOG_FILE);
+
+	// do the FE initialization
+	return fem.Init();
+}
+
+//-----------------------------------------------------------------------------
+// A cubic lattice of nodes with three degrees of freedom, connected by springs
+// along the edges and face diagonals of the lattice cells. When anchored, the 
+// nodes of the bottom layer are tied to the ground. When skew is not zero, an
+// antisymmetric part is added to the spring stiffness.
+class SpringLattice
+{
+public:
+	SpringLattice(int n, bool anchored, double skew) : m_n(n), m_anchored(anchored), m_skew(skew)
+	{
+		int d[6][3] = { {1,0,0},{0,1,0},{0,0,1},{1,1,0},{0,1,1},{1,0,1} };
+		for (int k = 0; k < n; ++k)
+			for (int j = 0; j < n; ++j)
+				for (int i = 0; i < n; ++i)
+					for (int l = 0; l < 6; ++l)
+					{
+						int i1 = i + d[l][0], j1 = j + d[l][1], k1 = k + d[l][2];
+						if ((i1 < n) && (j1 < n) && (k1 < n))
+						{
+							vector<int> lm(6);
+							int a = node(i, j, k), b = node(i1, j1, k1);
+							for (int m = 0; m < 3; ++m) { lm[m] = 3 * a + m; lm[3 + m] = 3 * b + m; }
+							m_LM.push_back(lm);
+							m_dir.push_back(vec3d(d[l][0], d[l][1], d[l][2]));
+						}
+					}
+	}
+
+	int Equations() const { return 3 * m_n*m_n*m_n; }
+
+	void Assemble(SparseMatrix* K)
+	{
+		SparseMatrixProfile MP(Equations(), Equations());
+		MP.CreateDiagonal();
+		MP.UpdateProfile(m_LM, (int)m_LM.size());
+		K->Create(MP);
+		K->Zero();
+
+		for (size_t n = 0; n < m_LM.size(); ++n)
+		{
+			vec3d e = m_dir[n]; e.unit();
+			double k[3][3];
+			for (int i = 0; i < 3; ++i)
+				for (int j = 0; j < 3; ++j)
+				{
+					k[i][j] = e(i)*e(j) + (i == j ? 0.1 : 0.0);
+					if (i < j) k[i][j] += m_skew*(1.0 + (n % 5));
+					if (i > j) k[i][j] -= m_skew*(1.0 + (n % 5));
+				}
+
+			matrix ke(6, 6);
+			for (int i = 0; i < 3; ++i)
+				for (int j = 0; j < 3; ++j)
+				{
+					ke[i][j] = ke[3 + i][3 + j] = k[i][j];
+					ke[i][3 + j] = ke[3 + i][j] = -k[i][j];
+				}
+			K->Assemble(ke, m_LM[n]);
+		}
+
+		if (m_anchored)
+		{
+			matrix kd(3, 3); kd.zero();
+			for (int m = 0; m < 3; ++m) kd[m][m] = 1.0;
+			vector<int> lm(3);
+			for (int j = 0; j < m_n; ++j)
+				for (int i = 0; i < m_n; ++i)
+				{
+					for (int m = 0; m < 3; ++m) lm[m] = 3 * node(i, j, 0) + m;
+					K->Assemble(kd, lm);
+				}
+		}
+	}
+
+	void Load(vector<double>& b)
+	{
+		b.assign(Equations(), 0.0);
+		for (int i = 0; i < Equations(); ++i) b[i] = sin(0.37*i) + ((i % 3) == 2 ? 1.0 : 0.0);
+	}
+
+private:
+	int node(int i, int j, int k) const { return i + m_n*(j + m_n*k); }
+
+private:
+	int		m_n;
+	bool	m_anchored;
+	double	m_skew;
+	vector< vector<int> >	m_LM;
+	vector<vec3d>			m_dir;
+};
+
+//-----------------------------------------------------------------------------
+static double norm(const vector<double>& a)
+{
+	double s = 0.0;
+	for (size_t i = 0; i < a.size(); ++i) s += a[i] * a[i];
+	return sqrt(s);
+}
+
+//-----------------------------------------------------------------------------
+// Factor and solve the lattice system with the given solver. The matrix stays
+// owned by the caller so that it can be used to evaluate the residual. 
+static bool solve_lattice(FEModel* fem, const char* szsolver, Matrix_Type mtype, SpringLattice& lattice, SparseMatrix*& K, vector<double>& x, vector<double>& b)
+{
+	K = nullptr;
+	LinearSolver* ls = fecore_new<LinearSolver>(szsolver, fem);
+	if (ls == nullptr) return false;
+
+	K = ls->CreateSparseMatrix(mtype);
+	if (K == nullptr) { delete ls; return false; }
+
+	lattice.Assemble(K);
+	lattice.Load(b);
+	x.assign(b.size(), 0.0);
+
+	bool bok = ls->PreProcess() && ls->Factor() && ls->BackSolve(x, b);
+	ls->Destroy();
+	delete ls;
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+// relative residual |K*x - b|/|b|
+static double residual(SparseMatrix* K, vector<double>& x, const vector<double>& b)
+{
+	vector<double> r(b.size(), 0.0);
+	K->mult_vector(&x[0], &r[0]);
+	for (size_t i = 0; i < r.size(); ++i) r[i] -= b[i];
+	return norm(r) / norm(b);
+}
+
+//-----------------------------------------------------------------------------
+bool FESupernodalSolverTest::Run()
+{
+	FEModel* fem = GetFEModel();
+	bool bok = true;
+
+	// symmetric system: compare with the skyline solver
+	{
+		SpringLattice lattice(SOLVER_TEST_SIZE, true, 0.0);
+		SparseMatrix* Ks = nullptr, *Kn = nullptr;
+		vector<double> xs, xn, b;
+		bool bsky = solve_lattice(fem, "skyline", REAL_SYMMETRIC, lattice, Ks, xs, b);
+		bool bsn = solve_lattice(fem, "supernodal", REAL_SYMMETRIC, lattice, Kn, xn, b);
+		if (bsky && bsn)
+		{
+			// The skyline factor overwrites its matrix, so both residuals are 
+			// evaluated with the supernodal solver's matrix.
+			double rn = residual(Kn, xn, b);
+			double rs = residual(Kn, xs, b);
+			vector<double> dx(xn);
+			for (size_t i = 0; i < dx.size(); ++i) dx[i] -= xs[i];
+			double ex = norm(dx) / norm(xs);
+
+			bool bpass = (rn < SOLVER_TEST_TOL) && (ex < SOLVER_TEST_TOL);
+			cerr << "symmetric   : neq = " << b.size() << ", residual = " << rn << " (skyline: " << rs << "), difference = " << ex << (bpass ? "  passed" : "  FAILED") << endl;
+			if (bpass == false) bok = false;
+		}
+		else
+		{
+			cerr << "symmetric   : solve failed  FAILED" << endl;
+			bok = false;
+		}
+		delete Ks;
+		delete Kn;
+	}
+
+	// unsymmetric system (no skyline equivalent)
+	{
+		SpringLattice lattice(SOLVER_TEST_SIZE, true, 0.02);
+		SparseMatrix* Kn = nullptr;
+		vector<double> xn, b;
+		if (solve_lattice(fem, "supernodal", REAL_UNSYMMETRIC, lattice, Kn, xn, b))
+		{
+			double rn = residual(Kn, xn, b);
+			bool bpass = (rn < SOLVER_TEST_TOL);
+			cerr << "unsymmetric : neq = " << b.size() << ", residual = " << rn << (bpass ? "  passed" : "  FAILED") << endl;
+			if (bpass == false) bok = false;
+		}
+		else
+		{
+			cerr << "unsymmetric : solve failed  FAILED" << endl;
+			bok = false;
+		}
+		delete Kn;
+	}
+
+	// singular system: the rigid body modes must be detected
+	{
+		SpringLattice lattice(SOLVER_TEST_SIZE, false, 0.0);
+		SparseMatrix* Kn = nullptr;
+		vector<double> xn, b;
+		bool bfail = (solve_lattice(fem, "supernodal", REAL_SYMMETRIC, lattice, Kn, xn, b) == false) && (Kn != nullptr);
+		cerr << "singular    : " << (bfail ? "factorization failed  passed" : "factorization succeeded  FAILED") << endl;
+		if (bfail == false) bok = false;
+		delete Kn;
+	}
+
+	return bok;
+}
@@ -45,6 +45,76 @@ bool FEBioGeometrySection::ReadElement(XMLTag &tag, FEElement& el, int nid)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//! Reads the nodes of a Nodes section and adds them to the mesh. 
+//! Returns the number of nodes that were read.
+int FEBioGeometrySection::ReadNodes(XMLTag& tag)
+{
+	FEModel& fem = *GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+	int N0 = mesh.Nodes();
+
+	// get the largest nodal ID
+	// (It is assumed that nodes are sorted by ID so the last node should have the largest ID)
+	int max_id = 0;
+	if (N0 > 0) max_id = mesh.Node(N0 - 1).GetID();
+
+	// try to read all nodes in one pass
+	vector<int> nodeId;
+	vector<double> r;
+	if (tag.readBlock("node", nodeId, r, 3))
+	{
+		int nodes = (int)nodeId.size();
+		mesh.AddNodes(nodes);
+		for (int i = 0; i < nodes; ++i)
+		{
+			FENode& node = mesh.Node(N0 + i);
+			node.m_r0 = vec3d(r[3 * i], r[3 * i + 1], r[3 * i + 2]);
+			node.m_rt = node.m_r0;
+
+			// Make sure the ID is valid
+			int nid = nodeId[i];
+			if (nid <= max_id) throw XMLReader::InvalidAttributeValue(tag, "id");
+
+			// set the ID
+			node.SetID(nid);
+			max_id = nid;
+		}
+		return nodes;
+	}
+
+	// first we need to figure out how many nodes there are
+	int nodes = tag.children();
+
+	// resize node's array
+	mesh.AddNodes(nodes);
+
+	// read nodal coordinates
+	++tag;
+	for (int i = 0; i<nodes; ++i)
+	{
+		FENode& node = mesh.Node(N0 + i);
+		value(tag, node.m_r0);
+		node.m_rt = node.m_r0;
+
+		// get the nodal ID
+		int nid = -1;
+		tag.AttributeValue("id", nid);
+
+		// Make sure it is valid
+		if (nid <= max_id) throw XMLReader::InvalidAttributeValue(tag, "id");
+
+		// set the ID
+		node.SetID(nid);
+		max_id = nid;
+
+		// go on to the next node
+		++tag;
+	}
+
+	return nodes;
+}
+
 //=============================================================================
 // FEBioGeometrySection1x
 //============================================================================= 
@@ -84,15 +154,6 @@ void FEBioGeometrySection1x::ParseNodeSection(XMLTag& tag)
 	FEMesh& mesh = fem.GetMesh();
 	int N0 = mesh.Nodes();
 
-	// get the largest nodal ID
-	// (It is assumed that nodes are sorted by ID so the last node should have the largest ID)
-	int max_id = 0;
-	if (N0 > 0) max_id = mesh.Node(N0 - 1).GetID();
-
-	// first we need to figure out how many nodes there are
-	XMLTag t(tag);
-	int nodes = tag.children();
-
 	// see if this list defines a set
 	const char* szl = tag.AttributeValue("set", true);
 	FENodeSet* ps = 0;
@@ -104,31 +165,8 @@ void FEBioGeometrySection1x::ParseNodeSection(XMLTag& tag)
 		mesh.AddNodeSet(ps);
 	}
 
-	// resize node's array
-	mesh.AddNodes(nodes);
-
-	// read nodal coordinates
-	++tag;
-	for (int i = 0; i<nodes; ++i)
-	{
-		FENode& node = mesh.Node(N0 + i);
-		value(tag, node.m_r0);
-		node.m_rt = node.m_r0;
-
-		// get the nodal ID
-		int nid = -1;
-		tag.AttributeValue("id", nid);
-
-		// Make sure it is valid
-		if (nid <= max_id) throw XMLReader::InvalidAttributeValue(tag, "id");
-
-		// set the ID
-		node.SetID(nid);
-		max_id = nid;
-
-		// go on to the next node
-		++tag;
-	}
+	// read the nodes
+	int nodes = ReadNodes(tag);
 
 	// If a node set is defined add these nodes to the node-set
 	if (ps)
@@ -520,15 +558,6 @@ void FEBioGeometrySection2::ParseNodeSection(XMLTag& tag)
 	FEMesh& mesh = fem.GetMesh();
 	int N0 = mesh.Nodes();
 
-	// get the largest nodal ID
-	// (It is assumed that nodes are sorted by ID so the last node should have the largest ID)
-	int max_id = 0;
-	if (N0 > 0) max_id = mesh.Node(N0 - 1).GetID();
-
-	// first we need to figure out how many nodes there are
-	XMLTag t(tag);
-	int nodes = tag.children();
-
 	// see if this list defines a set
 	const char* szl = tag.AttributeValue("set", true);
 	FENodeSet* ps = 0;
@@ -540,31 +569,8 @@ void FEBioGeometrySection2::ParseNodeSection(XMLTag& tag)
 		mesh.AddNodeSet(ps);
 	}
 
-	// resize node's array
-	mesh.AddNodes(nodes);
-
-	// read nodal coordinates
-	++tag;
-	for (int i = 0; i<nodes; ++i)
-	{
-		FENode& node = mesh.Node(N0 + i);
-		value(tag, node.m_r0);
-		node.m_rt = node.m_r0;
-
-		// get the nodal ID
-		int nid = -1;
-		tag.AttributeValue("id", nid);
-
-		// Make sure it is valid
-		if (nid <= max_id) throw XMLReader::InvalidAttributeValue(tag, "id");
-
-		// set the ID
-		node.SetID(nid);
-		max_id = nid;
-
-		// go on to the next node
-		++tag;
-	}
+	// read the nodes
+	int nodes = ReadNodes(tag);
 
 	// If a node set is defined add these nodes to the node-set
 	if (ps)
@@ -617,8 +623,13 @@ void FEBioGeometrySection2::ParseElementSection(XMLTag& tag)
 	FEDomain& dom = *pdom;
 	dom.SetName(szname);
 
-	// count elements
-	int elems = tag.children();
+	// Try to read all element data in one pass, otherwise count the elements.
+	// (this moves the tag, so we need to copy the name)
+	string name = szname;
+	vector<int> elemId, enode;
+	int neln = FEElementLibrary::GetElementTraits(espec.etype)->m_neln;
+	bool bblock = tag.readBlock("elem", elemId, enode, neln);
+	int elems = (bblock ? (int)elemId.size() : tag.children());
 	assert(elems);
 
 	// add domain it to the mesh
@@ -628,35 +639,51 @@ void FEBioGeometrySection2::ParseElementSection(XMLTag& tag)
 
 	// for named domains, we'll also create an element set
 	FEElementSet* pg = 0;
-	if (szname)
+	if (!name.empty())
 	{
 		pg = new FEElementSet(&fem);
-		pg->SetName(szname);
+		pg->SetName(name);
 		mesh.AddElementSet(pg);
 	}
 
 	// read element data
-	++tag;
-	for (int i = 0; i<elems; ++i)
+	if (bblock)
 	{
-		if ((tag == "elem") == false) throw XMLReader::InvalidTag(tag);
+		for (int i = 0; i < elems; ++i)
+		{
+			int nid = elemId[i];
+			GetBuilder()->m_maxid = nid;
 
-		// get the element ID
-		int nid;
-		tag.AttributeValue("id", nid);
+			FEElement& el = dom.ElementRef(i);
+			assert(el.Nodes() == neln);
+			el.SetID(nid);
+			GetBuilder()->GlobalToLocalID(&enode[i * neln], neln, el.m_node);
+		}
+	}
+	else
+	{
+		++tag;
+		for (int i = 0; i<elems; ++i)
+		{
+			if ((tag == "elem") == false) throw XMLReader::InvalidTag(tag);
 
-		// Make sure element IDs increase
-		//		if (nid <= m_pim->m_maxid) throw XMLReader::InvalidAttributeValue(tag, "id");
+			// get the element ID
+			int nid;
+			tag.AttributeValue("id", nid);
 
-		// keep track of the largest element ID
-		// (which by assumption is the ID that was just read in)
-		GetBuilder()->m_maxid = nid;
+			// Make sure element IDs increase
+			//		if (nid <= m_pim->m_maxid) throw XMLReader::InvalidAttributeValue(tag, "id");
 
-		// read the element data
-		if (ReadElement(tag, dom.ElementRef(i), nid) == false) throw XMLReader::InvalidValue(tag);
+			// keep track of the largest element ID
+			// (which by assumption is the ID that was just read in)
+			GetBuilder()->m_maxid = nid;
 
-		// go to next tag
-		++tag;
+			// read the element data
+			if (ReadElement(tag, dom.ElementRef(i), nid) == false) throw XMLReader::InvalidValue(tag);
+
+			// go to next tag
+			++tag;
+		}
 	}
 
 	// create the element set
@@ -1175,15 +1202,6 @@ void FEBioGeometrySection25::ParseNodeSection(XMLTag& tag)
 	FEMesh& mesh = fem.GetMesh();
 	int N0 = mesh.Nodes();
 
-	// get the largest nodal ID
-	// (It is assumed that nodes are sorted by ID so the last node should have the largest ID)
-	int max_id = 0;
-	if (N0 > 0) max_id = mesh.Node(N0 - 1).GetID();
-
-	// first we need to figure out how many nodes there are
-	XMLTag t(tag);
-	int nodes = tag.children();
-
 	// see if this list defines a set
 	const char* szl = tag.AttributeValue("name", true);
 	FENodeSet* ps = 0;
@@ -1195,31 +1213,8 @@ void FEBioGeometrySection25::ParseNodeSection(XMLTag& tag)
 		mesh.AddNodeSet(ps);
 	}
 
-	// resize node's array
-	mesh.AddNodes(nodes);
-
-	// read nodal coordinates
-	++tag;
-	for (int i = 0; i<nodes; ++i)
-	{
-		FENode& node = mesh.Node(N0 + i);
-		value(tag, node.m_r0);
-		node.m_rt = node.m_r0;
-
-		// get the nodal ID
-		int nid = -1;
-		tag.AttributeValue("id", nid);
-
-		// Make sure it is valid
-		if (nid <= max_id) throw XMLReader::InvalidAttributeValue(tag, "id");
-
-		// set the ID
-		node.SetID(nid);
-		max_id = nid;
-
-		// go on to the next node
-		++tag;
-	}
+	// read the nodes
+	int nodes = ReadNodes(tag);
 
 	// If a node set is defined add these nodes to the node-set
 	if (ps)
@@ -1332,21 +1327,40 @@ void FEBioGeometrySection25::ParseElementSection(XMLTag& tag)
 	}
 
 	// count elements
-	vector<FEModelBuilder::ELEMENT> elemList; elemList.reserve(512000);
-	++tag;
-	do
+	vector<FEModelBuilder::ELEMENT> elemList;
+
+	// try to read all element data in one pass
+	vector<int> elemId, enode;
+	int neln = FEElementLibrary::GetElementTraits(espec.etype)->m_neln;
+	if (tag.readBlock("elem", elemId, enode, neln))
 	{
-		if ((tag == "elem") == false) throw XMLReader::InvalidTag(tag);
+		elemList.resize(elemId.size());
+		for (size_t i = 0; i < elemId.size(); ++i)
+		{
+			FEModelBuilder::ELEMENT& el = elemList[i];
+			el.nid = elemId[i];
+			el.nodes = neln;
+			for (int j = 0; j < neln; ++j) el.node[j] = enode[i * neln + j];
+		}
+	}
+	else
+	{
+		elemList.reserve(512000);
+		++tag;
+		do
+		{
+			if ((tag == "elem") == false) throw XMLReader::InvalidTag(tag);
 
-		// get the element ID
-		FEModelBuilder::ELEMENT el;
-		tag.AttributeValue("id", el.nid);
+			// get the element ID
+			FEModelBuilder::ELEMENT el;
+			tag.AttributeValue("id", el.nid);
 
-		el.nodes = tag.value(el.node, FEElement::MAX_NODES);
-		elemList.push_back(el);
-		++tag;
+			el.nodes = tag.value(el.node, FEElement::MAX_NODES);
+			elemList.push_back(el);
+			++tag;
+		}
+		while (!tag.isend());
 	}
-	while (!tag.isend());
 
 	int elems = (int) elemList.size();
 	assert(elems);
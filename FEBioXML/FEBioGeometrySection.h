@@ -39,6 +39,8 @@ public:
 
 protected:
 	bool ReadElement(XMLTag& tag, FEElement& el, int nid);
+
+	int ReadNodes(XMLTag& tag);
 };
 
 //-----------------------------------------------------------------------------
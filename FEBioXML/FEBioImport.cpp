@@ -169,6 +169,11 @@ FEBioImport::RepeatedPartList::RepeatedPartList(const std::string& name)
 	SetErrorString("An part list with name \"%s\" was already defined.", name.c_str());
 }
 
+FEBioImport::FailedLoadingMeshFile::FailedLoadingMeshFile(const std::string& err)
+{
+	SetErrorString("Failed loading mesh file: %s", err.c_str());
+}
+
 //-----------------------------------------------------------------------------
 FEBioImport::FEBioImport()
 {
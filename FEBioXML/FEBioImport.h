@@ -167,6 +167,12 @@ public:
 	public: RepeatedPartList(const std::string& name);
 	};
 
+	// failed loading a binary mesh file
+	class FailedLoadingMeshFile : public FEFileException
+	{
+	public: FailedLoadingMeshFile(const std::string& err);
+	};
+
 public:
 	//! constructor
 	FEBioImport();
@@ -0,0 +1,537 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEBioMeshFile.h"
+#include <XML/XMLReader.h>
+#include <FECore/FEElement.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <assert.h>
+#include <fstream>
+#include <sstream>
+#include <list>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+namespace {
+
+	const char FEBM_MAGIC[8] = { 'F', 'E', 'B', 'M', 'E', 'S', 'H', 0 };
+
+	struct FILE_HEADER
+	{
+		char		magic[8];	// FEBM_MAGIC
+		uint32_t	version;	// file version
+		uint32_t	blocks;		// number of blocks
+		uint64_t	size;		// number of bytes that follow the header
+		uint64_t	checksum;	// checksum of the bytes that follow the header
+	};
+
+	struct BLOCK_HEADER
+	{
+		uint32_t	type;		// block type
+		uint32_t	cols;		// values per row
+		uint64_t	rows;		// number of rows
+		uint32_t	nameLength;	// length of name
+		uint32_t	typeLength;	// length of element type
+		uint64_t	size;		// number of bytes that follow the block header
+	};
+
+	static_assert(sizeof(FILE_HEADER) == 32, "unexpected header size");
+	static_assert(sizeof(BLOCK_HEADER) == 32, "unexpected block header size");
+
+	// everything is aligned to 8 bytes
+	inline uint64_t padded(uint64_t n) { return (n + 7) & ~(uint64_t)7; }
+
+	// Checksum of a sequence of 64-bit words. A last partial word is padded with zeros.
+	uint64_t hashWords(uint64_t h, const char* d, size_t n)
+	{
+		for (size_t i = 0; i < n; i += 8)
+		{
+			uint64_t w = 0;
+			memcpy(&w, d + i, (n - i < 8 ? n - i : 8));
+			h = (h ^ w) * 0x100000001b3ull;
+			h ^= (h >> 29);
+		}
+		return h;
+	}
+
+	const uint64_t CHECKSUM_SEED = 0xcbf29ce484222325ull;
+
+	// number of bytes of the arrays of a block
+	uint64_t arraySize(int type, uint64_t rows, uint64_t cols)
+	{
+		switch (type)
+		{
+		case FEBioMeshFile::NODES     : return padded(rows * sizeof(int)) + padded(rows * 3 * sizeof(double));
+		case FEBioMeshFile::ELEMENTS  : return padded(rows * sizeof(int)) + padded(rows * cols * sizeof(int));
+		case FEBioMeshFile::NODESET   : 
+		case FEBioMeshFile::ELEMENTSET: return padded(rows * sizeof(int));
+		case FEBioMeshFile::SURFACE   :
+		case FEBioMeshFile::EDGE      : return 2 * padded(rows * sizeof(int)) + padded(rows * cols * sizeof(int));
+		}
+		return 0;
+	}
+
+	// writes data to a file while computing the checksum
+	class ChecksumWriter
+	{
+	public:
+		ChecksumWriter(FILE* fp) : m_fp(fp), m_checksum(CHECKSUM_SEED), m_size(0) {}
+
+		// write the data, followed by zeros up to the next multiple of 8 bytes
+		void write(const void* pd, size_t n)
+		{
+			static const char zero[8] = { 0 };
+			if (n == 0) return;
+			fwrite(pd, 1, n, m_fp);
+			size_t pad = (size_t)padded(n) - n;
+			if (pad) fwrite(zero, 1, pad, m_fp);
+			m_checksum = hashWords(m_checksum, (const char*)pd, n);
+			m_size += n + pad;
+		}
+
+		uint64_t checksum() const { return m_checksum; }
+		uint64_t size() const { return m_size; }
+
+	private:
+		FILE*		m_fp;
+		uint64_t	m_checksum;
+		uint64_t	m_size;
+	};
+}
+
+//-----------------------------------------------------------------------------
+FEBioMeshFile::FEBioMeshFile()
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshFile::Open(const char* szfile)
+{
+	Close();
+
+	stringstream ss;
+	if (m_file.Open(szfile) == false)
+	{
+		ss << "Failed opening mesh file " << szfile;
+		m_err = ss.str();
+		return false;
+	}
+
+	const char* pd = m_file.Data();
+	size_t size = m_file.Size();
+
+	// check the header
+	FILE_HEADER hdr;
+	if (size < sizeof(hdr)) { m_err = "Invalid mesh file"; Close(); return false; }
+	memcpy(&hdr, pd, sizeof(hdr));
+	if (memcmp(hdr.magic, FEBM_MAGIC, 8) != 0) { m_err = "Invalid mesh file"; Close(); return false; }
+	if ((hdr.version == 0) || (hdr.version > VERSION))
+	{
+		ss << "Unsupported mesh file version " << hdr.version;
+		m_err = ss.str();
+		Close();
+		return false;
+	}
+	if (hdr.size != size - sizeof(hdr)) { m_err = "Mesh file is truncated"; Close(); return false; }
+
+	// check the data
+	pd += sizeof(hdr);
+	if (hashWords(CHECKSUM_SEED, pd, (size_t)hdr.size) != hdr.checksum) { m_err = "Mesh file checksum mismatch"; Close(); return false; }
+
+	// read the blocks
+	const char* pe = pd + hdr.size;
+	for (uint32_t n = 0; n < hdr.blocks; ++n)
+	{
+		BLOCK_HEADER bh;
+		if ((size_t)(pe - pd) < sizeof(bh)) { m_err = "Invalid mesh file"; Close(); return false; }
+		memcpy(&bh, pd, sizeof(bh));
+		pd += sizeof(bh);
+
+		uint64_t need = padded(bh.nameLength) + padded(bh.typeLength) + arraySize(bh.type, bh.rows, bh.cols);
+		if ((bh.size < need) || (bh.size > (uint64_t)(pe - pd)) || (bh.rows > 0x7FFFFFFF) || (bh.cols > FEElement::MAX_NODES))
+		{
+			m_err = "Invalid mesh file"; Close(); return false;
+		}
+
+		Block b;
+		b.type = (int)bh.type;
+		b.rows = (int)bh.rows;
+		b.cols = (int)bh.cols;
+
+		const char* p = pd;
+		b.name.assign(p, bh.nameLength); p += padded(bh.nameLength);
+		b.elemType.assign(p, bh.typeLength); p += padded(bh.typeLength);
+
+		// the arrays (which are aligned since the map and all offsets are)
+		uint64_t nrow = padded(bh.rows * sizeof(int));
+		switch (bh.type)
+		{
+		case NODES:
+			b.ids = (const int*)p; p += nrow;
+			b.coords = (const double*)p;
+			break;
+		case ELEMENTS:
+			b.ids = (const int*)p; p += nrow;
+			b.nodes = (const int*)p;
+			break;
+		case NODESET:
+		case ELEMENTSET:
+			b.ids = (const int*)p;
+			break;
+		case SURFACE:
+		case EDGE:
+			b.ids = (const int*)p; p += nrow;
+			b.ntype = (const int*)p; p += nrow;
+			b.nodes = (const int*)p;
+			break;
+		}
+
+		// (blocks of unknown type are skipped)
+		if ((bh.type >= NODES) && (bh.type <= EDGE)) m_blocks.push_back(b);
+
+		pd += bh.size;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEBioMeshFile::Close()
+{
+	m_blocks.clear();
+	m_file.Close();
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshFile::Write(const char* szfile, const std::vector<Block>& blocks)
+{
+	FILE* fp = fopen(szfile, "wb");
+	if (fp == nullptr)
+	{
+		m_err = string("Failed creating mesh file ") + szfile;
+		return false;
+	}
+
+	// we write the header last, when we know the checksum
+	FILE_HEADER hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	fwrite(&hdr, sizeof(hdr), 1, fp);
+
+	ChecksumWriter ar(fp);
+	for (const Block& b : blocks)
+	{
+		BLOCK_HEADER bh;
+		bh.type = (uint32_t)b.type;
+		bh.rows = (uint64_t)b.rows;
+		bh.cols = (uint32_t)b.cols;
+		bh.nameLength = (uint32_t)b.name.size();
+		bh.typeLength = (uint32_t)b.elemType.size();
+		bh.size = padded(bh.nameLength) + padded(bh.typeLength) + arraySize(b.type, bh.rows, bh.cols);
+		ar.write(&bh, sizeof(bh));
+
+		ar.write(b.name.c_str(), b.name.size());
+		ar.write(b.elemType.c_str(), b.elemType.size());
+
+		size_t nrow = b.rows * sizeof(int);
+		switch (b.type)
+		{
+		case NODES:
+			ar.write(b.ids, nrow);
+			ar.write(b.coords, (size_t)b.rows * 3 * sizeof(double));
+			break;
+		case ELEMENTS:
+			ar.write(b.ids, nrow);
+			ar.write(b.nodes, (size_t)b.rows * b.cols * sizeof(int));
+			break;
+		case NODESET:
+		case ELEMENTSET:
+			ar.write(b.ids, nrow);
+			break;
+		case SURFACE:
+		case EDGE:
+			ar.write(b.ids, nrow);
+			ar.write(b.ntype, nrow);
+			ar.write(b.nodes, (size_t)b.rows * b.cols * sizeof(int));
+			break;
+		default:
+			assert(false);
+		}
+	}
+
+	memcpy(hdr.magic, FEBM_MAGIC, 8);
+	hdr.version = VERSION;
+	hdr.blocks = (uint32_t)blocks.size();
+	hdr.size = ar.size();
+	hdr.checksum = ar.checksum();
+	fseek(fp, 0, SEEK_SET);
+	fwrite(&hdr, sizeof(hdr), 1, fp);
+
+	bool bok = (ferror(fp) == 0);
+	if (fclose(fp) != 0) bok = false;
+	if (bok == false) m_err = string("Failed writing mesh file ") + szfile;
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+// data of a block that is read from an feb file
+struct MeshBlockData
+{
+	vector<int>		ids;
+	vector<int>		nodes;
+	vector<int>		ntype;
+	vector<double>	coords;
+};
+
+//-----------------------------------------------------------------------------
+// Reads the facets of a Surface or Edge section. The type name of each facet
+// also defines its number of nodes.
+static void ReadFacets(XMLTag& tag, FEBioMeshFile::Block& b, MeshBlockData& d, const char* sztypes[], const int* ntypes)
+{
+	const int M = FEElement::MAX_NODES;
+	vector<int> nodes;
+	int cols = 0;
+	++tag;
+	do
+	{
+		int nt = -1;
+		for (int i = 0; sztypes[i]; ++i) if (tag == sztypes[i]) { nt = ntypes[i]; break; }
+		if (nt < 0) throw XMLReader::InvalidTag(tag);
+
+		int id = -1;
+		tag.AttributeValue("id", id);
+
+		int n[M] = { 0 };
+		if (tag.value(n, nt) != nt) throw XMLReader::InvalidValue(tag);
+
+		d.ids.push_back(id);
+		d.ntype.push_back(nt);
+		nodes.insert(nodes.end(), n, n + M);
+		if (nt > cols) cols = nt;
+
+		++tag;
+	}
+	while (!tag.isend());
+
+	// store the nodes with the actual number of columns
+	b.rows = (int)d.ids.size();
+	b.cols = cols;
+	d.nodes.resize((size_t)b.rows * cols);
+	for (int i = 0; i < b.rows; ++i)
+		for (int j = 0; j < cols; ++j) d.nodes[(size_t)i * cols + j] = nodes[(size_t)i * M + j];
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshFile::ConvertFEBFile(const char* szfeb, const char* szout, const char* szmesh)
+{
+	// we need the text of the file to copy the parts we don't convert
+	string text;
+	{
+		ifstream in(szfeb, ios::in | ios::binary);
+		if (!in) { m_err = string("Failed opening input file ") + szfeb; return false; }
+		stringstream ss; ss << in.rdbuf();
+		text = ss.str();
+	}
+
+	XMLReader xml;
+	if (xml.Open(szfeb) == false) { m_err = string("Failed opening input file ") + szfeb; return false; }
+
+	list<MeshBlockData> data;
+	vector<Block> blocks;
+	vector<pair<int64_t, int64_t> > keep;	// sections that are not converted
+	int64_t head = 0, tail = 0;
+	try
+	{
+		XMLTag tag;
+		if (xml.FindTag("febio_spec", tag) == false) { m_err = "febio_spec tag was not found"; return false; }
+		const char* szv = tag.AttributeValue("version", true);
+		if ((szv == nullptr) || (strcmp(szv, "4.0") != 0)) { m_err = "Only files of version 4.0 can be converted"; return false; }
+
+		if (xml.FindTag("febio_spec/Mesh", tag) == false) { m_err = "Mesh section was not found"; return false; }
+		if (tag.isleaf()) { m_err = "Mesh section has no child sections"; return false; }
+
+		head = tag.m_fpos;
+		int64_t pos = tag.m_fpos;
+		++tag;
+		do
+		{
+			Block b;
+			if (tag == "Nodes")
+			{
+				data.push_back(MeshBlockData());
+				MeshBlockData& d = data.back();
+				b.type = NODES;
+				const char* szname = tag.AttributeValue("name", true);
+				if (szname) b.name = szname;
+				if (tag.readBlock("node", d.ids, d.coords, 3) == false)
+				{
+					++tag;
+					do
+					{
+						int id = -1; double r[3];
+						tag.AttributeValue("id", id);
+						if (tag.value(r, 3) != 3) throw XMLReader::InvalidValue(tag);
+						d.ids.push_back(id);
+						d.coords.insert(d.coords.end(), r, r + 3);
+						++tag;
+					}
+					while (!tag.isend());
+				}
+				b.rows = (int)d.ids.size();
+				b.cols = 3;
+			}
+			else if (tag == "Elements")
+			{
+				data.push_back(MeshBlockData());
+				MeshBlockData& d = data.back();
+				b.type = ELEMENTS;
+				b.name = tag.AttributeValue("name");
+				b.elemType = tag.AttributeValue("type");
+
+				// the first element defines the number of nodes
+				XMLTag t(tag); ++t;
+				int n[FEElement::MAX_NODES];
+				int neln = t.value(n, FEElement::MAX_NODES);
+				if (tag.readBlock("elem", d.ids, d.nodes, neln) == false)
+				{
+					++tag;
+					do
+					{
+						int id = -1;
+						tag.AttributeValue("id", id);
+						if (tag.value(n, FEElement::MAX_NODES) != neln) throw XMLReader::InvalidValue(tag);
+						d.ids.push_back(id);
+						d.nodes.insert(d.nodes.end(), n, n + neln);
+						++tag;
+					}
+					while (!tag.isend());
+				}
+				b.rows = (int)d.ids.size();
+				b.cols = neln;
+			}
+			else if ((tag == "NodeSet") || (tag == "ElementSet"))
+			{
+				data.push_back(MeshBlockData());
+				MeshBlockData& d = data.back();
+				b.type = (tag == "NodeSet" ? NODESET : ELEMENTSET);
+				b.name = tag.AttributeValue("name");
+				if (tag.isleaf() == false) throw XMLReader::InvalidValue(tag);
+				tag.value(d.ids);
+				b.rows = (int)d.ids.size();
+				b.cols = 1;
+			}
+			else if (tag == "Surface")
+			{
+				data.push_back(MeshBlockData());
+				MeshBlockData& d = data.back();
+				b.type = SURFACE;
+				b.name = tag.AttributeValue("name");
+				if (!tag.isleaf() && !tag.isempty())
+				{
+					const char* sztypes[] = { "quad4", "tri3", "tri6", "tri7", "quad8", "quad9", nullptr };
+					const int ntypes[] = { 4, 3, 6, 7, 8, 9 };
+					ReadFacets(tag, b, d, sztypes, ntypes);
+				}
+			}
+			else if (tag == "Edge")
+			{
+				data.push_back(MeshBlockData());
+				MeshBlockData& d = data.back();
+				b.type = EDGE;
+				b.name = tag.AttributeValue("name");
+				const char* sztypes[] = { "line2", "line3", nullptr };
+				const int ntypes[] = { 2, 3 };
+				ReadFacets(tag, b, d, sztypes, ntypes);
+			}
+			else
+			{
+				// all other sections are copied
+				tag.skip();
+				keep.push_back(pair<int64_t, int64_t>(pos, tag.m_fpos));
+			}
+
+			if (b.type != 0)
+			{
+				MeshBlockData& d = data.back();
+				b.ids = d.ids.data();
+				b.nodes = d.nodes.data();
+				b.ntype = d.ntype.data();
+				b.coords = d.coords.data();
+				blocks.push_back(b);
+			}
+
+			pos = tag.m_fpos;
+			++tag;
+		}
+		while (!tag.isend());
+		tail = pos;
+	}
+	catch (std::exception& e)
+	{
+		m_err = e.what();
+		return false;
+	}
+	xml.Close();
+
+	// write the mesh file
+	if (Write(szmesh, blocks) == false) return false;
+
+	// The mesh file is referenced by name if it is in the same folder as the 
+	// feb file (relative names are resolved with the path of the feb file).
+	string meshName = szmesh;
+	const char* szm = strrchr(szmesh, '/'); if (szm == nullptr) szm = strrchr(szmesh, '\\');
+	const char* szo = strrchr(szout, '/'); if (szo == nullptr) szo = strrchr(szout, '\\');
+	size_t lm = (szm ? szm - szmesh + 1 : 0);
+	size_t lo = (szo ? szo - szout + 1 : 0);
+	if ((lm == lo) && (strncmp(szmesh, szout, lm) == 0)) meshName = szmesh + lm;
+
+	// the indentation of the Mesh section's children
+	string out = text.substr(0, (size_t)head);
+	size_t nl = out.find_last_of('\n');
+	string indent = (nl != string::npos ? out.substr(nl) : string("\n"));
+
+	out += "<MeshFile>" + meshName + "</MeshFile>";
+	for (auto& r : keep)
+	{
+		int64_t a = r.first, b = r.second;
+		while ((a < b) && isspace((unsigned char)text[a])) a++;
+		while ((b > a) && isspace((unsigned char)text[b - 1])) b--;
+		out += indent + text.substr((size_t)a, (size_t)(b - a));
+	}
+	while ((tail > head) && isspace((unsigned char)text[tail - 1])) tail--;
+	out += text.substr((size_t)tail);
+
+	FILE* fp = fopen(szout, "wb");
+	if (fp == nullptr) { m_err = string("Failed creating file ") + szout; return false; }
+	fwrite(out.c_str(), 1, out.size(), fp);
+	fclose(fp);
+
+	return true;
+}
@@ -0,0 +1,102 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "febioxml_api.h"
+#include <FECore/MappedFile.h>
+#include <vector>
+#include <string>
+
+//-----------------------------------------------------------------------------
+// Binary mesh file (.febm). 
+// This file stores the nodes, elements, node sets, element sets, surfaces and 
+// edges of a Mesh section (version 4.0) in binary form, so that large meshes 
+// don't need to be parsed as text. A Mesh section can refer to such a file with
+// <MeshFile>file.febm</MeshFile>. The file is read through a memory map.
+//
+// The file starts with a header, which is followed by a list of blocks. Each 
+// block contains a block header, its name, and its arrays. All data is stored 
+// in native byte order and everything is aligned to 8 bytes. The header stores
+// a checksum of all data that follows it.
+class FEBIOXML_API FEBioMeshFile
+{
+public:
+	enum { VERSION = 1 };
+
+	enum BlockType {
+		NODES = 1,		// ids + coordinates (cols = 3)
+		ELEMENTS,		// ids + connectivity (cols = nodes per element)
+		NODESET,		// node ids (cols = 1)
+		ELEMENTSET,		// element ids (cols = 1)
+		SURFACE,		// ids + nodes per facet + facet nodes (cols = max nodes per facet)
+		EDGE			// ids + nodes per edge + edge nodes (cols = max nodes per edge)
+	};
+
+	// A block of the file. When reading, the pointers point into the memory map.
+	// When writing, they point to the data that is to be written.
+	struct Block
+	{
+		int				type = 0;
+		std::string		name;
+		std::string		elemType;			// element type (ELEMENTS only)
+		int				rows = 0;
+		int				cols = 0;
+		const int*		ids = nullptr;		// ids (or the items of a set)
+		const int*		nodes = nullptr;	// rows x cols node ids (ELEMENTS, SURFACE, EDGE)
+		const int*		ntype = nullptr;	// nr of nodes of each row (SURFACE, EDGE)
+		const double*	coords = nullptr;	// rows x 3 coordinates (NODES)
+	};
+
+public:
+	FEBioMeshFile();
+
+	//! Open a file and check its version and checksum
+	bool Open(const char* szfile);
+
+	//! close the file
+	void Close();
+
+	int Blocks() const { return (int)m_blocks.size(); }
+	const Block& GetBlock(int i) const { return m_blocks[i]; }
+
+	//! error message of the last call to Open or Write
+	const std::string& GetErrorString() const { return m_err; }
+
+	//! Write the blocks to a file
+	bool Write(const char* szfile, const std::vector<Block>& blocks);
+
+	//! Convert an feb file (version 4.0) into a new feb file and a binary mesh file.
+	//! The nodes, elements, sets, surfaces and edges of the Mesh section are written
+	//! to the binary mesh file, and the Mesh section of the new feb file refers to it.
+	bool ConvertFEBFile(const char* szfeb, const char* szout, const char* szmesh);
+
+private:
+	MappedFile			m_file;
+	std::vector<Block>	m_blocks;
+	std::string			m_err;
+};
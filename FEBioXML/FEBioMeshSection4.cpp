@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEBioMeshSection4.h"
+#include "FEBioMeshFile.h"
 #include <FECore/FEModel.h>
 #include <sstream>
 
@@ -64,6 +65,7 @@ void FEBioMeshSection4::Parse(XMLTag& tag)
 		else if (tag == "PartList"   ) ParsePartListSection   (tag, part);
 		else if (tag == "SurfacePair") ParseSurfacePairSection(tag, part);
 		else if (tag == "DiscreteSet") ParseDiscreteSetSection(tag, part);
+		else if (tag == "MeshFile"   ) ParseMeshFile          (tag, part);
 		else throw XMLReader::InvalidTag(tag);
 		++tag;
 	}
@@ -88,31 +90,53 @@ void FEBioMeshSection4::ParseNodeSection(XMLTag& tag, FEBModel::Part* part)
 	}
 
 	// allocate node
+	vector<FEBModel::NODE> node;
+	vector<int> nodeList;
 
-	vector<FEBModel::NODE> node; node.reserve(10000);
-	vector<int> nodeList; nodeList.reserve(10000);
+	// try to read all nodal coordinates in one pass
+	vector<double> r;
+	if (tag.readBlock("node", nodeList, r, 3))
+	{
+		int nodes = (int)nodeList.size();
+		node.resize(nodes);
+		for (int i = 0; i < nodes; ++i)
+		{
+			FEBModel::NODE& nd = node[i];
+			nd.id = nodeList[i];
+			nd.r = vec3d(r[3 * i], r[3 * i + 1], r[3 * i + 2]);
 
-	// read nodal coordinates
-	++tag;
-	do {
-		// nodal coordinates
-		FEBModel::NODE nd;
-		value(tag, nd.r);
+			// make sure node IDs are incrementing
+			if (nd.id <= m_maxNodeId) throw XMLReader::InvalidAttributeValue(tag, "id");
+			m_maxNodeId = nd.id;
+		}
+	}
+	else
+	{
+		node.reserve(10000);
+		nodeList.reserve(10000);
 
-		// get the nodal ID
-		tag.AttributeValue("id", nd.id);
+		// read nodal coordinates
+		++tag;
+		do {
+			// nodal coordinates
+			FEBModel::NODE nd;
+			value(tag, nd.r);
 
-		// make sure node IDs are incrementing
-		if (nd.id <= m_maxNodeId) throw XMLReader::InvalidAttributeValue(tag, "id");
-		m_maxNodeId = nd.id;
+			// get the nodal ID
+			tag.AttributeValue("id", nd.id);
 
-		// add it to the pile
-		node.push_back(nd);
-		nodeList.push_back(nd.id);
+			// make sure node IDs are incrementing
+			if (nd.id <= m_maxNodeId) throw XMLReader::InvalidAttributeValue(tag, "id");
+			m_maxNodeId = nd.id;
 
-		// go on to the next node
-		++tag;
-	} while (!tag.isend());
+			// add it to the pile
+			node.push_back(nd);
+			nodeList.push_back(nd.id);
+
+			// go on to the next node
+			++tag;
+		} while (!tag.isend());
+	}
 
 	// add nodes to the part
 	part->AddNodes(node);
@@ -122,21 +146,10 @@ void FEBioMeshSection4::ParseNodeSection(XMLTag& tag, FEBModel::Part* part)
 }
 
 //-----------------------------------------------------------------------------
-//! This function reads the Element section from the FEBio input file. It also
-//! creates the domain classes which store the element data. A domain is defined
-//! by the module (structural, poro, heat, etc), the element type (solid, shell,
-//! etc.) and the material. 
-//!
-void FEBioMeshSection4::ParseElementSection(XMLTag& tag, FEBModel::Part* part)
+//! Create a new domain in the part
+FEBModel::Domain* FEBioMeshSection4::CreateDomain(FEBModel::Part* part, const char* szname, const char* sztype)
 {
-	FEModel& fem = *GetFEModel();
-	FEMesh& mesh = fem.GetMesh();
-
-	// get the (required!) name
-	const char* szname = tag.AttributeValue("name");
-
 	// get the element spec
-	const char* sztype = tag.AttributeValue("type");
 	FE_Element_Spec espec = GetBuilder()->ElementSpec(sztype);
 	if (FEElementLibrary::IsValid(espec) == false) throw FEBioImport::InvalidElementType();
 
@@ -156,6 +169,27 @@ void FEBioMeshSection4::ParseElementSection(XMLTag& tag, FEBModel::Part* part)
 	// add domain it to the mesh
 	part->AddDomain(dom);
 
+	return dom;
+}
+
+//-----------------------------------------------------------------------------
+//! This function reads the Element section from the FEBio input file. It also
+//! creates the domain classes which store the element data. A domain is defined
+//! by the module (structural, poro, heat, etc), the element type (solid, shell,
+//! etc.) and the material. 
+//!
+void FEBioMeshSection4::ParseElementSection(XMLTag& tag, FEBModel::Part* part)
+{
+	// get the (required!) name
+	const char* szname = tag.AttributeValue("name");
+
+	// get the element type
+	const char* sztype = tag.AttributeValue("type");
+
+	// create the new domain
+	FEBModel::Domain* dom = CreateDomain(part, szname, sztype);
+	FE_Element_Spec espec = dom->ElementSpec();
+
 	// for named domains, we'll also create an element set
 	FEBModel::ElementSet* pg = 0;
 	if (szname)
@@ -164,8 +198,7 @@ void FEBioMeshSection4::ParseElementSection(XMLTag& tag, FEBModel::Part* part)
 		part->AddElementSet(pg);
 	}
 
-	dom->Reserve(10000);
-	vector<int> elemList; elemList.reserve(10000);
+	vector<int> elemList;
 
 	// keep track of largest ID
 	// we need to enforce that element IDs are increasing
@@ -173,27 +206,53 @@ void FEBioMeshSection4::ParseElementSection(XMLTag& tag, FEBModel::Part* part)
 	// so it's done on the whole model.)
 	int maxID = -1;
 
-	// read element data
-	++tag;
-	do
+	// try to read all element data in one pass
+	vector<int> enode;
+	int neln = FEElementLibrary::GetElementTraits(espec.etype)->m_neln;
+	if (tag.readBlock("elem", elemList, enode, neln))
 	{
-		FEBModel::ELEMENT el;
-
-		// get the element ID
-		tag.AttributeValue("id", el.id);
+		int elems = (int)elemList.size();
+		dom->Reserve(elems);
+		for (int i = 0; i < elems; ++i)
+		{
+			FEBModel::ELEMENT el;
+			el.id = elemList[i];
 
-		if ((maxID == -1) || (el.id > maxID)) maxID = el.id;
-		else throw XMLReader::InvalidAttributeValue(tag, "id");
+			if ((maxID == -1) || (el.id > maxID)) maxID = el.id;
+			else throw XMLReader::InvalidAttributeValue(tag, "id");
 
-		// read the element data
-		tag.value(el.node, FEElement::MAX_NODES);
+			for (int j = 0; j < neln; ++j) el.node[j] = enode[i * neln + j];
 
-		dom->AddElement(el);
-		elemList.push_back(el.id);
+			dom->AddElement(el);
+		}
+	}
+	else
+	{
+		dom->Reserve(10000);
+		elemList.reserve(10000);
 
-		// go to next tag
+		// read element data
 		++tag;
-	} while (!tag.isend());
+		do
+		{
+			FEBModel::ELEMENT el;
+
+			// get the element ID
+			tag.AttributeValue("id", el.id);
+
+			if ((maxID == -1) || (el.id > maxID)) maxID = el.id;
+			else throw XMLReader::InvalidAttributeValue(tag, "id");
+
+			// read the element data
+			tag.value(el.node, FEElement::MAX_NODES);
+
+			dom->AddElement(el);
+			elemList.push_back(el.id);
+
+			// go to next tag
+			++tag;
+		} while (!tag.isend());
+	}
 
 	// set the element list
 	if (pg) pg->SetElementList(elemList);
@@ -438,3 +497,126 @@ void FEBioMeshSection4::ParseDiscreteSetSection(XMLTag& tag, FEBModel::Part* par
 		++tag;
 	} while (!tag.isend());
 }
+
+//-----------------------------------------------------------------------------
+//! Reads the nodes, elements, sets, surfaces and edges from a binary mesh file
+//! (see FEBioMeshFile). This does the same as reading the corresponding 
+//! sections, but copies the data directly from the mapped file.
+void FEBioMeshSection4::ParseMeshFile(XMLTag& tag, FEBModel::Part* part)
+{
+	// see if we need to pre-pend a path
+	char szfile[1024];
+	snprintf(szfile, sizeof(szfile), "%s", tag.szvalue());
+	char* ch = strrchr(szfile, '\\');
+	if (ch == 0) ch = strrchr(szfile, '/');
+	if (ch == 0)
+	{
+		// pre-pend the name with the input path
+		snprintf(szfile, sizeof(szfile), "%s%s", GetFileReader()->GetFilePath(), tag.szvalue());
+	}
+
+	FEBioMeshFile file;
+	if (file.Open(szfile) == false) throw FEBioImport::FailedLoadingMeshFile(file.GetErrorString());
+
+	for (int n = 0; n < file.Blocks(); ++n)
+	{
+		const FEBioMeshFile::Block& b = file.GetBlock(n);
+		switch (b.type)
+		{
+		case FEBioMeshFile::NODES:
+		{
+			vector<FEBModel::NODE> node(b.rows);
+			for (int i = 0; i < b.rows; ++i)
+			{
+				FEBModel::NODE& nd = node[i];
+				nd.id = b.ids[i];
+				nd.r = vec3d(b.coords[3 * i], b.coords[3 * i + 1], b.coords[3 * i + 2]);
+
+				// make sure node IDs are incrementing
+				if (nd.id <= m_maxNodeId) throw XMLReader::InvalidValue(tag);
+				m_maxNodeId = nd.id;
+			}
+			part->AddNodes(node);
+
+			if (b.name.empty() == false)
+			{
+				FEBModel::NodeSet* ps = new FEBModel::NodeSet(b.name);
+				part->AddNodeSet(ps);
+				ps->SetNodeList(vector<int>(b.ids, b.ids + b.rows));
+			}
+		}
+		break;
+		case FEBioMeshFile::ELEMENTS:
+		{
+			FEBModel::Domain* dom = CreateDomain(part, b.name.c_str(), b.elemType.c_str());
+			int neln = FEElementLibrary::GetElementTraits(dom->ElementSpec().etype)->m_neln;
+			if (b.cols != neln) throw XMLReader::InvalidValue(tag);
+
+			// element IDs must be increasing
+			dom->Create(b.rows);
+			for (int i = 0; i < b.rows; ++i)
+			{
+				FEBModel::ELEMENT& el = dom->GetElement(i);
+				el.id = b.ids[i];
+				if ((i > 0) && (el.id <= b.ids[i - 1])) throw XMLReader::InvalidValue(tag);
+				for (int j = 0; j < neln; ++j) el.node[j] = b.nodes[(size_t)i * neln + j];
+			}
+
+			FEBModel::ElementSet* pg = new FEBModel::ElementSet(b.name);
+			part->AddElementSet(pg);
+			pg->SetElementList(vector<int>(b.ids, b.ids + b.rows));
+		}
+		break;
+		case FEBioMeshFile::NODESET:
+		{
+			if (part->FindNodeSet(b.name)) throw FEBioImport::RepeatedNodeSet(b.name);
+			FEBModel::NodeSet* set = new FEBModel::NodeSet(b.name);
+			part->AddNodeSet(set);
+			set->SetNodeList(vector<int>(b.ids, b.ids + b.rows));
+		}
+		break;
+		case FEBioMeshFile::ELEMENTSET:
+		{
+			if (part->FindElementSet(b.name)) throw FEBioImport::RepeatedElementSet(b.name);
+			if (b.rows == 0) throw XMLReader::InvalidValue(tag);
+			FEBModel::ElementSet* set = new FEBModel::ElementSet(b.name);
+			part->AddElementSet(set);
+			set->SetElementList(vector<int>(b.ids, b.ids + b.rows));
+		}
+		break;
+		case FEBioMeshFile::SURFACE:
+		{
+			if (part->FindSurface(b.name)) throw FEBioImport::RepeatedSurface(b.name);
+			FEBModel::Surface* ps = new FEBModel::Surface(b.name);
+			part->AddSurface(ps);
+			ps->Create(b.rows);
+			for (int i = 0; i < b.rows; ++i)
+			{
+				FEBModel::FACET& face = ps->GetFacet(i);
+				face.id = b.ids[i];
+				face.ntype = b.ntype[i];
+				if ((face.ntype < 0) || (face.ntype > b.cols)) throw XMLReader::InvalidValue(tag);
+				for (int j = 0; j < face.ntype; ++j) face.node[j] = b.nodes[(size_t)i * b.cols + j];
+			}
+		}
+		break;
+		case FEBioMeshFile::EDGE:
+		{
+			if (part->FindEdgeSet(b.name)) throw FEBioImport::RepeatedEdgeSet(b.name);
+			vector<FEBModel::EDGE> edgeSet(b.rows);
+			for (int i = 0; i < b.rows; ++i)
+			{
+				FEBModel::EDGE& edge = edgeSet[i];
+				edge.id = b.ids[i];
+				edge.ntype = b.ntype[i];
+				if ((edge.ntype < 0) || (edge.ntype > b.cols)) throw XMLReader::InvalidValue(tag);
+				for (int j = 0; j < edge.ntype; ++j) edge.node[j] = b.nodes[(size_t)i * b.cols + j];
+			}
+			FEBModel::EdgeSet* ps = new FEBModel::EdgeSet(b.name);
+			part->AddEdgeSet(ps);
+			ps->SetEdgeList(edgeSet);
+		}
+		break;
+		}
+	}
+}
@@ -49,6 +49,9 @@ protected:
 	void ParseEdgeSection       (XMLTag& tag, FEBModel::Part* part);
 	void ParseSurfacePairSection(XMLTag& tag, FEBModel::Part* part);
 	void ParseDiscreteSetSection(XMLTag& tag, FEBModel::Part* part);
+	void ParseMeshFile          (XMLTag& tag, FEBModel::Part* part);
+
+	FEBModel::Domain* CreateDomain(FEBModel::Part* part, const char* szname, const char* sztype);
 
 private:
 	int m_maxNodeId;
@@ -294,12 +294,13 @@ void FEBioOutputSection::ParsePlotfile(XMLTag &tag)
 
 	FEPlotDataStore& plotData = fem.GetPlotDataStore();
 
-	// get the plot file type. Must be "febio"!
+	// get the plot file type. Must be "febio", "vtk", or "vtu"!
 	const char* sz = tag.AttributeValue("type", true);
 	if (sz)
 	{
 		if ((strcmp(sz, "febio" ) != 0) && 
-			(strcmp(sz, "vtk"   ) != 0)) throw XMLReader::InvalidAttributeValue(tag, "type", sz);
+			(strcmp(sz, "vtk"   ) != 0) &&
+			(strcmp(sz, "vtu"   ) != 0)) throw XMLReader::InvalidAttributeValue(tag, "type", sz);
 	}
 	else sz = "febio";
 	plotData.SetPlotFileType(sz);
@@ -390,6 +391,37 @@ void FEBioOutputSection::ParsePlotfile(XMLTag &tag)
                     // Add the plot variable
 					plotData.AddPlotVariable(szt, item);
                 }
+
+				// see if the data should be encoded
+				const char* szenc = tag.AttributeValue("encoding", true);
+				if (szenc)
+				{
+					FEPlotVariable& var = plotData.GetPlotVariable(plotData.PlotVariables() - 1);
+					if ((strcmp(szenc, "none") != 0) &&
+						(strcmp(szenc, "delta") != 0) &&
+						(strcmp(szenc, "quantize") != 0) &&
+						(strcmp(szenc, "delta_quantize") != 0) &&
+						(strcmp(szenc, "farfield") != 0)) throw XMLReader::InvalidAttributeValue(tag, "encoding", szenc);
+					var.m_encoding = szenc;
+
+					// the lossy encodings need an error bound
+					if ((strcmp(szenc, "none") != 0) && (strcmp(szenc, "delta") != 0))
+					{
+						const char* szerr = tag.AttributeValue("error", true);
+						if (szerr == nullptr) throw XMLReader::MissingAttribute(tag, "error");
+						var.m_encError = atof(szerr);
+						if (var.m_encError <= 0.0) throw XMLReader::InvalidAttributeValue(tag, "error", szerr);
+					}
+
+					// the farfield encoding stores a node set with full precision
+					if (strcmp(szenc, "farfield") == 0)
+					{
+						const char* szset = tag.AttributeValue("node_set", true);
+						if (szset == nullptr) throw XMLReader::MissingAttribute(tag, "node_set");
+						if (GetFEModel()->GetMesh().FindNodeSet(szset) == nullptr) throw XMLReader::InvalidAttributeValue(tag, "node_set", szset);
+						var.m_encNodeSet = szset;
+					}
+				}
 			}
 			else if (tag=="compression")
 			{
@@ -397,6 +429,26 @@ void FEBioOutputSection::ParsePlotfile(XMLTag &tag)
 				tag.value(ncomp);
 				plotData.SetPlotCompression(ncomp);
 			}
+			else if (tag == "async")
+			{
+				int nqueue;
+				tag.value(nqueue);
+				plotData.SetPlotAsyncQueue(nqueue);
+			}
+			else if (tag == "block_size")
+			{
+				// block size is given in kB
+				int nsize;
+				tag.value(nsize);
+				plotData.SetPlotBlockSize(nsize * 1024);
+			}
+			else if (tag == "vtu_encoding")
+			{
+				// encoding of the appended data of vtu files
+				const char* szenc = tag.szvalue();
+				if ((strcmp(szenc, "raw") != 0) && (strcmp(szenc, "base64") != 0)) throw XMLReader::InvalidValue(tag);
+				plotData.SetPlotDataEncoding(szenc);
+			}
 			++tag;
 		}
 		while (!tag.isend());
@@ -140,3 +140,50 @@ size_t CompactMatrix::actualNonZeroes()
 	}
 	return nnz;
 }
+
+//-----------------------------------------------------------------------------
+// Finds the offsets into the values array of the entries that an element matrix is assembled into.
+// This follows the assembly routines of the derived classes: symmetric matrices only store the 
+// lower-triangular part, and rows or columns with a negative index are not assembled. 
+bool CompactMatrix::ValueOffsets(const std::vector<int>& lmi, const std::vector<int>& lmj, std::vector<int>& offsets)
+{
+	const int N = (int)lmi.size();
+	const int M = (int)lmj.size();
+	offsets.assign(N*M, -1);
+
+	bool bsymm = isSymmetric();
+	bool brow = isRowBased();
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lmi[i];
+		if (I < 0) continue;
+		for (int j = 0; j < M; ++j)
+		{
+			int J = lmj[j];
+			if ((J < 0) || (bsymm && (I < J))) continue;
+
+			// for symmetric matrices the lower-triangular part is stored
+			// so the entry is in column J, or (equivalently) in row J for row-based formats
+			int r = I, c = J;
+			if (bsymm && brow) { r = J; c = I; }
+			int k = (brow ? r : c);
+			int l = (brow ? c : r) + m_offset;
+
+			int* pi = m_pindices + (m_ppointers[k] - m_offset);
+			int n = m_ppointers[k + 1] - m_ppointers[k];
+			for (int m = 0; m < n; ++m)
+			{
+				if (pi[m] == l)
+				{
+					offsets[i*M + j] = m_ppointers[k] - m_offset + m;
+					break;
+				}
+			}
+
+			// entry was not allocated
+			if (offsets[i*M + j] < 0) return false;
+		}
+	}
+
+	return true;
+}
@@ -86,6 +86,9 @@ public:
 	//! count the actual nr. of nonzeroes
 	size_t actualNonZeroes();
 
+	//! find the offsets into the values array for an element matrix
+	bool ValueOffsets(const std::vector<int>& lmi, const std::vector<int>& lmj, std::vector<int>& offsets) override;
+
 protected:
 	double*	m_pd;			//!< matrix values
 	int*	m_pindices;		//!< indices
@@ -28,6 +28,10 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "CompactSymmMatrix.h"
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 using namespace std;
 
 //-----------------------------------------------------------------------------
@@ -44,6 +48,18 @@ bool CompactSymmMatrix::mult_vector(double* x, double* r)
 	int N = Rows();
 	int M = Columns();
 
+	// Only the lower triangle is stored, so each column scatters into the rows below
+	// the diagonal. That can't be done in parallel directly, so for larger matrices
+	// the columns are split in blocks that buffer their scatter outside their own rows.
+#ifdef _OPENMP
+	int nthreads = omp_get_max_threads();
+	if ((nthreads > 1) && (N == M) && (N >= 1000))
+	{
+		mult_vector_mt(x, r, nthreads);
+		return true;
+	}
+#endif
+
 	// zero result vector
 	for (int j = 0; j<N; ++j) r[j] = 0.0;
 
@@ -95,6 +111,95 @@ bool CompactSymmMatrix::mult_vector(double* x, double* r)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// The columns are split into nthreads contiguous blocks with about the same number 
+// of nonzeroes, and each block owns the same range of rows of r. A column only 
+// scatters into rows at or below its diagonal, so a block adds directly into its own 
+// rows, and only the rows below its range (the "halo") need a separate buffer. The 
+// halo only extends to the last row that the block's columns touch. Once all blocks 
+// are done, each block adds the halos of the preceding blocks to its rows.
+void CompactSymmMatrix::mult_vector_mt(double* x, double* r, int nthreads)
+{
+	const int N = Rows();
+	const int* pp = m_ppointers;
+
+	// split the columns into blocks with about the same number of nonzeroes
+	vector<int> jb(nthreads + 1);
+	jb[0] = 0;
+	jb[nthreads] = N;
+	double nnz = (double)(pp[N] - pp[0]);
+	for (int t = 1; t < nthreads; ++t)
+	{
+		int target = pp[0] + (int)(nnz * t / nthreads);
+		int j = (int)(std::lower_bound(pp, pp + N + 1, target) - pp);
+		jb[t] = std::max(jb[t - 1], std::min(j, N));
+	}
+
+	// halo buffer of each block
+	vector< vector<double> > halo(nthreads);
+
+	#pragma omp parallel num_threads(nthreads)
+	{
+#ifdef _OPENMP
+		int tid = omp_get_thread_num();
+		int nt = omp_get_num_threads();
+#else
+		int tid = 0;
+		int nt = 1;
+#endif
+		for (int t = tid; t < nthreads; t += nt)
+		{
+			const int j0 = jb[t], j1 = jb[t + 1];
+			for (int i = j0; i < j1; ++i) r[i] = 0.0;
+
+			// the rows are sorted, so the last entry of a column is its largest row
+			int kmax = j1 - 1;
+			for (int j = j0; j < j1; ++j)
+			{
+				int n = pp[j + 1] - pp[j];
+				if (n > 0) kmax = std::max(kmax, m_pindices[pp[j + 1] - m_offset - 1] - m_offset);
+			}
+			vector<double>& h = halo[t];
+			h.assign(kmax + 1 - j1, 0.0);
+
+			for (int j = j0; j < j1; ++j)
+			{
+				const double* pv = m_pd + pp[j] - m_offset;
+				const int* pi = m_pindices + pp[j] - m_offset;
+				int n = pp[j + 1] - pp[j];
+
+				double xj = x[j];
+				double rj = pv[0] * xj;
+				for (int i = 1; i < n; ++i)
+				{
+					int k = pi[i] - m_offset;
+					double vk = pv[i] * xj;
+					if (k < j1) r[k] += vk; else h[k - j1] += vk;
+					rj += pv[i] * x[k];
+				}
+				r[j] += rj;
+			}
+		}
+
+		// all halos must be complete
+		#pragma omp barrier
+
+		// add the halos of the preceding blocks
+		for (int t = tid; t < nthreads; t += nt)
+		{
+			const int j0 = jb[t], j1 = jb[t + 1];
+			for (int s = 0; s < t; ++s)
+			{
+				const vector<double>& h = halo[s];
+				int k0 = jb[s + 1];
+				int i0 = std::max(j0, k0);
+				int i1 = std::min(j1, k0 + (int)h.size());
+				for (int i = i0; i < i1; ++i) r[i] += h[i - k0];
+			}
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 void CompactSymmMatrix::Create(SparseMatrixProfile& mp)
 {
@@ -221,8 +326,12 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 			for (; n<l; ++n)
 				if (pi[n] == I)
 				{
-					#pragma omp atomic
-					pm[n] += ke[i][j];
+					if (m_batomic)
+					{
+						#pragma omp atomic
+						pm[n] += ke[i][j];
+					}
+					else pm[n] += ke[i][j];
 					break;
 				}
 		}
@@ -257,8 +366,12 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const
 				for (int n = 0; n<l; ++n) 
 					if (pi[n] - m_offset == I)
 					{
-						#pragma omp atomic
-						pv[n] += ke[i][j];
+						if (m_batomic)
+						{
+							#pragma omp atomic
+							pv[n] += ke[i][j];
+						}
+						else pv[n] += ke[i][j];
 						break;
 					}
 			}
@@ -289,8 +402,12 @@ void CompactSymmMatrix::add(int i, int j, double v)
 			int m = pi[n];
 			if (m == i)
 			{
-				#pragma omp atomic
-				pd[n] += v;
+				if (m_batomic)
+				{
+					#pragma omp atomic
+					pd[n] += v;
+				}
+				else pd[n] += v;
 				return;
 			}
 			else if (m < i)
@@ -86,4 +86,8 @@ public:
 
 	//! do row (L) and column (R) scaling
 	void scale(const std::vector<double>& L, const std::vector<double>& R) override;
+
+private:
+	//! multithreaded version of mult_vector
+	void mult_vector_mt(double* x, double* r, int nthreads);
 };
@@ -62,6 +62,7 @@ bool DataRecord::SetFileName(const char* szfile)
 	if (szfile == nullptr) return false;
 
 	strcpy(m_szfile, szfile);
+	if (m_fp) fclose(m_fp);
 	m_fp = fopen(szfile, "wt");
 	if (m_fp == 0)
 	{
@@ -75,6 +75,9 @@ public:
 
 	bool SetFileName(const char* szfile);
 
+	//! the name of the data file (empty if the data is written to the log)
+	const char* GetFileName() const { return m_szfile; }
+
 	bool Write();
 
 	void SetItemList(const std::vector<int>& items);
@@ -40,6 +40,7 @@ FEClosestPointProjection::FEClosestPointProjection(FESurface& s) : m_surf(s)
 	m_rad = 0.0;	// 0 means don't use search radius
 	m_bspecial = false;
 	m_projectBoundary = false;
+	m_bbvh = false;
 
 	// calculate node-element list
 	m_NEL.Create(m_surf);
@@ -51,12 +52,27 @@ FEClosestPointProjection::FEClosestPointProjection(FESurface& s) : m_surf(s)
 bool FEClosestPointProjection::Init()
 {
 	// initialize the nearest neighbor search
-	m_SNQ.Attach(&m_surf);
-	m_SNQ.Init();
+	if (m_bbvh)
+	{
+		m_BVH.Attach(&m_surf);
+		m_BVH.Init(0.0);
+	}
+	else
+	{
+		m_SNQ.Attach(&m_surf);
+		m_SNQ.Init();
+	}
 
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void FEClosestPointProjection::Update()
+{
+	if (m_bbvh && m_BVH.IsValid()) m_BVH.Refit();
+	else Init();
+}
+
 //-----------------------------------------------------------------------------
 // helper function for projecting a point onto an edge
 bool Project2Edge(const vec3d& p0, const vec3d& p1, const vec3d& x, vec3d& q)
@@ -172,7 +188,7 @@ FESurfaceElement* FEClosestPointProjection::Project(const vec3d& x, vec3d& q, ve
 	FEMesh& mesh = *m_surf.GetMesh();
 
 	// let's find the closest node
-	int mn = m_SNQ.Find(x);
+	int mn = (m_bbvh ? m_BVH.FindClosestNode(x) : m_SNQ.Find(x));
 	if (mn < 0) return nullptr;
 
 	// make sure it is within the search radius
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "FESurface.h"
 #include "FENNQuery.h"
+#include "FESurfaceBVH.h"
 #include "FEElemElemList.h"
 #include "FENodeElemList.h"
 
@@ -44,6 +45,9 @@ public:
 	//! Initialization
 	bool Init();
 
+	//! Update the search structures after the surface has moved
+	void Update();
+
 	//! Project a point onto surface
 	FESurfaceElement* Project(const vec3d& x, vec3d& q, vec2d& r);
 
@@ -69,6 +73,9 @@ public:
 	//! set if boundary projections are allowed
 	void AllowBoundaryProjections(bool b) { m_projectBoundary = b; }
 
+	//! Use a bounding volume hierarchy instead of the nearest-neighbor query to find the closest node
+	void UseBVH(bool b) { m_bbvh = b; }
+
 private:
 	bool ContainsElement(FESurfaceElement* el);
 	FESurfaceElement* ProjectSpecial(int closestPoint, const vec3d& x, vec3d& q, vec2d& r);
@@ -78,10 +85,12 @@ protected:
 	double	m_rad;	//!< search radius
 	bool	m_bspecial;	//!< try to handle special cases
 	bool	m_projectBoundary;	//!< allow boundary projections
+	bool	m_bbvh;		//!< use bounding volume hierarchy
 
 protected:
 	FESurface&		m_surf;		//!< reference to surface
 	FENNQuery		m_SNQ;		//!< used to find the nearest neighbour
+	FESurfaceBVH	m_BVH;		//!< alternative for finding the nearest neighbour
 	FENodeElemList	m_NEL;		//!< node-element tree
 	FEElemElemList	m_EEL;		//!< element neighbor list
 };
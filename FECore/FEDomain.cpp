@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "DumpStream.h"
 #include "FEMesh.h"
 #include "FEGlobalMatrix.h"
+#include "FELinearSystem.h"
 
 //-----------------------------------------------------------------------------
 FEDomain::FEDomain(int nclass, FEModel* fem) : FEMeshPartition(nclass, fem)
@@ -192,6 +193,74 @@ void FEDomain::BuildMatrixProfile(FEGlobalMatrix& M)
 	}
 }
 
+//-----------------------------------------------------------------------------
+// Each element is assigned the lowest color that is larger than the colors of all
+// the elements with a lower index that share a node with it. This guarantees that
+// elements of the same color do not share any nodes, and that the contributions
+// to any matrix entry are added in the same order as in a serial element loop, which
+// makes the assembled matrix independent of the number of threads.
+void FEDomain::CreateElementColoring()
+{
+	m_elemColor.clear();
+
+	FEMesh* mesh = GetMesh();
+	vector<int> nodeColor(mesh->Nodes(), 0);
+
+	const int NE = Elements();
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		int ne = el.Nodes();
+
+		int c = 0;
+		for (int j = 0; j < ne; ++j)
+		{
+			int nj = nodeColor[el.m_node[j]];
+			if (nj > c) c = nj;
+		}
+
+		if (c >= (int)m_elemColor.size()) m_elemColor.resize(c + 1);
+		m_elemColor[c].push_back(i);
+
+		for (int j = 0; j < ne; ++j) nodeColor[el.m_node[j]] = c + 1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEDomain::ClearElementColoring()
+{
+	m_elemColor.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEDomain::AssembleElements(FELinearSystem& LS, std::function<void(int iel)> f)
+{
+	// make sure the coloring is still valid (e.g. the mesh may have been modified)
+	int ncolored = 0;
+	for (size_t c = 0; c < m_elemColor.size(); ++c) ncolored += (int)m_elemColor[c].size();
+
+	if (ncolored != Elements())
+	{
+		const int NE = Elements();
+		#pragma omp parallel for shared(f)
+		for (int i = 0; i < NE; ++i) f(i);
+	}
+	else
+	{
+		SparseMatrix& K = LS.GetStiffnessMatrix();
+		bool batomic = K.AtomicAssembly();
+		K.SetAtomicAssembly(false);
+		for (int c = 0; c < (int)m_elemColor.size(); ++c)
+		{
+			const vector<int>& elems = m_elemColor[c];
+			const int NE = (int)elems.size();
+			#pragma omp parallel for shared(f)
+			for (int i = 0; i < NE; ++i) f(elems[i]);
+		}
+		K.SetAtomicAssembly(batomic);
+	}
+}
+
 //-----------------------------------------------------------------------------
 void FEDomain::Activate(const FEDofList& dof)
 {
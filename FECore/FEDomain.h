@@ -32,6 +32,7 @@ SOFTWARE.*/
 
 // forward declaration of material class
 class FEMaterial;
+class FELinearSystem;
 
 // Base class for solid and shell parts. Domains can also have materials assigned.
 class FECORE_API FEDomain : public FEMeshPartition
@@ -83,6 +84,21 @@ public:
 	//! indicates whether it is safe to commit the updates.
 	virtual void IncrementalUpdate(std::vector<double>& ui, bool finalFlag);
 
+public:
+	//! Partition the elements in colors such that no two elements of the same color share a node.
+	void CreateElementColoring();
+
+	//! remove the element coloring
+	void ClearElementColoring();
+
+	//! number of element colors (zero when no coloring was created)
+	int ElementColors() const { return (int)m_elemColor.size(); }
+
+	//! Calls f for all elements in parallel. The function f is expected to assemble the element's
+	//! contribution into LS. If an element coloring was created, the colors are processed one after 
+	//! another and the global matrix is assembled without atomic updates.
+	void AssembleElements(FELinearSystem& LS, std::function<void(int iel)> f);
+
 protected:
 	// helper function for activating dof lists
 	void Activate(const FEDofList& dof);
@@ -92,4 +108,7 @@ protected:
 
 protected:
 	FEMat3dValuator* m_matAxis; // initial material axis
+
+private:
+	std::vector< std::vector<int> >	m_elemColor;	//!< element indices for each color
 };
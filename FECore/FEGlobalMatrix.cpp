@@ -28,19 +28,23 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEGlobalMatrix.h"
+#include "CompactMatrix.h"
 #include "FEModel.h"
 #include "FEDomain.h"
 #include "FESurface.h"
+#include "FELinearConstraintManager.h"
 
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElement& el)
 {
+	m_pel = &el;
 	m_node = el.m_node;
 }
 
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke) : matrix(ke)
 {
+	m_pel = ke.m_pel;
 	m_node = ke.m_node;
 	m_lmi = ke.m_lmi;
 	m_lmj = ke.m_lmj;
@@ -49,6 +53,7 @@ FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke) : matrix(ke)
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke, double scale)
 {
+	m_pel = ke.m_pel;
 	m_node = ke.m_node;
 	m_lmi = ke.m_lmi;
 	m_lmj = ke.m_lmj;
@@ -60,6 +65,7 @@ FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke, double scale)
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElement& el, const vector<int>& lmi) : matrix((int)lmi.size(), (int)lmi.size())
 {
+	m_pel = &el;
 	m_node = el.m_node;
 	m_lmi = lmi;
 	m_lmj = lmi;
@@ -68,6 +74,7 @@ FEElementMatrix::FEElementMatrix(const FEElement& el, const vector<int>& lmi) :
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElement& el, vector<int>& lmi, vector<int>& lmj) : matrix((int)lmi.size(), (int)lmj.size())
 {
+	m_pel = &el;
 	m_node = el.m_node;
 	m_lmi = lmi;
 	m_lmj = lmj;
@@ -90,6 +97,14 @@ FEGlobalMatrix::FEGlobalMatrix(SparseMatrix* pK, bool del)
 	m_pMP = 0;
 	m_nlm = 0;
 	m_delA = del;
+	m_bcolored = false;
+	m_bscatter = false;
+	m_scatterMinID = 0;
+	m_scatterSymm = false;
+	m_breuse = false;
+	m_bpad = false;
+	m_breset = true;
+	m_hash = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -104,6 +119,8 @@ FEGlobalMatrix::~FEGlobalMatrix()
 //-----------------------------------------------------------------------------
 void FEGlobalMatrix::Clear()
 { 
+	// The scatter maps are kept, since they can be reused if the matrix is
+	// created again with the same profile (see build_end).
 	if (m_pA) m_pA->Clear(); 
 }
 
@@ -168,11 +185,40 @@ void FEGlobalMatrix::build_flush()
 void FEGlobalMatrix::build_end()
 {
 	if (m_nlm > 0) build_flush();
+
+	// The value offsets of the scatter maps only depend on the profile, so the maps
+	// remain valid when the profile did not change. They are rebuilt when the static
+	// profile was reset, since the mesh or the equation numbers may have changed.
+	bool bkeepMaps = (m_scatter.empty() == false) && (m_breset == false) &&
+		(m_MPa.Rows() == m_pMP->Rows()) && (m_MPa.Columns() == m_pMP->Columns()) &&
+		(m_pMP->Hash() == m_hash) && (*m_pMP == m_MPa);
+	if (bkeepMaps == false) ClearScatterMaps();
+
 	m_pA->Create(*m_pMP);
+
+	// store the profile so we can compare it to the next one
+	// (this is only needed when the matrix structure or the scatter maps can be reused)
+	if (m_breuse || m_bpad || m_bscatter)
+	{
+		m_MPa = *m_pMP;
+		m_hash = m_MPa.Hash();
+	}
+	else
+	{
+		m_MPa.Clear();
+		m_hash = 0;
+	}
 }
 
 //-----------------------------------------------------------------------------
 bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
+{
+	BuildProfile(pfem, neq, breset);
+	return CreateFromProfile(pfem);
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::BuildProfile(FEModel* pfem, int neq, bool breset)
 {
 	// The first time we come here we build the "static" profile.
 	// This static profile stores the contribution to the matrix profile
@@ -194,29 +240,92 @@ bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
 		// of building it from scratch.
 		if (breset)
 		{
-			m_MPs.Clear();
+			if (m_sharedMPs)
+			{
+				// the static profile is shared, so we just copy it
+				*m_pMP = *m_sharedMPs;
+			}
+			else
+			{
+				m_MPs.Clear();
+
+				// build the matrix profile
+				pfem->BuildMatrixProfile(*this, true);
 
-			// build the matrix profile
-			pfem->BuildMatrixProfile(*this, true);
+				// copy the static profile to the MP object
+				// Make sure the LM buffer is flushed first.
+				build_flush();
+				m_MPs = *m_pMP;
+			}
 
-			// copy the static profile to the MP object
-			// Make sure the LM buffer is flushed first.
-			build_flush();
-			m_MPs = *m_pMP;
+			// Create the element colorings for the domains. Colored assembly is not used when
+			// there are linear constraints, since those assemble into the parent dofs, which
+			// may be shared by elements of the same color.
+			FEMesh& mesh = pfem->GetMesh();
+			bool bcolor = m_bcolored && (pfem->GetLinearConstraintManager().LinearConstraints() == 0);
+			for (int i = 0; i < mesh.Domains(); ++i)
+			{
+				FEDomain& dom = mesh.Domain(i);
+				if (bcolor) dom.CreateElementColoring();
+				else dom.ClearElementColoring();
+			}
 		}
 		else
 		{
 			// copy the old static profile
-			*m_pMP = m_MPs;
+			*m_pMP = StaticProfile();
 		}
 
 		// Add the "dynamic" profile
 		pfem->BuildMatrixProfile(*this, false);
 	}
+
+	// Make sure the LM buffer is flushed
+	if (m_nlm > 0) build_flush();
+	m_breset = breset;
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::SetSharedStaticProfile(std::shared_ptr<const SparseMatrixProfile> mp)
+{
+	m_sharedMPs = mp;
+
+	// we no longer need our own copy
+	if (m_sharedMPs) m_MPs.Clear();
+}
+
+//-----------------------------------------------------------------------------
+bool FEGlobalMatrix::IsProfileAllocated() const
+{
+	if ((m_pMP == nullptr) || (m_pA == nullptr) || (m_pA->NonZeroes() == 0)) return false;
+	if ((m_MPa.Rows() != m_pMP->Rows()) || (m_MPa.Columns() != m_pMP->Columns())) return false;
+
+	// A padded matrix can be reused as long as it contains the new profile. 
+	// Otherwise, the profiles must be identical.
+	if (m_bpad) return m_MPa.Contains(*m_pMP);
+	else return (m_pMP->Hash() == m_hash) && (*m_pMP == m_MPa);
+}
+
+//-----------------------------------------------------------------------------
+bool FEGlobalMatrix::CreateFromProfile(FEModel* pfem)
+{
+	if (m_pMP == nullptr) return false;
+
+	// Add the entries of the previous profile. This is only done when the static 
+	// profile was not rebuilt, since otherwise the equation numbers may have changed.
+	if (m_bpad && (m_breset == false) && (m_MPa.Rows() == m_pMP->Rows()) && (m_MPa.Columns() == m_pMP->Columns()))
+	{
+		m_pMP->Merge(m_MPa);
+	}
+
 	// All done! We can now finish building the profile and create 
 	// the actual sparse matrix. This is done in the following function
 	build_end();
 
+	// The value offsets depend on the entire profile (including the dynamic part),
+	// so the scatter maps are only rebuilt when the profile changed (see build_end).
+	if (m_bscatter && m_scatter.empty()) BuildScatterMaps(pfem->GetMesh());
+
 	return true;
 }
 
@@ -314,7 +423,179 @@ bool FEGlobalMatrix::Create(const FESurface& surf, const std::vector<int>& equat
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::ClearScatterMaps()
+{
+	m_scatter.clear();
+	m_scatterLM.clear();
+	m_scatterSlot.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::BuildScatterMaps(FEMesh& mesh)
+{
+	// get the ID range of the domain elements
+	int minID = -1, maxID = -1;
+	for (int nd = 0; nd < mesh.Domains(); ++nd)
+	{
+		FEDomain& dom = mesh.Domain(nd);
+		for (int i = 0; i < dom.Elements(); ++i)
+		{
+			int eid = dom.ElementRef(i).GetID();
+			if ((eid < minID) || (minID == -1)) minID = eid;
+			if ((eid > maxID) || (maxID == -1)) maxID = eid;
+		}
+	}
+	if (minID < 0) return;
+
+	// symmetric matrices only store the lower-triangular part, so (i,j) and (j,i) 
+	// end up in the same entry and we only need to store half the offsets.
+	CompactMatrix* pA = dynamic_cast<CompactMatrix*>(m_pA);
+	m_scatterSymm = (pA && pA->isSymmetric());
+
+	ScatterMap none = { 0, 0, 0 };
+	m_scatterMinID = minID;
+	m_scatter.assign(maxID - minID + 1, none);
+
+	vector<int> lm, slot;
+	for (int nd = 0; nd < mesh.Domains(); ++nd)
+	{
+		FEDomain& dom = mesh.Domain(nd);
+		for (int i = 0; i < dom.Elements(); ++i)
+		{
+			FEElement& el = dom.ElementRef(i);
+			dom.UnpackLM(el, lm);
+
+			// Only keep the dofs that the domain assembles. The LM vector can contain 
+			// additional dofs (e.g. the rigid rotations of solid domains) that are not
+			// part of the element matrices.
+			size_t ndof = (size_t)dom.GetDOFList().Size() * el.Nodes();
+			if ((ndof > 0) && (ndof < lm.size())) lm.resize(ndof);
+
+			// don't use scatter maps if the matrix format does not support it
+			if (m_pA->ValueOffsets(lm, lm, slot) == false)
+			{
+				ClearScatterMaps();
+				return;
+			}
+
+			const int n = (int)lm.size();
+			ScatterMap& map = m_scatter[el.GetID() - minID];
+			map.lm = m_scatterLM.size();
+			map.slot = m_scatterSlot.size();
+			map.n = n;
+
+			m_scatterLM.insert(m_scatterLM.end(), lm.begin(), lm.end());
+			if (m_scatterSymm)
+			{
+				// store the offset of (i,j), or of (j,i) if that is the one that is assembled
+				for (int r = 0; r < n; ++r)
+					for (int c = r; c < n; ++c)
+						m_scatterSlot.push_back(slot[r*n + c] >= 0 ? slot[r*n + c] : slot[c*n + r]);
+			}
+			else m_scatterSlot.insert(m_scatterSlot.end(), slot.begin(), slot.end());
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Returns the value offsets for an element matrix, or null if no scatter map was found.
+// The map is only used if the element matrix has the same row and column indices as
+// the LM vector that was used for building the map. Note that the LM vector of a domain
+// can be longer than the element matrix (e.g. solid domains also pack the shell dofs), 
+// in which case only the leading block is assembled. The stride of the map's rows is 
+// returned in n.
+const int* FEGlobalMatrix::FindScatterMap(const FEElementMatrix& ke, int& n) const
+{
+	const FEElement* pe = ke.GetElement();
+	if ((pe == nullptr) || m_scatter.empty()) return nullptr;
+
+	int index = pe->GetID() - m_scatterMinID;
+	if ((index < 0) || (index >= (int)m_scatter.size())) return nullptr;
+	const ScatterMap& map = m_scatter[index];
+
+	const vector<int>& lmi = ke.RowIndices();
+	const vector<int>& lmj = ke.ColumnsIndices();
+	const int N = ke.rows();
+	n = map.n;
+	if ((N == 0) || (N > n) || (ke.columns() != N)) return nullptr;
+	if (((int)lmi.size() < N) || ((int)lmj.size() < N)) return nullptr;
+
+	// the offsets only depend on the LM vector, so if it matches, the map can be used
+	const int* lm = &m_scatterLM[map.lm];
+	for (int i = 0; i < N; ++i)
+	{
+		if ((lmi[i] != lm[i]) || (lmj[i] != lm[i])) return nullptr;
+	}
+
+	return &m_scatterSlot[map.slot];
+}
+
+//-----------------------------------------------------------------------------
 void FEGlobalMatrix::Assemble(const FEElementMatrix& ke)
 {
-	m_pA->Assemble(ke, ke.RowIndices(), ke.ColumnsIndices());
+	// see if we can use a precomputed scatter map
+	int n = 0;
+	const int* slot = FindScatterMap(ke, n);
+	if (slot == nullptr)
+	{
+		m_pA->Assemble(ke, ke.RowIndices(), ke.ColumnsIndices());
+		return;
+	}
+
+	double* pv = m_pA->Values();
+	const bool batomic = m_pA->AtomicAssembly();
+	const int N = ke.rows();
+	if (m_scatterSymm)
+	{
+		// Only the upper triangle of offsets is stored, so row i starts at i*n - i*(i-1)/2.
+		// Like the matrix's own assembly, we add ke[i][j] when lm[i] >= lm[j], and ke[j][i] otherwise.
+		const vector<int>& lm = ke.RowIndices();
+		for (int i = 0; i < N; ++i)
+		{
+			const int* si = slot + i*n - i*(i - 1)/2 - i;
+			for (int j = i; j < N; ++j)
+			{
+				const int s = si[j];
+				if (s < 0) continue;
+
+				// with duplicate equation numbers both (i,j) and (j,i) are assembled
+				const bool bboth = ((lm[i] == lm[j]) && (i != j));
+				const double v = (lm[i] >= lm[j] ? ke[i][j] : ke[j][i]);
+				if (batomic)
+				{
+					#pragma omp atomic
+					pv[s] += v;
+					if (bboth)
+					{
+						#pragma omp atomic
+						pv[s] += ke[j][i];
+					}
+				}
+				else
+				{
+					pv[s] += v;
+					if (bboth) pv[s] += ke[j][i];
+				}
+			}
+		}
+	}
+	else
+	{
+		for (int i = 0; i < N; ++i)
+		{
+			const double* ki = ke[i];
+			const int* si = slot + i*n;
+			for (int j = 0; j < N; ++j)
+			{
+				if (si[j] < 0) continue;
+				if (batomic)
+				{
+					#pragma omp atomic
+					pv[si[j]] += ki[j];
+				}
+				else pv[si[j]] += ki[j];
+			}
+		}
+	}
 }
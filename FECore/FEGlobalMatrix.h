@@ -31,12 +31,14 @@ SOFTWARE.*/
 #include "SparseMatrix.h"
 #include "FESolver.h"
 #include <vector>
+#include <memory>
 
 //-----------------------------------------------------------------------------
 class FEModel;
 class FEMesh;
 class FESurface;
 class FEElement;
+class FEMeshPartition;
 
 //-----------------------------------------------------------------------------
 //! This class represents an element matrix, i.e. a matrix of values and the row and
@@ -82,7 +84,11 @@ public:
 	// get the nodes
 	const std::vector<int>& Nodes() const { return m_node; }
 
+	// get the element (can be null)
+	const FEElement* GetElement() const { return m_pel; }
+
 private:
+	const FEElement*	m_pel = nullptr;	//!< element this matrix was constructed from
 	std::vector<int>	m_node;	//!< node indices
 	std::vector<int>	m_lmi;	//!< row indices
 	std::vector<int>	m_lmj;	//!< column indices
@@ -116,6 +122,16 @@ public:
 	//! construct the stiffness matrix from a FEM object
 	bool Create(FEModel* pfem, int neq, bool breset);
 
+	//! build the matrix profile from a FEM object, without creating the sparse matrix
+	void BuildProfile(FEModel* pfem, int neq, bool breset);
+
+	//! create the sparse matrix from the profile that was last built by BuildProfile
+	bool CreateFromProfile(FEModel* pfem);
+
+	//! See if the structure of the current sparse matrix can hold the profile that was last 
+	//! built by BuildProfile. In that case, the sparse matrix does not need to be recreated.
+	bool IsProfileAllocated() const;
+
 	//! construct the stiffness matrix from a mesh
 	bool Create(FEMesh& mesh, int neq);
 
@@ -153,6 +169,40 @@ public:
 	//! get the sparse matrix profile
 	SparseMatrixProfile* GetSparseMatrixProfile() { return m_pMP; }
 
+	//! Use element coloring for assembling the domains (instead of atomic updates)
+	void SetColoredAssembly(bool b) { m_bcolored = b; }
+
+	//! Precompute the value offsets of the domain elements for assembly
+	void SetScatterMaps(bool b) { m_bscatter = b; }
+
+	//! Keep the profile of the current matrix, so that the matrix structure can be reused 
+	//! when the next profile is the same (see IsProfileAllocated).
+	void SetProfileReuse(bool b) { m_breuse = b; }
+
+	//! Keep the entries of previous profiles when the dynamic profile changes, so that
+	//! the matrix structure can be reused when previously seen entries return. 
+	void SetProfilePadding(bool b) { m_bpad = b; }
+
+	//! Use a static profile that is shared with other matrices of identical models (e.g. RVE copies).
+	//! The static profile is then no longer rebuilt when the profile is reset. 
+	void SetSharedStaticProfile(std::shared_ptr<const SparseMatrixProfile> mp);
+
+	//! see if the static profile is shared
+	bool HasSharedStaticProfile() const { return (m_sharedMPs != nullptr); }
+
+	//! return the static profile that was last built
+	const SparseMatrixProfile& StaticProfile() const { return (m_sharedMPs ? *m_sharedMPs : m_MPs); }
+
+protected:
+	// build the scatter maps for the domain elements
+	void BuildScatterMaps(FEMesh& mesh);
+
+	// release the scatter maps
+	void ClearScatterMaps();
+
+	// find the scatter map for an element matrix
+	const int* FindScatterMap(const FEElementMatrix& ke, int& n) const;
+
 public:
 	void build_begin(int neq);
 	void build_add(std::vector<int>& lm);
@@ -162,12 +212,38 @@ public:
 protected:
 	SparseMatrix*	m_pA;	//!< the actual global stiffness matrix
 	bool			m_delA;	//!< delete A in destructor
+	bool			m_bcolored;	//!< create element colorings for assembly
+	bool			m_bscatter;	//!< precompute the scatter maps of the domain elements
+	bool			m_breuse;	//!< keep the profile of the current matrix for reuse
+	bool			m_bpad;		//!< pad the profile with the entries of previous profiles
+	bool			m_breset;	//!< was the static profile rebuilt for the last profile?
 
 	// The following data structures are used to incrementally
 	// build the profile of the sparse matrix
 
 	SparseMatrixProfile*	m_pMP;		//!< profile of sparse matrix
 	SparseMatrixProfile		m_MPs;		//!< the "static" part of the matrix profile
+	std::shared_ptr<const SparseMatrixProfile>	m_sharedMPs;	//!< shared static profile (replaces m_MPs when set)
+	SparseMatrixProfile		m_MPa;		//!< the profile that the current sparse matrix was created from
+	size_t					m_hash;		//!< hash value of m_MPa
 	vector< vector<int> >	m_LM;		//!< used for building the stiffness matrix
 	int	m_nlm;				//!< nr of elements in m_LM array
+
+	// The scatter maps store for each domain element the LM vector that was used to build the map
+	// (limited to the dofs that the domain assembles), and the offsets into the values array of 
+	// the sparse matrix for the entries of the element matrix. The maps are kept as long as the
+	// profile of the matrix does not change.
+	// For symmetric matrices only the upper triangle (j >= i) of the element matrix is stored, since 
+	// both (i,j) and (j,i) are assembled into the same entry. The maps are looked up by element ID.
+	struct ScatterMap
+	{
+		size_t	lm;		//!< start of the element's LM vector in m_scatterLM
+		size_t	slot;	//!< start of the element's offsets in m_scatterSlot
+		int		n;		//!< size of the LM vector (0 if there is no map for this ID)
+	};
+	std::vector<ScatterMap>	m_scatter;		//!< scatter maps, indexed by element ID - m_scatterMinID
+	int						m_scatterMinID;	//!< smallest element ID
+	bool					m_scatterSymm;	//!< only the upper triangle of the element matrices is stored
+	std::vector<int>		m_scatterLM;	//!< the LM vectors of all elements
+	std::vector<int>		m_scatterSlot;	//!< value offsets (-1 if the entry is not assembled)
 };
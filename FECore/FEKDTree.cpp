@@ -0,0 +1,279 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#include "stdafx.h"
+#include "FEKDTree.h"
+#include <algorithm>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+static inline double coord(const vec3d& r, int axis)
+{
+	return (axis == 0 ? r.x : (axis == 1 ? r.y : r.z));
+}
+
+//-----------------------------------------------------------------------------
+// This defines the order of the k-nearest-neighbour search: points are sorted
+// by distance, and equidistant points by descending index. This is the same
+// order in which the brute-force findNeirestNeighbors returns the points.
+static inline bool is_closer(double d1, int i1, double d2, int i2)
+{
+	return ((d1 < d2) || ((d1 == d2) && (i1 > i2)));
+}
+
+//-----------------------------------------------------------------------------
+FEKDTree::FEKDTree()
+{
+	m_leafSize = 8;
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::Clear()
+{
+	m_pt.clear();
+	m_index.clear();
+	m_inv.clear();
+	m_node.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::Build(const std::vector<vec3d>& points, int leafSize)
+{
+	Clear();
+	m_leafSize = (leafSize < 1 ? 1 : leafSize);
+
+	int N = (int)points.size();
+	if (N == 0) return;
+
+	m_index.resize(N);
+	for (int i = 0; i < N; ++i) m_index[i] = i;
+
+	struct RANGE { int node, n0, n1; };
+	vector<RANGE> level(1), next;
+	level[0].node = 0; level[0].n0 = 0; level[0].n1 = N;
+	while (level.empty() == false)
+	{
+		// the nodes of a level are numbered consecutively
+		int nodes = (int)level.size();
+		m_node.resize(level[nodes - 1].node + 1);
+
+		// split the nodes of this level. This is done in parallel, except for the
+		// first few levels, which have too few nodes.
+		#pragma omp parallel for schedule(dynamic) if (nodes > 1)
+		for (int i = 0; i < nodes; ++i)
+		{
+			const RANGE& r = level[i];
+			NODE& nd = m_node[r.node];
+			if (r.n1 - r.n0 <= m_leafSize)
+			{
+				nd.axis = -1;
+				nd.split = 0.0;
+				continue;
+			}
+
+			// split along the largest extent of the bounding box
+			vec3d cmin = points[m_index[r.n0]], cmax = cmin;
+			for (int j = r.n0 + 1; j < r.n1; ++j)
+			{
+				const vec3d& p = points[m_index[j]];
+				if (p.x < cmin.x) cmin.x = p.x;
+				if (p.x > cmax.x) cmax.x = p.x;
+				if (p.y < cmin.y) cmin.y = p.y;
+				if (p.y > cmax.y) cmax.y = p.y;
+				if (p.z < cmin.z) cmin.z = p.z;
+				if (p.z > cmax.z) cmax.z = p.z;
+			}
+			vec3d d = cmax - cmin;
+			int axis = 0;
+			if (d.y > coord(d, axis)) axis = 1;
+			if (d.z > coord(d, axis)) axis = 2;
+
+			// partition the points at the median
+			int mid = r.n0 + (r.n1 - r.n0) / 2;
+			nth_element(m_index.begin() + r.n0, m_index.begin() + mid, m_index.begin() + r.n1, [&](int a, int b) {
+				double xa = coord(points[a], axis);
+				double xb = coord(points[b], axis);
+				return ((xa < xb) || ((xa == xb) && (a < b)));
+			});
+
+			nd.axis = axis;
+			nd.split = coord(points[m_index[mid]], axis);
+		}
+
+		// setup the next level
+		next.clear();
+		for (int i = 0; i < nodes; ++i)
+		{
+			const RANGE& r = level[i];
+			if (m_node[r.node].axis >= 0)
+			{
+				int mid = r.n0 + (r.n1 - r.n0) / 2;
+				RANGE left  = { 2 * r.node + 1, r.n0, mid };
+				RANGE right = { 2 * r.node + 2, mid, r.n1 };
+				next.push_back(left);
+				next.push_back(right);
+			}
+		}
+		level.swap(next);
+	}
+
+	// store the points in tree order
+	m_pt.resize(N);
+	m_inv.resize(N);
+	for (int i = 0; i < N; ++i)
+	{
+		m_pt[i] = points[m_index[i]];
+		m_inv[m_index[i]] = i;
+	}
+}
+
+//-----------------------------------------------------------------------------
+int FEKDTree::FindNearest(const vec3d& x) const
+{
+	if (m_pt.empty()) return -1;
+	int imin = -1;
+	double dmin = 0.0;
+	findNearest(0, 0, (int)m_pt.size(), x, imin, dmin);
+	return imin;
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::findNearest(int node, int n0, int n1, const vec3d& x, int& imin, double& dmin) const
+{
+	const NODE& nd = m_node[node];
+	if (nd.axis < 0)
+	{
+		for (int i = n0; i < n1; ++i)
+		{
+			vec3d dr = m_pt[i] - x;
+			double d2 = dr*dr;
+			if ((imin < 0) || is_closer(d2, m_index[i], dmin, imin))
+			{
+				dmin = d2;
+				imin = m_index[i];
+			}
+		}
+		return;
+	}
+
+	// visit the child that contains x first
+	int mid = n0 + (n1 - n0) / 2;
+	double diff = coord(x, nd.axis) - nd.split;
+	if (diff <= 0.0)
+	{
+		findNearest(2 * node + 1, n0, mid, x, imin, dmin);
+		if (diff*diff <= dmin) findNearest(2 * node + 2, mid, n1, x, imin, dmin);
+	}
+	else
+	{
+		findNearest(2 * node + 2, mid, n1, x, imin, dmin);
+		if (diff*diff <= dmin) findNearest(2 * node + 1, n0, mid, x, imin, dmin);
+	}
+}
+
+//-----------------------------------------------------------------------------
+int FEKDTree::FindNearest(const vec3d& x, int k, std::vector<int>& closestPoints) const
+{
+	int N = (int)m_pt.size();
+	if (k > N) k = N;
+	closestPoints.resize(k);
+	if (k <= 0) return 0;
+
+	vector<double> dist(k, 0.0);
+	int n = 0;
+	findNearest(0, 0, N, x, k, n, closestPoints.data(), dist.data());
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::findNearest(int node, int n0, int n1, const vec3d& x, int k, int& n, int* idx, double* dist) const
+{
+	const NODE& nd = m_node[node];
+	if (nd.axis < 0)
+	{
+		for (int i = n0; i < n1; ++i)
+		{
+			vec3d dr = m_pt[i] - x;
+			double d2 = dr*dr;
+			int j = m_index[i];
+			if ((n < k) || is_closer(d2, j, dist[n - 1], idx[n - 1]))
+			{
+				// insert the point in the sorted list
+				int m = (n < k ? n++ : n - 1);
+				while ((m > 0) && is_closer(d2, j, dist[m - 1], idx[m - 1]))
+				{
+					dist[m] = dist[m - 1];
+					idx[m] = idx[m - 1];
+					m--;
+				}
+				dist[m] = d2;
+				idx[m] = j;
+			}
+		}
+		return;
+	}
+
+	int mid = n0 + (n1 - n0) / 2;
+	double diff = coord(x, nd.axis) - nd.split;
+	if (diff <= 0.0)
+	{
+		findNearest(2 * node + 1, n0, mid, x, k, n, idx, dist);
+		if ((n < k) || (diff*diff <= dist[n - 1])) findNearest(2 * node + 2, mid, n1, x, k, n, idx, dist);
+	}
+	else
+	{
+		findNearest(2 * node + 2, mid, n1, x, k, n, idx, dist);
+		if ((n < k) || (diff*diff <= dist[n - 1])) findNearest(2 * node + 1, n0, mid, x, k, n, idx, dist);
+	}
+}
+
+//-----------------------------------------------------------------------------
+int FEKDTree::FindRadius(const vec3d& x, double R, std::vector<int>& points) const
+{
+	points.clear();
+	if (m_pt.empty()) return 0;
+	findRadius(0, 0, (int)m_pt.size(), x, R*R, points);
+	return (int)points.size();
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::findRadius(int node, int n0, int n1, const vec3d& x, double R2, std::vector<int>& points) const
+{
+	const NODE& nd = m_node[node];
+	if (nd.axis < 0)
+	{
+		for (int i = n0; i < n1; ++i)
+		{
+			vec3d dr = m_pt[i] - x;
+			if (dr*dr <= R2) points.push_back(m_index[i]);
+		}
+		return;
+	}
+
+	int mid = n0 + (n1 - n0) / 2;
+	double diff = coord(x, nd.axis) - nd.split;
+	if ((diff <= 0.0) || (diff*diff <= R2)) findRadius(2 * node + 1, n0, mid, x, R2, points);
+	if ((diff >= 0.0) || (diff*diff <= R2)) findRadius(2 * node + 2, mid, n1, x, R2, points);
+}
@@ -0,0 +1,87 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#pragma once
+#include "vec3d.h"
+#include "fecore_api.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! KD-tree for nearest-neighbour and radius queries on a point cloud.
+//! The tree is balanced: each node splits its range of points at the median
+//! along the axis of largest extent. Since the split is always at the middle
+//! of the range, the tree is stored implicitly: the children of node i are
+//! 2i+1 and 2i+2, and only the split axis and value are stored per node.
+//! The tree is built level by level, where the nodes of each level are
+//! processed in parallel. The query functions do not modify the tree, so they
+//! can be called from multiple threads.
+class FECORE_API FEKDTree
+{
+	struct NODE
+	{
+		int		axis;	//!< split axis (-1 for leaves)
+		double	split;	//!< split value
+	};
+
+public:
+	FEKDTree();
+
+	//! build the tree for the point cloud.
+	//! leafSize is the max nr of points in a leaf
+	void Build(const std::vector<vec3d>& points, int leafSize = 8);
+
+	//! clear all data
+	void Clear();
+
+	//! number of points in the tree
+	int Points() const { return (int)m_pt.size(); }
+
+	//! return a point (index refers to the original point list)
+	const vec3d& Point(int i) const { return m_pt[m_inv[i]]; }
+
+public:
+	//! find the closest point to x. Returns -1 if the tree is empty.
+	int FindNearest(const vec3d& x) const;
+
+	//! find the k closest points to x, sorted by distance. Returns the number
+	//! of points found (which is less than k if the tree has fewer points).
+	//! Points with equal distance are ordered by descending index.
+	int FindNearest(const vec3d& x, int k, std::vector<int>& closestPoints) const;
+
+	//! find all points within a distance R of x. The result is not sorted.
+	int FindRadius(const vec3d& x, double R, std::vector<int>& points) const;
+
+private:
+	void findNearest(int node, int n0, int n1, const vec3d& x, int& imin, double& dmin) const;
+	void findNearest(int node, int n0, int n1, const vec3d& x, int k, int& n, int* idx, double* dist) const;
+	void findRadius(int node, int n0, int n1, const vec3d& x, double R2, std::vector<int>& points) const;
+
+private:
+	std::vector<vec3d>	m_pt;		//!< points, in tree order
+	std::vector<int>	m_index;	//!< original index of points in tree order
+	std::vector<int>	m_inv;		//!< tree order position of original points
+	std::vector<NODE>	m_node;		//!< the tree nodes
+	int					m_leafSize;
+};
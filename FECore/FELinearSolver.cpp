@@ -193,6 +193,7 @@ bool FELinearSolver::SolveStep()
 	FEGlobalVector rhs(fem, m_R, F);
 	{
 		TRACK_TIME(TimerID::Timer_Residual);
+		FE_PROFILE_COMPONENT(this, "ForceVector");
 		ForceVector(rhs);
 	}
 
@@ -252,6 +253,7 @@ bool FELinearSolver::ReformStiffness()
 		TRACK_TIME(TimerID::Timer_Stiffness);
 
 		FELinearSystem K(GetFEModel(), *m_pK, m_R, m_u, (m_msymm == REAL_SYMMETRIC));
+		FE_PROFILE_COMPONENT(this, "StiffnessMatrix");
 		if (!StiffnessMatrix(K)) return false;
 
 		// do call back
@@ -352,7 +354,11 @@ void FELinearSolver::ForceVector(FEGlobalVector& R)
 	for (int i = 0; i < nml; ++i)
 	{
 		FEModelLoad& ml = *fem.ModelLoad(i);
-		if (ml.IsActive()) ml.LoadVector(R);
+		if (ml.IsActive())
+		{
+			FE_PROFILE_COMPONENT(&ml, "LoadVector");
+			ml.LoadVector(R);
+		}
 	}
 }
 
@@ -398,6 +404,7 @@ void FELinearSolver::Update(vector<double>& u)
 	for (int i=0; i<mesh.Domains(); ++i)
 	{
 		FEDomain& dom = mesh.Domain(i);
+		FE_PROFILE_COMPONENT(&dom, "Update");
 		dom.Update(tp);
 	}
 
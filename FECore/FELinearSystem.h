@@ -52,6 +52,9 @@ public:
 	// get symmetry flag
 	bool IsSymmetric() const;
 
+	// get the global stiffness matrix
+	FEGlobalMatrix& GetStiffnessMatrix() { return m_K; }
+
 public:
 	// Assembly routine
 	// This assembles the element stiffness matrix ke into the global matrix.
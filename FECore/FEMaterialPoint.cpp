@@ -80,6 +80,7 @@ void FEMaterialPointData::Serialize(DumpStream& ar)
 //=================================================================================================
 FEMaterialPoint::FEMaterialPoint(FEMaterialPointData* data)
 {
+	ClearLookup();
 	m_data = data;
 	m_elem = nullptr;
 	m_index = -1;
@@ -96,6 +97,7 @@ FEMaterialPoint::~FEMaterialPoint()
 // but we should not actually need to copy anything
 FEMaterialPoint::FEMaterialPoint(const FEMaterialPoint&)
 {
+	ClearLookup();
 	m_elem = nullptr;
 	m_shape = nullptr;
 	m_data = nullptr;
@@ -105,6 +107,7 @@ FEMaterialPoint::FEMaterialPoint(const FEMaterialPoint&)
 
 FEMaterialPoint& FEMaterialPoint::operator = (const FEMaterialPoint&)
 {
+	ClearLookup();
 	m_elem = nullptr;
 	m_shape = nullptr;
 	m_data = nullptr;
@@ -144,6 +147,39 @@ void FEMaterialPoint::Append(FEMaterialPointData* pt)
 	if (pt == nullptr) return;
 	assert(m_data);
 	if (m_data) m_data->Append(pt);
+	ClearLookup();
+}
+
+void FEMaterialPoint::ClearLookup()
+{
+	for (int i = 0; i < MAX_LOOKUP; ++i)
+	{
+		m_lookupId[i].store(nullptr);
+		m_lookup[i] = nullptr;
+	}
+}
+
+// Stores the result of a lookup in the first empty slot. A slot is claimed
+// before the data is written, and the type index is only published afterwards, so
+// that other threads never see a type index with the wrong data. 
+static char s_slotBusy = 0;
+void FEMaterialPoint::StoreData(const void* typeId, void* pd) const
+{
+	for (int i = 0; i < MAX_LOOKUP; ++i)
+	{
+		const void* id = m_lookupId[i].load(std::memory_order_acquire);
+		if (id == typeId) return;
+		if (id == nullptr)
+		{
+			const void* empty = nullptr;
+			if (m_lookupId[i].compare_exchange_strong(empty, &s_slotBusy))
+			{
+				m_lookup[i] = pd;
+				m_lookupId[i].store(typeId, std::memory_order_release);
+				return;
+			}
+		}
+	}
 }
 
 //=================================================================================================
@@ -32,10 +32,24 @@ SOFTWARE.*/
 #include "quatd.h"
 #include "FETimeInfo.h"
 #include <vector>
+#include <atomic>
+#include <type_traits>
 
 class FEElement;
 class FEMaterialPoint;
 
+//-----------------------------------------------------------------------------
+//! Type index of material point data classes, used for constant time lookups in
+//! ExtractData. The index is the address of a static member, so it is a compile-time
+//! constant and no registration or initialization is needed.
+template <class T> struct FEMaterialPointTypeID
+{
+	static char tag;
+	static const void* id() { return &tag; }
+};
+
+template <class T> char FEMaterialPointTypeID<T>::tag = 0;
+
 //-----------------------------------------------------------------------------
 //! Material point class
 
@@ -141,6 +155,13 @@ public:
 	template <class T> T* ExtractData();
 	template <class T> const T* ExtractData() const;
 
+private:
+	// Look up and store previous results of ExtractData. The slots are filled once 
+	// and never overwritten, so that concurrent lookups always see consistent entries. 
+	void* FindData(const void* typeId) const;
+	void StoreData(const void* typeId, void* pd) const;
+	void ClearLookup();
+
 public:
 	vec3d		m_r0;		//!< material point position
 	vec3d		m_rt;		//!< current point position
@@ -155,6 +176,11 @@ public:
 
 protected:
 	FEMaterialPointData* m_data;
+
+private:
+	enum { MAX_LOOKUP = 2 };
+	mutable std::atomic<const void*>	m_lookupId[MAX_LOOKUP];	//!< type index for each lookup slot (null = empty)
+	mutable void*				m_lookup[MAX_LOOKUP];	//!< data for each lookup slot
 };
 
 //-----------------------------------------------------------------------------
@@ -225,16 +251,42 @@ template <class T> inline const T* FEMaterialPointData::ExtractData() const
 	return 0;
 }
 
+//-----------------------------------------------------------------------------
+inline void* FEMaterialPoint::FindData(const void* typeId) const
+{
+	for (int i = 0; i < MAX_LOOKUP; ++i)
+	{
+		if (m_lookupId[i].load(std::memory_order_acquire) == typeId) return m_lookup[i];
+	}
+	return nullptr;
+}
+
 //-----------------------------------------------------------------------------
 template <class T> inline T* FEMaterialPoint::ExtractData()
 {
-	return (m_data ? m_data->ExtractData<T>() : nullptr);
+	if (m_data == nullptr) return nullptr;
+
+	const void* typeId = FEMaterialPointTypeID<typename std::remove_cv<T>::type>::id();
+	void* pd = FindData(typeId);
+	if (pd) return static_cast<T*>(pd);
+
+	T* p = m_data->ExtractData<T>();
+	if (p) StoreData(typeId, p);
+	return p;
 }
 
 //-----------------------------------------------------------------------------
 template <class T> inline const T* FEMaterialPoint::ExtractData() const
 {
-	return (m_data ? m_data->ExtractData<T>() : nullptr);
+	if (m_data == nullptr) return nullptr;
+
+	const void* typeId = FEMaterialPointTypeID<typename std::remove_cv<T>::type>::id();
+	void* pd = FindData(typeId);
+	if (pd) return static_cast<const T*>(pd);
+
+	const T* p = static_cast<const FEMaterialPointData*>(m_data)->ExtractData<T>();
+	if (p) StoreData(typeId, const_cast<void*>(static_cast<const void*>(p)));
+	return p;
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,89 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "FEMeshPartition.h"
+#include "FEMaterialPoint.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! Lookup cache for material point data. For each integration point of a domain this 
+//! caches the pointer that FEMaterialPoint::ExtractData returns for data of type T, so 
+//! that domains can find the data in constant time. The data itself stays in the 
+//! material points. The cache must be rebuilt when the material point data of the 
+//! domain is reallocated.
+template <class T> class FEMaterialPointCache
+{
+public:
+	FEMaterialPointCache() {}
+
+	//! Build the cache for all the integration points of the domain. Returns false if
+	//! the data of type T could not be found at any of the integration points.
+	bool Create(FEMeshPartition& dom)
+	{
+		Clear();
+
+		const int NE = dom.Elements();
+		m_offset.resize(NE + 1);
+		m_offset[0] = 0;
+		for (int i = 0; i < NE; ++i) m_offset[i + 1] = m_offset[i] + dom.ElementRef(i).GaussPoints();
+
+		m_data.resize(m_offset[NE]);
+		for (int i = 0; i < NE; ++i)
+		{
+			FEElement& el = dom.ElementRef(i);
+			T** pd = &m_data[m_offset[i]];
+			for (int n = 0; n < el.GaussPoints(); ++n)
+			{
+				pd[n] = el.GetMaterialPoint(n)->template ExtractData<T>();
+				if (pd[n] == nullptr) { Clear(); return false; }
+			}
+		}
+		return true;
+	}
+
+	//! clear the cache
+	void Clear()
+	{
+		m_offset.clear();
+		m_data.clear();
+	}
+
+	//! see if the cache is empty
+	bool IsEmpty() const { return m_data.empty(); }
+
+	//! number of elements in the cache
+	int Elements() const { return (m_offset.empty() ? 0 : (int)m_offset.size() - 1); }
+
+	//! get the data of integration point n of element iel
+	T& operator () (int iel, int n) { return *m_data[m_offset[iel] + n]; }
+	const T& operator () (int iel, int n) const { return *m_data[m_offset[iel] + n]; }
+
+private:
+	std::vector<int>	m_offset;	//!< offset into pointer array for each element
+	std::vector<T*>		m_data;		//!< pointers to the data of all integration points
+};
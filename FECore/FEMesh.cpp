@@ -44,6 +44,7 @@ SOFTWARE.*/
 #include "FENodeDataMap.h"
 #include "DumpStream.h"
 #include "FECoreKernel.h"
+#include "FEProfiler.h"
 #include <algorithm>
 
 //-----------------------------------------------------------------------------
@@ -1127,7 +1128,11 @@ void FEMesh::Update(const FETimeInfo& tp)
 	for (int i = 0; i<Domains(); ++i)
 	{
 		FEDomain& dom = Domain(i);
-		if (dom.IsActive()) dom.Update(tp);
+		if (dom.IsActive())
+		{
+			FE_PROFILE_COMPONENT(&dom, "Update");
+			dom.Update(tp);
+		}
 	}
 }
 
@@ -54,8 +54,9 @@ SOFTWARE.*/
 #include "DumpStream.h"
 #include "LinearSolver.h"
 #include "FETimeStepController.h"
+#include "FEProfiler.h"
 #include "Timer.h"
-#include "DumpMemStream.h"
+#include "FEStateSnapshot.h"
 #include "FEPlotDataStore.h"
 #include "FESolidDomain.h"
 #include "FEShellDomain.h"
@@ -126,7 +127,7 @@ public:
 	};
 
 public:
-	Implementation(FEModel* fem) : m_fem(fem), m_mesh(fem), m_dmp(*fem)
+	Implementation(FEModel* fem) : m_fem(fem), m_mesh(fem), m_state(*fem)
 	{
 		// --- Analysis Data ---
 		m_pStep = 0;
@@ -155,26 +156,14 @@ public:
 
 	void PushState()
 	{
-		DumpMemStream& ar = m_dmp;
-		ar.clear(); // this also prepares the stream for writing
-		m_fem->Serialize(ar);
+		m_state.Save();
 	}
 
 	bool PopState()
 	{
-		// get the dump stream
-		DumpMemStream& ar = m_dmp;
-
-		// make sure we have data to rewind
-		if (ar.size() == 0) return false;
-
-		// prepare the archive for reading
-		ar.Open(false, true);
-
 		// restore the previous state
-		m_fem->Serialize(m_dmp);
-
-		return true;
+		// (this returns false if there is no data to rewind)
+		return m_state.Restore();
 	}
 
 	std::pair<int, int> FindComponent(FECoreBase* pc)
@@ -247,7 +236,7 @@ public:
 
 	FEPlotDataStore	m_plotData;		//!< Output request for plot file
 
-	DumpMemStream	m_dmp;	// only used by incremental solver
+	FEStateSnapshot	m_state;	// only used by incremental solver
 
 public: // Global Data
 	std::map<string, double> m_Const;	//!< Global model constants
@@ -715,14 +704,22 @@ void FEModel::Update()
 		for (int i = 0; i < SurfacePairConstraints(); ++i)
 		{
 			FESurfacePairConstraint* psc = SurfacePairConstraint(i);
-			if (psc && psc->IsActive()) psc->Update();
+			if (psc && psc->IsActive())
+			{
+				FE_PROFILE_COMPONENT(psc, "Update");
+				psc->Update();
+			}
 		}
 
 		// update all constraints
 		for (int i = 0; i < NonlinearConstraints(); ++i)
 		{
 			FENLConstraint* pc = NonlinearConstraint(i);
-			if (pc && pc->IsActive()) pc->Update();
+			if (pc && pc->IsActive())
+			{
+				FE_PROFILE_COMPONENT(pc, "Update");
+				pc->Update();
+			}
 		}
 
 		// some of the loads may alter the prescribed dofs, so we update the mesh again
@@ -1258,8 +1255,8 @@ bool FEModel::RCI_Rewind()
 //-----------------------------------------------------------------------------
 bool FEModel::RCI_ClearRewindStack()
 {
-	if (m_imp->m_dmp.size() == 0) return false;
-	m_imp->m_dmp.clear();
+	if (m_imp->m_state.IsEmpty()) return false;
+	m_imp->m_state.Clear();
 	return true;
 }
 
@@ -2020,6 +2017,13 @@ bool FEModel::LogBlocked() const
 	return m_imp->m_block_log;
 }
 
+//-----------------------------------------------------------------------------
+bool FEModel::RedirectOutput(const std::string& suffix)
+{
+	// the base class does not write any files
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 void FEModel::SetGlobalConstant(const string& s, double v)
 {
@@ -2458,6 +2462,16 @@ void FEModel::SerializeGeometry(DumpStream& ar)
 	ar & m_imp->m_mesh;
 }
 
+//-----------------------------------------------------------------------------
+void FEModel::SerializeState(DumpStream& ar)
+{
+	assert(ar.IsShallow());
+	ar & m_imp->m_timeInfo;
+	ar & m_imp->m_CI;
+	ar & m_imp->m_NLC;
+	ar & m_imp->m_Step;
+}
+
 //-----------------------------------------------------------------------------
 // This function serializes data to a stream.
 // This is used for running and cold restarts.
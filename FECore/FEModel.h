@@ -385,6 +385,11 @@ public:	// --- Miscellaneous routines ---
 	//! Derived classes can override this
 	virtual void SerializeGeometry(DumpStream& ar);
 
+	//! Serialize the mutable state that is not stored in the mesh (shallow archives only).
+	//! This is used by FEStateSnapshot, which stores the mesh data itself. 
+	//! Derived classes that store additional state in SerializeGeometry should override this.
+	virtual void SerializeState(DumpStream& ar);
+
 	//! set the active module
 	void SetActiveModule(const std::string& moduleName);
 
@@ -402,6 +407,12 @@ public:
 	// Derived classes can use this to implement the actual logging mechanism
 	virtual void Log(int ntag, const char* msg);
 
+	//! This is called in a process that was forked from the process that owns the model.
+	//! The open output files are shared with the parent process and must not be written to. 
+	//! Derived classes that write output should write it to new files instead, whose names
+	//! are made unique with the suffix. 
+	virtual bool RedirectOutput(const std::string& suffix);
+
 public: // Global data
 	void AddGlobalData(FEGlobalData* psd);
 	FEGlobalData* GetGlobalData(int i);
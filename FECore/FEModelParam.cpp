@@ -102,6 +102,13 @@ FEScalarValuator* FEParamDouble::valuator()
 	return m_val;
 }
 
+// evaluate the parameter at n material points
+void FEParamDouble::operator () (FEMaterialPoint** mp, int n, double* val)
+{
+	m_val->values(mp, n, val);
+	if (m_scl != 1.0) for (int i = 0; i < n; ++i) val[i] *= m_scl;
+}
+
 // is this a const value
 bool FEParamDouble::isConst() const { return m_val->isConst(); };
 
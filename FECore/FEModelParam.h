@@ -88,6 +88,9 @@ public:
 	// evaluate the parameter at a material point
 	double operator () (const FEMaterialPoint& pt) { return m_scl*(*m_val)(pt); }
 
+	// evaluate the parameter at n material points
+	void operator () (FEMaterialPoint** mp, int n, double* val);
+
 	// is this a const value
 	bool isConst() const;
 
@@ -28,25 +28,19 @@ SOFTWARE.*/
 
 #pragma once
 #include "vec3d.h"
+#include "FEKDTree.h"
 #include <vector>
 #include "fecore_api.h"
 
 class FESurface;
 
 //-----------------------------------------------------------------------------
-//! This class is a helper class to locate the nearest neighbour on a surface
+//! This class is a helper class to locate the nearest neighbour on a surface.
+//! The surface nodes are stored in a KD-tree, which is built by Init (for the
+//! current positions) or InitReference (for the reference positions).
 
 class FECORE_API FENNQuery
 {
-public:
-	struct NODE
-	{
-		int		i;	// index of node
-		vec3d	r;	// position of node
-		double	d1;	// distance to pivot 1
-		double	d2;	// distance to pivot 2
-	};
-
 public:
 	FENNQuery(FESurface* ps = 0);
 	virtual ~FENNQuery();
@@ -62,18 +56,11 @@ public:
 	int Find(vec3d x);	
 	int FindReference(vec3d x);	
 
-protected:
-	int FindRadius(double r);
-
 protected:
 	FESurface*	m_ps;	//!< the surface to search
-	std::vector<NODE>	m_bk;	// BK tree
-
-	vec3d	m_q1;	// pivot 1
-	vec3d	m_q2;	// pivot 2
-
-	int		m_imin;	// last found index
+	FEKDTree	m_tree;	//!< KD-tree of the surface nodes
 };
 
-// function for finding the k closest neighbors
+// function for finding the k closest neighbors. This does a brute-force search
+// over all points, so for repeated queries on large point sets use FEKDTree instead.
 int FECORE_API findNeirestNeighbors(const std::vector<vec3d>& point, const vec3d& x, int k, std::vector<int>& closestNodes);
@@ -39,6 +39,7 @@ SOFTWARE.*/
 #include "FEDomain.h"
 #include "DumpStream.h"
 #include "FELinearSystem.h"
+#include "FEProfiler.h"
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -55,6 +56,10 @@ BEGIN_FECORE_CLASS(FENewtonSolver, FESolver)
 		ADD_PARAMETER(m_bzero_diagonal      , "check_zero_diagonal");
 		ADD_PARAMETER(m_zero_tol            , "zero_diagonal_tol"  );
 		ADD_PARAMETER(m_force_partition     , "force_partition");
+		ADD_PARAMETER(m_bcolored_assembly   , "colored_assembly");
+		ADD_PARAMETER(m_bscatter_maps       , "cache_scatter_maps");
+		ADD_PARAMETER(m_breuse_profile      , "reuse_profile");
+		ADD_PARAMETER(m_bpad_profile        , "pad_profile");
 		ADD_PARAMETER(m_breformtimestep     , "reform_each_time_step");
 		ADD_PARAMETER(m_breformAugment      , "reform_augment");
 		ADD_PARAMETER(m_bdivreform          , "diverge_reform");
@@ -98,6 +103,10 @@ FENewtonSolver::FENewtonSolver(FEModel* pfem) : FESolver(pfem)
 	m_zero_tol = 0.0;
 
 	m_force_partition = 0;
+	m_bcolored_assembly = false;
+	m_bscatter_maps = false;
+	m_breuse_profile = false;
+	m_bpad_profile = false;
 	m_breformtimestep = true;
 	m_breformAugment = false;
 }
@@ -204,7 +213,10 @@ bool FENewtonSolver::ReformStiffness()
 		zero(m_Fd);
 
 		// calculate the global stiffness matrix
-	    bret = StiffnessMatrix();
+		{
+			FE_PROFILE_COMPONENT(this, "StiffnessMatrix");
+			bret = StiffnessMatrix();
+		}
 
 		// check for zero diagonals
 		if (m_bzero_diagonal)
@@ -232,6 +244,7 @@ bool FENewtonSolver::ReformStiffness()
     {
         {
 			TRACK_TIME(TimerID::Timer_LinSol_Factor);
+			FE_PROFILE_COMPONENT(m_plinsolve, "Factor");
 			// factorize the stiffness matrix
 			if (m_plinsolve->Factor() == false)
 			{
@@ -278,6 +291,35 @@ bool FENewtonSolver::CreateStiffness(bool breset)
 {
 	{
 		TRACK_TIME(TimerID::Timer_Reform);
+
+		// build the new matrix profile
+		m_pK->BuildProfile(GetFEModel(), m_neq, breset);
+
+		// When only the "dynamic" part of the profile was rebuilt (e.g. for contact), see if the 
+		// current matrix can hold the new profile. If so, we can keep the matrix structure and 
+		// skip the preprocessing (e.g. symbolic factorization) of the linear solver.
+		// A shared static profile never changes, so then this also applies when the profile is reset.
+		bool bstatic = ((breset == false) || m_pK->HasSharedStaticProfile());
+		if (m_breuse_profile && bstatic && m_pK->IsProfileAllocated())
+		{
+			feLog("===== reusing stiffness matrix profile\n");
+			if (m_plinsolve->IsPreProcessStructural())
+			{
+				m_plinsolve->SetStructureReused();
+				return true;
+			}
+
+			// the solver's preprocessing may depend on more than the sparsity pattern, so redo it
+			m_plinsolve->Destroy();
+			FE_PROFILE_COMPONENT(m_plinsolve, "PreProcess");
+			if (!m_plinsolve->PreProcess())
+			{
+				feLogError("An error occurred during preprocessing of linear solver");
+				return false;
+			}
+			return true;
+		}
+
 		// clean up the solver
 		m_plinsolve->Destroy();
 
@@ -286,7 +328,7 @@ bool FENewtonSolver::CreateStiffness(bool breset)
 
 		// create the stiffness matrix
 		feLog("===== reforming stiffness matrix:\n");
-		if (m_pK->Create(GetFEModel(), m_neq, breset) == false)
+		if (m_pK->CreateFromProfile(GetFEModel()) == false)
 		{
 			feLogError("An error occured while building the stiffness matrix\n\n");
 			return false;
@@ -313,6 +355,7 @@ bool FENewtonSolver::CreateStiffness(bool breset)
 
 	// Do the preprocessing of the solver
 	{
+		FE_PROFILE_COMPONENT(m_plinsolve, "PreProcess");
 		if (!m_plinsolve->PreProcess())
 		{
 			feLogError("An error occurred during preprocessing of linear solver");
@@ -406,6 +449,16 @@ bool FENewtonSolver::AllocateLinearSystem()
 		feLogError("Failed allocating stiffness matrix.");
 		return false;
 	}
+	m_pK->SetColoredAssembly(m_bcolored_assembly);
+	m_pK->SetScatterMaps(m_bscatter_maps);
+	// padding only helps when the matrix structure can be reused, so it implies reuse_profile
+	if (m_bpad_profile && (m_breuse_profile == false))
+	{
+		feLogWarning("pad_profile requires reuse_profile. reuse_profile will be turned on.");
+		m_breuse_profile = true;
+	}
+	m_pK->SetProfileReuse(m_breuse_profile);
+	m_pK->SetProfilePadding(m_bpad_profile);
 
 	return true;
 }
@@ -850,6 +903,7 @@ void FENewtonSolver::SolveEquations(std::vector<double>& u, std::vector<double>&
 	// call the qn strategy to actually solve the equations
 	{
 		TRACK_TIME(TimerID::Timer_LinSol_Backsolve);
+		FE_PROFILE_COMPONENT(m_plinsolve, "BackSolve");
 		m_qnstrategy->SolveEquations(u, R);
 	}
 
@@ -980,6 +1034,7 @@ bool FENewtonSolver::DoAugmentations()
 		{
 			// TODO: Why is this not calling strategy->Residual? 
 			TRACK_TIME(TimerID::Timer_Residual);
+			FE_PROFILE_COMPONENT(this, "Residual");
 			Residual(m_R0);
 		}
 
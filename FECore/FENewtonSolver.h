@@ -224,6 +224,10 @@ public:
 	// solver parameters
 	int					m_maxref;		//!< max nr of reformations per time step
 	int					m_force_partition;	//!< Force a partition of the global matrix (e.g. for testing with BIPN solver)
+	bool				m_bcolored_assembly;	//!< use element coloring instead of atomic updates for assembly
+	bool				m_bscatter_maps;	//!< precompute the element scatter maps for assembly
+	bool				m_breuse_profile;	//!< reuse the matrix structure when the profile did not change
+	bool				m_bpad_profile;		//!< keep the entries of previous profiles in the matrix structure
 	double				m_Rtol;			//!< residual convergence norm
 	double				m_Etol;			//!< energy convergence norm
 	double				m_Rmin;			//!< min residual value
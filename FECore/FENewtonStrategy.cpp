@@ -73,6 +73,7 @@ bool FENewtonStrategy::ReformStiffness()
 bool FENewtonStrategy::Residual(std::vector<double>& R, bool binit)
 {
 	TRACK_TIME(TimerID::Timer_Residual);
+	FE_PROFILE_COMPONENT(m_pns, "Residual");
 	return m_pns->Residual(R);
 }
 
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FENode.h"
 #include "DumpStream.h"
+#include <string.h>
 
 //=============================================================================
 // FENode
@@ -128,6 +129,40 @@ void FENode::Serialize(DumpStream& ar)
 	}
 }
 
+//-----------------------------------------------------------------------------
+// the vectors in the flat state array
+#define FENODE_STATE_VEC3D(node) { &node.m_rt, &node.m_at, &node.m_rp, &node.m_vp, &node.m_ap, &node.m_dt, &node.m_dp }
+static const int FENODE_STATE_VECS = 7;
+
+//-----------------------------------------------------------------------------
+//! Number of values of the flat state array
+int FENode::StateSize() const
+{
+	return 3 * FENODE_STATE_VECS + (int)(m_val_t.size() + m_val_p.size() + m_Fr.size());
+}
+
+//-----------------------------------------------------------------------------
+//! Copy the shallow state to a flat array of StateSize() values
+void FENode::SaveState(double* d) const
+{
+	const vec3d* v[FENODE_STATE_VECS] = FENODE_STATE_VEC3D((*this));
+	for (int j = 0; j < FENODE_STATE_VECS; ++j, d += 3) { d[0] = v[j]->x; d[1] = v[j]->y; d[2] = v[j]->z; }
+	if (m_val_t.empty() == false) { memcpy(d, m_val_t.data(), m_val_t.size() * sizeof(double)); d += m_val_t.size(); }
+	if (m_val_p.empty() == false) { memcpy(d, m_val_p.data(), m_val_p.size() * sizeof(double)); d += m_val_p.size(); }
+	if (m_Fr.empty() == false) memcpy(d, m_Fr.data(), m_Fr.size() * sizeof(double));
+}
+
+//-----------------------------------------------------------------------------
+//! Restore the shallow state from a flat array
+void FENode::RestoreState(const double* d)
+{
+	vec3d* v[FENODE_STATE_VECS] = FENODE_STATE_VEC3D((*this));
+	for (int j = 0; j < FENODE_STATE_VECS; ++j, d += 3) *v[j] = vec3d(d[0], d[1], d[2]);
+	if (m_val_t.empty() == false) { memcpy(m_val_t.data(), d, m_val_t.size() * sizeof(double)); d += m_val_t.size(); }
+	if (m_val_p.empty() == false) { memcpy(m_val_p.data(), d, m_val_p.size() * sizeof(double)); d += m_val_p.size(); }
+	if (m_Fr.empty() == false) memcpy(m_Fr.data(), d, m_Fr.size() * sizeof(double));
+}
+
 //-----------------------------------------------------------------------------
 //! Update nodal values, which copies the current values to the previous array
 void FENode::UpdateValues()
@@ -148,6 +148,13 @@ public:
 	bool is_active(int ndof) const { return ((m_BC[ndof] & 0xF0) != 0); }
 
 	int dofs() const { return (int) m_ID.size(); }
+
+public:
+	// Copy the data that is stored in a shallow archive to and from a flat array.
+	// (used by FEStateSnapshot)
+	int StateSize() const;
+	void SaveState(double* d) const;
+	void RestoreState(const double* d);
     
 public:
 	// return position of shell back-node
@@ -35,13 +35,93 @@ FENormalProjection::FENormalProjection(FESurface& s) : m_surf(s)
 {
 	m_tol = 0.0;
 	m_rad = 0.0;
+	m_bincremental = false;
+	m_bbvh = false;
 }
 
 //-----------------------------------------------------------------------------
 void FENormalProjection::Init()
 {
-	m_OT.Attach(&m_surf);
-	m_OT.Init(m_tol);
+	InitSearch();
+
+	// the neighbor list only depends on the surface's connectivity, so it is not 
+	// rebuilt when the surface moves
+	if (m_bincremental) m_EEL.Create(&m_surf);
+}
+
+//-----------------------------------------------------------------------------
+void FENormalProjection::InitSearch()
+{
+	if (m_bbvh)
+	{
+		m_BVH.Attach(&m_surf);
+		m_BVH.Init(m_tol);
+	}
+	else
+	{
+		m_OT.Attach(&m_surf);
+		m_OT.Init(m_tol);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FENormalProjection::Update()
+{
+	if (m_bbvh && m_BVH.IsValid()) m_BVH.Refit();
+	else InitSearch();
+}
+
+//-----------------------------------------------------------------------------
+void FENormalProjection::FindCandidateSurfaceElements(const vec3d& r, const vec3d& n, std::set<int>& selist) const
+{
+	if (m_bbvh) m_BVH.FindCandidateSurfaceElements(r, n, selist, m_rad);
+	else m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
+}
+
+//-----------------------------------------------------------------------------
+//! This function first checks the element pe and its direct neighbors for an
+//! intersection and only searches the entire surface if none is found. The 
+//! intersection criteria are the same as in Project(vec3d, vec3d, double*).
+//!
+FESurfaceElement* FENormalProjection::Project(const vec3d& r, const vec3d& n, double rs[2], FESurfaceElement* pe)
+{
+	if ((pe == nullptr) || (m_bincremental == false)) return Project(r, n, rs);
+
+	// check the element and its neighbors
+	const int NMAX = FEElement::MAX_NODES;
+	FESurfaceElement* pel[NMAX + 1];
+	int nel = 0;
+	pel[nel++] = pe;
+	int nid = pe->m_lid;
+	int N = pe->facet_edges();
+	for (int k = 0; k < N; ++k)
+	{
+		FESurfaceElement* pk = static_cast<FESurfaceElement*>(m_EEL.Neighbor(nid, k));
+		if (pk) pel[nel++] = pk;
+	}
+
+	bool found = false;
+	double rsl[2], gl, g = 0;
+	FESurfaceElement* pei = 0;
+	for (int i = 0; i < nel; ++i)
+	{
+		FESurfaceElement* pi = pel[i];
+		if (pi->isActive() && m_surf.Intersect(*pi, r, n, rsl, gl, m_tol))
+		{
+			if ((gl > -m_rad) && ((!found) || (gl < g)))
+			{
+				found = true;
+				g = gl;
+				rs[0] = rsl[0];
+				rs[1] = rsl[1];
+				pei = pi;
+			}
+		}
+	}
+	if (found) return pei;
+
+	// do a global search
+	return Project(r, n, rs);
 }
 
 //-----------------------------------------------------------------------------
@@ -54,7 +134,7 @@ FESurfaceElement* FENormalProjection::Project(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
 	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
+	FindCandidateSurfaceElements(r, n, selist);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
@@ -102,7 +182,7 @@ FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
 	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
+	FindCandidateSurfaceElements(r, n, selist);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
@@ -145,7 +225,7 @@ FESurfaceElement* FENormalProjection::Project3(const vec3d& r, const vec3d& n, d
 {
 	// let's find all the candidate surface elements
 	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist, m_rad);
+	FindCandidateSurfaceElements(r, n, selist);
 
 	double g, gmax = -1e99, r2[2] = {rs[0], rs[1]};
 	int imin = -1;
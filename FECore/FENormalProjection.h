@@ -29,10 +29,14 @@ SOFTWARE.*/
 #pragma once
 #include "FESurface.h"
 #include "FEOctree.h"
+#include "FEElemElemList.h"
+#include "FESurfaceBVH.h"
 
 //-----------------------------------------------------------------------------
 //! This class calculates the normal projection on to a surface.
 //! This is used by some contact algorithms.
+//! After Init, the projection functions do not modify this class, so they
+//! can be called from multiple threads.
 class FECORE_API FENormalProjection
 {
 public:
@@ -42,23 +46,49 @@ public:
 	// initialization
 	void Init();
 
+	//! Update the search structures after the surface has moved. With the bounding 
+	//! volume hierarchy this only refits the boxes, otherwise the octree is rebuilt.
+	void Update();
+
 	void SetTolerance(double tol) { m_tol = tol; }
 	void SetSearchRadius(double srad) { m_rad = srad; }
 
+	//! Set if the element-neighbor list needs to be built. This is required
+	//! for the incremental projection below.
+	void SetIncrementalSearch(bool b) { m_bincremental = b; }
+
+	//! Use a bounding volume hierarchy instead of an octree to find candidate elements
+	void UseBVH(bool b) { m_bbvh = b; }
+
 public:
 	//! find the intersection of a ray with the surface
 	FESurfaceElement* Project(vec3d r, vec3d n, double rs[2]);
 	FESurfaceElement* Project2(vec3d r, vec3d n, double rs[2]);
 	FESurfaceElement* Project3(const vec3d& r, const vec3d& n, double rs[2], int* pei = 0);
 
+	//! Find the intersection of a ray with the surface, starting with element pe and 
+	//! its neighbors, before searching the entire surface.
+	FESurfaceElement* Project(const vec3d& r, const vec3d& n, double rs[2], FESurfaceElement* pe);
+
 	vec3d Project(const vec3d& r, const vec3d& N);
 	vec3d Project2(const vec3d& r, const vec3d& N);
 
+private:
+	//! build the search structure for the current surface position
+	void InitSearch();
+
+	//! find all candidate surface elements intersected by ray
+	void FindCandidateSurfaceElements(const vec3d& r, const vec3d& n, std::set<int>& selist) const;
+
 private:
 	double	m_tol;	//!< projection tolerance
 	double	m_rad;	//!< search radius
+	bool	m_bincremental;	//!< build data for incremental search
+	bool	m_bbvh;			//!< use bounding volume hierarchy instead of octree
 
 private:
 	FESurface&	m_surf;	//!< the target surface
 	FEOctree	m_OT;	//!< used to optimize ray-surface intersections
+	FESurfaceBVH	m_BVH;	//!< alternative to octree
+	FEElemElemList	m_EEL;	//!< element neighbor list (for incremental search)
 };
@@ -139,7 +139,7 @@ bool OTnode::ElementIntersectsNode(const int iel)
 // Determine if a ray intersects any of the faces of this node.
 // The ray originates at p and is directed along the unit vector n
 
-bool OTnode::RayIntersectsNode(const vec3d& p, const vec3d& n)
+bool OTnode::RayIntersectsNode(const vec3d& p, const vec3d& n) const
 {
 	// check intersection with x-faces
 	if (n.x) {
@@ -197,7 +197,7 @@ bool OTnode::RayIntersectsNode(const vec3d& p, const vec3d& n)
 
 //-----------------------------------------------------------------------------
 // Find intersected octree leaves and return a set of their surface elements
-void OTnode::FindIntersectedLeaves(const vec3d& p, const vec3d& n, set<int>& sel, double srad)
+void OTnode::FindIntersectedLeaves(const vec3d& p, const vec3d& n, set<int>& sel, double srad) const
 {
 	// Check if octree node is within search radius from p.
 	bool bNodeWithinSRad = ( (cmin.x - srad <= p.x) && (cmax.x + srad >= p.x) &&
@@ -316,7 +316,7 @@ void FEOctree::Init(const double stol)
 	return;
 }
 
-void FEOctree::FindCandidateSurfaceElements(vec3d p, vec3d n, set<int>& sel, double srad)
+void FEOctree::FindCandidateSurfaceElements(vec3d p, vec3d n, set<int>& sel, double srad) const
 {
 	root.FindIntersectedLeaves(p, n, sel, srad);
 }
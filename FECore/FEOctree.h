@@ -47,8 +47,8 @@ public:
 	void FillNode(const std::vector<int>& parent_selist);
 	bool ElementIntersectsNode(const int j);
 	void PrintNodeContent();
-	bool RayIntersectsNode(const vec3d& p, const vec3d& n);
-	void FindIntersectedLeaves(const vec3d& p, const vec3d& n, std::set<int>& sel, double srad);
+	bool RayIntersectsNode(const vec3d& p, const vec3d& n) const;
+	void FindIntersectedLeaves(const vec3d& p, const vec3d& n, std::set<int>& sel, double srad) const;
 	void CountNodes(int& nnode, int& nlevel);
 	
 public:
@@ -76,7 +76,8 @@ public:
 	void Init(const double stol);
 	
 	//! find all candidate surface elements intersected by ray
-	void FindCandidateSurfaceElements(vec3d p, vec3d n, std::set<int>& sel, double srad);
+	//! (this does not modify the octree, so it can be called from multiple threads)
+	void FindCandidateSurfaceElements(vec3d p, vec3d n, std::set<int>& sel, double srad) const;
 	
 protected:
 	FESurface*	m_ps;	//!< the surface to search
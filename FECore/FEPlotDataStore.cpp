@@ -28,7 +28,7 @@ SOFTWARE.*/
 #include "DumpStream.h"
 
 //-----------------------------------------------------------------------------
-FEPlotVariable::FEPlotVariable() {}
+FEPlotVariable::FEPlotVariable() { m_encError = 0.0; }
 
 //-----------------------------------------------------------------------------
 FEPlotVariable::FEPlotVariable(const FEPlotVariable& pv)
@@ -36,6 +36,9 @@ FEPlotVariable::FEPlotVariable(const FEPlotVariable& pv)
     m_svar = pv.m_svar;
     m_sdom = pv.m_sdom;
     m_item = pv.m_item;
+    m_encoding = pv.m_encoding;
+    m_encError = pv.m_encError;
+    m_encNodeSet = pv.m_encNodeSet;
 }
 
 //-----------------------------------------------------------------------------
@@ -44,6 +47,9 @@ void FEPlotVariable::operator = (const FEPlotVariable& pv)
     m_svar = pv.m_svar;
     m_sdom = pv.m_sdom;
     m_item = pv.m_item;
+    m_encoding = pv.m_encoding;
+    m_encError = pv.m_encError;
+    m_encNodeSet = pv.m_encNodeSet;
 }
 
 FEPlotVariable::FEPlotVariable(const std::string& var, std::vector<int>& item, const char* szdom)
@@ -51,6 +57,7 @@ FEPlotVariable::FEPlotVariable(const std::string& var, std::vector<int>& item, c
     m_svar = var;
     if (szdom) m_sdom = szdom;
     m_item = item;
+    m_encError = 0.0;
 }
 
 void FEPlotVariable::Serialize(DumpStream& ar)
@@ -58,21 +65,30 @@ void FEPlotVariable::Serialize(DumpStream& ar)
     ar & m_svar;
     ar & m_sdom;
     ar & m_item;
+    ar & m_encoding;
+    ar & m_encError;
+    ar & m_encNodeSet;
 }
 
 //=======================================================================================
 FEPlotDataStore::FEPlotDataStore()
 {
 	m_splot_type = "febio";
+	m_splot_encoding = "raw";
     m_plot.clear();
     m_nplot_compression = 0;
+    m_nplot_async = 0;
+    m_nplot_blocksize = 0;
 }
 
 //-----------------------------------------------------------------------------
 FEPlotDataStore::FEPlotDataStore(const FEPlotDataStore& plt)
 {
     m_splot_type = plt.m_splot_type;
+    m_splot_encoding = plt.m_splot_encoding;
     m_nplot_compression = plt.m_nplot_compression;
+    m_nplot_async = plt.m_nplot_async;
+    m_nplot_blocksize = plt.m_nplot_blocksize;
     m_plot = plt.m_plot;
 }
 
@@ -80,7 +96,10 @@ FEPlotDataStore::FEPlotDataStore(const FEPlotDataStore& plt)
 void FEPlotDataStore::operator = (const FEPlotDataStore& plt)
 {
     m_splot_type = plt.m_splot_type;
+    m_splot_encoding = plt.m_splot_encoding;
     m_nplot_compression = plt.m_nplot_compression;
+    m_nplot_async = plt.m_nplot_async;
+    m_nplot_blocksize = plt.m_nplot_blocksize;
     m_plot = plt.m_plot;
 }
 
@@ -103,6 +122,42 @@ void FEPlotDataStore::SetPlotCompression(int n)
     m_nplot_compression = n;
 }
 
+//-----------------------------------------------------------------------------
+int FEPlotDataStore::GetPlotAsyncQueue() const
+{
+    return m_nplot_async;
+}
+
+//-----------------------------------------------------------------------------
+void FEPlotDataStore::SetPlotAsyncQueue(int n)
+{
+    m_nplot_async = (n > 0 ? n : 0);
+}
+
+//-----------------------------------------------------------------------------
+int FEPlotDataStore::GetPlotBlockSize() const
+{
+    return m_nplot_blocksize;
+}
+
+//-----------------------------------------------------------------------------
+void FEPlotDataStore::SetPlotBlockSize(int n)
+{
+    m_nplot_blocksize = (n > 0 ? n : 0);
+}
+
+//-----------------------------------------------------------------------------
+const std::string& FEPlotDataStore::GetPlotDataEncoding() const
+{
+    return m_splot_encoding;
+}
+
+//-----------------------------------------------------------------------------
+void FEPlotDataStore::SetPlotDataEncoding(const std::string& encoding)
+{
+    m_splot_encoding = encoding;
+}
+
 //-----------------------------------------------------------------------------
 void FEPlotDataStore::SetPlotFileType(const std::string& fileType)
 {
@@ -117,6 +172,9 @@ std::string FEPlotDataStore::GetPlotFileType()
 void FEPlotDataStore::Serialize(DumpStream& ar)
 {
     ar & m_nplot_compression;
+    ar & m_nplot_async;
+    ar & m_nplot_blocksize;
     ar & m_splot_type;
+    ar & m_splot_encoding;
     ar & m_plot;
 }
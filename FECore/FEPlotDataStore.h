@@ -48,6 +48,11 @@ public:
 	std::string			m_svar;		//!< name of output variable
 	std::string			m_sdom;		//!< (optional) name of domain
 	std::vector<int>	m_item;		//!< (optional) list of items
+
+	// optional encoding of the data in the plot file
+	std::string			m_encoding;		//!< name of encoding (empty = no encoding)
+	double				m_encError;		//!< error bound for lossy encodings
+	std::string			m_encNodeSet;	//!< node set that is stored with full precision (farfield encoding)
 };
 
 class FECORE_API FEPlotDataStore
@@ -62,6 +67,18 @@ public:
 	int GetPlotCompression() const;
 	void SetPlotCompression(int n);
 
+	//! Number of states that can be queued for writing by a background thread (0 = write on the solver thread)
+	int GetPlotAsyncQueue() const;
+	void SetPlotAsyncQueue(int n);
+
+	//! Block size (in bytes) for compressing the states in independent blocks (0 = one compressed stream per state)
+	int GetPlotBlockSize() const;
+	void SetPlotBlockSize(int n);
+
+	//! Encoding of the appended data of vtu files ("raw" or "base64")
+	const std::string& GetPlotDataEncoding() const;
+	void SetPlotDataEncoding(const std::string& encoding);
+
 	void SetPlotFileType(const std::string& fileType);
 	std::string GetPlotFileType();
 
@@ -72,6 +89,9 @@ public:
 
 private:
 	std::string					m_splot_type;
+	std::string					m_splot_encoding;
 	std::vector<FEPlotVariable>	m_plot;
 	int							m_nplot_compression;
+	int							m_nplot_async;
+	int							m_nplot_blocksize;
 };
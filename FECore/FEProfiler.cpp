@@ -0,0 +1,353 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEProfiler.h"
+#include "FECoreBase.h"
+#include <stdio.h>
+#include <chrono>
+#include <map>
+#include <mutex>
+using namespace std::chrono;
+
+//-----------------------------------------------------------------------------
+namespace {
+
+	// a node in the scope tree of a thread
+	struct ScopeNode
+	{
+		std::string				name;
+		int						parent;
+		std::map<std::string, int>	children;
+		size_t					calls;
+		double					total;	// total time (in seconds)
+		double					child;	// time spent in child scopes
+	};
+
+	// a recorded scope, used for the trace file
+	struct TraceEvent
+	{
+		int		node;	// scope node
+		double	ts;		// start time (in seconds, since the profiler was created)
+		double	dur;	// duration (in seconds)
+	};
+
+	// the profiling data of a thread
+	struct ThreadData
+	{
+		int							tid;
+		std::vector<ScopeNode>		nodes;	// first node is the root
+		std::vector<int>			stack;	// active scopes
+		std::vector<double>			start;	// start times of the active scopes
+		std::vector<TraceEvent>		events;
+
+		void clear()
+		{
+			nodes.clear();
+			ScopeNode root;
+			root.parent = -1;
+			root.calls = 0;
+			root.total = root.child = 0.0;
+			nodes.push_back(root);
+			stack.assign(1, 0);
+			start.assign(1, 0.0);
+			events.clear();
+		}
+	};
+
+	// merged scope data for the summary
+	struct SummaryNode
+	{
+		std::string		name;
+		int				level;
+		size_t			calls = 0;
+		double			total = 0.0;
+		double			child = 0.0;
+		std::vector<std::string>	children;	// paths of the child scopes, in order of first appearance
+	};
+
+	// escape a string for JSON output
+	std::string json_string(const std::string& s)
+	{
+		std::string r;
+		for (char c : s)
+		{
+			if ((c == '"') || (c == '\\')) { r += '\\'; r += c; }
+			else if ((unsigned char)c < 0x20) r += ' ';
+			else r += c;
+		}
+		return r;
+	}
+}
+
+//-----------------------------------------------------------------------------
+struct FEProfiler::Imp
+{
+	std::mutex					mtx;
+	std::vector<ThreadData*>	threads;
+	steady_clock::time_point	t0;
+	bool						btrace = false;
+
+	~Imp()
+	{
+		for (ThreadData* td : threads) delete td;
+	}
+
+	double now() const
+	{
+		return duration<double>(steady_clock::now() - t0).count();
+	}
+
+	// Get the data of the calling thread. This is allocated the first time a thread records a scope. 
+	ThreadData& threadData()
+	{
+		static thread_local ThreadData* td = nullptr;
+		if (td == nullptr)
+		{
+			td = new ThreadData;
+			td->clear();
+
+			std::lock_guard<std::mutex> lock(mtx);
+			td->tid = (int)threads.size();
+			threads.push_back(td);
+		}
+		return *td;
+	}
+};
+
+//-----------------------------------------------------------------------------
+std::atomic<bool> FEProfiler::m_benabled(false);
+
+//-----------------------------------------------------------------------------
+FEProfiler* FEProfiler::GetInstance()
+{
+	static FEProfiler prof;
+	return &prof;
+}
+
+//-----------------------------------------------------------------------------
+FEProfiler::FEProfiler() : m(new FEProfiler::Imp)
+{
+	m->t0 = steady_clock::now();
+}
+
+//-----------------------------------------------------------------------------
+FEProfiler::~FEProfiler()
+{
+	delete m;
+}
+
+//-----------------------------------------------------------------------------
+void FEProfiler::Enable(bool b)
+{
+	m_benabled.store(b);
+}
+
+//-----------------------------------------------------------------------------
+void FEProfiler::SetTracing(bool b)
+{
+	m->btrace = b;
+}
+
+//-----------------------------------------------------------------------------
+void FEProfiler::Reset()
+{
+	std::lock_guard<std::mutex> lock(m->mtx);
+	for (ThreadData* td : m->threads) td->clear();
+	m->t0 = steady_clock::now();
+}
+
+//-----------------------------------------------------------------------------
+void FEProfiler::BeginScope(const char* szname)
+{
+	ThreadData& td = m->threadData();
+
+	// find the child of the current scope with this name
+	int parent = td.stack.back();
+	int node = -1;
+	std::map<std::string, int>& children = td.nodes[parent].children;
+	auto it = children.find(szname);
+	if (it == children.end())
+	{
+		node = (int)td.nodes.size();
+		children[szname] = node;
+
+		ScopeNode sn;
+		sn.name = szname;
+		sn.parent = parent;
+		sn.calls = 0;
+		sn.total = sn.child = 0.0;
+		td.nodes.push_back(sn);
+	}
+	else node = it->second;
+
+	td.stack.push_back(node);
+	td.start.push_back(m->now());
+}
+
+//-----------------------------------------------------------------------------
+void FEProfiler::EndScope()
+{
+	ThreadData& td = m->threadData();
+
+	// The root is never popped. (This can happen if the profiler was reset while a scope was active.)
+	if (td.stack.size() <= 1) return;
+
+	double t1 = m->now();
+	int node = td.stack.back();
+	double t0 = td.start.back();
+	td.stack.pop_back();
+	td.start.pop_back();
+
+	double dt = t1 - t0;
+	ScopeNode& sn = td.nodes[node];
+	sn.calls++;
+	sn.total += dt;
+	td.nodes[sn.parent].child += dt;
+
+	if (m->btrace)
+	{
+		TraceEvent ev = { node, t0, dt };
+		td.events.push_back(ev);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEProfiler::GetSummary(std::vector<std::string>& lines)
+{
+	lines.clear();
+
+	// Merge the scope trees of all threads. Scopes are identified by their path, 
+	// so the same scope on different threads is combined. 
+	std::map<std::string, SummaryNode> nodes;
+	SummaryNode& root = nodes[""];
+	root.level = -1;
+	{
+		std::lock_guard<std::mutex> lock(m->mtx);
+		double t1 = m->now();
+		for (ThreadData* td : m->threads)
+		{
+			// Scopes that are still active (e.g. when the summary is requested from 
+			// a callback) are included with the time they have been active so far.
+			std::vector<double> open(td->nodes.size(), 0.0);
+			for (size_t i = 1; i < td->stack.size(); ++i) open[td->stack[i]] = t1 - td->start[i];
+
+			std::vector<std::string> path(td->nodes.size());
+			for (size_t i = 1; i < td->nodes.size(); ++i)
+			{
+				const ScopeNode& sn = td->nodes[i];
+				const std::string& parentPath = path[sn.parent];
+				path[i] = parentPath + "/" + sn.name;
+
+				auto it = nodes.find(path[i]);
+				if (it == nodes.end())
+				{
+					SummaryNode& s = nodes[path[i]];
+					s.name = sn.name;
+					s.level = nodes[parentPath].level + 1;
+					nodes[parentPath].children.push_back(path[i]);
+					it = nodes.find(path[i]);
+				}
+
+				SummaryNode& s = it->second;
+				s.calls += sn.calls + (open[i] > 0.0 ? 1 : 0);
+				s.total += sn.total + open[i];
+				s.child += sn.child;
+				if (sn.parent > 0) nodes[parentPath].child += open[i];
+			}
+		}
+	}
+
+	// the total time of all top-level scopes
+	double total = 0.0;
+	for (const std::string& c : root.children) total += nodes[c].total;
+
+	char szline[512];
+	snprintf(szline, sizeof(szline), "%-60s %10s %12s %12s %8s", "scope", "calls", "total (s)", "self (s)", "%");
+	lines.push_back(szline);
+	lines.push_back(std::string(106, '-'));
+
+	// print the tree, depth first
+	std::vector<std::string> stack(root.children.rbegin(), root.children.rend());
+	while (stack.empty() == false)
+	{
+		std::string path = stack.back(); stack.pop_back();
+		SummaryNode& s = nodes[path];
+
+		std::string name = std::string(2 * s.level, ' ') + s.name;
+		if (name.size() > 60) name = name.substr(0, 57) + "...";
+		double self = s.total - s.child;
+		double pct = (total > 0.0 ? 100.0 * s.total / total : 0.0);
+		snprintf(szline, sizeof(szline), "%-60s %10zu %12.4lf %12.4lf %8.2lf", name.c_str(), s.calls, s.total, self, pct);
+		lines.push_back(szline);
+
+		for (auto it = s.children.rbegin(); it != s.children.rend(); ++it) stack.push_back(*it);
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool FEProfiler::WriteTrace(const char* szfile)
+{
+	FILE* fp = fopen(szfile, "wt");
+	if (fp == nullptr) return false;
+
+	std::lock_guard<std::mutex> lock(m->mtx);
+
+	fprintf(fp, "{\"traceEvents\":[\n");
+	bool bfirst = true;
+	for (ThreadData* td : m->threads)
+	{
+		for (const TraceEvent& ev : td->events)
+		{
+			std::string name = json_string(td->nodes[ev.node].name);
+			fprintf(fp, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3lf,\"dur\":%.3lf}", (bfirst ? "" : ",\n"), name.c_str(), td->tid, ev.ts*1e6, ev.dur*1e6);
+			bfirst = false;
+		}
+	}
+	fprintf(fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	fclose(fp);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEProfileScope::BeginComponentScope(FECoreBase* pc, const char* szfunc)
+{
+	std::string name;
+	if (pc)
+	{
+		const char* sztype = pc->GetTypeStr();
+		name = (sztype ? sztype : "?");
+		const std::string& compName = pc->GetName();
+		if (compName.empty() == false) name += " '" + compName + "'";
+		name += "::";
+	}
+	name += szfunc;
+	FEProfiler::GetInstance()->BeginScope(name.c_str());
+}
@@ -0,0 +1,121 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+class FECoreBase;
+
+//-----------------------------------------------------------------------------
+//! The profiler records the time spent in nested scopes, e.g. in the stiffness
+//! matrix of each domain or the factorization of the linear solver. This gives a 
+//! more detailed breakdown than the fixed timers of the model (see TimerID). 
+//! Each thread records its own scopes. The results can be printed as a summary 
+//! table and written to a trace file in the Chrome trace format. The profiler is 
+//! disabled by default, in which case a profiled scope only checks a flag.
+class FECORE_API FEProfiler
+{
+	struct Imp;
+
+public:
+	//! return the one and only profiler
+	static FEProfiler* GetInstance();
+
+	//! see if the profiler is enabled
+	static bool IsEnabled() { return m_benabled.load(std::memory_order_relaxed); }
+
+public:
+	//! enable or disable the profiler
+	void Enable(bool b);
+
+	//! store the individual scopes so that they can be written to a trace file
+	void SetTracing(bool b);
+
+	//! clear all the recorded data. 
+	//! This should not be called while scopes are being recorded.
+	void Reset();
+
+	//! start a new scope on the calling thread
+	void BeginScope(const char* szname);
+
+	//! end the last scope of the calling thread
+	void EndScope();
+
+	//! Get the summary table. This lists the number of calls and the total and 
+	//! exclusive times of each scope, combined over all threads.
+	void GetSummary(std::vector<std::string>& lines);
+
+	//! write the recorded scopes to a trace file in the Chrome trace format
+	bool WriteTrace(const char* szfile);
+
+private:
+	FEProfiler();
+	~FEProfiler();
+	FEProfiler(const FEProfiler&) = delete;
+	void operator = (const FEProfiler&) = delete;
+
+private:
+	Imp*	m;
+
+	static std::atomic<bool>	m_benabled;
+};
+
+//-----------------------------------------------------------------------------
+//! Helper class for profiling the enclosing scope. 
+class FECORE_API FEProfileScope
+{
+public:
+	FEProfileScope(const char* szname)
+	{
+		m_bactive = FEProfiler::IsEnabled();
+		if (m_bactive) FEProfiler::GetInstance()->BeginScope(szname);
+	}
+
+	//! Profile a function of a model component. The name of the scope
+	//! is composed of the component's type, its name and the function name.
+	FEProfileScope(FECoreBase* pc, const char* szfunc)
+	{
+		m_bactive = FEProfiler::IsEnabled();
+		if (m_bactive) BeginComponentScope(pc, szfunc);
+	}
+
+	~FEProfileScope() { if (m_bactive) FEProfiler::GetInstance()->EndScope(); }
+
+private:
+	void BeginComponentScope(FECoreBase* pc, const char* szfunc);
+
+private:
+	bool	m_bactive;
+};
+
+#define FE_PROFILE_SCOPE(szname) FEProfileScope _profileScope(szname);
+#define FE_PROFILE_COMPONENT(pc, szfunc) FEProfileScope _profileScope(pc, szfunc);
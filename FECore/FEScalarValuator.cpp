@@ -38,6 +38,7 @@ SOFTWARE.*/
 bool FEMathExpression::Init(const std::string& expr, FECoreBase* pc)
 {
 	Clear();
+	m_code.Clear();
 
 	AddVariable("X");
 	AddVariable("Y");
@@ -106,6 +107,11 @@ bool FEMathExpression::Init(const std::string& expr, FECoreBase* pc)
 	}
 
 	assert(b);
+
+	// compile the expression for fast evaluation. If this fails, we'll
+	// fall back to evaluating the expression tree.
+	if (b) m_code.Compile(*this);
+
 	return b;
 }
 
@@ -113,11 +119,11 @@ void FEMathExpression::operator = (const FEMathExpression& me)
 {
 	MSimpleExpression::operator=(me);
 	m_vars = me.m_vars;
+	m_code = me.m_code;
 }
 
-double FEMathExpression::value(FEModel* fem, const FEMaterialPoint& pt)
+void FEMathExpression::fillVariables(FEModel* fem, const FEMaterialPoint& pt, double* var)
 {
-	std::vector<double> var(4 + m_vars.size());
 	var[0] = pt.m_r0.x;
 	var[1] = pt.m_r0.y;
 	var[2] = pt.m_r0.z;
@@ -144,7 +150,53 @@ double FEMathExpression::value(FEModel* fem, const FEMaterialPoint& pt)
 			}
 		}
 	}
-	return value_s(var);
+}
+
+double FEMathExpression::value(FEModel* fem, const FEMaterialPoint& pt)
+{
+	const int nvar = 4 + (int)m_vars.size();
+	if (m_code.IsValid() && (nvar <= MAX_VARS))
+	{
+		double var[MAX_VARS];
+		fillVariables(fem, pt, var);
+		return m_code.value(var);
+	}
+
+	std::vector<double> var(nvar);
+	fillVariables(fem, pt, var.data());
+	return (m_code.IsValid() ? m_code.value(var.data()) : value_s(var));
+}
+
+void FEMathExpression::values(FEModel* fem, FEMaterialPoint** mp, int n, double* val)
+{
+	const int nvar = 4 + (int)m_vars.size();
+	if ((m_code.IsValid() == false) || (nvar > MAX_VARS))
+	{
+		for (int i = 0; i < n; ++i) val[i] = value(fem, *mp[i]);
+		return;
+	}
+
+	if (m_code.IsConst())
+	{
+		double v = m_code.value(nullptr);
+		for (int i = 0; i < n; ++i) val[i] = v;
+		return;
+	}
+
+	const int B = MCompiledExpression::BLOCK_SIZE;
+	double var[B*MAX_VARS];
+	for (int i0 = 0; i0 < n; i0 += B)
+	{
+		const int m = (n - i0 < B ? n - i0 : B);
+		for (int j = 0; j < m; ++j) fillVariables(fem, *mp[i0 + j], var + j*nvar);
+		m_code.value(m, var, nvar, val + i0);
+	}
+}
+
+//=============================================================================
+void FEScalarValuator::values(FEMaterialPoint** mp, int n, double* val)
+{
+	for (int i = 0; i < n; ++i) val[i] = (*this)(*mp[i]);
 }
 
 //=============================================================================
@@ -239,6 +291,11 @@ double FEMathValue::operator()(const FEMaterialPoint& pt)
 	return m_math.value(GetFEModel(), pt);
 }
 
+void FEMathValue::values(FEMaterialPoint** mp, int n, double* val)
+{
+	m_math.values(GetFEModel(), mp, n, val);
+}
+
 //---------------------------------------------------------------------------------------
 
 FEMappedValue::FEMappedValue(FEModel* fem) : FEScalarValuator(fem), m_val(nullptr)
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEValuator.h"
 #include "MathObject.h"
+#include "MCompiledExpression.h"
 #include "FEDataMap.h"
 #include "FENodeDataMap.h"
 
@@ -44,6 +45,9 @@ public:
 
 	virtual double operator()(const FEMaterialPoint& pt) = 0;
 
+	// evaluate the valuator at n material points
+	virtual void values(FEMaterialPoint** mp, int n, double* val);
+
 	virtual FEScalarValuator* copy() = 0;
 
 	virtual bool isConst() { return false; }
@@ -58,6 +62,8 @@ public:
 	FEConstValue(FEModel* fem) : FEScalarValuator(fem), m_val(0.0) {};
 	double operator()(const FEMaterialPoint& pt) override { return m_val; }
 
+	void values(FEMaterialPoint** mp, int n, double* val) override { for (int i = 0; i < n; ++i) val[i] = m_val; }
+
 	bool isConst() override { return true; }
 
 	double* constValue() override { return &m_val; }
@@ -80,6 +86,8 @@ class FEMathExpression : public MSimpleExpression
 		FEDataMap* map;
 	};
 
+	enum { MAX_VARS = 32 };	// max nr of variables for allocation-free evaluation
+
 public:
 	bool Init(const std::string& expr, FECoreBase* pc = nullptr);
 
@@ -87,8 +95,15 @@ public:
 
 	double value(FEModel* fem, const FEMaterialPoint& pt);
 
+	// evaluate the expression at n material points
+	void values(FEModel* fem, FEMaterialPoint** mp, int n, double* val);
+
+private:
+	void fillVariables(FEModel* fem, const FEMaterialPoint& pt, double* var);
+
 private:
 	std::vector<MathParam>	m_vars;
+	MCompiledExpression		m_code;	// compiled expression used for evaluation
 };
 
 //---------------------------------------------------------------------------------------
@@ -99,6 +114,8 @@ public:
 	~FEMathValue();
 	double operator()(const FEMaterialPoint& pt) override;
 
+	void values(FEMaterialPoint** mp, int n, double* val) override;
+
 	bool Init() override;
 
 	FEScalarValuator* copy() override;
@@ -2637,26 +2637,20 @@ void FESolidDomain::LoadVector(
 //-----------------------------------------------------------------------------
 void FESolidDomain::LoadStiffness(FELinearSystem& LS, const FEDofList& dofList_a, const FEDofList& dofList_b, FEVolumeMatrixIntegrand f)
 {
-#pragma omp parallel shared(f)
-	{
-	FEElementMatrix ke;
-
 	int dofPerNode_a = dofList_a.Size();
 	int dofPerNode_b = dofList_b.Size();
 
 	FEMesh& mesh = *GetMesh();
-	vec3d rt[FEElement::MAX_NODES];
 
-	matrix kab(dofPerNode_a, dofPerNode_b);
+	AssembleElements(LS, [&](int m) {
 
-	int NE = Elements();
-	#pragma omp for nowait
-	for (int m = 0; m < NE; ++m)
-	{
 		// get the element
 		FESolidElement& el = Element(m);
 		if (el.isActive())
 		{
+			FEElementMatrix ke;
+			matrix kab(dofPerNode_a, dofPerNode_b);
+
 			// calculate nodal normal tractions
 			int neln = el.Nodes();
 
@@ -2712,6 +2706,5 @@ void FESolidDomain::LoadStiffness(FELinearSystem& LS, const FEDofList& dofList_a
 			// assemble element matrix in global stiffness matrix
 			LS.Assemble(ke);
 		}
-	}
-	} // omp parallel
+	});
 }
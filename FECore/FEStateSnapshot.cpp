@@ -0,0 +1,138 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEStateSnapshot.h"
+#include "FEModel.h"
+#include "FEMesh.h"
+#include "FEDomain.h"
+#include "Timer.h"
+
+FEStateSnapshot::FEStateSnapshot(FEModel& fem) : m_fem(fem), m_modelData(fem)
+{
+	m_valid = false;
+	m_nodes = 0;
+	m_nodeStride = 0;
+}
+
+FEStateSnapshot::~FEStateSnapshot()
+{
+	for (DumpMemStream* ps : m_domData) delete ps;
+	m_domData.clear();
+}
+
+void FEStateSnapshot::Clear()
+{
+	m_valid = false;
+}
+
+size_t FEStateSnapshot::size() const
+{
+	if (m_valid == false) return 0;
+	size_t n = m_nodeData.size() * sizeof(double) + m_modelData.size();
+	for (const DumpMemStream* ps : m_domData) n += ps->size();
+	return n;
+}
+
+void FEStateSnapshot::Save()
+{
+	TRACK_TIME(TimerID::Timer_Serialize);
+
+	FEMesh& mesh = m_fem.GetMesh();
+
+	// nodal values
+	// (all nodes have the same number of dofs)
+	const int NN = mesh.Nodes();
+	m_nodes = NN;
+	m_nodeStride = (NN > 0 ? mesh.Node(0).StateSize() : 0);
+	m_nodeData.resize((size_t)NN * m_nodeStride);
+#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
+	{
+		FENode& node = mesh.Node(i);
+		assert(node.StateSize() == m_nodeStride);
+		node.SaveState(&m_nodeData[(size_t)i * m_nodeStride]);
+	}
+
+	// domain data
+	const int ND = mesh.Domains();
+	for (int i = (int)m_domData.size(); i < ND; ++i) m_domData.push_back(new DumpMemStream(m_fem));
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < ND; ++i)
+	{
+		DumpMemStream& ar = *m_domData[i];
+		ar.clear();
+		mesh.Domain(i).Serialize(ar);
+	}
+
+	// all other data
+	m_modelData.clear();
+	m_fem.SerializeState(m_modelData);
+
+	m_valid = true;
+
+	m_fem.DoCallback(CB_SERIALIZE_SAVE);
+}
+
+bool FEStateSnapshot::Restore()
+{
+	if (m_valid == false) return false;
+
+	TRACK_TIME(TimerID::Timer_Serialize);
+
+	FEMesh& mesh = m_fem.GetMesh();
+	assert(mesh.Nodes() == m_nodes);
+	assert(mesh.Domains() <= (int)m_domData.size());
+
+	// nodal values
+	const int NN = m_nodes;
+#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
+	{
+		mesh.Node(i).RestoreState(&m_nodeData[(size_t)i * m_nodeStride]);
+	}
+
+	// domain data
+	const int ND = mesh.Domains();
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < ND; ++i)
+	{
+		DumpMemStream& ar = *m_domData[i];
+		ar.Open(false, true);
+		mesh.Domain(i).Serialize(ar);
+	}
+
+	// all other data
+	m_modelData.Open(false, true);
+	m_fem.SerializeState(m_modelData);
+
+	m_fem.DoCallback(CB_SERIALIZE_LOAD);
+
+	return true;
+}
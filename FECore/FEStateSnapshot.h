@@ -0,0 +1,80 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include "DumpMemStream.h"
+#include <vector>
+
+class FEModel;
+
+//-----------------------------------------------------------------------------
+//! Snapshot of the mutable state of a model, used to retry a time step. 
+//! Unlike a shallow serialization of the whole model, the nodal values are copied
+//! into one flat array, so that saving and restoring them is a plain copy. The state 
+//! of each domain (i.e. the material point data) is stored in a separate buffer, 
+//! so that the domains can be saved and restored in parallel. The remaining state 
+//! (time, contact, constraints, steps and, for mechanics, the rigid bodies) is 
+//! small and is serialized as before. 
+//! The buffers are kept between calls to Save, so after the first time step no 
+//! memory needs to be allocated.
+class FECORE_API FEStateSnapshot
+{
+public:
+	FEStateSnapshot(FEModel& fem);
+	~FEStateSnapshot();
+
+	//! store the current state of the model
+	void Save();
+
+	//! restore the state of the model. Returns false if no state was saved.
+	bool Restore();
+
+	//! clear the snapshot (this keeps the allocated memory)
+	void Clear();
+
+	//! see if a state was saved
+	bool IsEmpty() const { return (m_valid == false); }
+
+	//! number of bytes used by the snapshot
+	size_t size() const;
+
+	//! the model of this snapshot
+	FEModel* GetFEModel() { return &m_fem; }
+
+private:
+	FEModel&	m_fem;
+	bool		m_valid;
+
+	int							m_nodes;		//!< nr of nodes stored
+	int							m_nodeStride;	//!< nr of values per node
+	std::vector<double>			m_nodeData;		//!< nodal values
+	std::vector<DumpMemStream*>	m_domData;		//!< state of each domain
+	DumpMemStream				m_modelData;	//!< all other state
+};
@@ -176,6 +176,23 @@ void FESurface::GetBoundaryFlags(std::vector<bool>& boundary) const
 	}
 }
 
+//-----------------------------------------------------------------------------
+bool FESurface::SharesNodes(const FESurface& s) const
+{
+	if (&s == this) return (Nodes() > 0);
+
+	const FEMesh* mesh = GetMesh();
+	if ((mesh == nullptr) || (s.GetMesh() != mesh)) return false;
+
+	std::vector<bool> tag(mesh->Nodes(), false);
+	for (int i = 0; i < Nodes(); ++i) tag[NodeIndex(i)] = true;
+	for (int i = 0; i < s.Nodes(); ++i)
+	{
+		if (tag[s.NodeIndex(i)]) return true;
+	}
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 // Create material point data for this surface
 FEMaterialPoint* FESurface::CreateMaterialPoint()
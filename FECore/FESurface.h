@@ -117,6 +117,9 @@ public:
 	//! Get a list of bools that indicate whether the corresponding node is on the boundary
 	// TODO: Move to MeshPartition
 	void GetBoundaryFlags(std::vector<bool>& boundary) const;
+
+	//! See if this surface has nodes in common with another surface (e.g. for self-contact)
+	bool SharesNodes(const FESurface& s) const;
     
     //! Set alpha parameter for intermediate time
     void SetAlpha(const double alpha) { m_alpha = alpha; }
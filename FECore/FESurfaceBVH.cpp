@@ -0,0 +1,340 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FESurfaceBVH.h"
+#include "FESurface.h"
+#include <algorithm>
+using namespace std;
+
+// max nr of elements in a leaf
+#define BVH_LEAF_SIZE	4
+
+// max depth of the tree (the tree is balanced, so this is never reached in practice)
+#define BVH_MAX_DEPTH	128
+
+//-----------------------------------------------------------------------------
+FESurfaceBVH::FESurfaceBVH(FESurface* ps)
+{
+	m_ps = ps;
+	m_stol = 0.0;
+	m_d = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Clear()
+{
+	m_node.clear();
+	m_elem.clear();
+}
+
+//-----------------------------------------------------------------------------
+// Build the tree top-down, by splitting the elements at the median of their 
+// centroids along the largest dimension of the centroids' bounding box.
+void FESurfaceBVH::Init(double stol)
+{
+	assert(m_ps);
+	Clear();
+	m_stol = stol;
+
+	int NE = m_ps->Elements();
+	if (NE == 0) return;
+
+	// calculate the element centroids
+	vector<vec3d> centroid(NE);
+	m_elem.resize(NE);
+	for (int i = 0; i < NE; ++i)
+	{
+		FESurfaceElement& el = m_ps->Element(i);
+		vec3d c(0, 0, 0);
+		int ne = el.Nodes();
+		for (int j = 0; j < ne; ++j) c += m_ps->Node(el.m_lnode[j]).m_rt;
+		centroid[i] = c / ne;
+		m_elem[i] = i;
+	}
+
+	// build the tree
+	m_node.reserve(2 * (NE / BVH_LEAF_SIZE + 1));
+	Build(0, NE, centroid);
+
+	// calculate the bounding boxes
+	Refit();
+}
+
+//-----------------------------------------------------------------------------
+int FESurfaceBVH::Build(int first, int count, vector<vec3d>& centroid)
+{
+	int nid = (int)m_node.size();
+	NODE node;
+	node.left = node.right = -1;
+	node.first = first;
+	node.count = count;
+	m_node.push_back(node);
+	if (count <= BVH_LEAF_SIZE) return nid;
+
+	// find the largest dimension of the centroids
+	vec3d cmin = centroid[m_elem[first]], cmax = cmin;
+	for (int i = first + 1; i < first + count; ++i)
+	{
+		const vec3d& c = centroid[m_elem[i]];
+		if (c.x < cmin.x) cmin.x = c.x;
+		if (c.x > cmax.x) cmax.x = c.x;
+		if (c.y < cmin.y) cmin.y = c.y;
+		if (c.y > cmax.y) cmax.y = c.y;
+		if (c.z < cmin.z) cmin.z = c.z;
+		if (c.z > cmax.z) cmax.z = c.z;
+	}
+	vec3d d = cmax - cmin;
+	int axis = 0;
+	if ((d.y > d.x) && (d.y >= d.z)) axis = 1;
+	else if ((d.z > d.x) && (d.z > d.y)) axis = 2;
+
+	// split at the median
+	int half = count / 2;
+	vector<int>::iterator it0 = m_elem.begin() + first;
+	nth_element(it0, it0 + half, it0 + count, [&](int a, int b) {
+		const vec3d& ca = centroid[a];
+		const vec3d& cb = centroid[b];
+		return (axis == 0 ? ca.x < cb.x : (axis == 1 ? ca.y < cb.y : ca.z < cb.z));
+	});
+
+	// create the children (which will be stored after this node)
+	int left  = Build(first, half, centroid);
+	int right = Build(first + half, count - half, centroid);
+
+	NODE& parent = m_node[nid];
+	parent.left  = left;
+	parent.right = right;
+	parent.first = -1;
+	parent.count = 0;
+	return nid;
+}
+
+//-----------------------------------------------------------------------------
+// The leaves' boxes are calculated from the nodal positions first. Since children
+// are stored after their parents, a single backward sweep then updates the rest.
+void FESurfaceBVH::Refit()
+{
+	if (m_node.empty()) return;
+	int N = (int)m_node.size();
+
+#pragma omp parallel for
+	for (int i = 0; i < N; ++i)
+	{
+		NODE& node = m_node[i];
+		if (node.left < 0)
+		{
+			FESurfaceElement& el0 = m_ps->Element(m_elem[node.first]);
+			vec3d cmin = m_ps->Node(el0.m_lnode[0]).m_rt, cmax = cmin;
+			for (int k = 0; k < node.count; ++k)
+			{
+				FESurfaceElement& el = m_ps->Element(m_elem[node.first + k]);
+				int ne = el.Nodes();
+				for (int j = 0; j < ne; ++j)
+				{
+					const vec3d& r = m_ps->Node(el.m_lnode[j]).m_rt;
+					if (r.x < cmin.x) cmin.x = r.x;
+					if (r.x > cmax.x) cmax.x = r.x;
+					if (r.y < cmin.y) cmin.y = r.y;
+					if (r.y > cmax.y) cmax.y = r.y;
+					if (r.z < cmin.z) cmin.z = r.z;
+					if (r.z > cmax.z) cmax.z = r.z;
+				}
+			}
+			node.cmin = cmin;
+			node.cmax = cmax;
+		}
+	}
+
+	for (int i = N - 1; i >= 0; --i)
+	{
+		NODE& node = m_node[i];
+		if (node.left >= 0)
+		{
+			const NODE& a = m_node[node.left];
+			const NODE& b = m_node[node.right];
+			node.cmin = vec3d(min(a.cmin.x, b.cmin.x), min(a.cmin.y, b.cmin.y), min(a.cmin.z, b.cmin.z));
+			node.cmax = vec3d(max(a.cmax.x, b.cmax.x), max(a.cmax.y, b.cmax.y), max(a.cmax.z, b.cmax.z));
+		}
+	}
+
+	// the tolerance is relative to the size of the surface (as in FEOctree)
+	m_d = (m_node[0].cmax - m_node[0].cmin).norm()*m_stol;
+}
+
+//-----------------------------------------------------------------------------
+// Check if the line through p along n intersects the (expanded) box of a node.
+bool FESurfaceBVH::RayIntersectsBox(const NODE& node, const vec3d& p, const vec3d& n) const
+{
+	const double pa[3] = { p.x, p.y, p.z };
+	const double na[3] = { n.x, n.y, n.z };
+	const double lo[3] = { node.cmin.x - m_d, node.cmin.y - m_d, node.cmin.z - m_d };
+	const double hi[3] = { node.cmax.x + m_d, node.cmax.y + m_d, node.cmax.z + m_d };
+
+	double tmin = -1e99, tmax = 1e99;
+	for (int i = 0; i < 3; ++i)
+	{
+		if (na[i] == 0.0)
+		{
+			if ((pa[i] < lo[i]) || (pa[i] > hi[i])) return false;
+		}
+		else
+		{
+			double t1 = (lo[i] - pa[i]) / na[i];
+			double t2 = (hi[i] - pa[i]) / na[i];
+			if (t1 > t2) { double t = t1; t1 = t2; t2 = t; }
+			if (t1 > tmin) tmin = t1;
+			if (t2 < tmax) tmax = t2;
+			if (tmin > tmax) return false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// squared distance of a point to the box of a node (zero if inside)
+double FESurfaceBVH::BoxDistance2(const NODE& node, const vec3d& x) const
+{
+	double dx = (x.x < node.cmin.x ? node.cmin.x - x.x : (x.x > node.cmax.x ? x.x - node.cmax.x : 0.0));
+	double dy = (x.y < node.cmin.y ? node.cmin.y - x.y : (x.y > node.cmax.y ? x.y - node.cmax.y : 0.0));
+	double dz = (x.z < node.cmin.z ? node.cmin.z - x.z : (x.z > node.cmax.z ? x.z - node.cmax.z : 0.0));
+	return dx*dx + dy*dy + dz*dz;
+}
+
+//-----------------------------------------------------------------------------
+template <class T> void FESurfaceBVH::FindCandidates(const vec3d& p, const vec3d& n, T& sel, double srad) const
+{
+	if (m_node.empty()) return;
+
+	// p must lie within this distance of a node's box
+	double R = srad + m_d;
+
+	int stack[BVH_MAX_DEPTH];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const NODE& node = m_node[stack[--ns]];
+
+		if ((p.x < node.cmin.x - R) || (p.x > node.cmax.x + R)) continue;
+		if ((p.y < node.cmin.y - R) || (p.y > node.cmax.y + R)) continue;
+		if ((p.z < node.cmin.z - R) || (p.z > node.cmax.z + R)) continue;
+		if (RayIntersectsBox(node, p, n) == false) continue;
+
+		if (node.left < 0)
+		{
+			for (int i = 0; i < node.count; ++i) sel.insert(sel.end(), m_elem[node.first + i]);
+		}
+		else
+		{
+			assert(ns + 2 <= BVH_MAX_DEPTH);
+			stack[ns++] = node.right;
+			stack[ns++] = node.left;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindCandidateSurfaceElements(const vec3d& p, const vec3d& n, set<int>& sel, double srad) const
+{
+	FindCandidates(p, n, sel, srad);
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindCandidateSurfaceElements(const vector<vec3d>& p, const vector<vec3d>& n, vector< vector<int> >& sel, double srad) const
+{
+	int N = (int)p.size();
+	assert(n.size() == p.size());
+	sel.resize(N);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < N; ++i)
+	{
+		sel[i].clear();
+		FindCandidates(p[i], n[i], sel[i], srad);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Branch-and-bound search: nodes that are further away than the closest node 
+// found so far are skipped, and the closer child is always visited first.
+int FESurfaceBVH::FindClosestNode(const vec3d& x) const
+{
+	if (m_node.empty()) return -1;
+
+	int imin = -1;
+	double d2min = 1e99;
+
+	int stack[BVH_MAX_DEPTH];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		// boxes at the same distance as the current closest node can still contain
+		// a node with a lower index, so only prune boxes that are farther away
+		const NODE& node = m_node[stack[--ns]];
+		if (BoxDistance2(node, x) > d2min) continue;
+
+		if (node.left < 0)
+		{
+			for (int k = 0; k < node.count; ++k)
+			{
+				FESurfaceElement& el = m_ps->Element(m_elem[node.first + k]);
+				int ne = el.Nodes();
+				for (int j = 0; j < ne; ++j)
+				{
+					int nj = el.m_lnode[j];
+					vec3d r = m_ps->Node(nj).m_rt;
+					double d2 = (r - x)*(r - x);
+					if ((d2 < d2min) || ((d2 == d2min) && (nj < imin)))
+					{
+						d2min = d2;
+						imin = nj;
+					}
+				}
+			}
+		}
+		else
+		{
+			assert(ns + 2 <= BVH_MAX_DEPTH);
+			double dl = BoxDistance2(m_node[node.left], x);
+			double dr = BoxDistance2(m_node[node.right], x);
+			if (dl <= dr) { stack[ns++] = node.right; stack[ns++] = node.left; }
+			else { stack[ns++] = node.left; stack[ns++] = node.right; }
+		}
+	}
+
+	return imin;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindClosestNodes(const vector<vec3d>& x, vector<int>& nodes) const
+{
+	int N = (int)x.size();
+	nodes.resize(N);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < N; ++i) nodes[i] = FindClosestNode(x[i]);
+}
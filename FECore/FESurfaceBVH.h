@@ -0,0 +1,102 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "vec3d.h"
+#include "fecore_api.h"
+#include <vector>
+#include <set>
+
+class FESurface;
+
+//-----------------------------------------------------------------------------
+//! Bounding volume hierarchy (a binary tree of axis-aligned bounding boxes) of the
+//! elements of a surface. It can be used instead of the FEOctree to find candidate
+//! elements for ray-surface intersections, and instead of the FENNQuery to find the
+//! closest surface node. Unlike these classes, the hierarchy does not need to be
+//! rebuilt when the surface deforms. Refit updates the bounding boxes from the current
+//! nodal positions in linear time, while the tree topology is kept.
+//! The query functions do not modify the hierarchy, so they can be called from
+//! multiple threads.
+class FECORE_API FESurfaceBVH
+{
+	struct NODE
+	{
+		vec3d	cmin, cmax;		//!< bounding box
+		int		left, right;	//!< child nodes (-1 for leaves)
+		int		first, count;	//!< range into element list (leaves only)
+	};
+
+public:
+	FESurfaceBVH(FESurface* ps = nullptr);
+
+	//! attach to a surface
+	void Attach(FESurface* ps) { m_ps = ps; }
+
+	//! build the hierarchy from the current nodal positions
+	//! stol is the (relative) tolerance used to expand the bounding boxes
+	void Init(double stol);
+
+	//! update the bounding boxes to the current nodal positions
+	void Refit();
+
+	//! clear all data
+	void Clear();
+
+	//! see if the hierarchy was built
+	bool IsValid() const { return (m_node.empty() == false); }
+
+	//! number of nodes in the hierarchy
+	int Nodes() const { return (int)m_node.size(); }
+
+public:
+	//! find all candidate surface elements intersected by the line through p with direction n
+	//! Only elements whose bounding box lies within the search radius srad of p are returned.
+	void FindCandidateSurfaceElements(const vec3d& p, const vec3d& n, std::set<int>& sel, double srad) const;
+
+	//! batched version of the function above
+	void FindCandidateSurfaceElements(const std::vector<vec3d>& p, const std::vector<vec3d>& n, std::vector< std::vector<int> >& sel, double srad) const;
+
+	//! find the (local) index of the surface node that is closest to x. 
+	int FindClosestNode(const vec3d& x) const;
+
+	//! batched version of the function above
+	void FindClosestNodes(const std::vector<vec3d>& x, std::vector<int>& nodes) const;
+
+private:
+	int Build(int first, int count, std::vector<vec3d>& centroid);
+	template <class T> void FindCandidates(const vec3d& p, const vec3d& n, T& sel, double srad) const;
+	bool RayIntersectsBox(const NODE& node, const vec3d& p, const vec3d& n) const;
+	double BoxDistance2(const NODE& node, const vec3d& x) const;
+
+private:
+	FESurface*			m_ps;		//!< the surface
+	std::vector<NODE>	m_node;		//!< nodes of the tree (root is first, children are stored after their parent)
+	std::vector<int>	m_elem;		//!< element indices, ordered by leaf
+	double				m_stol;		//!< relative search tolerance
+	double				m_d;		//!< absolute search tolerance
+};
@@ -26,6 +26,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include <regex>
 #include <string>
+#include <string.h>
 #include "FSPath.h"
 
 
@@ -125,7 +125,12 @@ bool JFNKStrategy::ReformStiffness()
 bool JFNKStrategy::Residual(std::vector<double>& R, bool binit)
 {
 	// first calculate the residual
-	bool b = m_pns->Residual(R);
+	bool b = false;
+	{
+		TRACK_TIME(TimerID::Timer_Residual);
+		FE_PROFILE_COMPONENT(m_pns, "Residual");
+		b = m_pns->Residual(R);
+	}
 	if (b == false) return false;
 
 	// store a copy
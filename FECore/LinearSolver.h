@@ -77,6 +77,19 @@ public:
 	//! At this point, we know the size of the matrix and its sparsity pattern.
 	virtual bool PreProcess();
 
+	//! Return true if the preprocessing only depends on the sparsity pattern of the matrix. 
+	//! The preprocessing then remains valid when the matrix structure is reused.
+	virtual bool IsPreProcessStructural() const { return false; }
+
+	//! Called when the matrix structure was reused and the preprocessing was kept (see IsPreProcessStructural).
+	//! Solvers may then also keep any analysis that only depends on the sparsity pattern.
+	virtual void SetStructureReused() {}
+
+	//! Share the preprocessing (e.g. symbolic factorization) with another solver of the same type.
+	//! Both solvers must solve systems with the same sparsity pattern (e.g. copies of the same model). 
+	//! The preprocessing is then only done once. Returns false if the solver does not support this.
+	virtual bool SharePreProcess(LinearSolver* solver) { return false; }
+
 	//! Factor the matrix (must be overridden)
 	//! Iterative solvers can use this function for creating a pre-conditioner.
 	virtual bool Factor() = 0;
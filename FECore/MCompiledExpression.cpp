@@ -0,0 +1,362 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#include "stdafx.h"
+#include "MCompiledExpression.h"
+#include <math.h>
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+MCompiledExpression::MCompiledExpression()
+{
+	m_stackSize = 0;
+}
+
+//-----------------------------------------------------------------------------
+void MCompiledExpression::Clear()
+{
+	m_code.clear();
+	m_stackSize = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool MCompiledExpression::Compile(const MSimpleExpression& e)
+{
+	Clear();
+	const MItem* pi = e.GetExpression().ItemPtr();
+	if ((pi == nullptr) || (compile(pi) == false))
+	{
+		Clear();
+		return false;
+	}
+	m_stackSize = calcStackSize();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void MCompiledExpression::emit(const Instr& op)
+{
+	m_code.push_back(op);
+}
+
+//-----------------------------------------------------------------------------
+static double binaryOp(int op, double a, double b)
+{
+	switch (op)
+	{
+	case MADD: return a + b;
+	case MSUB: return a - b;
+	case MMUL: return a * b;
+	case MDIV: return a / b;
+	case MPOW: return pow(a, b);
+	}
+	assert(false);
+	return 0.0;
+}
+
+//-----------------------------------------------------------------------------
+// Emit the instruction for a binary operation (op is one of MADD, ..., MPOW).
+// The left and right operands have already been emitted.
+void MCompiledExpression::emitBinary(int op)
+{
+	size_t N = m_code.size();
+	Instr& l = m_code[N - 2];
+	Instr& r = m_code[N - 1];
+
+	// Note that an operand's code only ends with a PUSH_CONST if the entire
+	// operand was folded into a constant.
+	if ((l.op == PUSH_CONST) && (r.op == PUSH_CONST))
+	{
+		l.c = binaryOp(op, l.c, r.c);
+		m_code.pop_back();
+		return;
+	}
+
+	if (r.op == PUSH_CONST)
+	{
+		switch (op)
+		{
+		case MADD: r.op = ADD_C; break;
+		case MSUB: r.op = SUB_C; break;
+		case MMUL: r.op = MUL_C; break;
+		case MDIV: r.op = DIV_C; break;
+		case MPOW: r.op = (r.c == 2.0 ? SQR : POW_C); break;
+		}
+		return;
+	}
+
+	if ((r.op == PUSH_VAR) && (op != MPOW))
+	{
+		switch (op)
+		{
+		case MADD: r.op = ADD_V; break;
+		case MSUB: r.op = SUB_V; break;
+		case MMUL: r.op = MUL_V; break;
+		case MDIV: r.op = DIV_V; break;
+		}
+		return;
+	}
+
+	Instr ins = { 0, 0, 0.0 };
+	switch (op)
+	{
+	case MADD: ins.op = ADD; break;
+	case MSUB: ins.op = SUB; break;
+	case MMUL: ins.op = MUL; break;
+	case MDIV: ins.op = DIV; break;
+	case MPOW: ins.op = POW; break;
+	}
+	emit(ins);
+}
+
+//-----------------------------------------------------------------------------
+bool MCompiledExpression::compile(const MItem* pi)
+{
+	Instr ins = { 0, 0, 0.0 };
+	switch (pi->Type())
+	{
+	case MCONST:
+	case MFRAC:
+	case MNAMED:
+		ins.op = PUSH_CONST;
+		ins.c = mnumber(pi)->value();
+		emit(ins);
+		return true;
+	case MVAR:
+		ins.op = PUSH_VAR;
+		ins.n = mvar(pi)->index();
+		if (ins.n < 0) return false;
+		emit(ins);
+		return true;
+	case MNEG:
+		if (compile(munary(pi)->Item()) == false) return false;
+		if (m_code.back().op == PUSH_CONST) m_code.back().c = -m_code.back().c;
+		else { ins.op = NEG; emit(ins); }
+		return true;
+	case MADD:
+	case MSUB:
+	case MMUL:
+	case MDIV:
+	case MPOW:
+		if (compile(mbinary(pi)->LeftItem()) == false) return false;
+		if (compile(mbinary(pi)->RightItem()) == false) return false;
+		emitBinary(pi->Type());
+		return true;
+	case MF1D:
+		{
+			FUNCPTR f = mfnc1d(pi)->funcptr();
+			if ((f == nullptr) || (compile(munary(pi)->Item()) == false)) return false;
+			if (m_code.back().op == PUSH_CONST) m_code.back().c = f(m_code.back().c);
+			else { ins.op = FUNC1; ins.f1 = f; emit(ins); }
+		}
+		return true;
+	case MF2D:
+		{
+			FUNC2PTR f = mfnc2d(pi)->funcptr();
+			if (f == nullptr) return false;
+			if (compile(mbinary(pi)->LeftItem()) == false) return false;
+			if (compile(mbinary(pi)->RightItem()) == false) return false;
+			size_t N = m_code.size();
+			if ((m_code[N - 2].op == PUSH_CONST) && (m_code[N - 1].op == PUSH_CONST))
+			{
+				m_code[N - 2].c = f(m_code[N - 2].c, m_code[N - 1].c);
+				m_code.pop_back();
+			}
+			else { ins.op = FUNC2; ins.f2 = f; emit(ins); }
+		}
+		return true;
+	case MSFNC:
+		return compile(msfncnd(pi)->Value());
+	case MFND:
+		{
+			const MFuncND* pf = mfncnd(pi);
+			FUNCNPTR f = pf->funcptr();
+			int n = pf->Params();
+			if ((f == nullptr) || (n <= 0) || (n > MAX_STACK)) return false;
+			for (int i = 0; i < n; ++i)
+			{
+				if (compile(pf->Param(i)) == false) return false;
+			}
+
+			// see if all arguments are constant
+			size_t N = m_code.size();
+			bool bconst = true;
+			for (int i = 0; i < n; ++i) if (m_code[N - n + i].op != PUSH_CONST) { bconst = false; break; }
+			if (bconst)
+			{
+				double a[MAX_STACK];
+				for (int i = 0; i < n; ++i) a[i] = m_code[N - n + i].c;
+				m_code.resize(N - n + 1);
+				m_code.back().c = f(a, n);
+			}
+			else { ins.op = FUNCN; ins.n = n; ins.fn = f; emit(ins); }
+		}
+		return true;
+	default:
+		return false;
+	}
+}
+
+//-----------------------------------------------------------------------------
+int MCompiledExpression::calcStackSize() const
+{
+	int sp = 0, maxSize = 0;
+	for (const Instr& ins : m_code)
+	{
+		switch (ins.op)
+		{
+		case PUSH_CONST:
+		case PUSH_VAR: sp++; break;
+		case ADD: case SUB: case MUL: case DIV: case POW:
+		case FUNC2: sp--; break;
+		case FUNCN: sp -= ins.n - 1; break;
+		default:
+			break;
+		}
+		if (sp > maxSize) maxSize = sp;
+	}
+	assert(sp == 1);
+	return maxSize;
+}
+
+//-----------------------------------------------------------------------------
+double MCompiledExpression::value(const double* var) const
+{
+	assert(IsValid());
+	double buf[MAX_STACK];
+	std::vector<double> tmp;
+	double* st = buf;
+	if (m_stackSize > MAX_STACK) { tmp.resize(m_stackSize); st = tmp.data(); }
+
+	int sp = -1;
+	const Instr* code = m_code.data();
+	const int N = (int)m_code.size();
+	for (int i = 0; i < N; ++i)
+	{
+		const Instr& ins = code[i];
+		switch (ins.op)
+		{
+		case PUSH_CONST: st[++sp] = ins.c; break;
+		case PUSH_VAR  : st[++sp] = var[ins.n]; break;
+		case NEG       : st[sp] = -st[sp]; break;
+		case ADD       : st[sp - 1] += st[sp]; sp--; break;
+		case SUB       : st[sp - 1] -= st[sp]; sp--; break;
+		case MUL       : st[sp - 1] *= st[sp]; sp--; break;
+		case DIV       : st[sp - 1] /= st[sp]; sp--; break;
+		case POW       : st[sp - 1] = pow(st[sp - 1], st[sp]); sp--; break;
+		case SQR       : st[sp] *= st[sp]; break;
+		case ADD_C     : st[sp] += ins.c; break;
+		case SUB_C     : st[sp] -= ins.c; break;
+		case MUL_C     : st[sp] *= ins.c; break;
+		case DIV_C     : st[sp] /= ins.c; break;
+		case POW_C     : st[sp] = pow(st[sp], ins.c); break;
+		case ADD_V     : st[sp] += var[ins.n]; break;
+		case SUB_V     : st[sp] -= var[ins.n]; break;
+		case MUL_V     : st[sp] *= var[ins.n]; break;
+		case DIV_V     : st[sp] /= var[ins.n]; break;
+		case FUNC1     : st[sp] = ins.f1(st[sp]); break;
+		case FUNC2     : st[sp - 1] = ins.f2(st[sp - 1], st[sp]); sp--; break;
+		case FUNCN     : sp -= ins.n - 1; st[sp] = ins.fn(st + sp, ins.n); break;
+		}
+	}
+	assert(sp == 0);
+	return st[0];
+}
+
+//-----------------------------------------------------------------------------
+// The batch evaluation processes the points in blocks of BLOCK_SIZE so that
+// each instruction is dispatched once per block and its inner loop can be vectorized.
+void MCompiledExpression::value(int n, const double* var, int stride, double* out) const
+{
+	assert(IsValid());
+	if (IsConst())
+	{
+		for (int i = 0; i < n; ++i) out[i] = m_code[0].c;
+		return;
+	}
+
+	if (m_stackSize > MAX_STACK)
+	{
+		for (int i = 0; i < n; ++i) out[i] = value(var + i*stride);
+		return;
+	}
+
+	const int B = BLOCK_SIZE;
+	double st[MAX_STACK][BLOCK_SIZE];
+	const Instr* code = m_code.data();
+	const int N = (int)m_code.size();
+	for (int i0 = 0; i0 < n; i0 += B)
+	{
+		const int m = (n - i0 < B ? n - i0 : B);
+		const double* v = var + i0*stride;
+
+		int sp = -1;
+		for (int i = 0; i < N; ++i)
+		{
+			const Instr& ins = code[i];
+			const double c = ins.c;
+			const int k = ins.n;
+			double* a = (sp > 0 ? st[sp - 1] : nullptr);
+			double* b = (sp >= 0 ? st[sp] : nullptr);
+			switch (ins.op)
+			{
+			case PUSH_CONST: ++sp; for (int j = 0; j < m; ++j) st[sp][j] = c; break;
+			case PUSH_VAR  : ++sp; for (int j = 0; j < m; ++j) st[sp][j] = v[j*stride + k]; break;
+			case NEG       : for (int j = 0; j < m; ++j) b[j] = -b[j]; break;
+			case ADD       : for (int j = 0; j < m; ++j) a[j] += b[j]; sp--; break;
+			case SUB       : for (int j = 0; j < m; ++j) a[j] -= b[j]; sp--; break;
+			case MUL       : for (int j = 0; j < m; ++j) a[j] *= b[j]; sp--; break;
+			case DIV       : for (int j = 0; j < m; ++j) a[j] /= b[j]; sp--; break;
+			case POW       : for (int j = 0; j < m; ++j) a[j] = pow(a[j], b[j]); sp--; break;
+			case SQR       : for (int j = 0; j < m; ++j) b[j] *= b[j]; break;
+			case ADD_C     : for (int j = 0; j < m; ++j) b[j] += c; break;
+			case SUB_C     : for (int j = 0; j < m; ++j) b[j] -= c; break;
+			case MUL_C     : for (int j = 0; j < m; ++j) b[j] *= c; break;
+			case DIV_C     : for (int j = 0; j < m; ++j) b[j] /= c; break;
+			case POW_C     : for (int j = 0; j < m; ++j) b[j] = pow(b[j], c); break;
+			case ADD_V     : for (int j = 0; j < m; ++j) b[j] += v[j*stride + k]; break;
+			case SUB_V     : for (int j = 0; j < m; ++j) b[j] -= v[j*stride + k]; break;
+			case MUL_V     : for (int j = 0; j < m; ++j) b[j] *= v[j*stride + k]; break;
+			case DIV_V     : for (int j = 0; j < m; ++j) b[j] /= v[j*stride + k]; break;
+			case FUNC1     : for (int j = 0; j < m; ++j) b[j] = ins.f1(b[j]); break;
+			case FUNC2     : for (int j = 0; j < m; ++j) a[j] = ins.f2(a[j], b[j]); sp--; break;
+			case FUNCN:
+				{
+					double arg[MAX_STACK];
+					sp -= k - 1;
+					for (int j = 0; j < m; ++j)
+					{
+						for (int l = 0; l < k; ++l) arg[l] = st[sp + l][j];
+						st[sp][j] = ins.fn(arg, k);
+					}
+				}
+				break;
+			}
+		}
+		assert(sp == 0);
+
+		for (int j = 0; j < m; ++j) out[i0 + j] = st[0][j];
+	}
+}
@@ -0,0 +1,96 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#pragma once
+#include "MathObject.h"
+#include "MFunctions.h"
+#include <vector>
+#include "fecore_api.h"
+
+//-----------------------------------------------------------------------------
+// A math expression that is compiled into a flat, constant-folded list of
+// stack-machine instructions. This avoids the recursive traversal of the
+// MItem tree and does not allocate any memory during evaluation.
+// The variables are passed in the same order as they appear in the
+// variable list of the expression it was compiled from.
+class FECORE_API MCompiledExpression
+{
+public:
+	enum { MAX_STACK = 32 };	// max stack size for allocation-free evaluation
+	enum { BLOCK_SIZE = 16 };	// nr of points processed together in the batch evaluation
+
+	enum OpCode {
+		PUSH_CONST, PUSH_VAR,
+		NEG, ADD, SUB, MUL, DIV, POW, SQR,
+		ADD_C, SUB_C, MUL_C, DIV_C, POW_C,	// right operand is a constant
+		ADD_V, SUB_V, MUL_V, DIV_V,			// right operand is a variable
+		FUNC1, FUNC2, FUNCN
+	};
+
+	struct Instr
+	{
+		int		op;
+		int		n;		// variable index or nr of function arguments
+		double	c;		// constant value
+		union {
+			FUNCPTR		f1;
+			FUNC2PTR	f2;
+			FUNCNPTR	fn;
+		};
+	};
+
+public:
+	MCompiledExpression();
+
+	// compile the expression. Returns false if the expression contains items that cannot be compiled.
+	bool Compile(const MSimpleExpression& e);
+
+	void Clear();
+
+	bool IsValid() const { return (m_code.empty() == false); }
+
+	// returns true if the expression was folded into a single constant
+	bool IsConst() const { return ((m_code.size() == 1) && (m_code[0].op == PUSH_CONST)); }
+
+	// nr of instructions
+	int Size() const { return (int)m_code.size(); }
+
+	// evaluate the expression. var must point to the variable values.
+	double value(const double* var) const;
+
+	// evaluate the expression for n sets of variables. The variable values of set i
+	// start at var[i*stride].
+	void value(int n, const double* var, int stride, double* out) const;
+
+private:
+	bool compile(const MItem* pi);
+	void emit(const Instr& op);
+	void emitBinary(int op);
+	int calcStackSize() const;
+
+private:
+	std::vector<Instr>	m_code;
+	int					m_stackSize;
+};
@@ -0,0 +1,99 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "MappedFile.h"
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+	m_data = nullptr;
+	m_size = 0;
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const char* szfile)
+{
+	Close();
+
+#ifdef WIN32
+	HANDLE hfile = CreateFileA(szfile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hfile == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if ((GetFileSizeEx(hfile, &size) == FALSE) || (size.QuadPart == 0)) { CloseHandle(hfile); return false; }
+
+	// (the view keeps the file and mapping open)
+	HANDLE hmap = CreateFileMappingA(hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(hfile);
+	if (hmap == NULL) return false;
+	void* pd = MapViewOfFile(hmap, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(hmap);
+	if (pd == nullptr) return false;
+
+	m_size = (size_t) size.QuadPart;
+#else
+	int fd = ::open(szfile, O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || (st.st_size == 0)) { ::close(fd); return false; }
+
+	// (the mapping keeps the file open)
+	void* pd = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (pd == MAP_FAILED) return false;
+
+	m_size = (size_t) st.st_size;
+#endif
+	m_data = (const char*) pd;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data == nullptr) return;
+#ifdef WIN32
+	UnmapViewOfFile(m_data);
+#else
+	munmap((void*) m_data, m_size);
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
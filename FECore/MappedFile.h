@@ -0,0 +1,65 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <stddef.h>
+
+//-----------------------------------------------------------------------------
+//! This class maps a file into memory for reading. The data stays valid 
+//! until the file is closed. 
+class FECORE_API MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	//! map the file into memory. Returns false if the file cannot be mapped
+	//! (this is also the case for empty files).
+	bool Open(const char* szfile);
+
+	//! release the memory map
+	void Close();
+
+	//! see if a file is mapped
+	bool IsOpen() const { return (m_data != nullptr); }
+
+	//! pointer to the file data
+	const char* Data() const { return m_data; }
+
+	//! size of the file in bytes
+	size_t Size() const { return m_size; }
+
+private:
+	MappedFile(const MappedFile&) = delete;
+	void operator = (const MappedFile&) = delete;
+
+private:
+	const char*	m_data;
+	size_t		m_size;
+};
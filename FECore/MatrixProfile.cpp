@@ -358,3 +358,112 @@ SparseMatrixProfile SparseMatrixProfile::GetBlockProfile(int nrow0, int ncol0, i
 
 	return bMP;
 }
+
+//-----------------------------------------------------------------------------
+// Since the row entries are always kept sorted and merged, two profiles are
+// identical if all their row entries are identical.
+bool SparseMatrixProfile::operator == (const SparseMatrixProfile& mp) const
+{
+	if ((m_nrow != mp.m_nrow) || (m_ncol != mp.m_ncol)) return false;
+	if (m_prof.size() != mp.m_prof.size()) return false;
+
+	for (size_t j = 0; j < m_prof.size(); ++j)
+	{
+		const ColumnProfile& a = m_prof[j];
+		const ColumnProfile& b = mp.m_prof[j];
+		if (a.size() != b.size()) return false;
+		for (int i = 0; i < a.size(); ++i)
+		{
+			if ((a[i].start != b[i].start) || (a[i].end != b[i].end)) return false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SparseMatrixProfile::Contains(const SparseMatrixProfile& mp) const
+{
+	if ((m_nrow != mp.m_nrow) || (m_ncol != mp.m_ncol)) return false;
+	if (m_prof.size() != mp.m_prof.size()) return false;
+
+	for (size_t j = 0; j < m_prof.size(); ++j)
+	{
+		const ColumnProfile& a = m_prof[j];
+		const ColumnProfile& b = mp.m_prof[j];
+
+		// since both lists are sorted, we can walk them simultaneously
+		int k = 0;
+		for (int i = 0; i < b.size(); ++i)
+		{
+			const RowEntry& rb = b[i];
+			while ((k < a.size()) && (a[k].end < rb.start)) ++k;
+			if ((k == a.size()) || (a[k].start > rb.start) || (a[k].end < rb.end)) return false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void SparseMatrixProfile::Merge(const SparseMatrixProfile& mp)
+{
+	assert((m_nrow == mp.m_nrow) && (m_ncol == mp.m_ncol));
+	if (m_prof.size() != mp.m_prof.size()) return;
+
+#pragma omp parallel for schedule(dynamic)
+	for (int j = 0; j < (int)m_prof.size(); ++j)
+	{
+		ColumnProfile& a = m_prof[j];
+		const ColumnProfile& b = mp.m_prof[j];
+		if (b.size() == 0) continue;
+
+		// merge the two sorted lists
+		ColumnProfile c;
+		c.reserve(a.size() + b.size());
+		int ia = 0, ib = 0;
+		while ((ia < a.size()) || (ib < b.size()))
+		{
+			RowEntry r;
+			if ((ib == b.size()) || ((ia < a.size()) && (a[ia].start < b[ib].start))) r = a[ia++];
+			else r = b[ib++];
+
+			// merge with the last entry if they overlap or are adjacent
+			int n = c.size();
+			if ((n > 0) && (r.start <= c[n - 1].end + 1))
+			{
+				if (r.end > c[n - 1].end) c[n - 1].end = r.end;
+			}
+			else c.push_back(r.start, r.end);
+		}
+		a = c;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// FNV-1a hash of all the row entries
+size_t SparseMatrixProfile::Hash() const
+{
+	unsigned long long h = 14695981039346656037ULL;
+	auto add = [&](int v) {
+		unsigned int u = (unsigned int)v;
+		for (int k = 0; k < 4; ++k)
+		{
+			h ^= (u & 0xFF);
+			h *= 1099511628211ULL;
+			u >>= 8;
+		}
+	};
+
+	add(m_nrow);
+	add(m_ncol);
+	for (size_t j = 0; j < m_prof.size(); ++j)
+	{
+		const ColumnProfile& a = m_prof[j];
+		add(a.size());
+		for (int i = 0; i < a.size(); ++i)
+		{
+			add(a[i].start);
+			add(a[i].end);
+		}
+	}
+	return (size_t)h;
+}
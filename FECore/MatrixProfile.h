@@ -126,6 +126,18 @@ public:
 	// Extracts a block profile
 	SparseMatrixProfile GetBlockProfile(int nrow0, int ncol0, int nrow1, int ncol1) const;
 
+	//! see if two profiles are identical
+	bool operator == (const SparseMatrixProfile& mp) const;
+
+	//! see if all the entries of mp are also in this profile
+	bool Contains(const SparseMatrixProfile& mp) const;
+
+	//! add all the entries of mp to this profile
+	void Merge(const SparseMatrixProfile& mp);
+
+	//! calculate a hash value of the profile (for quick comparisons)
+	size_t Hash() const;
+
 private:
 	int	m_nrow, m_ncol;				//!< dimensions of matrix
 	std::vector<ColumnProfile>	m_prof;	//!< the actual profile in condensed format
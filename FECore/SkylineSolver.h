@@ -43,6 +43,7 @@ public:
 
 	//! Preprocess 
 	bool PreProcess() override;
+	bool IsPreProcessStructural() const override { return true; }
 
 	//! Factor matrix
 	bool Factor() override;
@@ -60,6 +60,13 @@ public:
 	//! return number of nonzeros
 	size_t NonZeroes() const { return m_nsize; }
 
+	//! Turn atomic updates during assembly on or off. Atomic updates should only be turned off
+	//! when the caller guarantees that no two threads add to the same matrix entry concurrently.
+	void SetAtomicAssembly(bool b) { m_batomic = b; }
+
+	//! see if atomic updates are used during assembly
+	bool AtomicAssembly() const { return m_batomic; }
+
 public: // functions to be overwritten in derived classes
 
 	//! set all matrix elements to zero
@@ -95,6 +102,11 @@ public: // functions to be overwritten in derived classes
 	//! scale matrix
 	virtual void scale(const std::vector<double>& L, const std::vector<double>& R);
 
+	//! Find the offsets into the values array of the entries that an element matrix with row indices lmi
+	//! and column indices lmj is assembled into (in row-major order of the element matrix). Entries that 
+	//! are not assembled get an offset of -1. Returns false if the matrix format does not support this.
+	virtual bool ValueOffsets(const std::vector<int>& lmi, const std::vector<int>& lmj, std::vector<int>& offsets) { return false; }
+
 public:
 	//! multiply with vector
 	bool mult_vector(double* x, double* r) override { assert(false); return false; }
@@ -111,4 +123,5 @@ protected:
 	// NOTE: These values are set by derived classes
 	int	m_nrow, m_ncol;		//!< dimension of matrix
 	size_t m_nsize;			//!< number of nonzeroes (i.e. matrix elements actually allocated)
+	bool	m_batomic;		//!< use atomic updates during assembly
 };
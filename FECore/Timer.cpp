@@ -50,10 +50,12 @@ struct	Timer::Imp {
 
 	Timer* parent = nullptr; // the timer that was active when this timer starts
 
-	static Timer* activeTimer;
+	// Each thread keeps track of its own active timer, so that models that
+	// are solved concurrently (e.g. RVE models) do not pause each other's timers.
+	static thread_local Timer* activeTimer;
 };
 
-Timer* Timer::Imp::activeTimer = nullptr;
+thread_local Timer* Timer::Imp::activeTimer = nullptr;
 
 Timer::Timer()
 {
@@ -172,4 +174,37 @@ void Timer::time_str(double fsec, char* sz)
 }
 
 //============================================================================
-TimerTracker::TimerTracker(FEModel* fem, int timerId) : TimerTracker(fem->GetTimer(timerId)) {}
+TimerTracker::TimerTracker(FEModel* fem, int timerId) : TimerTracker(fem->GetTimer(timerId))
+{
+	// only record the outermost scope of a timer, like the timer itself
+	if (m_timer && FEProfiler::IsEnabled())
+	{
+		m_bprofile = true;
+		FEProfiler::GetInstance()->BeginScope(TimerName(timerId));
+	}
+}
+
+//-----------------------------------------------------------------------------
+const char* TimerName(int timerId)
+{
+	static const char* szname[] = {
+		"Init",
+		"Update",
+		"LinSol_Factor",
+		"LinSol_Backsolve",
+		"Reform",
+		"Residual",
+		"Stiffness",
+		"QNUpdate",
+		"Serialize",
+		"ModelSolve",
+		"Callback",
+		"USER1",
+		"USER2",
+		"USER3",
+		"USER4"
+	};
+	static_assert(sizeof(szname) / sizeof(szname[0]) == TIMER_COUNT, "timer names do not match TimerID");
+	if ((timerId < 0) || (timerId >= TIMER_COUNT)) return "?";
+	return szname[timerId];
+}
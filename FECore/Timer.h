@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 #pragma once
 #include "fecore_api.h"
+#include "FEProfiler.h"
 
 class FEModel;
 
@@ -110,12 +111,16 @@ enum TimerID {
 	TIMER_COUNT // leave this at the end so that it equals the nr. of timers we need
 };
 
+//! return the name of a timer
+FECORE_API const char* TimerName(int timerId);
+
 //-----------------------------------------------------------------------------
 // This is helper class that can be used to ensure that a timer is stopped when
 // the function that is being timed exits. That way, the Timer::stop member does not 
 // have to be called at every exit point of a function.
 // In addition, it will also check if the timer is already running (e.g. from a function
 // higher in the call stack) in which case it will track the timer. 
+// When the profiler is enabled, the tracked timer is also recorded as a profiler scope.
 class FECORE_API TimerTracker
 {
 public:
@@ -124,11 +129,17 @@ public:
 	{
 		if (timer && !timer->isRunning()) { m_timer = timer; timer->start(); }
 		else m_timer = nullptr;
+		m_bprofile = false;
+	}
+	~TimerTracker()
+	{ 
+		if (m_timer) m_timer->stop(); 
+		if (m_bprofile) FEProfiler::GetInstance()->EndScope();
 	}
-	~TimerTracker() { if (m_timer) m_timer->stop(); }
 
 private:
 	Timer*	m_timer;
+	bool	m_bprofile;
 };
 
 #define TRACK_TIME(timerId) TimerTracker _trackTimer(GetFEModel(), timerId);
@@ -32,13 +32,20 @@ BEGIN_FECORE_CLASS(FEImageDataMap, FEElemDataGenerator)
 	ADD_PARAMETER(m_r0, "range_min");
 	ADD_PARAMETER(m_r1, "range_max");
 	ADD_PARAMETER(m_blur, "blur");
+	ADD_PARAMETER(m_blurType, "blur_type")->setEnums("iterative\0gaussian\0fft\0");
+	ADD_PARAMETER(m_interpolation, "interpolation")->setEnums("linear\0cubic\0");
+	ADD_PARAMETER(m_output, "output")->setEnums("value\0gradient\0hessian\0");
 	ADD_PROPERTY(m_imgSrc, "image");
 END_FECORE_CLASS();
 
-FEImageDataMap::FEImageDataMap(FEModel* fem) : FEElemDataGenerator(fem), m_map(m_im)
+FEImageDataMap::FEImageDataMap(FEModel* fem) : FEElemDataGenerator(fem)
 {
 	m_imgSrc = nullptr;
 	m_blur = 0.0;
+	m_blurType = BLUR_ITERATIVE;
+	m_interpolation = ImageVolume::LINEAR;
+	m_output = OUTPUT_VALUE;
+	m_blurred = false;
 	m_data = nullptr;
 }
 
@@ -46,12 +53,17 @@ bool FEImageDataMap::Init()
 {
 	if (m_imgSrc == nullptr) return false;
 
-	if (m_imgSrc->GetImage3D(m_im0) == false)
+	// The voxels are mapped from the image file when the source supports it,
+	// so the image is only copied to memory when it needs to be blurred.
+	if (m_imgSrc->GetImageVolume(m_vol) == false)
 	{
 		return false;
 	}
-	m_im = m_im0;
-	m_map.SetRange(m_r0, m_r1);
+	m_vol.SetRange(m_r0, m_r1);
+	m_blurred = false;
+
+	// the derivatives are sampled many times, so we precompute them once
+	if (m_output != OUTPUT_VALUE) m_vol.PrecomputeDerivatives(m_output == OUTPUT_HESSIAN);
 
 	return FEElemDataGenerator::Init();
 }
@@ -61,8 +73,15 @@ FEDataMap* FEImageDataMap::Generate()
 	FEElementSet* elset = GetElementSet();
 	if (elset == nullptr) return nullptr;
 
+	FEDataType dataType = FEDataType::FE_DOUBLE;
+	switch (m_output)
+	{
+	case OUTPUT_GRADIENT: dataType = FEDataType::FE_VEC3D; break;
+	case OUTPUT_HESSIAN : dataType = FEDataType::FE_MAT3DS; break;
+	}
+
 	// TODO: Can I use FMT_NODE?
-	if (m_data == nullptr) m_data = new FEDomainMap(FEDataType::FE_DOUBLE, Storage_Fmt::FMT_MULT);
+	if (m_data == nullptr) m_data = new FEDomainMap(dataType, Storage_Fmt::FMT_MULT);
 	m_data->Create(elset);
 
 	GenerateData();
@@ -74,28 +93,69 @@ void FEImageDataMap::GenerateData()
 	assert(m_data);
 	FEElementSet& set = *GetElementSet();
 	FEMesh& mesh = *set.GetMesh();
+	ImageVolume::Interpolation interp = (ImageVolume::Interpolation)m_interpolation;
+
+	std::vector<vec3d> r(FEElement::MAX_NODES);
+	std::vector<double> v(FEElement::MAX_NODES);
+	std::vector<vec3d> g(FEElement::MAX_NODES);
+	std::vector<mat3ds> h(FEElement::MAX_NODES);
+
 	int N = set.Elements();
 	for (int i = 0; i < N; ++i)
 	{
 		FEElement& el = set.Element(i);
 		int ne = el.Nodes();
-		for (int j = 0; j < ne; ++j)
+		for (int j = 0; j < ne; ++j) r[j] = mesh.Node(el.m_node[j]).m_r0;
+
+		switch (m_output)
 		{
-			vec3d ri = mesh.Node(el.m_node[j]).m_r0;
-			double d = m_map.value(m_map.map(ri));
-			m_data->setValue(i, j, d);
+		case OUTPUT_GRADIENT:
+			m_vol.gradients(&r[0], ne, &g[0]);
+			for (int j = 0; j < ne; ++j) m_data->setValue(i, j, g[j]);
+			break;
+		case OUTPUT_HESSIAN:
+			m_vol.hessians(&r[0], ne, &h[0]);
+			for (int j = 0; j < ne; ++j) m_data->setValue(i, j, h[j]);
+			break;
+		default:
+			m_vol.values(&r[0], ne, &v[0], interp);
+			for (int j = 0; j < ne; ++j) m_data->setValue(i, j, v[j]);
 		}
 	}
 }
 
-void FEImageDataMap::Evaluate(double time)
+void FEImageDataMap::BlurImage()
 {
-	if (m_blur > 0)
+	// the blur filters need the voxels in memory
+	if ((m_im0.width() == 0) && (m_imgSrc->GetImage3D(m_im0) == false)) return;
+
+	switch (m_blurType)
 	{
+	case BLUR_GAUSSIAN: gaussian_blur(m_im, m_im0, (float)m_blur); break;
+	case BLUR_FFT:
+		if (m_im0.depth() == 1) fftblur_2d(m_im, m_im0, (float)m_blur);
+		else fftblur_3d(m_im, m_im0, (float)m_blur);
+		break;
+	default:
 		if (m_im0.depth() == 1) blur_image_2d(m_im, m_im0, (float)m_blur);
 		else blur_image(m_im, m_im0, (float)m_blur);
 	}
-	else m_im = m_im0;
+
+	m_vol.Create(m_im);
+	if (m_output != OUTPUT_VALUE) m_vol.PrecomputeDerivatives(m_output == OUTPUT_HESSIAN);
+	m_blurred = true;
+}
+
+void FEImageDataMap::Evaluate(double time)
+{
+	if (m_blur > 0) BlurImage();
+	else if (m_blurred)
+	{
+		// go back to the original image
+		if (m_imgSrc->GetImageVolume(m_vol) == false) return;
+		if (m_output != OUTPUT_VALUE) m_vol.PrecomputeDerivatives(m_output == OUTPUT_HESSIAN);
+		m_blurred = false;
+	}
 
 	GenerateData();
 }
@@ -26,13 +26,26 @@ SOFTWARE.*/
 #pragma once
 #include <FECore/FEDataGenerator.h>
 #include "FEImageSource.h"
-#include "ImageMap.h"
+#include "ImageVolume.h"
 #include "feimglib_api.h"
 
 class FEDomainMap;
 
 class FEIMGLIB_API FEImageDataMap : public FEElemDataGenerator
 {
+public:
+	enum BlurType {
+		BLUR_ITERATIVE,		// repeated averaging of neighboring voxels
+		BLUR_GAUSSIAN,		// recursive Gaussian filter, blur is the standard deviation in voxels
+		BLUR_FFT			// Gaussian mask in Fourier space
+	};
+
+	enum OutputType {
+		OUTPUT_VALUE,		// image value (scalar map)
+		OUTPUT_GRADIENT,	// image gradient (vector map)
+		OUTPUT_HESSIAN		// image Hessian (symmetric tensor map)
+	};
+
 public:
 	FEImageDataMap(FEModel* fem);
 
@@ -45,17 +58,24 @@ public:
 private:
 	void GenerateData();
 
+	// copy the blurred image to the volume
+	void BlurImage();
+
 private:
 	vec3d	m_r0;
 	vec3d	m_r1;
 	double	m_blur;
+	int		m_blurType;
+	int		m_interpolation;
+	int		m_output;
 
 	FEImageSource* m_imgSrc;
 
 private:
-	Image		m_im0, m_im;
-	ImageMap	m_map;
-	FEDomainMap* m_data;
+	ImageVolume		m_vol;		// the (memory-mapped) image that is sampled
+	Image			m_im0, m_im;	// only loaded when the image is blurred
+	bool			m_blurred;		// the volume holds a blurred copy of the image
+	FEDomainMap*	m_data;
 
 	DECLARE_FECORE_CLASS();
 };
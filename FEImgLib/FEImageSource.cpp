@@ -25,12 +25,28 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 #include "FEImageSource.h"
 #include <FECore/log.h>
+#include <vector>
 
 FEImageSource::FEImageSource(FEModel* fem) : FECoreClass(fem)
 {
 
 }
 
+bool FEImageSource::GetImageVolume(ImageVolume& vol)
+{
+	Image im;
+	if (GetImage3D(im) == false) return false;
+	vol.Create(im);
+	return true;
+}
+
+// see if this machine stores multi-byte values in little endian order
+static bool is_little_endian()
+{
+	unsigned short n = 1;
+	return (*((unsigned char*)&n) == 1);
+}
+
 //========================================================================
 
 BEGIN_FECORE_CLASS(FERawImage, FEImageSource)
@@ -68,6 +84,30 @@ bool FERawImage::GetImage3D(Image& im)
 	return Load(szfile, im, fmt, m_bend);
 }
 
+//-----------------------------------------------------------------------------
+bool FERawImage::GetImageVolume(ImageVolume& vol)
+{
+	ImageVolume::VoxelType type;
+	switch (m_format)
+	{
+	case 0: type = ImageVolume::VOXEL_UINT8; break;
+	case 1: type = ImageVolume::VOXEL_UINT16; break;
+	default:
+		assert(false);
+		return false;
+	}
+
+	// The endianess flag indicates big endian data
+	bool swap = (m_bend && is_little_endian());
+
+	if (vol.Map(m_file.c_str(), 0, m_dim[0], m_dim[1], m_dim[2], type, swap) == false)
+	{
+		feLogError("Failed to map image file %s", m_file.c_str());
+		return false;
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 bool FERawImage::Load(const char* szfile, Image& im, Image::ImageFormat fmt, bool endianess)
 {
@@ -190,23 +230,19 @@ bool nrrd_read_key_value(const char* szline, char* key, char* val)
 	return true;
 }
 
-bool FENRRDImage::Load(const char* szfile, Image& im)
+bool FENRRDImage::ReadHeader(FILE* fp, NRRD_HEADER& hdr)
 {
-	if (szfile == nullptr) return false;
-
-	FILE* fp = fopen(szfile, "rb");
-	if (fp == nullptr) return false;
-
-	// read the header
 	char buf[1024] = { 0 }, key[256] = { 0 }, val[256] = { 0 };
 	nrrd_read_line(fp, buf);
-	if (strncmp(buf, "NRRD", 4) != 0) { fclose(fp); return false; }
+	if (strncmp(buf, "NRRD", 4) != 0) return false;
+
+	hdr.type = NRRD_INVALID;
+	hdr.sizes[0] = hdr.sizes[1] = hdr.sizes[2] = 0;
+	hdr.bigEndian = false;
+	hdr.offset = 0;
 
-	NRRD_TYPE imType = NRRD_INVALID;
 	int dim = 0;
-	int sizes[3] = { 0 };
 	NRRD_ENCODING enc = NRRD_RAW;
-
 	while (nrrd_read_line(fp, buf))
 	{
 		if (buf[0] == 0) break;
@@ -214,14 +250,17 @@ bool FENRRDImage::Load(const char* szfile, Image& im)
 		// read key-value
 		if (buf[0] != '#')
 		{
-			if (nrrd_read_key_value(buf, key, val) == false) { fclose(fp); return false; }
+			if (nrrd_read_key_value(buf, key, val) == false) return false;
 
 			if (strcmp(key, "type") == 0)
 			{
-				if (strcmp(val, "float") == 0) imType = NRRD_FLOAT;
+				if (strcmp(val, "float") == 0) hdr.type = NRRD_FLOAT;
+				else if ((strcmp(val, "uchar") == 0) || (strcmp(val, "unsigned char") == 0) || (strcmp(val, "uint8") == 0) || (strcmp(val, "uint8_t") == 0)) hdr.type = NRRD_UINT8;
+				else if ((strcmp(val, "ushort") == 0) || (strcmp(val, "unsigned short") == 0) || (strcmp(val, "unsigned short int") == 0) || (strcmp(val, "uint16") == 0) || (strcmp(val, "uint16_t") == 0)) hdr.type = NRRD_UINT16;
 			}
 			else if (strcmp(key, "dimension") == 0) dim = atoi(val);
-			else if (strcmp(key, "sizes") == 0) sscanf(val, "%d %d %d", sizes, sizes + 1, sizes + 2);
+			else if (strcmp(key, "sizes") == 0) sscanf(val, "%d %d %d", hdr.sizes, hdr.sizes + 1, hdr.sizes + 2);
+			else if (strcmp(key, "endian") == 0) hdr.bigEndian = (strcmp(val, "big") == 0);
 			else if (strcmp(key, "encoding") == 0)
 			{
 				if (strcmp(val, "raw") == 0) enc = NRRD_RAW;
@@ -230,20 +269,92 @@ bool FENRRDImage::Load(const char* szfile, Image& im)
 		}
 	}
 
-	// read the image
-	if (imType != NRRD_FLOAT) { feLog("Invalid image format (only float supported)"); fclose(fp); return false; }
-	if (dim != 3) { feLog("Invalid image dimensions (must be 3)"); fclose(fp); return false; }
-	if (enc != NRRD_RAW) { feLog("Invalid encoding (only raw supported)"); fclose(fp); return false; }
+	if (hdr.type == NRRD_INVALID) { feLog("Invalid image format (only float, uchar, and ushort supported)"); return false; }
+	if (dim != 3) { feLog("Invalid image dimensions (must be 3)"); return false; }
+	if (enc != NRRD_RAW) { feLog("Invalid encoding (only raw supported)"); return false; }
+	if ((hdr.sizes[0] <= 0) || (hdr.sizes[1] <= 0) || (hdr.sizes[2] <= 0)) { feLog("Invalid image sizes"); return false; }
+
+	hdr.offset = (size_t)ftell(fp);
+
+	return true;
+}
 
-	int nsize = sizes[0] * sizes[1] * sizes[2];
-	if (nsize <= 0) { feLog("Invalid image sizes"); fclose(fp); return false; }
+bool FENRRDImage::Load(const char* szfile, Image& im)
+{
+	if (szfile == nullptr) return false;
+
+	FILE* fp = fopen(szfile, "rb");
+	if (fp == nullptr) return false;
+
+	// read the header
+	NRRD_HEADER hdr;
+	if (ReadHeader(fp, hdr) == false) { fclose(fp); return false; }
 
-	im.Create(sizes[0], sizes[1], sizes[2]);
+	// read the image
+	int nsize = hdr.sizes[0] * hdr.sizes[1] * hdr.sizes[2];
+	im.Create(hdr.sizes[0], hdr.sizes[1], hdr.sizes[2]);
 	float* pf = im.data();
-	int nread = fread(pf, sizeof(float), nsize, fp);
-	if (nread != nsize) { feLog("Failed reading image data"); fclose(fp); return false; }
-	
+	bool swap = (hdr.bigEndian == is_little_endian());
+	if (hdr.type == NRRD_FLOAT)
+	{
+		int nread = (int)fread(pf, sizeof(float), nsize, fp);
+		if (nread != nsize) { feLog("Failed reading image data"); fclose(fp); return false; }
+		if (swap)
+		{
+			for (int i = 0; i < nsize; ++i)
+			{
+				unsigned char* b = (unsigned char*)(pf + i);
+				unsigned char c = b[0]; b[0] = b[3]; b[3] = c; c = b[1]; b[1] = b[2]; b[2] = c;
+			}
+		}
+	}
+	else
+	{
+		// integer voxels are normalized to [0,1]
+		int m = (hdr.type == NRRD_UINT8 ? 1 : 2);
+		std::vector<unsigned char> pb((size_t)nsize * m);
+		int nread = (int)fread(pb.data(), m, nsize, fp);
+		if (nread != nsize) { feLog("Failed reading image data"); fclose(fp); return false; }
+		for (int i = 0; i < nsize; ++i)
+		{
+			if (m == 1) pf[i] = (float)pb[i] / 255.f;
+			else
+			{
+				unsigned int n1 = pb[2 * i], n2 = pb[2 * i + 1];
+				unsigned short n = (unsigned short)(hdr.bigEndian ? (n1 << 8) + n2 : (n2 << 8) + n1);
+				pf[i] = (float)n / 65535.f;
+			}
+		}
+	}
+
+	fclose(fp);
+
+	return true;
+}
+
+bool FENRRDImage::GetImageVolume(ImageVolume& vol)
+{
+	if (m_file.empty()) return false;
+	const char* szfile = m_file.c_str();
+
+	FILE* fp = fopen(szfile, "rb");
+	if (fp == nullptr) return false;
+	NRRD_HEADER hdr;
+	bool b = ReadHeader(fp, hdr);
 	fclose(fp);
+	if (b == false) return false;
 
+	ImageVolume::VoxelType type = ImageVolume::VOXEL_FLOAT;
+	if (hdr.type == NRRD_UINT8 ) type = ImageVolume::VOXEL_UINT8;
+	if (hdr.type == NRRD_UINT16) type = ImageVolume::VOXEL_UINT16;
+	bool swap = (hdr.bigEndian == is_little_endian());
+
+	// the data is read into an Image without flipping the rows, so we flip 
+	// them here as well to get the same voxel coordinates.
+	if (vol.Map(szfile, hdr.offset, hdr.sizes[0], hdr.sizes[1], hdr.sizes[2], type, swap, true) == false)
+	{
+		feLogError("Failed to map image file %s", szfile);
+		return false;
+	}
 	return true;
 }
@@ -25,7 +25,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 #pragma once
 #include "Image.h"
+#include "ImageVolume.h"
 #include <FECore/FECoreClass.h>
+#include <stdio.h>
 #include "feimglib_api.h"
 
 //---------------------------------------------------------------------------
@@ -39,6 +41,11 @@ public:
 
 	virtual bool GetImage3D(Image& im) = 0;
 
+	// Get the image as a (read-only) image volume. The default implementation
+	// copies the image returned by GetImage3D. Sources that read files override
+	// this to map the file into memory instead.
+	virtual bool GetImageVolume(ImageVolume& vol);
+
 	std::string GetFileName() { return m_file; }
 
 protected:
@@ -54,6 +61,8 @@ public:
 
 	bool GetImage3D(Image& im) override;
 
+	bool GetImageVolume(ImageVolume& vol) override;
+
 private:
 	// load raw data from file
 	bool Load(const char* szfile, Image& im, Image::ImageFormat fmt, bool endianess = false);
@@ -72,6 +81,8 @@ class FEIMGLIB_API FENRRDImage : public FEImageSource
 {
 	enum NRRD_TYPE {
 		NRRD_INVALID,
+		NRRD_UINT8,
+		NRRD_UINT16,
 		NRRD_FLOAT
 	};
 
@@ -85,7 +96,20 @@ public:
 
 	bool GetImage3D(Image& im) override;
 
+	bool GetImageVolume(ImageVolume& vol) override;
+
 private:
+	struct NRRD_HEADER
+	{
+		NRRD_TYPE		type;
+		int				sizes[3];
+		bool			bigEndian;
+		size_t			offset;		// start of the image data
+	};
+
+	// read and check the header
+	bool ReadHeader(FILE* fp, NRRD_HEADER& hdr);
+
 	// load image data from file
 	bool Load(const char* szfile, Image& im);
 
@@ -29,28 +29,47 @@ SOFTWARE.*/
 BEGIN_FECORE_CLASS(FEImageValuator, FEScalarValuator)
 	ADD_PARAMETER(m_r0, "range_min");
 	ADD_PARAMETER(m_r1, "range_max");
+	ADD_PARAMETER(m_interpolation, "interpolation")->setEnums("linear\0cubic\0");
 	ADD_PROPERTY(m_imSrc, "image")->SetDefaultType("raw");
 	ADD_PROPERTY(m_transform, "transform");
 END_FECORE_CLASS();
 
-FEImageValuator::FEImageValuator(FEModel* fem) : FEScalarValuator(fem), m_map(m_im)
+FEImageValuator::FEImageValuator(FEModel* fem) : FEScalarValuator(fem)
 {
 	m_imSrc = nullptr;
+	m_interpolation = ImageVolume::LINEAR;
 }
 
 bool FEImageValuator::Init()
 {
 	if (m_imSrc == nullptr) return false;
-	if (m_imSrc->GetImage3D(m_im) == false) return false;
+	if (m_imSrc->GetImageVolume(m_vol) == false) return false;
 
-	m_map.SetRange(m_r0, m_r1);
+	m_vol.SetRange(m_r0, m_r1);
 
 	return FEScalarValuator::Init();
 }
 
 double FEImageValuator::operator()(const FEMaterialPoint& pt)
 {
-	return m_transform->value(m_map.value(pt.m_r0));
+	ImageVolume::Interpolation m = (ImageVolume::Interpolation)m_interpolation;
+	return m_transform->value(m_vol.value(pt.m_r0, m));
+}
+
+void FEImageValuator::values(FEMaterialPoint** mp, int n, double* val)
+{
+	ImageVolume::Interpolation m = (ImageVolume::Interpolation)m_interpolation;
+
+	// sample the image in blocks
+	const int M = 64;
+	vec3d r[M];
+	for (int i0 = 0; i0 < n; i0 += M)
+	{
+		int nb = (n - i0 < M ? n - i0 : M);
+		for (int i = 0; i < nb; ++i) r[i] = mp[i0 + i]->m_r0;
+		m_vol.values(r, nb, val + i0, m);
+		for (int i = 0; i < nb; ++i) val[i0 + i] = m_transform->value(val[i0 + i]);
+	}
 }
 
 FEScalarValuator* FEImageValuator::copy()
@@ -27,7 +27,7 @@ SOFTWARE.*/
 #include <FECore/FEScalarValuator.h>
 #include <FECore/FEFunction1D.h>
 #include "FEImageSource.h"
-#include "ImageMap.h"
+#include "ImageVolume.h"
 #include "feimglib_api.h"
 
 class FEIMGLIB_API FEImageValuator : public FEScalarValuator
@@ -39,15 +39,17 @@ public:
 
 	double operator()(const FEMaterialPoint& pt) override;
 
+	void values(FEMaterialPoint** mp, int n, double* val) override;
+
 	FEScalarValuator* copy() override;
 
 private:
 	vec3d	m_r0, m_r1;
 	FEImageSource* m_imSrc;
 	FEFunction1D* m_transform;
+	int		m_interpolation;
 
-	Image		m_im;
-	ImageMap	m_map;
+	ImageVolume	m_vol;
 
 	DECLARE_FECORE_CLASS();
 };
@@ -0,0 +1,479 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#include "ImageVolume.h"
+#include <string.h>
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+ImageVolume::ImageVolume()
+{
+	m_nx = m_ny = m_nz = 0;
+	m_r0 = vec3d(0, 0, 0);
+	m_r1 = vec3d(0, 0, 0);
+	m_type = VOXEL_FLOAT;
+	m_swap = false;
+	m_flipY = false;
+	m_data = nullptr;
+	m_nbx = m_nby = m_nbz = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool ImageVolume::Map(const char* szfile, size_t offset, int nx, int ny, int nz, VoxelType type, bool swapBytes, bool flipY)
+{
+	Clear();
+	if ((nx <= 0) || (ny <= 0) || (nz <= 0)) return false;
+
+	size_t bytes = 0;
+	switch (type)
+	{
+	case VOXEL_UINT8 : bytes = 1; break;
+	case VOXEL_UINT16: bytes = 2; break;
+	case VOXEL_FLOAT : bytes = 4; break;
+	default:
+		return false;
+	}
+
+	if (m_file.Open(szfile) == false) return false;
+
+	// make sure the file is large enough
+	size_t nsize = (size_t)nx * ny * nz * bytes;
+	if (offset + nsize > m_file.Size()) { m_file.Close(); return false; }
+
+	m_data = (const unsigned char*)m_file.Data() + offset;
+	m_nx = nx;
+	m_ny = ny;
+	m_nz = nz;
+	m_type = type;
+	m_swap = (swapBytes && (bytes > 1));
+	m_flipY = flipY;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void ImageVolume::Create(Image& im)
+{
+	Clear();
+
+	size_t n = (size_t)im.width() * im.height() * im.depth();
+	m_buf.assign(im.data(), im.data() + n);
+
+	m_data = (const unsigned char*)m_buf.data();
+	m_nx = im.width();
+	m_ny = im.height();
+	m_nz = im.depth();
+	m_type = VOXEL_FLOAT;
+	m_swap = false;
+
+	// the rows of an image are stored in reverse order
+	m_flipY = true;
+}
+
+//-----------------------------------------------------------------------------
+void ImageVolume::Clear()
+{
+	m_file.Close();
+	m_buf.clear();
+	m_grad.clear();
+	m_hess.clear();
+	m_data = nullptr;
+	m_nx = m_ny = m_nz = 0;
+	m_nbx = m_nby = m_nbz = 0;
+}
+
+//-----------------------------------------------------------------------------
+void ImageVolume::SetRange(const vec3d& r0, const vec3d& r1)
+{
+	m_r0 = r0;
+	m_r1 = r1;
+}
+
+//-----------------------------------------------------------------------------
+float ImageVolume::value(int i, int j, int k) const
+{
+	size_t n = ((size_t)k * m_ny + (m_flipY ? m_ny - j - 1 : j)) * m_nx + i;
+	switch (m_type)
+	{
+	case VOXEL_UINT8:
+		return (float)m_data[n] / 255.f;
+	case VOXEL_UINT16:
+	{
+		unsigned short v;
+		memcpy(&v, m_data + 2 * n, 2);
+		if (m_swap) v = (unsigned short)((v >> 8) | (v << 8));
+		return (float)v / 65535.f;
+	}
+	case VOXEL_FLOAT:
+	{
+		unsigned char b[4];
+		memcpy(b, m_data + 4 * n, 4);
+		if (m_swap) { unsigned char c = b[0]; b[0] = b[3]; b[3] = c; c = b[1]; b[1] = b[2]; b[2] = c; }
+		float f;
+		memcpy(&f, b, 4);
+		return f;
+	}
+	}
+	return 0.f;
+}
+
+//-----------------------------------------------------------------------------
+double ImageVolume::grad_x(int i, int j, int k) const
+{
+	if (i == 0       ) return value(i + 1, j, k) - value(i    , j, k);
+	if (i == m_nx - 1) return value(i    , j, k) - value(i - 1, j, k);
+	return 0.5*(value(i + 1, j, k) - value(i - 1, j, k));
+}
+
+double ImageVolume::grad_y(int i, int j, int k) const
+{
+	if (j == 0       ) return value(i, j + 1, k) - value(i, j    , k);
+	if (j == m_ny - 1) return value(i, j    , k) - value(i, j - 1, k);
+	return 0.5*(value(i, j + 1, k) - value(i, j - 1, k));
+}
+
+double ImageVolume::grad_z(int i, int j, int k) const
+{
+	if (m_nz == 1) return 0.0;
+	if (k == 0       ) return value(i, j, k + 1) - value(i, j, k    );
+	if (k == m_nz - 1) return value(i, j, k    ) - value(i, j, k - 1);
+	return 0.5*(value(i, j, k + 1) - value(i, j, k - 1));
+}
+
+//-----------------------------------------------------------------------------
+void ImageVolume::voxel_gradient(int i, int j, int k, double g[3]) const
+{
+	if (m_grad.empty() == false)
+	{
+		const float* gi = &m_grad[3 * brick_index(i, j, k)];
+		g[0] = gi[0]; g[1] = gi[1]; g[2] = gi[2];
+	}
+	else
+	{
+		g[0] = grad_x(i, j, k);
+		g[1] = grad_y(i, j, k);
+		g[2] = grad_z(i, j, k);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void ImageVolume::voxel_hessian(int i, int j, int k, double h[6]) const
+{
+	if (m_hess.empty() == false)
+	{
+		const float* hi = &m_hess[6 * brick_index(i, j, k)];
+		for (int l = 0; l < 6; ++l) h[l] = hi[l];
+		return;
+	}
+
+	// differentiate the gradient along the x, y, or z axis
+	const int n[3] = { m_nx, m_ny, m_nz };
+	double ga[3], gb[3];
+	for (int a = 0; a < 3; ++a)
+	{
+		int l = (a == 0 ? i : (a == 1 ? j : k));
+		if (n[a] <= 2)
+		{
+			ga[0] = ga[1] = ga[2] = gb[0] = gb[1] = gb[2] = 0.0;
+		}
+		else
+		{
+			int lm = (l == 0 ? l : l - 1);
+			int lp = (l == n[a] - 1 ? l : l + 1);
+			if (a == 0) { voxel_gradient(lp, j, k, ga); voxel_gradient(lm, j, k, gb); }
+			if (a == 1) { voxel_gradient(i, lp, k, ga); voxel_gradient(i, lm, k, gb); }
+			if (a == 2) { voxel_gradient(i, j, lp, ga); voxel_gradient(i, j, lm, gb); }
+
+			// central differences in the interior
+			double s = ((lp - lm) == 2 ? 0.5 : 1.0);
+			for (int c = 0; c < 3; ++c) { ga[c] = s*(ga[c] - gb[c]); }
+		}
+
+		if (a == 0) { h[0] = ga[0]; h[3] = ga[1]; h[5] = ga[2]; }	// xx, xy, xz
+		if (a == 1) { h[1] = ga[1]; h[4] = ga[2]; }				// yy, yz
+		if (a == 2) { h[2] = ga[2]; }							// zz
+	}
+}
+
+//-----------------------------------------------------------------------------
+void ImageVolume::PrecomputeDerivatives(bool hessian)
+{
+	m_grad.clear();
+	m_hess.clear();
+	if (m_data == nullptr) return;
+
+	m_nbx = (m_nx + 7) / 8;
+	m_nby = (m_ny + 7) / 8;
+	m_nbz = (m_nz + 7) / 8;
+	size_t nb = (size_t)m_nbx * m_nby * m_nbz * 512;
+
+	const int nx = m_nx, ny = m_ny, nz = m_nz;
+
+	std::vector<float> grad(3 * nb, 0.f);
+#pragma omp parallel for
+	for (int k = 0; k < nz; ++k)
+		for (int j = 0; j < ny; ++j)
+			for (int i = 0; i < nx; ++i)
+			{
+				double g[3];
+				voxel_gradient(i, j, k, g);
+				float* gi = &grad[3 * brick_index(i, j, k)];
+				gi[0] = (float)g[0]; gi[1] = (float)g[1]; gi[2] = (float)g[2];
+			}
+	m_grad.swap(grad);
+
+	if (hessian)
+	{
+		std::vector<float> hess(6 * nb, 0.f);
+#pragma omp parallel for
+		for (int k = 0; k < nz; ++k)
+			for (int j = 0; j < ny; ++j)
+				for (int i = 0; i < nx; ++i)
+				{
+					double h[6];
+					voxel_hessian(i, j, k, h);
+					float* hi = &hess[6 * brick_index(i, j, k)];
+					for (int l = 0; l < 6; ++l) hi[l] = (float)h[l];
+				}
+		m_hess.swap(hess);
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool ImageVolume::map(const vec3d& p, POINT& pt) const
+{
+	int nx = m_nx;
+	int ny = m_ny;
+	int nz = m_nz;
+	if (m_data == nullptr) return false;
+
+	double x = (p.x - m_r0.x) / (m_r1.x - m_r0.x);
+	double y = (p.y - m_r0.y) / (m_r1.y - m_r0.y);
+	double z = (nz == 1 ? 0 : (p.z - m_r0.z) / (m_r1.z - m_r0.z));
+
+	double dx = 1.0 / (double)(nx - 1);
+	double dy = 1.0 / (double)(ny - 1);
+	double dz = (nz > 1 ? 1.0 / (double)(nz - 1) : 1.0);
+
+	int i = (int)floor(x * (nx - 1));
+	int j = (int)floor(y * (ny - 1));
+	int k = (int)floor(z * (nz - 1));
+
+	if (i == nx - 1) i--;
+	if (j == ny - 1) j--;
+	if ((k == nz - 1) && (nz > 1)) k--;
+
+	double r = (x - i * dx) / dx;
+	double s = (y - j * dy) / dy;
+	double t = (z - k * dz) / dz;
+
+	pt.i = i; pt.j = j; pt.k = k;
+	pt.r = r; pt.s = s; pt.t = t;
+
+	if (nz == 1)
+	{
+		pt.h[0] = (1 - r) * (1 - s);
+		pt.h[1] = r * (1 - s);
+		pt.h[2] = r * s;
+		pt.h[3] = s * (1 - r);
+		pt.h[4] = pt.h[5] = pt.h[6] = pt.h[7] = 0.0;
+	}
+	else
+	{
+		pt.h[0] = (1 - r) * (1 - s) * (1 - t);
+		pt.h[1] = r * (1 - s) * (1 - t);
+		pt.h[2] = r * s * (1 - t);
+		pt.h[3] = s * (1 - r) * (1 - t);
+		pt.h[4] = (1 - r) * (1 - s) * t;
+		pt.h[5] = r * (1 - s) * t;
+		pt.h[6] = r * s * t;
+		pt.h[7] = s * (1 - r) * t;
+	}
+
+	if ((i < 0) || (i >= nx - 1)) return false;
+	if ((j < 0) || (j >= ny - 1)) return false;
+	if ((nz > 1) && ((k < 0) || (k >= nz - 1))) return false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+double ImageVolume::linear(const POINT& p) const
+{
+	if (m_nz == 1)
+	{
+		double v[4];
+		v[0] = value(p.i    , p.j    , 0);
+		v[1] = value(p.i + 1, p.j    , 0);
+		v[2] = value(p.i + 1, p.j + 1, 0);
+		v[3] = value(p.i    , p.j + 1, 0);
+		return (p.h[0]*v[0] + p.h[1]*v[1] + p.h[2]*v[2] + p.h[3]*v[3]);
+	}
+	else
+	{
+		double v[8];
+		v[0] = value(p.i    , p.j    , p.k    );
+		v[1] = value(p.i + 1, p.j    , p.k    );
+		v[2] = value(p.i + 1, p.j + 1, p.k    );
+		v[3] = value(p.i    , p.j + 1, p.k    );
+		v[4] = value(p.i    , p.j    , p.k + 1);
+		v[5] = value(p.i + 1, p.j    , p.k + 1);
+		v[6] = value(p.i + 1, p.j + 1, p.k + 1);
+		v[7] = value(p.i    , p.j + 1, p.k + 1);
+		return (p.h[0]*v[0] + p.h[1]*v[1] + p.h[2]*v[2] + p.h[3]*v[3] + p.h[4]*v[4] + p.h[5]*v[5] + p.h[6]*v[6] + p.h[7]*v[7]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Catmull-Rom weights of the four samples around local coordinate t in [0,1]
+static void catmull_rom(double t, double w[4])
+{
+	double t2 = t * t, t3 = t2 * t;
+	w[0] = 0.5*(-t3 + 2.0*t2 - t);
+	w[1] = 0.5*(3.0*t3 - 5.0*t2 + 2.0);
+	w[2] = 0.5*(-3.0*t3 + 4.0*t2 + t);
+	w[3] = 0.5*(t3 - t2);
+}
+
+//-----------------------------------------------------------------------------
+double ImageVolume::cubic(const POINT& p) const
+{
+	double wx[4], wy[4], wz[4];
+	int ii[4], jj[4], kk[4];
+	catmull_rom(p.r, wx);
+	catmull_rom(p.s, wy);
+	catmull_rom(p.t, wz);
+
+	// the samples are clamped to the image
+	for (int l = 0; l < 4; ++l)
+	{
+		int i = p.i + l - 1; ii[l] = (i < 0 ? 0 : (i >= m_nx ? m_nx - 1 : i));
+		int j = p.j + l - 1; jj[l] = (j < 0 ? 0 : (j >= m_ny ? m_ny - 1 : j));
+		int k = p.k + l - 1; kk[l] = (k < 0 ? 0 : (k >= m_nz ? m_nz - 1 : k));
+	}
+
+	double v = 0.0;
+	if (m_nz == 1)
+	{
+		for (int b = 0; b < 4; ++b)
+		{
+			double vb = 0.0;
+			for (int a = 0; a < 4; ++a) vb += wx[a] * value(ii[a], jj[b], 0);
+			v += wy[b] * vb;
+		}
+	}
+	else
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			double vc = 0.0;
+			for (int b = 0; b < 4; ++b)
+			{
+				double vb = 0.0;
+				for (int a = 0; a < 4; ++a) vb += wx[a] * value(ii[a], jj[b], kk[c]);
+				vc += wy[b] * vb;
+			}
+			v += wz[c] * vc;
+		}
+	}
+	return v;
+}
+
+//-----------------------------------------------------------------------------
+double ImageVolume::value(const vec3d& r, Interpolation m) const
+{
+	POINT p;
+	if (map(r, p) == false) return 0.0;
+	return (m == CUBIC ? cubic(p) : linear(p));
+}
+
+//-----------------------------------------------------------------------------
+vec3d ImageVolume::gradient(const vec3d& r) const
+{
+	POINT p;
+	if (map(r, p) == false) return vec3d(0, 0, 0);
+
+	// interpolate the voxel gradients
+	int nn = (m_nz == 1 ? 4 : 8);
+	const int di[8] = { 0, 1, 1, 0, 0, 1, 1, 0 };
+	const int dj[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
+	const int dk[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+	double G[3] = { 0, 0, 0 };
+	for (int n = 0; n < nn; ++n)
+	{
+		double g[3];
+		voxel_gradient(p.i + di[n], p.j + dj[n], p.k + dk[n], g);
+		G[0] += p.h[n] * g[0];
+		G[1] += p.h[n] * g[1];
+		G[2] += p.h[n] * g[2];
+	}
+
+	if (m_nz == 1) return vec3d(G[0] / dx(), G[1] / dy(), 0.0);
+	return vec3d(G[0] / dx(), G[1] / dy(), G[2] / dz());
+}
+
+//-----------------------------------------------------------------------------
+mat3ds ImageVolume::hessian(const vec3d& r) const
+{
+	POINT p;
+	if (map(r, p) == false) return mat3ds(0, 0, 0, 0, 0, 0);
+
+	// interpolate the voxel Hessians
+	int nn = (m_nz == 1 ? 4 : 8);
+	const int di[8] = { 0, 1, 1, 0, 0, 1, 1, 0 };
+	const int dj[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
+	const int dk[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+	double H[6] = { 0, 0, 0, 0, 0, 0 };
+	for (int n = 0; n < nn; ++n)
+	{
+		double h[6];
+		voxel_hessian(p.i + di[n], p.j + dj[n], p.k + dk[n], h);
+		for (int l = 0; l < 6; ++l) H[l] += p.h[n] * h[l];
+	}
+
+	double Dx = dx(), Dy = dy(), Dz = dz();
+	if (m_nz == 1) return mat3ds(H[0] / (Dx*Dx), H[1] / (Dy*Dy), 0.0, H[3] / (Dx*Dy), 0.0, 0.0);
+	return mat3ds(H[0] / (Dx*Dx), H[1] / (Dy*Dy), H[2] / (Dz*Dz), H[3] / (Dx*Dy), H[4] / (Dy*Dz), H[5] / (Dx*Dz));
+}
+
+//-----------------------------------------------------------------------------
+void ImageVolume::values(const vec3d* r, int n, double* v, Interpolation m) const
+{
+#pragma omp parallel for if (n >= 256)
+	for (int i = 0; i < n; ++i) v[i] = value(r[i], m);
+}
+
+//-----------------------------------------------------------------------------
+void ImageVolume::gradients(const vec3d* r, int n, vec3d* g) const
+{
+#pragma omp parallel for if (n >= 256)
+	for (int i = 0; i < n; ++i) g[i] = gradient(r[i]);
+}
+
+//-----------------------------------------------------------------------------
+void ImageVolume::hessians(const vec3d* r, int n, mat3ds* h) const
+{
+#pragma omp parallel for if (n >= 256)
+	for (int i = 0; i < n; ++i) h[i] = hessian(r[i]);
+}
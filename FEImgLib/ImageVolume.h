@@ -0,0 +1,152 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#pragma once
+#include "Image.h"
+#include <FECore/vec3d.h>
+#include <FECore/mat3d.h>
+#include <FECore/MappedFile.h>
+#include <vector>
+#include "feimglib_api.h"
+
+//-----------------------------------------------------------------------------
+// Read-only 3D image that is sampled at physical coordinates. In contrast to 
+// Image, the voxel data of an image file is memory-mapped and kept in its 
+// original type (8-bit, 16-bit, or float), so large images are paged in on demand.
+// Integer voxels are normalized to [0,1].
+// The gradient and Hessian of the voxels (the same finite differences as ImageMap)
+// can be precomputed. They are stored in bricks of 8x8x8 voxels, so that the 
+// corners of a sample point are close in memory.
+// The sampling functions are const and can be called from multiple threads.
+class FEIMGLIB_API ImageVolume
+{
+public:
+	enum VoxelType {
+		VOXEL_UINT8,
+		VOXEL_UINT16,
+		VOXEL_FLOAT
+	};
+
+	enum Interpolation {
+		LINEAR,		// (bi/tri)linear interpolation (same as ImageMap)
+		CUBIC		// (bi/tri)cubic Catmull-Rom interpolation
+	};
+
+public:
+	ImageVolume();
+
+	// map the voxels of a file. The voxels start at byte offset and are stored with x the fastest index.
+	// If swapBytes is set, the byte order of the voxels is reversed. If flipY is set, the rows
+	// are stored in reverse order (as is the case for the data of an Image).
+	bool Map(const char* szfile, size_t offset, int nx, int ny, int nz, VoxelType type, bool swapBytes = false, bool flipY = false);
+
+	// copy the voxels of an image
+	void Create(Image& im);
+
+	// release all data
+	void Clear();
+
+	int width () const { return m_nx; }
+	int height() const { return m_ny; }
+	int depth () const { return m_nz; }
+
+	VoxelType Type() const { return m_type; }
+
+	// set the physical coordinates of the first and last voxel
+	void SetRange(const vec3d& r0, const vec3d& r1);
+
+	// voxel value
+	float value(int i, int j, int k) const;
+
+	// precompute the voxel gradients and, optionally, Hessians
+	void PrecomputeDerivatives(bool hessian);
+
+	bool HasGradient() const { return !m_grad.empty(); }
+	bool HasHessian() const { return !m_hess.empty(); }
+
+public:
+	// Sample the image. Points outside the image return zero.
+	double value(const vec3d& r, Interpolation m = LINEAR) const;
+	vec3d gradient(const vec3d& r) const;
+	mat3ds hessian(const vec3d& r) const;
+
+	// Sample the image at n points, e.g. all integration points of a domain.
+	void values(const vec3d* r, int n, double* v, Interpolation m = LINEAR) const;
+	void gradients(const vec3d* r, int n, vec3d* g) const;
+	void hessians(const vec3d* r, int n, mat3ds* h) const;
+
+	// voxel dimensions
+	double dx() const { return (m_r1.x - m_r0.x) / (double)(m_nx - 1); }
+	double dy() const { return (m_r1.y - m_r0.y) / (double)(m_ny - 1); }
+	double dz() const { return (m_nz == 1 ? 1.0 : (m_r1.z - m_r0.z) / (double)(m_nz - 1)); }
+
+private:
+	struct POINT
+	{
+		int		i, j, k;
+		double	r, s, t;	// local coordinates in voxel cell
+		double	h[8];		// trilinear weights
+	};
+
+	// find the voxel cell of a point. Returns false if the point is outside the image.
+	bool map(const vec3d& p, POINT& pt) const;
+
+	double linear(const POINT& p) const;
+	double cubic(const POINT& p) const;
+
+	// voxel derivatives (in voxel units)
+	void voxel_gradient(int i, int j, int k, double g[3]) const;
+	void voxel_hessian(int i, int j, int k, double h[6]) const;
+
+	double grad_x(int i, int j, int k) const;
+	double grad_y(int i, int j, int k) const;
+	double grad_z(int i, int j, int k) const;
+
+	// index of a voxel in the bricked derivative arrays
+	size_t brick_index(int i, int j, int k) const
+	{
+		size_t b = ((size_t)(k >> 3) * m_nby + (j >> 3)) * m_nbx + (i >> 3);
+		return (b << 9) + ((k & 7) << 6) + ((j & 7) << 3) + (i & 7);
+	}
+
+private:
+	ImageVolume(const ImageVolume&) = delete;
+	void operator = (const ImageVolume&) = delete;
+
+private:
+	int		m_nx, m_ny, m_nz;
+	vec3d	m_r0, m_r1;
+
+	VoxelType				m_type;
+	bool					m_swap;
+	bool					m_flipY;
+	const unsigned char*	m_data;		// pointer to the first voxel
+	MappedFile				m_file;		// mapped image file
+	std::vector<float>		m_buf;		// voxels that are not mapped from a file
+
+	int					m_nbx, m_nby, m_nbz;	// number of bricks
+	std::vector<float>	m_grad;		// voxel gradients (3 per voxel)
+	std::vector<float>	m_hess;		// voxel Hessians (xx, yy, zz, xy, yz, xz)
+};
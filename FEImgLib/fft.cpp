@@ -1,105 +1,356 @@
-#ifdef HAVE_MKL
-#include <mkl.h>
-#include <complex>
-
-//---------------------------------------------------------------------------------------
-// calculate the DFT of a source image x. The source image is assumed to be stored
-// in row-major order, indexed by (x,y), where x is the column index, and y the row index. 
-// The complex Fourier coefficients are returned in c. The buffer must be pre-allocated and must have
-// the size (nx,ny), the same as the source image.
-bool mkl_dft2(int nx, int ny, float* x, MKL_Complex8* c)
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#include "fft.h"
+#include <vector>
+#include <math.h>
+
+typedef std::complex<double> dcomplex;
+
+// complex multiplication (std::complex's operator* has slow special handling of infinities)
+inline dcomplex cmul(const dcomplex& a, const dcomplex& b)
+{
+	return dcomplex(a.real()*b.real() - a.imag()*b.imag(), a.real()*b.imag() + a.imag()*b.real());
+}
+
+//-----------------------------------------------------------------------------
+// Plan for 1D complex transforms of length n. Powers of two are done with an
+// iterative radix-2 algorithm. Other lengths use Bluestein's algorithm, which
+// writes the DFT as a convolution that is evaluated with radix-2 transforms of
+// length m >= 2n - 1.
+class FFTPlan
+{
+public:
+	FFTPlan(int n);
+
+	int size() const { return m_n; }
+
+	// size of the work buffer needed by Transform
+	int WorkSize() const { return (m_m == m_n ? 0 : m_m); }
+
+	// in-place transform of a. The inverse transform is not normalized.
+	void Transform(dcomplex* a, bool inverse, dcomplex* work) const;
+
+private:
+	void Radix2(dcomplex* a, bool inverse) const;
+
+private:
+	int		m_n;
+	int		m_m;						// length of the radix-2 transforms
+	std::vector<dcomplex>	m_w;		// twiddle factors exp(-2*pi*i*k/m), k < m/2
+	std::vector<int>		m_rev;		// bit-reversal permutation
+	std::vector<dcomplex>	m_chirp;	// exp(-pi*i*k^2/n), k < n (Bluestein only)
+	std::vector<dcomplex>	m_B;		// transformed convolution kernel (Bluestein only)
+};
+
+FFTPlan::FFTPlan(int n) : m_n(n)
+{
+	const double pi = 3.14159265358979323846;
+
+	m_m = 1;
+	while (m_m < n) m_m <<= 1;
+	if (m_m != n)
+	{
+		m_m = 1;
+		while (m_m < 2 * n - 1) m_m <<= 1;
+	}
+
+	m_w.resize(m_m / 2);
+	for (int k = 0; k < m_m / 2; ++k)
+	{
+		double a = 2.0 * pi * k / m_m;
+		m_w[k] = dcomplex(cos(a), -sin(a));
+	}
+
+	int bits = 0;
+	while ((1 << bits) < m_m) bits++;
+	m_rev.resize(m_m);
+	for (int i = 0; i < m_m; ++i)
+	{
+		int r = 0;
+		for (int b = 0; b < bits; ++b) if (i & (1 << b)) r |= (1 << (bits - 1 - b));
+		m_rev[i] = r;
+	}
+
+	if (m_m != m_n)
+	{
+		m_chirp.resize(n);
+		for (int k = 0; k < n; ++k)
+		{
+			// k^2 is reduced modulo 2n to retain accuracy for large k
+			long long k2 = ((long long)k * k) % (2 * (long long)n);
+			double a = pi * (double)k2 / n;
+			m_chirp[k] = dcomplex(cos(a), -sin(a));
+		}
+
+		m_B.assign(m_m, dcomplex(0.0, 0.0));
+		m_B[0] = std::conj(m_chirp[0]);
+		for (int k = 1; k < n; ++k) m_B[k] = m_B[m_m - k] = std::conj(m_chirp[k]);
+		Radix2(&m_B[0], false);
+	}
+}
+
+void FFTPlan::Radix2(dcomplex* a, bool inverse) const
+{
+	const int m = m_m;
+	for (int i = 0; i < m; ++i)
+	{
+		int r = m_rev[i];
+		if (i < r) std::swap(a[i], a[r]);
+	}
+
+	for (int len = 2; len <= m; len <<= 1)
+	{
+		int h = len / 2;
+		int step = m / len;
+		for (int i = 0; i < m; i += len)
+		{
+			dcomplex* a0 = a + i;
+			dcomplex* a1 = a + i + h;
+			for (int k = 0; k < h; ++k)
+			{
+				dcomplex w = m_w[k * step];
+				if (inverse) w = std::conj(w);
+				dcomplex u = a0[k];
+				dcomplex v = cmul(a1[k], w);
+				a0[k] = u + v;
+				a1[k] = u - v;
+			}
+		}
+	}
+}
+
+void FFTPlan::Transform(dcomplex* a, bool inverse, dcomplex* work) const
+{
+	if (m_m == m_n) { Radix2(a, inverse); return; }
+
+	// Bluestein's algorithm. The inverse is evaluated as the conjugate of 
+	// the forward transform of the conjugate sequence.
+	const int n = m_n;
+	const int m = m_m;
+	for (int k = 0; k < n; ++k) work[k] = cmul((inverse ? std::conj(a[k]) : a[k]), m_chirp[k]);
+	for (int k = n; k < m; ++k) work[k] = dcomplex(0.0, 0.0);
+
+	Radix2(work, false);
+	for (int k = 0; k < m; ++k) work[k] = cmul(work[k], m_B[k]);
+	Radix2(work, true);
+
+	const double s = 1.0 / m;
+	for (int k = 0; k < n; ++k)
+	{
+		dcomplex r = cmul(work[k], m_chirp[k]) * s;
+		a[k] = (inverse ? std::conj(r) : r);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Forward transform of the real rows a and b of length n. Both rows are packed in one
+// complex transform and the half spectra are separated using the symmetry of the DFT.
+// The row b may be null.
+static void rfft_pair(const FFTPlan& p, const float* a, const float* b, fft_complex* ca, fft_complex* cb, dcomplex* z, dcomplex* work)
 {
-	DFTI_DESCRIPTOR_HANDLE my_desc_handle;
-	MKL_LONG status;
-
-	MKL_LONG sizes[2] = { nx, ny };
-	MKL_LONG is[3] = { 0, 1, nx };
-	MKL_LONG os[3] = { 0, 1, nx }; // { 0, 1, N2/2+1}
-	status = DftiCreateDescriptor(&my_desc_handle, DFTI_SINGLE, DFTI_REAL, 2, sizes);
-	status = DftiSetValue(my_desc_handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-	status = DftiSetValue(my_desc_handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-	status = DftiSetValue(my_desc_handle, DFTI_INPUT_STRIDES, is);
-	status = DftiSetValue(my_desc_handle, DFTI_OUTPUT_STRIDES, os);
-	status = DftiCommitDescriptor(my_desc_handle);
-	status = DftiComputeForward(my_desc_handle, x, c);
-	status = DftiFreeDescriptor(&my_desc_handle);
-
-	return true;
+	const int n = p.size();
+	const int nh = n / 2 + 1;
+	for (int j = 0; j < n; ++j) z[j] = dcomplex(a[j], (b ? b[j] : 0.f));
+
+	p.Transform(z, false, work);
+
+	for (int k = 0; k < nh; ++k)
+	{
+		dcomplex zk = z[k];
+		dcomplex zc = std::conj(z[(n - k) % n]);
+		dcomplex A = (zk + zc) * 0.5;
+		ca[k] = fft_complex((float)A.real(), (float)A.imag());
+		if (cb)
+		{
+			// B = (zk - zc)/(2i)
+			dcomplex d = (zk - zc) * 0.5;
+			cb[k] = fft_complex((float)d.imag(), (float)-d.real());
+		}
+	}
 }
 
-//---------------------------------------------------------------------------------------
-// calculate the inverse DFT. The fourier coefficients are passed and assumed to be stored
-// in row-major order, indexed by (x,y), where x is the column index, and y the row index. 
-// The reconstructed image is returned in x, which must have the same size and storage. 
-bool mkl_idft2(int nx, int ny, MKL_Complex8* c, float* x)
+//-----------------------------------------------------------------------------
+// Inverse of rfft_pair. The result is multiplied by scale. The rows cb and b may be null.
+static void irfft_pair(const FFTPlan& p, const fft_complex* ca, const fft_complex* cb, float* a, float* b, double scale, dcomplex* z, dcomplex* work)
 {
-	DFTI_DESCRIPTOR_HANDLE my_desc_handle;
-	MKL_LONG status;
-
-	MKL_LONG sizes[2] = { nx, ny };
-	MKL_LONG is[3] = { 0, 1, nx };  // { 0, 1, Nx/2+1}
-	MKL_LONG os[3] = { 0, 1, nx };
-	status = DftiCreateDescriptor(&my_desc_handle, DFTI_SINGLE, DFTI_REAL, 2, sizes);
-	status = DftiSetValue(my_desc_handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-	status = DftiSetValue(my_desc_handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-	status = DftiSetValue(my_desc_handle, DFTI_INPUT_STRIDES, is);
-	status = DftiSetValue(my_desc_handle, DFTI_OUTPUT_STRIDES, os);
-	status = DftiSetValue(my_desc_handle, DFTI_BACKWARD_SCALE, 1.f / ((float)nx * (float)ny));
-	status = DftiCommitDescriptor(my_desc_handle);
-	status = DftiComputeBackward(my_desc_handle, c, x);
-	status = DftiFreeDescriptor(&my_desc_handle);
-
-	return true;
+	const int n = p.size();
+	const int nh = n / 2 + 1;
+	for (int k = 0; k < nh; ++k)
+	{
+		dcomplex A(ca[k].real(), ca[k].imag());
+		dcomplex B(0.0, 0.0);
+		if (cb) B = dcomplex(cb[k].real(), cb[k].imag());
+
+		// the zero and Nyquist frequencies of a real row are real
+		if ((k == 0) || (2 * k == n)) { A.imag(0.0); B.imag(0.0); }
+
+		// Z = A + iB
+		z[k] = A + dcomplex(-B.imag(), B.real());
+		if ((k > 0) && (2 * k < n))
+		{
+			// Z(n-k) = conj(A) + i*conj(B)
+			z[n - k] = std::conj(A) + dcomplex(B.imag(), B.real());
+		}
+	}
+
+	p.Transform(z, true, work);
+
+	for (int j = 0; j < n; ++j)
+	{
+		a[j] = (float)(z[j].real() * scale);
+		if (b) b[j] = (float)(z[j].imag() * scale);
+	}
 }
 
-//---------------------------------------------------------------------------------------
-// calculate the DFT of a source image x. The source image is assumed to be stored
-// in row-major order, indexed by (x,y,z), where x is the column index, y the row index, z is the plane index. 
-// The complex Fourier coefficients are returned in c. The buffer must be pre-allocated and must have
-// the size (nx,ny,nz), the same as the source image.
-bool mkl_dft3(int nx, int ny, int nz, float* x, MKL_Complex8* c)
+//-----------------------------------------------------------------------------
+// forward transform of the nrows rows of length nx of the real image x.
+static void rfft_rows(const float* x, fft_complex* c, int nx, int nrows)
 {
-	DFTI_DESCRIPTOR_HANDLE my_desc_handle;
-	MKL_LONG status;
-
-	MKL_LONG sizes[3] = { nx, ny, nz };
-	MKL_LONG is[4] = { 0, 1, nx, nx*ny };
-	MKL_LONG os[4] = { 0, 1, nx, nx*ny }; // { 0, 1, nx, ny, nz/2+1}
-	status = DftiCreateDescriptor(&my_desc_handle, DFTI_SINGLE, DFTI_REAL, 3, sizes);
-	status = DftiSetValue(my_desc_handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-	status = DftiSetValue(my_desc_handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-	status = DftiSetValue(my_desc_handle, DFTI_INPUT_STRIDES, is);
-	status = DftiSetValue(my_desc_handle, DFTI_OUTPUT_STRIDES, os);
-	status = DftiCommitDescriptor(my_desc_handle);
-	status = DftiComputeForward(my_desc_handle, x, c);
-	status = DftiFreeDescriptor(&my_desc_handle);
-
-	return true;
+	FFTPlan p(nx);
+	const int nh = nx / 2 + 1;
+	const int npairs = (nrows + 1) / 2;
+#pragma omp parallel
+	{
+		std::vector<dcomplex> z(nx), work(p.WorkSize());
+#pragma omp for schedule(static)
+		for (int t = 0; t < npairs; ++t)
+		{
+			size_t r0 = 2 * (size_t)t;
+			size_t r1 = r0 + 1;
+			const float* b = (r1 < (size_t)nrows ? x + r1 * nx : nullptr);
+			fft_complex* cb = (r1 < (size_t)nrows ? c + r1 * nh : nullptr);
+			rfft_pair(p, x + r0 * nx, b, c + r0 * nh, cb, z.data(), work.data());
+		}
+	}
 }
 
-//---------------------------------------------------------------------------------------
-// calculate the inverse DFT. The fourier coefficients are passed and assumed to be stored
-// in row-major order, indexed by (x,y,z), where x is the column index, y the row index, and z the plane index. 
-// The reconstructed image is returned in y, which must have the same size and storage. 
-bool mkl_idft3(int nx, int ny, int nz, MKL_Complex8* c, float* y)
+//-----------------------------------------------------------------------------
+// inverse transform of the nrows rows of the half spectrum c.
+static void irfft_rows(const fft_complex* c, float* x, int nx, int nrows, double scale)
 {
-	DFTI_DESCRIPTOR_HANDLE my_desc_handle;
-	MKL_LONG status;
-
-	MKL_LONG sizes[3] = { nx, ny, nz };
-	MKL_LONG is[4] = { 0, 1, nx, nx * ny };  // { 0, 1, nx, ny, nz/2+1}
-	MKL_LONG os[4] = { 0, 1, nx, nx * ny };
-	status = DftiCreateDescriptor(&my_desc_handle, DFTI_SINGLE, DFTI_REAL, 3, sizes);
-	status = DftiSetValue(my_desc_handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-	status = DftiSetValue(my_desc_handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-	status = DftiSetValue(my_desc_handle, DFTI_INPUT_STRIDES, is);
-	status = DftiSetValue(my_desc_handle, DFTI_OUTPUT_STRIDES, os);
-	status = DftiSetValue(my_desc_handle, DFTI_BACKWARD_SCALE, 1.f / ((float)nx * (float)ny * (float) nz));
-	status = DftiCommitDescriptor(my_desc_handle);
-	status = DftiComputeBackward(my_desc_handle, c, y);
-	status = DftiFreeDescriptor(&my_desc_handle);
-
-	return true;
+	FFTPlan p(nx);
+	const int nh = nx / 2 + 1;
+	const int npairs = (nrows + 1) / 2;
+#pragma omp parallel
+	{
+		std::vector<dcomplex> z(nx), work(p.WorkSize());
+#pragma omp for schedule(static)
+		for (int t = 0; t < npairs; ++t)
+		{
+			size_t r0 = 2 * (size_t)t;
+			size_t r1 = r0 + 1;
+			float* b = (r1 < (size_t)nrows ? x + r1 * nx : nullptr);
+			const fft_complex* cb = (r1 < (size_t)nrows ? c + r1 * nh : nullptr);
+			irfft_pair(p, c + r0 * nh, cb, x + r0 * nx, b, scale, z.data(), work.data());
+		}
+	}
 }
 
-#endif
+//-----------------------------------------------------------------------------
+// In-place transform of the complex lines c[o*ostride + i + l*stride], l < n, 
+// for o < no and i < ni. Neighboring lines (in i) are processed together so
+// that the strided access uses whole cache lines.
+static void fft_lines(fft_complex* c, int n, size_t stride, int no, size_t ostride, int ni, bool inverse)
+{
+	if (n == 1) return;
+
+	const int BS = 8;
+	FFTPlan p(n);
+	const int nb = (ni + BS - 1) / BS;
+	const int ntasks = no * nb;
+#pragma omp parallel
+	{
+		std::vector<dcomplex> z((size_t)BS * n), work(p.WorkSize());
+#pragma omp for schedule(static)
+		for (int t = 0; t < ntasks; ++t)
+		{
+			int o = t / nb;
+			int i0 = (t % nb) * BS;
+			int m = (ni - i0 < BS ? ni - i0 : BS);
+			fft_complex* base = c + o * ostride + i0;
+
+			for (int l = 0; l < n; ++l)
+			{
+				const fft_complex* cl = base + l * stride;
+				for (int b = 0; b < m; ++b) z[b * n + l] = dcomplex(cl[b].real(), cl[b].imag());
+			}
+
+			for (int b = 0; b < m; ++b) p.Transform(&z[b * n], inverse, work.data());
+
+			for (int l = 0; l < n; ++l)
+			{
+				fft_complex* cl = base + l * stride;
+				for (int b = 0; b < m; ++b)
+				{
+					const dcomplex& zb = z[b * n + l];
+					cl[b] = fft_complex((float)zb.real(), (float)zb.imag());
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+size_t dft_size(int nx, int ny, int nz)
+{
+	return (size_t)(nx / 2 + 1) * ny * nz;
+}
+
+//-----------------------------------------------------------------------------
+void dft2(int nx, int ny, const float* x, fft_complex* c)
+{
+	const int nh = nx / 2 + 1;
+	rfft_rows(x, c, nx, ny);
+	fft_lines(c, ny, nh, 1, 0, nh, false);
+}
+
+//-----------------------------------------------------------------------------
+void idft2(int nx, int ny, fft_complex* c, float* x)
+{
+	const int nh = nx / 2 + 1;
+	fft_lines(c, ny, nh, 1, 0, nh, true);
+	irfft_rows(c, x, nx, ny, 1.0 / ((double)nx * (double)ny));
+}
+
+//-----------------------------------------------------------------------------
+void dft3(int nx, int ny, int nz, const float* x, fft_complex* c)
+{
+	const int nh = nx / 2 + 1;
+	const size_t ns = (size_t)nh * ny;
+	rfft_rows(x, c, nx, ny * nz);
+	fft_lines(c, ny, nh, nz, ns, nh, false);
+	fft_lines(c, nz, ns, 1, 0, (int)ns, false);
+}
+
+//-----------------------------------------------------------------------------
+void idft3(int nx, int ny, int nz, fft_complex* c, float* x)
+{
+	const int nh = nx / 2 + 1;
+	const size_t ns = (size_t)nh * ny;
+	fft_lines(c, nz, ns, 1, 0, (int)ns, true);
+	fft_lines(c, ny, nh, nz, ns, nh, true);
+	irfft_rows(c, x, nx, ny * nz, 1.0 / ((double)nx * (double)ny * (double)nz));
+}
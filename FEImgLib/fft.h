@@ -0,0 +1,55 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#pragma once
+#include "feimglib_api.h"
+#include <complex>
+
+//-----------------------------------------------------------------------------
+// Native fast Fourier transforms of real images. The transforms work for any
+// image size (not just powers of two) and are parallelized with OpenMP.
+//
+// The images are stored with x the fastest index, i.e. the value of voxel (i,j,k)
+// is at x[(k*ny + j)*nx + i]. Since the spectrum of a real image is Hermitian, 
+// only the non-redundant half is stored: the Fourier coefficient (i,j,k) is at
+// c[(k*ny + j)*nh + i], where nh = nx/2 + 1 and 0 <= i < nh.
+// The inverse transforms are normalized so that idft(dft(x)) = x.
+
+typedef std::complex<float> fft_complex;
+
+// size of the half-spectrum of an image
+FEIMGLIB_API size_t dft_size(int nx, int ny, int nz = 1);
+
+// forward DFT of a 2D image. The buffer c must have dft_size(nx, ny) entries.
+FEIMGLIB_API void dft2(int nx, int ny, const float* x, fft_complex* c);
+
+// inverse DFT of a 2D image. The coefficients in c are overwritten.
+FEIMGLIB_API void idft2(int nx, int ny, fft_complex* c, float* x);
+
+// forward DFT of a 3D image. The buffer c must have dft_size(nx, ny, nz) entries.
+FEIMGLIB_API void dft3(int nx, int ny, int nz, const float* x, fft_complex* c);
+
+// inverse DFT of a 3D image. The coefficients in c are overwritten.
+FEIMGLIB_API void idft3(int nx, int ny, int nz, fft_complex* c, float* x);
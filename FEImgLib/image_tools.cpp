@@ -1,10 +1,8 @@
 #include "image_tools.h"
 #include "Image.h"
+#include "fft.h"
 #include <math.h>
-
-#ifdef HAVE_MKL
-#include <mkl.h>
-#endif
+#include <vector>
 
 //-----------------------------------------------------------------------------
 void blur_image_2d(Image& trg, Image& src, float d)
@@ -24,6 +22,7 @@ void blur_image_2d(Image& trg, Image& src, float d)
 	for (int l = 0; l < n; ++l)
 	{
 		for (int k = 0; k < nz; ++k)
+#pragma omp parallel for private(f)
 			for (int j = 0; j < ny; ++j)
 				for (int i = 0; i < nx; ++i)
 				{
@@ -39,6 +38,7 @@ void blur_image_2d(Image& trg, Image& src, float d)
 	if (w > 0.0)
 	{
 		for (int k = 0; k < nz; ++k)
+#pragma omp parallel for private(f)
 			for (int j = 0; j < ny; ++j)
 				for (int i = 0; i < nx; ++i)
 				{
@@ -70,6 +70,7 @@ void blur_image(Image& trg, Image& src, float d)
 	float f[6];
 	for (int l = 0; l < n; ++l)
 	{
+#pragma omp parallel for private(f)
 		for (int k = 0; k < nz; ++k)
 			for (int j = 0; j < ny; ++j)
 				for (int i = 0; i < nx; ++i)
@@ -87,6 +88,7 @@ void blur_image(Image& trg, Image& src, float d)
 
 	if (w > 0.0)
 	{
+#pragma omp parallel for private(f)
 		for (int k = 0; k < nz; ++k)
 			for (int j = 0; j < ny; ++j)
 				for (int i = 0; i < nx; ++i)
@@ -104,16 +106,128 @@ void blur_image(Image& trg, Image& src, float d)
 	}
 }
 
-#ifdef HAVE_MKL
+//-----------------------------------------------------------------------------
+// Coefficients of the recursive Gaussian filter of Young and van Vliet (1995).
+// The filter consists of a causal pass
+//   w[n] = B*x[n] + b1*w[n-1] + b2*w[n-2] + b3*w[n-3]
+// followed by the same recursion in the anti-causal direction. The cost is 
+// independent of sigma.
+struct RecursiveGaussian
+{
+	double B, b1, b2, b3;
+	int L;	// length after which the impulse response has decayed
+
+	RecursiveGaussian(double sigma)
+	{
+		// the approximation is not accurate for smaller values
+		if (sigma < 0.5) sigma = 0.5;
+
+		double q = (sigma >= 2.5 ? 0.98711 * sigma - 0.96330 : 3.97156 - 4.14554 * sqrt(1.0 - 0.26891 * sigma));
+		double q2 = q * q, q3 = q2 * q;
+		double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+		b1 = (2.44413 * q + 2.85619 * q2 + 1.26661 * q3) / b0;
+		b2 = -(1.4281 * q2 + 1.26661 * q3) / b0;
+		b3 = 0.422205 * q3 / b0;
+		B = 1.0 - (b1 + b2 + b3);
+
+		// find where the impulse response has decayed
+		double h1 = B, h2 = 0.0, h3 = 0.0;
+		for (L = 1; L < 100000; ++L)
+		{
+			double h = b1 * h1 + b2 * h2 + b3 * h3;
+			h3 = h2; h2 = h1; h1 = h;
+			if ((fabs(h1) < 1e-7 * B) && (fabs(h2) < 1e-7 * B) && (fabs(h3) < 1e-7 * B)) break;
+		}
+	}
+};
+
+//-----------------------------------------------------------------------------
+// Applies the recursive Gaussian in-place to the lines x[o*ostride + i + l*stride], l < n,
+// for o < no and i < ni. Neighboring lines (in i) are filtered together, so the 
+// strided access is cache friendly. The image is extended by replicating the 
+// boundary values. The causal pass then starts in steady state, and the anti-causal
+// pass starts in steady state at the end of an extension of length L.
+static void gaussian_lines(float* x, int n, size_t stride, int no, size_t ostride, int ni, const RecursiveGaussian& g)
+{
+	if (n == 1) return;
+
+	const int BS = 32;
+	const int nb = (ni + BS - 1) / BS;
+	const int ntasks = no * nb;
+	const int N = n + g.L;
+#pragma omp parallel
+	{
+		// row l + 3 stores w[l] and rows 0-2 the initial values
+		std::vector<double> w((size_t)(N + 3) * BS);
+		double y1[BS], y2[BS], y3[BS];
+
+#pragma omp for schedule(static)
+		for (int t = 0; t < ntasks; ++t)
+		{
+			int o = t / nb;
+			int i0 = (t % nb) * BS;
+			int m = (ni - i0 < BS ? ni - i0 : BS);
+			float* base = x + o * ostride + i0;
+
+			// causal pass
+			double* w0 = w.data();
+			for (int b = 0; b < m; ++b) w0[b] = w0[BS + b] = w0[2 * BS + b] = base[b];
+			for (int l = 0; l < N; ++l)
+			{
+				const float* xl = base + (l < n ? l : n - 1) * stride;
+				double* wl = w0 + (size_t)(l + 3) * BS;
+				const double* w1 = wl - BS;
+				const double* w2 = wl - 2 * BS;
+				const double* w3 = wl - 3 * BS;
+				for (int b = 0; b < m; ++b) wl[b] = g.B * xl[b] + g.b1 * w1[b] + g.b2 * w2[b] + g.b3 * w3[b];
+			}
+
+			// anti-causal pass
+			const double* wN = w0 + (size_t)(N + 2) * BS;
+			for (int b = 0; b < m; ++b) y1[b] = y2[b] = y3[b] = wN[b];
+			for (int l = N - 1; l >= 0; --l)
+			{
+				const double* wl = w0 + (size_t)(l + 3) * BS;
+				for (int b = 0; b < m; ++b)
+				{
+					double y = g.B * wl[b] + g.b1 * y1[b] + g.b2 * y2[b] + g.b3 * y3[b];
+					y3[b] = y2[b]; y2[b] = y1[b]; y1[b] = y;
+				}
+
+				if (l < n)
+				{
+					float* xl = base + l * stride;
+					for (int b = 0; b < m; ++b) xl[b] = (float)y1[b];
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void gaussian_blur(Image& trg, Image& src, float sigma)
+{
+	trg = src;
+	if (sigma <= 0) return;
 
-// in fft.cpp
-bool mkl_dft2(int nx, int ny, float* x, MKL_Complex8* c);
-bool mkl_idft2(int nx, int ny, MKL_Complex8* c, float* y);
+	int nx = src.width();
+	int ny = src.height();
+	int nz = src.depth();
+	size_t nxy = (size_t)nx * ny;
 
+	RecursiveGaussian g(sigma);
+	float* x = trg.data();
+	gaussian_lines(x, nx, 1, ny * nz, nx, 1, g);
+	gaussian_lines(x, ny, nx, nz, nxy, nx, g);
+	if (nz > 1) gaussian_lines(x, nz, nxy, 1, 0, (int)nxy, g);
+}
+
+//-----------------------------------------------------------------------------
 FEIMGLIB_API void fftblur_2d(Image& trg, Image& src, float d)
 {
 	int nx = src.width();
 	int ny = src.height();
+	if ((trg.width() != nx) || (trg.height() != ny) || (trg.depth() != 1)) trg.Create(nx, ny, 1);
 
 	float* x = src.data();
 	float* y = trg.data();
@@ -131,36 +245,32 @@ FEIMGLIB_API void fftblur_2d(Image& trg, Image& src, float d)
 	float sigmay = ny / d;
 
 	// calculate the DFT
-	MKL_Complex8* c = new MKL_Complex8[nx * ny];
-	mkl_dft2(nx, ny, x, c);
+	const int nh = nx / 2 + 1;
+	std::vector<fft_complex> c(dft_size(nx, ny));
+	dft2(nx, ny, x, c.data());
 
 	// multiply the DFT with blur mask
-	for (int j = 0; j <= ny/2; ++j)
-		for (int i = 0; i < nx; ++i)
+#pragma omp parallel for
+	for (int j = 0; j < ny; ++j)
+		for (int i = 0; i < nh; ++i)
 		{
-			double wx = (i < nx / 2 ? i : i - nx) / sigmax;
-			double wy = j / sigmay;
+			double wx = i / sigmax;
+			double wy = (j < ny / 2 ? j : j - ny) / sigmay;
 			float v = (float) exp(-(wx * wx + wy * wy));
-
-			c[j * nx + i].real *= v;
-			c[j * nx + i].imag *= v;
+			c[j * nh + i] *= v;
 		}
 
 	// calculate the inverse DFT
-	mkl_idft2(nx, ny, c, y);
-
-	// clean up
-	delete[] c;
+	idft2(nx, ny, c.data(), y);
 }
 
-// in fft.cpp
-bool mkl_dft3(int nx, int ny, int nz, float* x, MKL_Complex8* c);
-bool mkl_idft3(int nx, int ny, int nz, MKL_Complex8* c, float* y);
+//-----------------------------------------------------------------------------
 FEIMGLIB_API void fftblur_3d(Image& trg, Image& src, float d)
 {
 	int nx = src.width();
 	int ny = src.height();
 	int nz = src.depth();
+	if ((trg.width() != nx) || (trg.height() != ny) || (trg.depth() != nz)) trg.Create(nx, ny, nz);
 
 	float* x = src.data();
 	float* y = trg.data();
@@ -168,7 +278,7 @@ FEIMGLIB_API void fftblur_3d(Image& trg, Image& src, float d)
 	// for zero blur radius, we just copy the image
 	if (d <= 0.f)
 	{
-		for (int i = 0; i < nx * ny*nz; ++i) y[i] = x[i];
+		for (size_t i = 0; i < (size_t)nx * ny * nz; ++i) y[i] = x[i];
 		return;
 	}
 
@@ -179,30 +289,23 @@ FEIMGLIB_API void fftblur_3d(Image& trg, Image& src, float d)
 	float sigmaz = nz / d;
 
 	// calculate the DFT
-	MKL_Complex8* c = new MKL_Complex8[nx * ny * nz];
-	mkl_dft3(nx, ny, nz, x, c);
+	const int nh = nx / 2 + 1;
+	std::vector<fft_complex> c(dft_size(nx, ny, nz));
+	dft3(nx, ny, nz, x, c.data());
 
 	// multiply the DFT with blur mask
-	for (int k = 0; k <= nz / 2; ++k)
+#pragma omp parallel for
+	for (int k = 0; k < nz; ++k)
 		for (int j = 0; j < ny; ++j)
-			for (int i = 0; i < nx; ++i)
+			for (int i = 0; i < nh; ++i)
 			{
-				double wx = (i < nx / 2 ? i : i - nx) / sigmax;
+				double wx = i / sigmax;
 				double wy = (j < ny / 2 ? j : j - ny) / sigmay;
-				double wz = k / sigmaz;
+				double wz = (k < nz / 2 ? k : k - nz) / sigmaz;
 				float v = (float)exp(-(wx * wx + wy * wy + wz * wz));
-
-				c[k*nx*ny + j * nx + i].real *= v;
-				c[k*nx*ny + j * nx + i].imag *= v;
+				c[((size_t)k * ny + j) * nh + i] *= v;
 			}
 
 	// calculate the inverse DFT
-	mkl_idft3(nx, ny, nz, c, y);
-
-	// clean up
-	delete[] c;
+	idft3(nx, ny, nz, c.data(), y);
 }
-#else // HAVE_MKL
-FEIMGLIB_API void fftblur_2d(Image& trg, Image& src, float d) {}
-FEIMGLIB_API void fftblur_3d(Image& trg, Image& src, float d) {}
-#endif // HAVE_MKL
@@ -6,5 +6,8 @@ class Image;
 FEIMGLIB_API void blur_image_2d(Image& trg, Image& src, float d);
 FEIMGLIB_API void blur_image(Image& trg, Image& src, float d);
 
+// separable Gaussian blur (2D or 3D) with standard deviation sigma (in voxels)
+FEIMGLIB_API void gaussian_blur(Image& trg, Image& src, float sigma);
+
 FEIMGLIB_API void fftblur_2d(Image& trg, Image& src, float d);
 FEIMGLIB_API void fftblur_3d(Image& trg, Image& src, float d);
@@ -27,6 +27,7 @@ SOFTWARE.*/
 #include "BiCGStabSolver.h"
 #include <FECore/CompactUnSymmMatrix.h>
 #include <FECore/log.h>
+#include "MatrixTools.h"
 
 //-----------------------------------------------------------------------------
 BEGIN_FECORE_CLASS(BiCGStabSolver, IterativeLinearSolver)
@@ -57,10 +58,14 @@ SparseMatrix* BiCGStabSolver::CreateSparseMatrix(Matrix_Type ntype)
 		m_P->SetPartitions(m_part);
 		m_pA = m_P->CreateSparseMatrix(ntype);
 	}
-	else
+
+	if (m_pA == nullptr)
 	{
-		if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix;
+		if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix(1);
 		else m_pA = new CRSSparseMatrix(1);
+
+		// preconditioners that don't allocate their own matrix work on ours
+		if (m_P) m_P->SetSparseMatrix(m_pA);
 	}
 	return m_pA;
 }
@@ -117,17 +122,13 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 	int neq = A.Rows();
 
 	// assume initial guess is zero
+#pragma omp parallel for
 	for (int i = 0; i < neq; ++i) x[i] = 0.0;
 
 	// calculate initial norm
 	// r0 = b - A*x0
-	vector<double> r_i(neq); double norm0 = 0.0, normi = 0.0;
-	for (int j = 0; j < neq; ++j)
-	{
-		r_i[j] = b[j];
-		norm0 += r_i[j] * r_i[j];
-	}
-	norm0 = sqrt(norm0);
+	vector<double> r_i(b, b + neq); double normi = 0.0;
+	double norm0 = sqrt(NumCore::dot(&r_i[0], &r_i[0], neq));
 
 	// if the norm is zero, there is nothing to do
 	if (norm0 == 0.0) return true;
@@ -145,10 +146,11 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 	bool converged = false;
 	do
 	{
-		double rho_i = rt*r_i;
+		double rho_i = NumCore::dot(&rt[0], &r_i[0], neq);
 
 		double beta = (rho_i / rho_p)*(alpha / w_p);
 
+#pragma omp parallel for
 		for (int j = 0; j < neq; ++j) p_i[j] = r_i[j] + beta*(p_p[j] - w_p*v_p[j]);
 
 		// apply preconditioner
@@ -160,11 +162,14 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 
 		A.mult_vector(&y[0], &v_p[0]);
 
-		alpha = rho_i / (rt*v_p);
+		alpha = rho_i / NumCore::dot(&rt[0], &v_p[0], neq);
 
-		for (int j = 0; j < neq; ++j) h[j] = x[j] + alpha*y[j];
-
-		for (int j = 0; j < neq; ++j) s[j] = r_i[j] - alpha*v_p[j];
+#pragma omp parallel for
+		for (int j = 0; j < neq; ++j)
+		{
+			h[j] = x[j] + alpha*y[j];
+			s[j] = r_i[j] - alpha*v_p[j];
+		}
 //		If h is accurate enough then xi = h and quit
 
 		if (m_P)
@@ -181,17 +186,15 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 		}
 		else q = t;
 
-		w_p = (q*z) / (q*q);
+		w_p = NumCore::dot(&q[0], &z[0], neq) / NumCore::dot(&q[0], &q[0], neq);
 
-		for (int j = 0; j < neq; ++j) x[j] = h[j] + w_p*z[j];
-		
-		normi = 0.0;
+#pragma omp parallel for
 		for (int j = 0; j < neq; ++j)
 		{
+			x[j] = h[j] + w_p*z[j];
 			r_i[j] = s[j] - w_p*t[j];
-			normi += r_i[j] * r_i[j];
 		}
-		normi = sqrt(normi);
+		normi = sqrt(NumCore::dot(&r_i[0], &r_i[0], neq));
 
 		// see if we have converged
 		double tol = norm0*m_tol + m_abstol;
@@ -0,0 +1,164 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#include "stdafx.h"
+#include "BlockJacobiPreconditioner.h"
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/log.h>
+#include "MatrixTools.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+BEGIN_FECORE_CLASS(BlockJacobiPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_nblocks      , FE_RANGE_GREATER_OR_EQUAL(0), "blocks");
+	ADD_PARAMETER(m_zeroThreshold, "zero_threshold");
+	ADD_PARAMETER(m_zeroReplace  , "zero_replace");
+END_FECORE_CLASS();
+
+BlockJacobiPreconditioner::BlockJacobiPreconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_nblocks = 0;
+	m_zeroThreshold = 1e-16;
+	m_zeroReplace = 1e-10;
+}
+
+// divide the equations in blocks of (nearly) equal size
+void BlockJacobiPreconditioner::BuildBlocks(int N)
+{
+	int nb = m_nblocks;
+#ifdef _OPENMP
+	if (nb <= 0) nb = omp_get_max_threads();
+#endif
+	if (nb <= 0) nb = 1;
+	if (nb > N) nb = N;
+
+	m_block.resize(nb);
+	for (int n = 0; n < nb; ++n)
+	{
+		Block& B = m_block[n];
+		B.i0 = (int)(((long long)N * n) / nb);
+		B.N = (int)(((long long)N * (n + 1)) / nb) - B.i0;
+		B.ia.assign(B.N + 1, 0);
+		B.ja.clear();
+		B.a.clear();
+	}
+}
+
+bool BlockJacobiPreconditioner::Factor()
+{
+	CompactMatrix* A = dynamic_cast<CompactMatrix*>(GetSparseMatrix());
+	if (A == nullptr) return false;
+
+	bool symm = A->isSymmetric();
+	if ((symm == false) && (A->isRowBased() == false)) return false;
+
+	int N = A->Rows();
+	int offset = A->Offset();
+	double* pv = A->Values();
+	int* pi = A->Indices();
+	int* pp = A->Pointers();
+
+	BuildBlocks(N);
+	int nb = (int)m_block.size();
+
+	// The symmetric format only stores the lower triangle column-wise, so the
+	// entry (i,j) with i > j lands in row i and its transpose in row j. Visiting 
+	// the columns in order keeps the column indices of each block row sorted.
+	bool bok = true;
+#pragma omp parallel for schedule(dynamic)
+	for (int n = 0; n < nb; ++n)
+	{
+		Block& B = m_block[n];
+		int i0 = B.i0, i1 = B.i0 + B.N;
+
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			vector<int> pos;
+			if (pass == 1)
+			{
+				for (int i = 0; i < B.N; ++i) B.ia[i + 1] += B.ia[i];
+				B.ja.resize(B.ia[B.N]);
+				B.a.resize(B.ia[B.N]);
+				pos.assign(B.ia.begin(), B.ia.end() - 1);
+			}
+
+			for (int j = i0; j < i1; ++j)
+			{
+				int n0 = pp[j] - offset;
+				int n1 = pp[j + 1] - offset;
+				for (int k = n0; k < n1; ++k)
+				{
+					int i = pi[k] - offset;
+					if ((i < i0) || (i >= i1)) continue;
+
+					if (symm)
+					{
+						// entry (i, j) in row i and (j, i) in row j
+						if (pass == 0)
+						{
+							B.ia[j - i0 + 1]++;
+							if (i != j) B.ia[i - i0 + 1]++;
+						}
+						else
+						{
+							int l = pos[j - i0]++; B.ja[l] = i - i0; B.a[l] = pv[k];
+							if (i != j) { l = pos[i - i0]++; B.ja[l] = j - i0; B.a[l] = pv[k]; }
+						}
+					}
+					else
+					{
+						// row-based: j is the row and i the column
+						if (pass == 0) B.ia[j - i0 + 1]++;
+						else { int l = pos[j - i0]++; B.ja[l] = i - i0; B.a[l] = pv[k]; }
+					}
+				}
+			}
+		}
+
+		if (NumCore::ilu0_factor(B.N, &B.ia[0], &B.ja[0], &B.a[0], 0, m_zeroThreshold, m_zeroReplace) == false)
+		{
+#pragma omp critical (BJ_factor)
+			bok = false;
+		}
+	}
+
+	if (bok == false) feLogError("Zero diagonal encountered in block-Jacobi preconditioner.");
+
+	return bok;
+}
+
+bool BlockJacobiPreconditioner::BackSolve(double* x, double* y)
+{
+	int nb = (int)m_block.size();
+#pragma omp parallel for schedule(dynamic)
+	for (int n = 0; n < nb; ++n)
+	{
+		Block& B = m_block[n];
+		NumCore::ilu0_solve(B.N, &B.ia[0], &B.ja[0], &B.a[0], 0, y + B.i0, x + B.i0);
+	}
+	return true;
+}
@@ -0,0 +1,65 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#pragma once
+#include <FECore/Preconditioner.h>
+
+//-----------------------------------------------------------------------------
+// Block-Jacobi preconditioner. The equations are divided into contiguous blocks 
+// and each diagonal block is approximated by its own ILU(0) factorization. The
+// blocks are independent, so they are factored and applied in parallel.
+// This works with any compact matrix (symmetric or row-based).
+class BlockJacobiPreconditioner : public Preconditioner
+{
+	struct Block
+	{
+		int		i0, N;		// first equation and size of block
+		vector<int>		ia;	// row pointers (zero-based)
+		vector<int>		ja;	// column indices (relative to i0)
+		vector<double>	a;	// values (overwritten by factorization)
+	};
+
+public:
+	BlockJacobiPreconditioner(FEModel* fem);
+
+	// create a preconditioner for a sparse matrix
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+private:
+	void BuildBlocks(int N);
+
+public:
+	int		m_nblocks;				// number of blocks (0 = one per thread)
+	double	m_zeroThreshold;		// threshold for zero diagonal check
+	double	m_zeroReplace;			// replacement value for zero diagonal
+
+private:
+	vector<Block>	m_block;
+
+	DECLARE_FECORE_CLASS();
+};
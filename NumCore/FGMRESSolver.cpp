@@ -190,24 +190,18 @@ void FGMRESSolver::DoJacobiPreconditioning(bool b)
 //-----------------------------------------------------------------------------
 SparseMatrix* FGMRESSolver::CreateSparseMatrix(Matrix_Type ntype)
 {
-#ifdef MKL_ISS
 	// Cleanup if necessary
 	if (m_pA) delete m_pA; 
 	m_pA = nullptr;
 
 	// since FMGRES doesn't really care what matrix is requested, 
 	// see if the preconditioner cares.
-	if (m_P)
-	{
-		m_P->SetPartitions(m_part);
-		m_pA = m_P->CreateSparseMatrix(ntype);
-		return m_pA;
-	}
-	else if (m_R)
+	Preconditioner* pc = (m_P ? m_P : m_R);
+	if (pc)
 	{
-		m_R->SetPartitions(m_part);
-		m_pA = m_R->CreateSparseMatrix(ntype);
-		return m_pA;
+		pc->SetPartitions(m_part);
+		m_pA = pc->CreateSparseMatrix(ntype);
+		if (m_pA) return m_pA;
 	}
 
 	// if the matrix is still zero, let's just allocate one
@@ -222,11 +216,12 @@ SparseMatrix* FGMRESSolver::CreateSparseMatrix(Matrix_Type ntype)
 		}
 	}
 
+	// preconditioners that don't allocate their own matrix (e.g. diagonal) work on ours
+	if (m_P) m_P->SetSparseMatrix(m_pA);
+	if (m_R) m_R->SetSparseMatrix(m_pA);
+
 	// return the matrix (Can be null if matrix format not supported!)
 	return m_pA;
-#else
-	return 0;
-#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -265,7 +260,24 @@ bool FGMRESSolver::PreProcess()
 
 	return true; 
 #else
-	return false;
+	// number of equations
+	int N = m_pA->Rows();
+
+	int M = (N < 150 ? N : 150);
+
+	if (m_nrestart > 0) M = m_nrestart;
+	else if (m_maxiter > 0) M = m_maxiter;
+	if (M > N) M = N;
+
+	// allocate storage for the Krylov basis (M+1 vectors) and
+	// for the preconditioned vectors (M vectors)
+	m_tmp.resize((size_t)N*(2 * M + 1));
+
+	m_Rv.resize(N);
+
+	m_W.resize(N, 1.0);
+
+	return true;
 #endif
 }
 
@@ -443,7 +455,175 @@ bool FGMRESSolver::BackSolve(double* x, double* b)
 	return bconverged;
 
 #else
-	return false;
+	// make sure we have a matrix
+	if (m_pA == 0) return false;
+
+	// number of equations
+	int N = m_pA->Rows();
+
+	// use the same defaults as the MKL version
+	int M = (N < 150 ? N : 150);
+
+	int nrestart = M;
+	if (m_nrestart > 0) nrestart = m_nrestart;
+	else if (m_maxiter > 0) nrestart = m_maxiter;
+	if (nrestart > N) nrestart = N;
+
+	int maxIter = M;
+	if (m_maxiter > 0) maxIter = m_maxiter;
+
+	double reltol = (m_reltol > 0 ? m_reltol : 1e-6);
+	double abstol = m_abstol;
+
+	// make sure we have enough storage
+	if (m_tmp.size() < (size_t)N*(2 * nrestart + 1)) m_tmp.resize((size_t)N*(2 * nrestart + 1));
+
+	// V are the Krylov vectors and Z the preconditioned vectors (flexible variant).
+	double* V = &m_tmp[0];
+	double* Z = (m_P ? V + (size_t)N*(nrestart + 1) : V);
+
+	// scale rhs
+	vector<double> F(N), r(N);
+	for (int i = 0; i < N; ++i) F[i] = m_W[i] * b[i];
+
+	// zero solution vector
+	for (int i = 0; i < N; ++i) x[i] = 0.0;
+
+	// Hessenberg matrix (column-major), Givens rotations and rhs of least-squares problem
+	vector<double> H((size_t)(nrestart + 1)*nrestart), cs(nrestart), sn(nrestart), g(nrestart + 1), y(nrestart);
+
+	// operator A*R applied to v, stored in w
+	auto matvec = [&](double* v, double* w) {
+		if (m_R)
+		{
+			m_R->mult_vector(v, &m_Rv[0]);
+			m_pA->mult_vector(&m_Rv[0], w);
+		}
+		else m_pA->mult_vector(v, w);
+	};
+
+	if (m_print_level > 0) feLog("FGMRES:\n");
+
+	bool bconverged = false;
+	bool bfail = false;
+	int iter = 0;
+	double norm0 = 0.0, normi = 0.0, tol = 0.0;
+	while ((bconverged == false) && (bfail == false) && (iter < maxIter))
+	{
+		// r = F - A*x
+		matvec(x, &r[0]);
+#pragma omp parallel for
+		for (int i = 0; i < N; ++i) r[i] = F[i] - r[i];
+		double beta = sqrt(NumCore::dot(&r[0], &r[0], N));
+		if (iter == 0)
+		{
+			norm0 = beta;
+			tol = reltol*norm0 + abstol;
+		}
+		normi = beta;
+
+		if (beta == 0.0) { bconverged = true; break; }
+		if (m_doResidualTest && (beta <= tol)) { bconverged = true; break; }
+
+#pragma omp parallel for
+		for (int i = 0; i < N; ++i) V[i] = r[i] / beta;
+		for (int i = 1; i <= nrestart; ++i) g[i] = 0.0;
+		g[0] = beta;
+
+		// Arnoldi process
+		int k = 0;
+		while ((k < nrestart) && (iter < maxIter))
+		{
+			double* vk = V + (size_t)N*k;
+			double* zk = Z + (size_t)N*k;
+			double* w = V + (size_t)N*(k + 1);
+
+			// apply the preconditioner
+			if (m_P)
+			{
+				if (m_P->mult_vector(vk, zk) == false) { bfail = true; break; }
+			}
+			matvec(zk, w);
+
+			// modified Gram-Schmidt
+			double* h = &H[(size_t)(nrestart + 1)*k];
+			for (int i = 0; i <= k; ++i)
+			{
+				double* vi = V + (size_t)N*i;
+				h[i] = NumCore::dot(w, vi, N);
+				NumCore::axpy(N, -h[i], vi, w);
+			}
+			h[k + 1] = sqrt(NumCore::dot(w, w, N));
+
+			// apply the previous Givens rotations to the new column
+			for (int i = 0; i < k; ++i)
+			{
+				double t = cs[i] * h[i] + sn[i] * h[i + 1];
+				h[i + 1] = -sn[i] * h[i] + cs[i] * h[i + 1];
+				h[i] = t;
+			}
+
+			// calculate the new rotation
+			double hkk = h[k], hk1 = h[k + 1];
+			double d = sqrt(hkk*hkk + hk1*hk1);
+			bool breakdown = (hk1 == 0.0);
+			if (d == 0.0) { bfail = true; break; }
+			cs[k] = hkk / d;
+			sn[k] = hk1 / d;
+			h[k] = d;
+			g[k + 1] = -sn[k] * g[k];
+			g[k] = cs[k] * g[k];
+
+			// normalize the new Krylov vector
+			if (!breakdown)
+			{
+#pragma omp parallel for
+				for (int i = 0; i < N; ++i) w[i] /= hk1;
+			}
+
+			k++;
+			iter++;
+			normi = fabs(g[k]);
+
+			if (m_print_level > 1) feLog("%3d = %lg (%lg)\n", iter, normi, tol);
+
+			if (m_doResidualTest && (normi <= tol)) { bconverged = true; break; }
+			if (breakdown && m_doZeroNormTest) { bconverged = true; break; }
+		}
+
+		// update solution: x = x + Z*y, where H*y = g
+		for (int i = k - 1; i >= 0; --i)
+		{
+			double yi = g[i];
+			for (int j = i + 1; j < k; ++j) yi -= H[(size_t)(nrestart + 1)*j + i] * y[j];
+			y[i] = yi / H[(size_t)(nrestart + 1)*i + i];
+		}
+		for (int i = 0; i < k; ++i) NumCore::axpy(N, y[i], Z + (size_t)N*i, x);
+	}
+
+	if (bconverged == false) bconverged = !m_maxIterFail;
+	if (bfail) bconverged = false;
+
+	if (m_do_jacobi)
+	{
+		for (int i = 0; i < N; ++i) x[i] *= m_W[i];
+	}
+
+	if (m_R)
+	{
+		m_R->mult_vector(&x[0], &m_Rv[0]);
+		for (int i = 0; i < N; ++i) x[i] = m_Rv[i];
+	}
+
+	if (m_print_level > 0)
+	{
+		feLog("%3d = %lg (%lg)\n", iter, normi, norm0);
+	}
+
+	// update stats
+	UpdateStats(iter);
+
+	return bconverged;
 #endif // MKL_ISS
 }
 
@@ -29,7 +29,8 @@ SOFTWARE.*/
 
 //-----------------------------------------------------------------------------
 //! This class implements an interface to the MKL FGMRES iterative solver for 
-//! nonsymmetric indefinite matrices (without pre-conditioning).
+//! nonsymmetric indefinite matrices. When MKL is not available, a native
+//! (OpenMP-parallel) restarted FGMRES is used instead.
 class FGMRESSolver : public IterativeLinearSolver
 {
 public:
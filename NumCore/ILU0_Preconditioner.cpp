@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "ILU0_Preconditioner.h"
 #include <FECore/CompactUnSymmMatrix.h>
+#include "MatrixTools.h"
 
 // We must undef PARDISO since it is defined as a function in mkl_solver.h
 #ifdef MKL_ISS
@@ -118,6 +119,26 @@ bool ILU0_Preconditioner::BackSolve(double* x, double* y)
 }
 
 #else
-bool ILU0_Preconditioner::Factor() { return false; }
-bool ILU0_Preconditioner::BackSolve(double* x, double* y) { return false; }
+bool ILU0_Preconditioner::Factor()
+{
+	if (m_K == 0) return false;
+
+	int N = m_K->Rows();
+	int NNZ = m_K->NonZeroes();
+	int offset = m_K->Offset();
+
+	// copy the matrix values and factor in place
+	double* pa = m_K->Values();
+	m_bilu0.assign(pa, pa + NNZ);
+
+	double zeroThreshold = (m_checkZeroDiagonal ? m_zeroThreshold : 0.0);
+	double zeroReplace = (m_checkZeroDiagonal ? m_zeroReplace : 0.0);
+	return NumCore::ilu0_factor(N, m_K->Pointers(), m_K->Indices(), &m_bilu0[0], offset, zeroThreshold, zeroReplace);
+}
+
+bool ILU0_Preconditioner::BackSolve(double* x, double* y)
+{
+	NumCore::ilu0_solve(m_K->Rows(), m_K->Pointers(), m_K->Indices(), &m_bilu0[0], m_K->Offset(), y, x);
+	return true;
+}
 #endif
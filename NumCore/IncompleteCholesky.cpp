@@ -177,6 +177,32 @@ bool IncompleteCholesky::BackSolve(double* x, double* y)
 
 	return true;
 #else 
+	// L is stored column-wise (lower triangle), so solve L z = y by columns
+	int N = m_L->Rows();
+	double* pa = m_L->Values();
+	int* ia = m_L->Pointers();
+	int* ja = m_L->Indices();
+	int offset = m_L->Offset();
+	for (int i = 0; i < N; ++i) z[i] = y[i];
+	for (int k = 0; k < N; ++k)
+	{
+		int n0 = ia[k] - offset;
+		int n1 = ia[k + 1] - offset;
+		double zk = z[k] / pa[n0];
+		z[k] = zk;
+		for (int n = n0 + 1; n < n1; ++n) z[ja[n] - offset] -= pa[n] * zk;
+	}
+
+	// then solve L^T x = z, where row k of L^T is column k of L
+	for (int k = N - 1; k >= 0; --k)
+	{
+		int n0 = ia[k] - offset;
+		int n1 = ia[k + 1] - offset;
+		double xk = z[k];
+		for (int n = n0 + 1; n < n1; ++n) xk -= pa[n] * x[ja[n] - offset];
+		x[k] = xk / pa[n0];
+	}
+
 	return true;
 #endif
 }
@@ -377,3 +377,91 @@ void NumCore::print_svg(CompactMatrix* m, std::ostream &out, int i0, int j0, int
 	}
 	out << "</svg>" << std::endl;
 }
+
+double NumCore::dot(const double* a, const double* b, int n)
+{
+	double sum = 0.0;
+#pragma omp parallel for reduction(+:sum)
+	for (int i = 0; i < n; ++i) sum += a[i] * b[i];
+	return sum;
+}
+
+void NumCore::axpy(int n, double a, const double* x, double* y)
+{
+#pragma omp parallel for
+	for (int i = 0; i < n; ++i) y[i] += a * x[i];
+}
+
+bool NumCore::ilu0_factor(int N, const int* ia, const int* ja, double* a, int offset, double zeroThreshold, double zeroReplace)
+{
+	// iw[j] is the position of column j in the current row (or -1)
+	std::vector<int> iw(N, -1);
+	std::vector<int> diag(N, -1);
+	for (int i = 0; i < N; ++i)
+	{
+		int n0 = ia[i] - offset;
+		int n1 = ia[i + 1] - offset;
+		for (int k = n0; k < n1; ++k) iw[ja[k] - offset] = k;
+
+		// eliminate the lower-triangular entries of this row
+		int k = n0;
+		for (; k < n1; ++k)
+		{
+			int j = ja[k] - offset;
+			if (j >= i) break;
+
+			double lij = a[k] / a[diag[j]];
+			a[k] = lij;
+
+			// update the remainder of row i with the upper part of row j
+			int m1 = ia[j + 1] - offset;
+			for (int m = diag[j] + 1; m < m1; ++m)
+			{
+				int l = iw[ja[m] - offset];
+				if (l >= 0) a[l] -= lij * a[m];
+			}
+		}
+
+		// check the diagonal
+		if ((k == n1) || (ja[k] - offset != i)) return false;
+		diag[i] = k;
+		if (fabs(a[k]) <= zeroThreshold) a[k] = (a[k] < 0.0 ? -zeroReplace : zeroReplace);
+		if (a[k] == 0.0) return false;
+
+		for (int m = n0; m < n1; ++m) iw[ja[m] - offset] = -1;
+	}
+
+	return true;
+}
+
+void NumCore::ilu0_solve(int N, const int* ia, const int* ja, const double* a, int offset, const double* y, double* x)
+{
+	// forward substitution with the unit lower-triangular factor
+	for (int i = 0; i < N; ++i)
+	{
+		double xi = y[i];
+		for (int k = ia[i] - offset; k < ia[i + 1] - offset; ++k)
+		{
+			int j = ja[k] - offset;
+			if (j >= i) break;
+			xi -= a[k] * x[j];
+		}
+		x[i] = xi;
+	}
+
+	// backward substitution with the upper-triangular factor
+	for (int i = N - 1; i >= 0; --i)
+	{
+		double xi = x[i];
+		int n0 = ia[i] - offset;
+		int n1 = ia[i + 1] - offset;
+		int k = n1 - 1;
+		for (; k > n0; --k)
+		{
+			int j = ja[k] - offset;
+			if (j <= i) break;
+			xi -= a[k] * x[j];
+		}
+		x[i] = xi / a[k];
+	}
+}
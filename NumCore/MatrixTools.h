@@ -69,4 +69,18 @@ namespace NumCore
 	// print matrix sparsity pattern to svn file
 	NUMCORE_API void print_svg(CompactMatrix* m, std::ostream &out, int i0 = 0, int j0 = 0, int i1 = -1, int j1 = -1);
 
+	// parallel dot product of two vectors of length n
+	NUMCORE_API double dot(const double* a, const double* b, int n);
+
+	// parallel y = y + a*x
+	NUMCORE_API void axpy(int n, double a, const double* x, double* y);
+
+	// In-place ILU(0) factorization of a CRS matrix (ia, ja, a) with sorted column indices.
+	// Diagonal entries with an absolute value below zeroThreshold are replaced by zeroReplace.
+	// Returns false if a zero diagonal is encountered that is not replaced.
+	NUMCORE_API bool ilu0_factor(int N, const int* ia, const int* ja, double* a, int offset, double zeroThreshold = 0.0, double zeroReplace = 0.0);
+
+	// solve LU x = y, where LU are the factors computed by ilu0_factor
+	NUMCORE_API void ilu0_solve(int N, const int* ia, const int* ja, const double* a, int offset, const double* y, double* x);
+
 } // namespace NumCore
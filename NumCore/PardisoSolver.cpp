@@ -100,6 +100,8 @@ PardisoSolver::PardisoSolver(FEModel* fem) : LinearSolver(fem), m_pA(0)
 	m_mtype = -2;
 	m_iparm3 = false;
 	m_isFactored = false;
+	m_isAnalyzed = false;
+	m_reuseAnalysis = false;
 	m_msglvl = 0; /* 0 Suppress printing, 1 Print statistical information */
 }
 
@@ -158,6 +160,8 @@ bool PardisoSolver::PreProcess()
 	//fprintf(stderr, "In PreProcess\n");
 	assert(m_isFactored == false);
 	pardisoinit(m_pt, &m_mtype, m_iparm);
+	m_isAnalyzed = false;
+	m_reuseAnalysis = false;
 
 	// Turn off reporting the number of non-zero elements in the factors.
 	// According to the documentation turning this on (set to -1) will 
@@ -178,6 +182,12 @@ bool PardisoSolver::PreProcess()
 	return LinearSolver::PreProcess();
 }
 
+//-----------------------------------------------------------------------------
+void PardisoSolver::SetStructureReused()
+{
+	m_reuseAnalysis = true;
+}
+
 //-----------------------------------------------------------------------------
 bool PardisoSolver::Factor()
 {
@@ -187,19 +197,26 @@ bool PardisoSolver::Factor()
 // ------------------------------------------------------------------------------
 // Reordering and Symbolic Factorization.  This step also allocates all memory
 // that is necessary for the factorization.
+// For symmetric matrices, this only depends on the structure of the matrix, so
+// it is skipped when the caller reused the matrix structure (see SetStructureReused).
+// For unsymmetric matrices the scaling and matching are computed from the values, 
+// so we redo this every time.
 // ------------------------------------------------------------------------------
 
 	int phase = 11;
-
 	int error = 0;
-	pardiso(m_pt, &m_maxfct, &m_mnum, &m_mtype, &phase, &m_n, m_pA->Values(), m_pA->Pointers(), m_pA->Indices(),
-		 NULL, &m_nrhs, m_iparm, &m_msglvl, NULL, NULL, &error);
-
-	if (error)
+	if ((m_isAnalyzed == false) || (m_reuseAnalysis == false) || (m_mtype != -2))
 	{
-		fprintf(stderr, "\nERROR during symbolic factorization: ");
-		print_err(error);
-		exit(2);
+		pardiso(m_pt, &m_maxfct, &m_mnum, &m_mtype, &phase, &m_n, m_pA->Values(), m_pA->Pointers(), m_pA->Indices(),
+			 NULL, &m_nrhs, m_iparm, &m_msglvl, NULL, NULL, &error);
+
+		if (error)
+		{
+			fprintf(stderr, "\nERROR during symbolic factorization: ");
+			print_err(error);
+			exit(2);
+		}
+		m_isAnalyzed = true;
 	}
 
 	if (m_msglvl == 1)
@@ -357,6 +374,8 @@ void PardisoSolver::Destroy()
 			NULL, &m_nrhs, m_iparm, &m_msglvl, NULL, NULL, &error);
 	}
 	m_isFactored = false;
+	m_isAnalyzed = false;
+	m_reuseAnalysis = false;
 }
 #else 
 BEGIN_FECORE_CLASS(PardisoSolver, LinearSolver)
@@ -367,6 +386,7 @@ END_FECORE_CLASS();
 PardisoSolver::PardisoSolver(FEModel* fem) : LinearSolver(fem) {}
 PardisoSolver::~PardisoSolver() {}
 bool PardisoSolver::PreProcess() { return false; }
+void PardisoSolver::SetStructureReused() {}
 bool PardisoSolver::Factor() { return false; }
 bool PardisoSolver::BackSolve(double* x, double* y) { return false; }
 void PardisoSolver::Destroy() {}
@@ -42,6 +42,8 @@ public:
 	PardisoSolver(FEModel* fem);
 	~PardisoSolver();
 	bool PreProcess() override;
+	bool IsPreProcessStructural() const override { return true; }
+	void SetStructureReused() override;
 	bool Factor() override;
 	bool BackSolve(double* x, double* y) override;
 	void Destroy() override;
@@ -73,6 +75,8 @@ protected:
 	bool	m_print_cn;	// estimate and print the condition number
 
 	bool	m_isFactored;
+	bool	m_isAnalyzed;	// symbolic factorization was done for the current matrix structure
+	bool	m_reuseAnalysis;	// the matrix structure was reused, so the symbolic factorization can be kept
 
 	void* m_pt[64]; // Internal solver memory pointer
 
@@ -29,6 +29,8 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "RCICGSolver.h"
 #include "IncompleteCholesky.h"
+#include "MatrixTools.h"
+#include <FECore/log.h>
 
 //-----------------------------------------------------------------------------
 // We must undef PARDISO since it is defined as a function in mkl_solver.h
@@ -62,14 +64,10 @@ RCICGSolver::RCICGSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(0), m_
 //-----------------------------------------------------------------------------
 SparseMatrix* RCICGSolver::CreateSparseMatrix(Matrix_Type ntype)
 {
-#ifdef MKL_ISS
 	if (ntype != REAL_SYMMETRIC) return 0;
 	m_pA = new CompactSymmMatrix(1);
 	if (m_P) m_P->SetSparseMatrix(m_pA);
 	return m_pA;
-#else
-	return 0;
-#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -209,7 +207,64 @@ bool RCICGSolver::BackSolve(double* x, double* b)
 
 	return (m_fail_max_iters ? bsuccess : true);
 #else
-	return false;
+	// make sure we have a matrix
+	if (m_pA == 0) return false;
+
+	// Native preconditioned conjugate gradient method. This uses the same
+	// defaults and stopping test as the MKL version: |r| <= tol*|b|.
+	int n = m_pA->Rows();
+	int maxiter = (m_maxiter > 0 ? m_maxiter : (n < 150 ? n : 150));
+
+	vector<double> r(n), z(n), p(n), q(n);
+
+	// zero solution vector, so that r = b
+#pragma omp parallel for
+	for (int i = 0; i < n; ++i) { x[i] = 0.0; r[i] = b[i]; }
+
+	double norm0 = sqrt(NumCore::dot(&r[0], &r[0], n));
+	double normi = norm0;
+	double tol = m_tol*norm0;
+
+	bool bsuccess = (norm0 == 0.0);
+	int niter = 0;
+	double rz = 0.0;
+	while ((bsuccess == false) && (niter < maxiter))
+	{
+		// apply preconditioner
+		if (m_P) m_P->mult_vector(&r[0], &z[0]);
+		else z = r;
+
+		double rz_new = NumCore::dot(&r[0], &z[0], n);
+		if (niter == 0) p = z;
+		else
+		{
+			double beta = rz_new / rz;
+#pragma omp parallel for
+			for (int i = 0; i < n; ++i) p[i] = z[i] + beta*p[i];
+		}
+		rz = rz_new;
+
+		if (m_pA->mult_vector(&p[0], &q[0]) == false) break;
+
+		double pq = NumCore::dot(&p[0], &q[0], n);
+		if (pq == 0.0) break;
+		double alpha = rz / pq;
+
+		NumCore::axpy(n,  alpha, &p[0], x);
+		NumCore::axpy(n, -alpha, &q[0], &r[0]);
+		niter++;
+
+		normi = sqrt(NumCore::dot(&r[0], &r[0], n));
+		if (m_print_level > 1) feLog("%3d = %lg (%lg)\n", niter, normi, tol);
+
+		if (normi <= tol) bsuccess = true;
+	}
+
+	if (m_print_level > 0) feLog("%3d = %lg (%lg)\n", niter, normi, tol);
+
+	UpdateStats(niter);
+
+	return (m_fail_max_iters ? bsuccess : true);
 #endif // MKL_ISS
 }
 
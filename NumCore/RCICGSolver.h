@@ -28,6 +28,7 @@ SOFTWARE.*/
 #include <FECore/CompactSymmMatrix.h>
 
 // This class implements an interface to the RCI CG iterative solver from the MKL math library.
+// When MKL is not available, a native (OpenMP-parallel) preconditioned CG is used instead.
 class RCICGSolver : public IterativeLinearSolver
 {
 public:
@@ -0,0 +1,1101 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#include "stdafx.h"
+#include "SupernodalSolver.h"
+#include <FECore/log.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// stored matrix entry and its position in the front of its supernode
+struct FrontEntry
+{
+	int	pos;		// index into matrix values
+	int	row, col;	// local front row and column
+};
+
+//-----------------------------------------------------------------------------
+// Symbolic analysis of a sparsity pattern: the fill-reducing ordering, the 
+// supernodes and their fronts, and the level schedule. Since it does not depend
+// on the matrix values, it can be shared by solvers of matrices with the same
+// structure (e.g. the copies of an RVE model).
+class SupernodalAnalysis
+{
+public:
+	int		ordering = 1;		// 0 = natural, 1 = nested dissection
+	int		leafSize = 64;		// size of nested dissection leaves
+	int		relaxSize = 16;		// max supernode width for relaxed amalgamation
+	double	relaxFill = 0.1;	// max fraction of explicit zeros added by amalgamation
+
+public:
+	bool	valid = false;		// set when the analysis succeeded
+	int		N = 0;
+	bool	symmetric = true;
+	size_t	hash = 0;			// hash of the analyzed sparsity pattern
+	vector<int>	patPtr, patIdx;	// copy of the analyzed sparsity pattern (to resolve hash collisions)
+
+	vector<int>	perm;		// new equation -> original equation
+	vector<int>	iperm;		// original equation -> new equation
+
+	// supernodes
+	int	nsn = 0;
+	vector<int>	snStart;	// first column (size nsn+1)
+	vector<int>	snParent;	// parent supernode (or -1)
+	vector<int>	rowPtr;		// offset into rowIdx (size nsn+1)
+	vector<int>	rowIdx;		// rows below the supernode's diagonal block (new numbering)
+	vector<int>	relIdx;		// location of these rows in the parent's front
+	vector<int>	childPtr, child;	// child supernodes
+
+	// assembly of the matrix into the fronts
+	vector<int>			entryPtr;
+	vector<FrontEntry>	entry;
+
+	// level schedule: all supernodes at the same level are independent
+	vector<int>	levelPtr, levelNode;
+
+	// layout of the numerical factor
+	vector<size_t>	Lptr;	// offset into L of m x k panel of each supernode
+	vector<size_t>	Uptr;	// offset into U of k x (m-k) row panel (unsymmetric only)
+	double	factorFlops = 0.0;	// estimated flop count of factorization
+
+	// protects the analysis when solvers that share it are preprocessed concurrently
+	std::mutex	mtx;
+
+public:
+	int width(int s) const { return snStart[s + 1] - snStart[s]; }
+	int frontSize(int s) const { return width(s) + rowPtr[s + 1] - rowPtr[s]; }
+
+	bool analyze(CompactMatrix* A);
+
+	static size_t patternHash(CompactMatrix* A);
+
+	void storePattern(CompactMatrix* A);
+	bool samePattern(CompactMatrix* A) const;
+
+private:
+	void buildGraph(CompactMatrix* A, vector<int>& xadj, vector<int>& adj);
+	void nestedDissection(const vector<int>& xadj, const vector<int>& adj, vector<int>& order);
+};
+
+//-----------------------------------------------------------------------------
+class SupernodalSolver::Impl
+{
+public:
+	int		print_level = 0;
+	int		ordering = 1;		// 0 = natural, 1 = nested dissection
+	int		leafSize = 64;		// size of nested dissection leaves
+	int		relaxSize = 16;		// max supernode width for relaxed amalgamation
+	double	relaxFill = 0.1;	// max fraction of explicit zeros added by amalgamation
+	int		blockSize = 32;		// block size of dense kernels
+	double	pivotTol = 1e-13;	// pivots below this fraction of the column's magnitude are rejected
+
+public:
+	std::shared_ptr<SupernodalAnalysis>	sym;	// symbolic analysis (possibly shared)
+
+	// numerical factor
+	vector<double>	L, U;
+	vector< vector<double> >	upd;	// update matrices (contribution blocks)
+
+public:
+	bool analyze(CompactMatrix* A);
+	bool factor(CompactMatrix* A);
+	void solve(double* x, const double* b);
+
+private:
+	bool factorNode(int s, const double* val, bool par);
+};
+
+//-----------------------------------------------------------------------------
+// Build the adjacency graph of the symmetrized sparsity pattern (without diagonal).
+void SupernodalAnalysis::buildGraph(CompactMatrix* A, vector<int>& xadj, vector<int>& adj)
+{
+	int offset = A->Offset();
+	int* pi = A->Indices();
+	int* pp = A->Pointers();
+
+	// count (possibly duplicate) edges
+	xadj.assign(N + 1, 0);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = pp[j] - offset; k < pp[j + 1] - offset; ++k)
+		{
+			int i = pi[k] - offset;
+			if (i != j) { xadj[i + 1]++; xadj[j + 1]++; }
+		}
+	}
+	for (int i = 0; i < N; ++i) xadj[i + 1] += xadj[i];
+
+	adj.resize(xadj[N]);
+	vector<int> pos(xadj.begin(), xadj.end() - 1);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = pp[j] - offset; k < pp[j + 1] - offset; ++k)
+		{
+			int i = pi[k] - offset;
+			if (i != j) { adj[pos[i]++] = j; adj[pos[j]++] = i; }
+		}
+	}
+
+	// sort and remove duplicates
+	int nnz = 0;
+	for (int i = 0; i < N; ++i)
+	{
+		int* a0 = &adj[0] + xadj[i];
+		int* a1 = &adj[0] + xadj[i + 1];
+		std::sort(a0, a1);
+		int* ae = std::unique(a0, a1);
+		int n = (int)(ae - a0);
+		xadj[i] = nnz;
+		for (int k = 0; k < n; ++k) adj[nnz + k] = a0[k];
+		nnz += n;
+	}
+	xadj[N] = nnz;
+	adj.resize(nnz);
+}
+
+//-----------------------------------------------------------------------------
+// Nested dissection ordering. Consecutive equations with identical adjacency
+// (e.g. the degrees of freedom of a node) are first merged into supervariables.
+// Each subgraph is split by a level of a breadth-first search from a
+// pseudo-peripheral vertex. The separator is ordered last.
+void SupernodalAnalysis::nestedDissection(const vector<int>& xadj, const vector<int>& adj, vector<int>& order)
+{
+	// find supervariables
+	vector<int> sv(N);
+	vector<int> svStart;
+	vector<int> ai, aj;
+	for (int i = 0; i < N; ++i)
+	{
+		bool same = false;
+		if (i > 0)
+		{
+			int ni = xadj[i] - xadj[i - 1];
+			int nj = xadj[i + 1] - xadj[i];
+			if (ni == nj)
+			{
+				ai.assign(adj.begin() + xadj[i - 1], adj.begin() + xadj[i]); ai.push_back(i - 1);
+				aj.assign(adj.begin() + xadj[i], adj.begin() + xadj[i + 1]); aj.push_back(i);
+				std::sort(ai.begin(), ai.end());
+				std::sort(aj.begin(), aj.end());
+				same = (ai == aj);
+			}
+		}
+		if (same == false) svStart.push_back(i);
+		sv[i] = (int)svStart.size() - 1;
+	}
+	int nv = (int)svStart.size();
+	svStart.push_back(N);
+
+	// build the compressed graph
+	vector<int> vw(nv), vxadj(nv + 1, 0), vadj;
+	vector<int> mark(nv, -1);
+	for (int v = 0; v < nv; ++v)
+	{
+		vw[v] = svStart[v + 1] - svStart[v];
+		int e = svStart[v];
+		mark[v] = v;
+		for (int k = xadj[e]; k < xadj[e + 1]; ++k)
+		{
+			int w = sv[adj[k]];
+			if (mark[w] != v) { mark[w] = v; vadj.push_back(w); }
+		}
+		vxadj[v + 1] = (int)vadj.size();
+	}
+
+	// ordering of the supervariables
+	vector<int> vorder(nv);
+
+	struct Part { int lo; vector<int> v; };
+	vector<Part> stack(1);
+	stack[0].lo = 0;
+	stack[0].v.resize(nv);
+	for (int i = 0; i < nv; ++i) stack[0].v[i] = i;
+
+	vector<int> label(nv, 0);	// subgraph that each vertex belongs to
+	vector<int> visit(nv, -1);	// stamp of last search that visited the vertex
+	vector<int> lev(nv);		// level of vertex in that search
+	vector<int> queue, levelPtr;
+	int nextLabel = 1, stamp = 0;
+
+	// breadth-first search within a subgraph; returns the number of levels
+	auto bfs = [&](int r, int id) {
+		stamp++;
+		queue.clear(); levelPtr.clear();
+		queue.push_back(r); visit[r] = stamp; lev[r] = 0;
+		levelPtr.push_back(0);
+		for (size_t q = 0; q < queue.size(); ++q)
+		{
+			int v = queue[q];
+			if (lev[v] == (int)levelPtr.size()) levelPtr.push_back((int)q);
+			for (int k = vxadj[v]; k < vxadj[v + 1]; ++k)
+			{
+				int w = vadj[k];
+				if ((label[w] == id) && (visit[w] != stamp))
+				{
+					visit[w] = stamp;
+					lev[w] = lev[v] + 1;
+					queue.push_back(w);
+				}
+			}
+		}
+		levelPtr.push_back((int)queue.size());
+		return (int)levelPtr.size() - 1;
+	};
+
+	while (stack.empty() == false)
+	{
+		Part P;
+		P.lo = stack.back().lo;
+		P.v.swap(stack.back().v);
+		stack.pop_back();
+
+		int n = (int)P.v.size();
+		int id = label[P.v[0]];
+
+		bool leaf = (n <= leafSize);
+		vector<int> A, B, S;
+		if (leaf == false)
+		{
+			// find a pseudo-peripheral vertex
+			int r = P.v[0];
+			int nlev = bfs(r, id);
+			for (int it = 0; it < 5; ++it)
+			{
+				int c = queue[levelPtr[nlev - 1]];
+				for (int q = levelPtr[nlev - 1]; q < levelPtr[nlev]; ++q)
+				{
+					int v = queue[q];
+					if (vxadj[v + 1] - vxadj[v] < vxadj[c + 1] - vxadj[c]) c = v;
+				}
+				int nc = bfs(c, id);
+				if (nc > nlev) { r = c; nlev = nc; }
+				else { nlev = bfs(r, id); break; }
+			}
+
+			if ((int)queue.size() < n)
+			{
+				// the subgraph is not connected: split off this component
+				A = queue;
+				for (int v : P.v) if (visit[v] != stamp) B.push_back(v);
+			}
+			else if (nlev < 3) leaf = true;
+			else
+			{
+				// choose the level that minimizes the separator size relative to the balance
+				vector<double> wl(nlev, 0.0);
+				double W = 0.0;
+				for (int l = 0; l < nlev; ++l)
+				{
+					for (int q = levelPtr[l]; q < levelPtr[l + 1]; ++q) wl[l] += vw[queue[q]];
+					W += wl[l];
+				}
+				int ks = 1;
+				double minCost = 0.0, wa = wl[0];
+				for (int l = 1; l < nlev - 1; ++l)
+				{
+					double wb = W - wa - wl[l];
+					double cost = wl[l] / (wa*wb);
+					if ((l == 1) || (cost < minCost)) { ks = l; minCost = cost; }
+					wa += wl[l];
+				}
+
+				for (int q = 0; q < levelPtr[ks]; ++q) A.push_back(queue[q]);
+				for (int q = levelPtr[ks + 1]; q < n; ++q) B.push_back(queue[q]);
+
+				// separator vertices that are not connected to the other side can be moved
+				for (int q = levelPtr[ks]; q < levelPtr[ks + 1]; ++q)
+				{
+					int v = queue[q];
+					bool bnext = false;
+					for (int k = vxadj[v]; k < vxadj[v + 1]; ++k)
+					{
+						int w = vadj[k];
+						if ((label[w] == id) && (lev[w] == ks + 1)) { bnext = true; break; }
+					}
+					if (bnext) S.push_back(v); else A.push_back(v);
+				}
+			}
+		}
+
+		if (leaf)
+		{
+			for (int i = 0; i < n; ++i) vorder[P.lo + i] = P.v[i];
+			continue;
+		}
+
+		// separator is numbered last
+		int ns = (int)S.size();
+		for (int i = 0; i < ns; ++i) vorder[P.lo + n - ns + i] = S[i];
+		for (int v : S) label[v] = -1;
+
+		int la = nextLabel++;
+		for (int v : A) label[v] = la;
+		int lb = nextLabel++;
+		for (int v : B) label[v] = lb;
+
+		Part PA; PA.lo = P.lo; PA.v.swap(A);
+		Part PB; PB.lo = P.lo + (int)PA.v.size(); PB.v.swap(B);
+		stack.push_back(Part()); stack.back().lo = PB.lo; stack.back().v.swap(PB.v);
+		stack.push_back(Part()); stack.back().lo = PA.lo; stack.back().v.swap(PA.v);
+	}
+
+	// expand to equations
+	order.clear();
+	order.reserve(N);
+	for (int i = 0; i < nv; ++i)
+	{
+		int v = vorder[i];
+		for (int e = svStart[v]; e < svStart[v + 1]; ++e) order.push_back(e);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// FNV-1a hash of the sparsity pattern
+size_t SupernodalAnalysis::patternHash(CompactMatrix* A)
+{
+	unsigned long long h = 14695981039346656037ULL;
+	auto add = [&](int v) {
+		unsigned int u = (unsigned int)v;
+		for (int k = 0; k < 4; ++k)
+		{
+			h ^= (u & 0xFF);
+			h *= 1099511628211ULL;
+			u >>= 8;
+		}
+	};
+
+	int N = A->Rows();
+	int* pp = A->Pointers();
+	int* pi = A->Indices();
+	add(N);
+	add(A->isSymmetric() ? 1 : 0);
+	for (int i = 0; i <= N; ++i) add(pp[i]);
+	size_t nnz = pp[N] - pp[0];
+	for (size_t k = 0; k < nnz; ++k) add(pi[k]);
+	return (size_t)h;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalAnalysis::storePattern(CompactMatrix* A)
+{
+	int N = A->Rows();
+	int* pp = A->Pointers();
+	int* pi = A->Indices();
+	size_t nnz = pp[N] - pp[0];
+	patPtr.assign(pp, pp + N + 1);
+	patIdx.assign(pi, pi + nnz);
+}
+
+//-----------------------------------------------------------------------------
+// see if A has the same sparsity pattern as the analyzed matrix
+bool SupernodalAnalysis::samePattern(CompactMatrix* A) const
+{
+	int n = A->Rows();
+	if ((n != N) || (A->isSymmetric() != symmetric)) return false;
+	if ((int)patPtr.size() != n + 1) return false;
+
+	int* pp = A->Pointers();
+	int* pi = A->Indices();
+	if (std::equal(patPtr.begin(), patPtr.end(), pp) == false) return false;
+
+	size_t nnz = pp[n] - pp[0];
+	if (patIdx.size() != nnz) return false;
+	return std::equal(patIdx.begin(), patIdx.end(), pi);
+}
+
+//-----------------------------------------------------------------------------
+// symbolic analysis
+bool SupernodalAnalysis::analyze(CompactMatrix* A)
+{
+	N = A->Rows();
+	symmetric = A->isSymmetric();
+	if ((symmetric == false) && (A->isRowBased() == false)) return false;
+
+	vector<int> xadj, adj;
+	buildGraph(A, xadj, adj);
+
+	// fill-reducing ordering
+	vector<int> order;
+	if (ordering == 1) nestedDissection(xadj, adj, order);
+	else
+	{
+		order.resize(N);
+		for (int i = 0; i < N; ++i) order[i] = i;
+	}
+	perm = order;
+	iperm.resize(N);
+	for (int i = 0; i < N; ++i) iperm[perm[i]] = i;
+
+	// elimination tree (Liu's algorithm with path compression)
+	vector<int> parent(N, -1), ancestor(N, -1);
+	for (int j = 0; j < N; ++j)
+	{
+		int oj = perm[j];
+		for (int k = xadj[oj]; k < xadj[oj + 1]; ++k)
+		{
+			int i = iperm[adj[k]];
+			while ((i != -1) && (i < j))
+			{
+				int t = ancestor[i];
+				ancestor[i] = j;
+				if (t == -1) parent[i] = j;
+				i = t;
+			}
+		}
+	}
+
+	// postorder the tree, so that subtrees (and supernodes) are contiguous
+	vector<int> head(N, -1), next(N, -1);
+	for (int j = N - 1; j >= 0; --j)
+	{
+		int p = parent[j];
+		if (p != -1) { next[j] = head[p]; head[p] = j; }
+	}
+	vector<int> post; post.reserve(N);
+	vector<int> stack;
+	for (int r = 0; r < N; ++r)
+	{
+		if (parent[r] != -1) continue;
+		stack.push_back(r);
+		while (stack.empty() == false)
+		{
+			int j = stack.back();
+			int c = head[j];
+			if (c != -1) { head[j] = next[c]; stack.push_back(c); }
+			else { post.push_back(j); stack.pop_back(); }
+		}
+	}
+	vector<int> ipost(N);
+	for (int i = 0; i < N; ++i) ipost[post[i]] = i;
+	vector<int> newParent(N);
+	for (int i = 0; i < N; ++i)
+	{
+		int p = parent[post[i]];
+		newParent[i] = (p == -1 ? -1 : ipost[p]);
+	}
+	parent.swap(newParent);
+	for (int i = 0; i < N; ++i) perm[i] = order[post[i]];
+	for (int i = 0; i < N; ++i) iperm[perm[i]] = i;
+
+	// children lists in the new numbering
+	head.assign(N, -1); next.assign(N, -1);
+	for (int j = N - 1; j >= 0; --j)
+	{
+		int p = parent[j];
+		if (p != -1) { next[j] = head[p]; head[p] = j; }
+	}
+
+	// symbolic factorization and (relaxed) supernode detection
+	vector<int> colSn(N);
+	vector< vector<int> > snStruct;
+	snStart.clear();
+	vector<int> mark(N, -1), sj;
+	for (int j = 0; j < N; ++j)
+	{
+		sj.clear();
+		mark[j] = j;
+		int oj = perm[j];
+		for (int k = xadj[oj]; k < xadj[oj + 1]; ++k)
+		{
+			int i = iperm[adj[k]];
+			if ((i > j) && (mark[i] != j)) { mark[i] = j; sj.push_back(i); }
+		}
+		for (int c = head[j]; c != -1; c = next[c])
+		{
+			const vector<int>& sc = snStruct[colSn[c]];
+			for (int i : sc)
+			{
+				if (mark[i] != j) { mark[i] = j; sj.push_back(i); }
+			}
+		}
+
+		bool merge = false;
+		if ((j > 0) && (parent[j - 1] == j))
+		{
+			int s = colSn[j - 1];
+			int ncol = j - snStart[s];
+			double nprev = (double) snStruct[s].size();
+			double extra = ncol * ((double)sj.size() + 1.0 - nprev);
+			if (extra == 0.0) merge = true;
+			else if (ncol < relaxSize)
+			{
+				double total = 0.5*(ncol + 1)*(ncol + 2) + (ncol + 1)*(double)sj.size();
+				merge = (extra <= relaxFill*total);
+			}
+		}
+
+		if (merge)
+		{
+			int s = colSn[j - 1];
+			colSn[j] = s;
+			snStruct[s].swap(sj);
+		}
+		else
+		{
+			colSn[j] = (int)snStart.size();
+			snStart.push_back(j);
+			snStruct.push_back(sj);
+		}
+	}
+	nsn = (int)snStart.size();
+	snStart.push_back(N);
+
+	// store the row structures
+	rowPtr.assign(nsn + 1, 0);
+	for (int s = 0; s < nsn; ++s) rowPtr[s + 1] = rowPtr[s] + (int)snStruct[s].size();
+	rowIdx.resize(rowPtr[nsn]);
+	for (int s = 0; s < nsn; ++s)
+	{
+		vector<int>& ss = snStruct[s];
+		std::sort(ss.begin(), ss.end());
+		std::copy(ss.begin(), ss.end(), rowIdx.begin() + rowPtr[s]);
+		vector<int>().swap(ss);
+	}
+
+	// supernodal tree
+	snParent.resize(nsn);
+	vector<int> nchild(nsn + 1, 0);
+	for (int s = 0; s < nsn; ++s)
+	{
+		int p = parent[snStart[s + 1] - 1];
+		snParent[s] = (p == -1 ? -1 : colSn[p]);
+		if (p != -1) nchild[snParent[s] + 1]++;
+	}
+	childPtr.assign(nsn + 1, 0);
+	for (int s = 0; s < nsn; ++s) childPtr[s + 1] = childPtr[s] + nchild[s + 1];
+	child.resize(childPtr[nsn]);
+	vector<int> cpos(childPtr.begin(), childPtr.end() - 1);
+	for (int s = 0; s < nsn; ++s) if (snParent[s] != -1) child[cpos[snParent[s]]++] = s;
+
+	// local front index of a row in supernode s
+	vector<int> loc(N, -1);
+	auto setLocal = [&](int s, bool set) {
+		int f = snStart[s], k = width(s);
+		for (int i = 0; i < k; ++i) loc[f + i] = (set ? i : -1);
+		for (int t = rowPtr[s]; t < rowPtr[s + 1]; ++t) loc[rowIdx[t]] = (set ? k + t - rowPtr[s] : -1);
+	};
+
+	// relative indices of the children's update matrices in the parent's front
+	relIdx.resize(rowIdx.size());
+	for (int s = 0; s < nsn; ++s)
+	{
+		if (childPtr[s] == childPtr[s + 1]) continue;
+		setLocal(s, true);
+		for (int n = childPtr[s]; n < childPtr[s + 1]; ++n)
+		{
+			int c = child[n];
+			for (int t = rowPtr[c]; t < rowPtr[c + 1]; ++t)
+			{
+				relIdx[t] = loc[rowIdx[t]];
+				assert(relIdx[t] >= 0);
+			}
+		}
+		setLocal(s, false);
+	}
+
+	// map the matrix entries to the fronts
+	int offset = A->Offset();
+	int* pi = A->Indices();
+	int* pp = A->Pointers();
+	int nnz = A->NonZeroes();
+	vector<int> entrySn(nnz);
+	entryPtr.assign(nsn + 1, 0);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = pp[j] - offset; k < pp[j + 1] - offset; ++k)
+		{
+			int i = pi[k] - offset;
+			int c = std::min(iperm[i], iperm[j]);
+			entrySn[k] = colSn[c];
+			entryPtr[colSn[c] + 1]++;
+		}
+	}
+	for (int s = 0; s < nsn; ++s) entryPtr[s + 1] += entryPtr[s];
+	entry.resize(nnz);
+	vector<int> epos(entryPtr.begin(), entryPtr.end() - 1);
+
+	// visit the entries by supernode, so that only one local map is needed at a time
+	vector<int> snEntries(nnz);
+	for (int k = 0; k < nnz; ++k) snEntries[epos[entrySn[k]]++] = k;
+	vector<int> col(nnz);
+	for (int j = 0; j < N; ++j)
+		for (int k = pp[j] - offset; k < pp[j + 1] - offset; ++k) col[k] = j;
+	for (int s = 0; s < nsn; ++s)
+	{
+		setLocal(s, true);
+		for (int n = entryPtr[s]; n < entryPtr[s + 1]; ++n)
+		{
+			int k = snEntries[n];
+			// for the symmetric (column-based) format, the index is the row and col[k] the column;
+			// for the row-based format, col[k] is the row and the index the column.
+			int a = iperm[symmetric ? pi[k] - offset : col[k]];
+			int b = iperm[symmetric ? col[k] : pi[k] - offset];
+			FrontEntry& e = entry[n];
+			e.pos = k;
+			if (symmetric)
+			{
+				e.row = loc[std::max(a, b)];
+				e.col = loc[std::min(a, b)];
+			}
+			else
+			{
+				e.row = loc[a];
+				e.col = loc[b];
+			}
+			assert((e.row >= 0) && (e.col >= 0));
+		}
+		setLocal(s, false);
+	}
+
+	// level schedule (leaves are at level 0)
+	vector<int> height(nsn, 0);
+	int maxLevel = 0;
+	for (int s = 0; s < nsn; ++s)
+	{
+		int p = snParent[s];
+		if ((p != -1) && (height[p] < height[s] + 1)) height[p] = height[s] + 1;
+		if (height[s] > maxLevel) maxLevel = height[s];
+	}
+	levelPtr.assign(maxLevel + 2, 0);
+	for (int s = 0; s < nsn; ++s) levelPtr[height[s] + 1]++;
+	for (int l = 0; l <= maxLevel; ++l) levelPtr[l + 1] += levelPtr[l];
+	levelNode.resize(nsn);
+	vector<int> lpos(levelPtr.begin(), levelPtr.end() - 1);
+	for (int s = 0; s < nsn; ++s) levelNode[lpos[height[s]]++] = s;
+
+	// factor storage
+	Lptr.assign(nsn + 1, 0);
+	Uptr.assign(nsn + 1, 0);
+	double flops = 0.0;
+	for (int s = 0; s < nsn; ++s)
+	{
+		size_t m = frontSize(s), k = width(s);
+		Lptr[s + 1] = Lptr[s] + m*k;
+		Uptr[s + 1] = Uptr[s] + (symmetric ? 0 : k*(m - k));
+		for (size_t p = 0; p < k; ++p) flops += (double)(m - p - 1)*(double)(m - p - 1);
+	}
+	if (symmetric == false) flops *= 2.0;
+	factorFlops = flops;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Make sure the symbolic analysis matches the sparsity pattern of A. When the 
+// analysis is shared with other solvers, it is only done by the first solver 
+// that is preprocessed and is then reused by the others.
+bool SupernodalSolver::Impl::analyze(CompactMatrix* A)
+{
+	size_t hash = SupernodalAnalysis::patternHash(A);
+
+	std::shared_ptr<SupernodalAnalysis> S = sym;
+	std::lock_guard<std::mutex> lock(S->mtx);
+	if (S->valid && (S->hash == hash) && S->samePattern(A)) return true;
+
+	// The pattern changed, so we need a new analysis. Other solvers might still
+	// be using the current one, so it is not overwritten.
+	if (S->valid) sym = std::make_shared<SupernodalAnalysis>();
+
+	SupernodalAnalysis& S1 = *sym;
+	S1.ordering  = ordering;
+	S1.leafSize  = leafSize;
+	S1.relaxSize = relaxSize;
+	S1.relaxFill = relaxFill;
+	S1.valid = S1.analyze(A);
+	S1.hash = hash;
+	S1.storePattern(A);
+
+	L.clear(); U.clear();
+
+	return S1.valid;
+}
+
+//-----------------------------------------------------------------------------
+// Assemble and factor the front of supernode s. When par is true, the dense
+// kernels are run in parallel.
+bool SupernodalSolver::Impl::factorNode(int s, const double* val, bool par)
+{
+	const SupernodalAnalysis& S = *sym;
+	const int k = S.width(s);
+	const int m = S.frontSize(s);
+	const int mu = m - k;
+	const int NB = blockSize;
+
+	// assemble the front and record the magnitude of the original pivot columns
+	vector<double> F((size_t)m*m, 0.0);
+	vector<double> amax(k, 0.0);
+	for (int n = S.entryPtr[s]; n < S.entryPtr[s + 1]; ++n)
+	{
+		const FrontEntry& e = S.entry[n];
+		F[(size_t)e.col*m + e.row] += val[e.pos];
+		if ((e.col < k) && (fabs(val[e.pos]) > amax[e.col])) amax[e.col] = fabs(val[e.pos]);
+	}
+
+	// add the update matrices of the children
+	for (int n = S.childPtr[s]; n < S.childPtr[s + 1]; ++n)
+	{
+		int c = S.child[n];
+		const int* rel = &S.relIdx[0] + S.rowPtr[c];
+		int mc = S.rowPtr[c + 1] - S.rowPtr[c];
+		const double* Uc = (mc > 0 ? &upd[c][0] : nullptr);
+#pragma omp parallel for schedule(dynamic, 16) if(par)
+		for (int jj = 0; jj < mc; ++jj)
+		{
+			double* Fj = &F[0] + (size_t)rel[jj]*m;
+			const double* Uj = Uc + (size_t)jj*mc;
+			for (int ii = (S.symmetric ? jj : 0); ii < mc; ++ii) Fj[rel[ii]] += Uj[ii];
+		}
+		vector<double>().swap(upd[c]);
+	}
+
+	// blocked right-looking factorization of the first k columns
+	bool bok = true;
+	vector<double> W;
+	if (S.symmetric) W.resize((size_t)m*NB);
+	for (int b0 = 0; b0 < k; b0 += NB)
+	{
+		int b1 = std::min(b0 + NB, k);
+
+		// factor the columns of this block
+		for (int p = b0; p < b1; ++p)
+		{
+			double* Fp = &F[0] + (size_t)p*m;
+			double d = Fp[p];
+			if (fabs(d) <= pivotTol*amax[p])
+			{
+				// (nearly) singular: without pivoting the factor is meaningless
+				bok = false;
+				if (d == 0.0) { d = 1.0; Fp[p] = 1.0; }
+			}
+
+			if (S.symmetric)
+			{
+				// W keeps the unscaled column (i.e. L*D)
+				double* Wp = &W[0] + (size_t)(p - b0)*m;
+				for (int i = p + 1; i < m; ++i) { Wp[i] = Fp[i]; Fp[i] /= d; }
+				for (int q = p + 1; q < b1; ++q)
+				{
+					double* Fq = &F[0] + (size_t)q*m;
+					double wq = Wp[q];
+					for (int i = q; i < m; ++i) Fq[i] -= Fp[i] * wq;
+				}
+			}
+			else
+			{
+				for (int i = p + 1; i < m; ++i) Fp[i] /= d;
+				for (int q = p + 1; q < b1; ++q)
+				{
+					double* Fq = &F[0] + (size_t)q*m;
+					double uq = Fq[p];
+					for (int i = p + 1; i < m; ++i) Fq[i] -= Fp[i] * uq;
+				}
+			}
+		}
+
+		// update the trailing columns
+#pragma omp parallel for schedule(dynamic, 4) if(par)
+		for (int q = b1; q < m; ++q)
+		{
+			double* Fq = &F[0] + (size_t)q*m;
+			for (int p = b0; p < b1; ++p)
+			{
+				const double* Fp = &F[0] + (size_t)p*m;
+				if (S.symmetric)
+				{
+					double wq = W[(size_t)(p - b0)*m + q];
+					for (int i = q; i < m; ++i) Fq[i] -= Fp[i] * wq;
+				}
+				else
+				{
+					double uq = Fq[p];
+					for (int i = p + 1; i < m; ++i) Fq[i] -= Fp[i] * uq;
+				}
+			}
+		}
+	}
+
+	// store the factor
+	std::copy(F.begin(), F.begin() + (size_t)m*k, L.begin() + S.Lptr[s]);
+	if (S.symmetric == false)
+	{
+		double* Us = &U[0] + S.Uptr[s];
+		for (int q = 0; q < mu; ++q)
+			for (int p = 0; p < k; ++p) Us[(size_t)q*k + p] = F[(size_t)(k + q)*m + p];
+	}
+
+	// store the update matrix for the parent
+	if (mu > 0)
+	{
+		vector<double>& Us = upd[s];
+		Us.resize((size_t)mu*mu);
+		for (int q = 0; q < mu; ++q)
+		{
+			const double* Fq = &F[0] + (size_t)(k + q)*m + k;
+			std::copy(Fq, Fq + mu, Us.begin() + (size_t)q*mu);
+		}
+	}
+
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::Impl::factor(CompactMatrix* A)
+{
+	const SupernodalAnalysis& S = *sym;
+	L.resize(S.Lptr[S.nsn]);
+	U.resize(S.Uptr[S.nsn]);
+	upd.assign(S.nsn, vector<double>());
+
+	int nthreads = 1;
+#ifdef _OPENMP
+	nthreads = omp_get_max_threads();
+#endif
+
+	const double* val = A->Values();
+	bool bok = true;
+	int nlevels = (int)S.levelPtr.size() - 1;
+	for (int l = 0; l < nlevels; ++l)
+	{
+		int n0 = S.levelPtr[l];
+		int nl = S.levelPtr[l + 1] - n0;
+		if ((nl > 1) && (nl >= nthreads))
+		{
+			// many independent supernodes: factor them in parallel
+#pragma omp parallel for schedule(dynamic)
+			for (int n = 0; n < nl; ++n)
+			{
+				if (factorNode(S.levelNode[n0 + n], val, false) == false)
+				{
+#pragma omp critical (SN_factor)
+					bok = false;
+				}
+			}
+		}
+		else
+		{
+			// few (large) supernodes: use parallel dense kernels
+			for (int n = 0; n < nl; ++n)
+			{
+				if (factorNode(S.levelNode[n0 + n], val, (nthreads > 1)) == false) bok = false;
+			}
+		}
+	}
+
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Impl::solve(double* x, const double* b)
+{
+	const SupernodalAnalysis& S = *sym;
+	vector<double> y(S.N);
+	for (int i = 0; i < S.N; ++i) y[i] = b[S.perm[i]];
+
+	// forward substitution
+	for (int s = 0; s < S.nsn; ++s)
+	{
+		int f = S.snStart[s], k = S.width(s), m = S.frontSize(s);
+		const int* R = &S.rowIdx[0] + S.rowPtr[s];
+		const double* Ls = &L[0] + S.Lptr[s];
+		for (int p = 0; p < k; ++p)
+		{
+			const double* Lp = Ls + (size_t)p*m;
+			double yp = y[f + p];
+			if (yp == 0.0) continue;
+			for (int i = p + 1; i < k; ++i) y[f + i] -= Lp[i] * yp;
+			for (int t = 0; t < m - k; ++t) y[R[t]] -= Lp[k + t] * yp;
+		}
+	}
+
+	// diagonal (symmetric only)
+	if (S.symmetric)
+	{
+		for (int s = 0; s < S.nsn; ++s)
+		{
+			int f = S.snStart[s], k = S.width(s), m = S.frontSize(s);
+			const double* Ls = &L[0] + S.Lptr[s];
+			for (int p = 0; p < k; ++p) y[f + p] /= Ls[(size_t)p*m + p];
+		}
+	}
+
+	// backward substitution
+	for (int s = S.nsn - 1; s >= 0; --s)
+	{
+		int f = S.snStart[s], k = S.width(s), m = S.frontSize(s);
+		const int* R = &S.rowIdx[0] + S.rowPtr[s];
+		const double* Ls = &L[0] + S.Lptr[s];
+		if (S.symmetric)
+		{
+			for (int p = k - 1; p >= 0; --p)
+			{
+				const double* Lp = Ls + (size_t)p*m;
+				double sum = y[f + p];
+				for (int i = p + 1; i < k; ++i) sum -= Lp[i] * y[f + i];
+				for (int t = 0; t < m - k; ++t) sum -= Lp[k + t] * y[R[t]];
+				y[f + p] = sum;
+			}
+		}
+		else
+		{
+			const double* Us = &U[0] + S.Uptr[s];
+			for (int p = k - 1; p >= 0; --p)
+			{
+				double sum = y[f + p];
+				for (int i = p + 1; i < k; ++i) sum -= Ls[(size_t)i*m + p] * y[f + i];
+				for (int t = 0; t < m - k; ++t) sum -= Us[(size_t)t*k + p] * y[R[t]];
+				y[f + p] = sum / Ls[(size_t)p*m + p];
+			}
+		}
+	}
+
+	for (int i = 0; i < S.N; ++i) x[S.perm[i]] = y[i];
+}
+
+//=============================================================================
+BEGIN_FECORE_CLASS(SupernodalSolver, LinearSolver)
+	ADD_PARAMETER(m->print_level, "print_level");
+	ADD_PARAMETER(m->ordering   , "ordering");
+	ADD_PARAMETER(m->leafSize   , "leaf_size");
+	ADD_PARAMETER(m->relaxSize  , "relax_size");
+	ADD_PARAMETER(m->relaxFill  , "relax_fill");
+	ADD_PARAMETER(m->blockSize  , "block_size");
+	ADD_PARAMETER(m->pivotTol   , "pivot_tol");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::SupernodalSolver(FEModel* fem) : LinearSolver(fem), m_pA(nullptr)
+{
+	m = new SupernodalSolver::Impl;
+	m->sym = std::make_shared<SupernodalAnalysis>();
+}
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::~SupernodalSolver()
+{
+	Destroy();
+	delete m;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::SetPrintLevel(int n)
+{
+	m->print_level = n;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* SupernodalSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	switch (ntype)
+	{
+	case REAL_SYMMETRIC     : m_pA = new CompactSymmMatrix(0); break;
+	case REAL_UNSYMMETRIC   :
+	case REAL_SYMM_STRUCTURE: m_pA = new CRSSparseMatrix(0); break;
+	default:
+		assert(false);
+		m_pA = nullptr;
+	}
+	return m_pA;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::SetSparseMatrix(SparseMatrix* pA)
+{
+	m_pA = dynamic_cast<CompactMatrix*>(pA);
+	return (m_pA != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::PreProcess()
+{
+	if (m_pA == nullptr) return false;
+	if (m->analyze(m_pA) == false)
+	{
+		feLogError("Matrix format not supported by supernodal solver.");
+		return false;
+	}
+
+	if (m->print_level > 0)
+	{
+		const SupernodalAnalysis& S = *m->sym;
+		feLog("\tNr of supernodes .......................... : %d\n", S.nsn);
+		feLog("\tNr of nonzeroes in factor ................. : %.0lf\n", (double)(S.Lptr[S.nsn] + S.Uptr[S.nsn]));
+		feLog("\tNr of factorization flops (est.) .......... : %lg\n", S.factorFlops);
+	}
+	return LinearSolver::PreProcess();
+}
+
+//-----------------------------------------------------------------------------
+// The symbolic analysis only depends on the sparsity pattern, so solvers of 
+// identical models can use the same analysis. 
+bool SupernodalSolver::SharePreProcess(LinearSolver* solver)
+{
+	SupernodalSolver* ps = dynamic_cast<SupernodalSolver*>(solver);
+	if ((ps == nullptr) || (ps == this)) return false;
+	m->sym = ps->m->sym;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::Factor()
+{
+	if (m_pA == nullptr) return false;
+	if (m_pA->Rows() == 0) return true;
+
+	if (m->factor(m_pA) == false)
+	{
+		feLogError("Zero or tiny pivot encountered in supernodal solver.");
+		return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::BackSolve(double* x, double* y)
+{
+	if (m_pA == nullptr) return false;
+	if (m_pA->Rows() == 0) return true;
+
+	m->solve(x, y);
+
+	// update statistics
+	UpdateStats(1);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Destroy()
+{
+	vector<double>().swap(m->L);
+	vector<double>().swap(m->U);
+	m->upd.clear();
+	LinearSolver::Destroy();
+}
@@ -26,10 +26,126 @@ SOFTWARE.*/
 #include "XMLReader.h"
 #include <assert.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
+//=============================================================================
+// Number parsing
+//=============================================================================
+// These functions are used instead of atof and atoi. They accept the same input, 
+// but parse the common cases directly. Numbers that cannot be converted exactly 
+// this way are passed on to strtod. Both functions return a pointer to the first 
+// character after the number, or sz if no number was found.
+
+static const double pow10_table[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const char* parse_number_strtod(const char* sz, const char* start, double& v)
+{
+	char* end = nullptr;
+	v = strtod(start, &end);
+	return (end == start ? sz : end);
+}
+
+static const char* parse_number(const char* sz, double& v)
+{
+	const char* s = sz;
+	while (isspace((unsigned char)*s)) ++s;
+	const char* start = s;
+
+	bool neg = false;
+	if      (*s == '-') { neg = true; ++s; }
+	else if (*s == '+') ++s;
+
+	// read the significant digits (at most 19 fit in 64 bits)
+	uint64_t m = 0;
+	int nd = 0, e10 = 0;
+	bool digits = false;
+	for (; isdigit((unsigned char)*s); ++s)
+	{
+		digits = true;
+		if ((m != 0) || (*s != '0'))
+		{
+			if (nd == 19) return parse_number_strtod(sz, start, v);
+			m = 10 * m + (*s - '0'); nd++;
+		}
+	}
+	if (*s == '.')
+	{
+		++s;
+		for (; isdigit((unsigned char)*s); ++s, --e10)
+		{
+			digits = true;
+			if ((m != 0) || (*s != '0'))
+			{
+				if (nd == 19) return parse_number_strtod(sz, start, v);
+				m = 10 * m + (*s - '0'); nd++;
+			}
+		}
+	}
+
+	// inf, nan, hexadecimal numbers, or no number at all
+	if ((digits == false) || (*s == 'x') || (*s == 'X')) return parse_number_strtod(sz, start, v);
+
+	// read the exponent
+	if ((*s == 'e') || (*s == 'E'))
+	{
+		const char* t = s + 1;
+		bool eneg = false;
+		if      (*t == '-') { eneg = true; ++t; }
+		else if (*t == '+') ++t;
+		if (isdigit((unsigned char)*t))
+		{
+			int e = 0;
+			for (; isdigit((unsigned char)*t); ++t) if (e < 100000) e = 10 * e + (*t - '0');
+			e10 += (eneg ? -e : e);
+			s = t;
+		}
+	}
+
+	// The significand and the power of ten are both exact doubles, 
+	// so a single multiplication or division gives the correctly rounded value.
+	if (m == 0) v = 0.0;
+	else if ((m < (1ull << 53)) && (e10 >= -22) && (e10 <= 22))
+	{
+		v = (e10 < 0 ? (double)m / pow10_table[-e10] : (double)m * pow10_table[e10]);
+	}
+	else return parse_number_strtod(sz, start, v);
+
+	if (neg) v = -v;
+	return s;
+}
+
+static const char* parse_number(const char* sz, int& n)
+{
+	const char* s = sz;
+	while (isspace((unsigned char)*s)) ++s;
+
+	bool neg = false;
+	if      (*s == '-') { neg = true; ++s; }
+	else if (*s == '+') ++s;
+
+	if (isdigit((unsigned char)*s) == 0) { n = 0; return sz; }
+
+	unsigned int m = 0;
+	for (; isdigit((unsigned char)*s); ++s) m = 10 * m + (*s - '0');
+	n = (int)(neg ? 0u - m : m);
+	return s;
+}
+
 //=============================================================================
 // XMLAtt
 //=============================================================================
@@ -61,7 +177,7 @@ int XMLAtt::value(int* v, int n)
 	for (int i = 0; i < n; ++i)
 	{
 		const char* sze = strchr(sz, ',');
-		v[i] = atoi(sz);
+		parse_number(sz, v[i]);
 		nr++;
 		if (sze) sz = sze + 1;
 		else break;
@@ -77,7 +193,7 @@ int XMLAtt::value(double* pf, int n)
 	{
 		const char* sze = strchr(sz, ',');
 
-		pf[i] = atof(sz);
+		parse_number(sz, pf[i]);
 		nr++;
 
 		if (sze) sz = sze + 1;
@@ -156,7 +272,7 @@ int XMLTag::value(double* pf, int n)
 	{
 		const char* sze = strchr(sz, ',');
 
-		pf[i] = atof(sz);
+		parse_number(sz, pf[i]);
 		nr++;
 
 		if (sze) sz = sze+1;
@@ -177,7 +293,9 @@ int XMLTag::value(float* pf, int n)
 	{
 		const char* sze = strchr(sz, ',');
 
-		pf[i] = (float) atof(sz);
+		double v;
+		parse_number(sz, v);
+		pf[i] = (float) v;
 		nr++;
 
 		if (sze) sz = sze+1;
@@ -198,7 +316,7 @@ int XMLTag::value(int* pi, int n)
 	{
 		const char* sze = strchr(sz, ',');
 
-		pi[i] = atoi(sz);
+		parse_number(sz, pi[i]);
 		nr++;
 
 		if (sze) sz = sze+1;
@@ -372,7 +490,8 @@ void XMLTag::value(vector<double>& l)
 		// read the value
 		if (sz && *sz)
 		{
-			double v = atof(sz);
+			double v;
+			parse_number(sz, v);
 			l.push_back(v);
 
 			// find next space or comma
@@ -394,7 +513,8 @@ void XMLTag::value2(std::vector<int>& l)
 		// read the value
 		if (sz && *sz)
 		{
-			int v = (int)atoi(sz);
+			int v;
+			parse_number(sz, v);
 			l.push_back(v);
 
 			// find next space or comma
@@ -414,6 +534,17 @@ int XMLTag::children()
 	return ncount;
 }
 
+//-----------------------------------------------------------------------------
+bool XMLTag::readBlock(const char* szchild, std::vector<int>& ids, std::vector<double>& data, int ncols)
+{
+	return m_preader->ReadBlock(*this, szchild, ids, data, ncols);
+}
+
+bool XMLTag::readBlock(const char* szchild, std::vector<int>& ids, std::vector<int>& data, int ncols)
+{
+	return m_preader->ReadBlock(*this, szchild, ids, data, ncols);
+}
+
 //-----------------------------------------------------------------------------
 //! return the string value of an attribute
 const char* XMLTag::AttributeValue(const char* szat, bool bopt)
@@ -574,6 +705,9 @@ XMLReader::XMLReader()
 	m_eof = false;
 	m_currentPos = 0;
 	m_buf = new char[BUF_SIZE];
+	m_data = nullptr;
+	m_dataSize = 0;
+	m_mapped = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -598,6 +732,11 @@ void XMLReader::Close()
         m_stream = nullptr;
     }
 
+	if (m_mapped) UnmapFile();
+	m_str.clear();
+	m_data = nullptr;
+	m_dataSize = 0;
+
 	m_nline = 0;
 	m_bufIndex = 0;
 	m_bufSize = 0;
@@ -609,26 +748,34 @@ void XMLReader::Close()
 bool XMLReader::Open(const char* szfile, bool checkForXMLTag)
 {
 	// make sure this reader has not been attached to a file yet
-    if(m_stream) return false;
-
-	// open the file
-    m_stream = new ifstream;
-    static_cast<ifstream*>(m_stream)->open(szfile, ifstream::in|ifstream::binary);
-    if(m_stream->fail()) return false;
-
+    if(m_stream || m_data) return false;
 
-	// read the first line
-	if (checkForXMLTag)
+	// try to map the file into memory
+	if (MapFile(szfile))
 	{
-		char szline[256] = { 0 };
-		// fgets(szline, 255, m_fp);
-        m_stream->get(szline, 255);
+		// make sure this is an XML file
+		if (checkForXMLTag && ((m_dataSize < 5) || (strncmp(m_data, "<?xml", 5) != 0))) return false;
+	}
+	else
+	{
+		// if that fails, we read the file through a stream
+		m_stream = new ifstream;
+		static_cast<ifstream*>(m_stream)->open(szfile, ifstream::in|ifstream::binary);
+		if(m_stream->fail()) return false;
 
-		// make sure it is correct
-		if (strncmp(szline, "<?xml", 5) != 0)
+		// read the first line
+		if (checkForXMLTag)
 		{
-			// This file is not an XML file
-			return false;
+			char szline[256] = { 0 };
+			// fgets(szline, 255, m_fp);
+			m_stream->get(szline, 255);
+
+			// make sure it is correct
+			if (strncmp(szline, "<?xml", 5) != 0)
+			{
+				// This file is not an XML file
+				return false;
+			}
 		}
 	}
 
@@ -641,26 +788,15 @@ bool XMLReader::Open(const char* szfile, bool checkForXMLTag)
 bool XMLReader::OpenString(std::string& xml, bool checkForXMLTag)
 {
     // make sure this we don't already have a stream
-    if(m_stream) return false;
+    if(m_stream || m_data) return false;
 
-    // create string stream
-    m_stream = new std::istringstream(xml);
-    if(m_stream->fail()) return false;
-
-    // read the first line
-	if (checkForXMLTag)
-	{
-		char szline[256] = { 0 };
-		// fgets(szline, 255, m_fp);
-        m_stream->get(szline, 255);
+	// keep a copy of the string and read from it directly
+	m_str = xml;
+	m_data = m_str.c_str();
+	m_dataSize = (int64_t) m_str.size();
 
-		// make sure it is correct
-		if (strncmp(szline, "<?xml", 5) != 0)
-		{
-			// This file is not an XML file
-			return false;
-		}
-	}
+    // make sure this is an XML file
+	if (checkForXMLTag && (strncmp(m_data, "<?xml", 5) != 0)) return false;
 
 	m_currentPos = 0;
 
@@ -782,10 +918,7 @@ private:
 bool XMLReader::FindTag(const char* xpath, XMLTag& tag)
 {
 	// go to the beginning of the file
-    m_stream->seekg(0, ios_base::beg);
-	m_bufIndex = m_bufSize = 0;
-	m_currentPos = 0;
-	m_eof = false;
+	seek(0);
 
 	// set the first tag
 	tag.m_preader = this;
@@ -836,13 +969,7 @@ void XMLReader::NextTag(XMLTag& tag)
 	m_nline = tag.m_ncurrent_line;
 
 	// set the current file position
-	if (m_currentPos != tag.m_fpos)
-	{
-        m_stream->seekg(tag.m_fpos, ios_base::beg);
-		m_currentPos = tag.m_fpos;
-		m_bufSize = m_bufIndex = 0;
-		m_eof = false;
-	}
+	if (m_currentPos != tag.m_fpos) seek(tag.m_fpos);
 
 	// update the path
 	if (!tag.isend() && !tag.isempty() && !tag.isleaf())
@@ -1055,6 +1182,15 @@ void XMLReader::ReadEndTag(XMLTag& tag)
 //-----------------------------------------------------------------------------
 char XMLReader::readNextChar()
 {
+	// read directly from memory
+	if (m_data)
+	{
+		if (m_currentPos >= m_dataSize) throw UnexpectedEOF();
+		char ch = m_data[m_currentPos++];
+		if (ch == '\n') m_nline++;
+		return ch;
+	}
+
 	if (m_bufIndex >= m_bufSize)
 	{
 		if (m_eof) 
@@ -1089,6 +1225,12 @@ int64_t XMLReader::currentPos()
 void XMLReader::rewind(int64_t nstep)
 {
 	// NOTE: What if we rewind past a newline? Won't that mess up the line index?
+	if (m_data)
+	{
+		m_currentPos -= nstep;
+		return;
+	}
+
 	m_bufIndex -= nstep;
 	m_currentPos -= nstep;
 
@@ -1100,6 +1242,74 @@ void XMLReader::rewind(int64_t nstep)
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! move to a file position
+void XMLReader::seek(int64_t pos)
+{
+	if (m_data == nullptr)
+	{
+		m_stream->seekg(pos, ios_base::beg);
+		m_bufSize = m_bufIndex = 0;
+		m_eof = false;
+	}
+	m_currentPos = pos;
+}
+
+//-----------------------------------------------------------------------------
+//! Map the file into memory. Returns false if this is not possible, in which 
+//! case the file is read through a stream.
+bool XMLReader::MapFile(const char* szfile)
+{
+#ifdef WIN32
+	HANDLE hfile = CreateFileA(szfile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hfile == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if ((GetFileSizeEx(hfile, &size) == FALSE) || (size.QuadPart == 0)) { CloseHandle(hfile); return false; }
+
+	// (the view keeps the file and mapping open)
+	HANDLE hmap = CreateFileMappingA(hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(hfile);
+	if (hmap == NULL) return false;
+	void* pd = MapViewOfFile(hmap, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(hmap);
+	if (pd == nullptr) return false;
+
+	m_dataSize = (int64_t) size.QuadPart;
+#else
+	int fd = ::open(szfile, O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || (st.st_size == 0)) { ::close(fd); return false; }
+
+	// (the mapping keeps the file open)
+	void* pd = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (pd == MAP_FAILED) return false;
+	madvise(pd, (size_t) st.st_size, MADV_SEQUENTIAL);
+
+	m_dataSize = (int64_t) st.st_size;
+#endif
+	m_data = (const char*) pd;
+	m_mapped = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void XMLReader::UnmapFile()
+{
+	assert(m_mapped);
+#ifdef WIN32
+	UnmapViewOfFile(m_data);
+#else
+	munmap((void*) m_data, (size_t) m_dataSize);
+#endif
+	m_data = nullptr;
+	m_dataSize = 0;
+	m_mapped = false;
+}
+
 // clean the string by removing whitespace at the front and back
 void clean_string(string& s)
 {
@@ -1207,6 +1417,171 @@ void XMLReader::SkipTag(XMLTag& tag)
 	while (!tag.isend());
 }
 
+//-----------------------------------------------------------------------------
+//! Read the children of a tag in one pass. This tokenizes the children directly 
+//! in memory, without copying the tag names, attributes and values. It only 
+//! handles the simple (but most common) form of a block. When anything else is 
+//! found (e.g. comments, entity references, other child tags), false is returned
+//! and the regular reader must be used, which also reports any errors.
+template <typename T> bool XMLReader::ReadBlockT(XMLTag& tag, const char* szchild, std::vector<int>& ids, std::vector<T>& data, int ncols)
+{
+	assert(tag.m_preader == this);
+
+	// the data must be in memory
+	if (m_data == nullptr) return false;
+
+	// the tag must have child elements
+	if (tag.isend() || tag.isempty() || tag.isleaf() || (ncols <= 0)) return false;
+
+	const char* p = m_data + tag.m_fpos;
+	const char* const pe = m_data + m_dataSize;
+	int nline = tag.m_ncurrent_line;
+	const std::string& parent = tag.m_sztag;
+	const size_t lparent = parent.size();
+	const size_t lchild = strlen(szchild);
+
+	// on failure, we remove the data that was added
+	const size_t nids0 = ids.size();
+	const size_t ndata0 = data.size();
+	auto fail = [&]() {
+		ids.resize(nids0);
+		data.resize(ndata0);
+		return false;
+	};
+
+	auto skip_space = [&]() {
+		while ((p < pe) && isspace((unsigned char)*p)) { if (*p == '\n') nline++; ++p; }
+	};
+
+	// match a tag name, which must be followed by whitespace or '>'
+	auto match_name = [&](const char* sz, size_t l) {
+		if (((size_t)(pe - p) <= l) || (strncmp(p, sz, l) != 0)) return false;
+		if ((isspace((unsigned char)p[l]) == 0) && (p[l] != '>')) return false;
+		p += l;
+		return true;
+	};
+
+	int nend = 0;
+	while (true)
+	{
+		skip_space();
+		if ((pe - p < 2) || (p[0] != '<')) return fail();
+
+		// this should be the end of the parent tag
+		if (p[1] == '/')
+		{
+			int nstart = nline;
+			p += 2; skip_space();
+			if (match_name(parent.c_str(), lparent) == false) return fail();
+			skip_space();
+			if ((p >= pe) || (*p != '>')) return fail();
+			++p;
+			nend = nstart;
+			break;
+		}
+
+		// read the start tag of the child
+		++p;
+		if (match_name(szchild, lchild) == false) return fail();
+
+		// read the attributes
+		bool bid = false;
+		int id = 0;
+		while (true)
+		{
+			skip_space();
+			if (p >= pe) return fail();
+			if (*p == '>') { ++p; break; }
+
+			// attribute name (this also catches empty tags)
+			const char* szname = p;
+			while ((p < pe) && isvalid(*p)) ++p;
+			size_t l = p - szname;
+			if (l == 0) return fail();
+
+			skip_space();
+			if ((p >= pe) || (*p != '=')) return fail();
+			++p; skip_space();
+			if ((p >= pe) || ((*p != '"') && (*p != '\''))) return fail();
+			char quot = *p++;
+
+			const char* szv = p;
+			const char* ch = (const char*) memchr(p, quot, pe - p);
+			if (ch == nullptr) return fail();
+			for (const char* c = szv; c < ch; ++c) if ((*c == '&') || (*c == '\n')) return fail();
+
+			if ((l == 2) && (strncmp(szname, "id", 2) == 0))
+			{
+				parse_number(szv, id);
+				bid = true;
+			}
+			p = ch + 1;
+		}
+		if (bid == false) return fail();
+
+		// Read the values. The next '<' stops the number parsing, so we can't read
+		// past the end of the data.
+		const char* szval = p;
+		const char* lt = (const char*) memchr(p, '<', pe - p);
+		if ((lt == nullptr) || (memchr(p, '&', lt - p) != nullptr)) return fail();
+		for (int i = 0; i < ncols; ++i)
+		{
+			T v;
+			const char* ch = parse_number(p, v);
+			if (ch == p) return fail();
+			data.push_back(v);
+			p = ch;
+
+			while ((p < lt) && isspace((unsigned char)*p)) ++p;
+			if (i < ncols - 1)
+			{
+				if (*p != ',') return fail();
+				++p;
+			}
+		}
+		if (p != lt) return fail();
+		nline += (int) std::count(szval, lt, '\n');
+
+		// read the end tag of the child
+		if ((pe - p < 2) || (p[1] != '/')) return fail();
+		p += 2; skip_space();
+		if (match_name(szchild, lchild) == false) return fail();
+		skip_space();
+		if ((p >= pe) || (*p != '>')) return fail();
+		++p;
+
+		ids.push_back(id);
+	}
+	if (ids.size() == nids0) return fail();
+
+	// The tag is now the end tag of the parent, 
+	// just as if the children were read one by one.
+	std::string name = parent;
+	tag.m_path.push_back(name);
+	tag.clear();
+	tag.m_sztag = name;
+	tag.m_bend = true;
+	tag.m_nstart_line = nend;
+	tag.m_ncurrent_line = nline;
+	tag.m_fpos = (int64_t)(p - m_data);
+
+	m_nline = nline;
+	m_currentPos = tag.m_fpos;
+	m_comment.clear();
+
+	return true;
+}
+
+bool XMLReader::ReadBlock(XMLTag& tag, const char* szchild, std::vector<int>& ids, std::vector<double>& data, int ncols)
+{
+	return ReadBlockT(tag, szchild, ids, data, ncols);
+}
+
+bool XMLReader::ReadBlock(XMLTag& tag, const char* szchild, std::vector<int>& ids, std::vector<int>& data, int ncols)
+{
+	return ReadBlockT(tag, szchild, ids, data, ncols);
+}
+
 //-----------------------------------------------------------------------------
 char XMLReader::GetNextChar()
 {
@@ -119,6 +119,14 @@ public:
 	// count the number of children
 	int children();
 
+	// Read all the children of this tag in one pass. Each child must be a leaf
+	// with name szchild, an "id" attribute and a comma separated list of exactly 
+	// ncols values. The ids and values are appended to the vectors and the tag is 
+	// moved to its end tag. If the block is not of this form, false is returned, 
+	// the tag is not moved, and the children need to be processed one by one.
+	bool readBlock(const char* szchild, std::vector<int>& ids, std::vector<double>& data, int ncols);
+	bool readBlock(const char* szchild, std::vector<int>& ids, std::vector<int>& data, int ncols);
+
 	const char* AttributeValue(const char* szat, bool bopt = false);
 	XMLAtt* AttributePtr(const char* szat);
 	XMLAtt* Attribute(const char* szat, bool bopt);
@@ -287,6 +295,10 @@ public:
 	//! Skip a tag
 	void SkipTag(XMLTag& tag);
 
+	//! Read the children of a tag in one pass (see XMLTag::readBlock)
+	bool ReadBlock(XMLTag& tag, const char* szchild, std::vector<int>& ids, std::vector<double>& data, int ncols);
+	bool ReadBlock(XMLTag& tag, const char* szchild, std::vector<int>& ids, std::vector<int>& data, int ncols);
+
 	const std::string& GetLastComment();
 
 protected: // helper functions
@@ -314,10 +326,28 @@ protected: // helper functions
 
 	// only used for processing comments
 	char GetNextChar();
+
+	//! move to a file position
+	void seek(int64_t pos);
+
+	//! map the file into memory
+	bool MapFile(const char* szfile);
+
+	//! release the memory mapped file
+	void UnmapFile();
+
+	template <typename T> bool ReadBlockT(XMLTag& tag, const char* szchild, std::vector<int>& ids, std::vector<T>& data, int ncols);
 	
 protected:
     std::istream* m_stream;
 
+	// When the file could be mapped into memory (or a string was passed), 
+	// the tags are read directly from memory and m_stream is not used.
+	const char*	m_data;		//!< start of the data in memory
+	int64_t		m_dataSize;	//!< size of data in memory
+	bool		m_mapped;	//!< m_data points to a memory mapped file
+	std::string	m_str;		//!< copy of the string passed to OpenString
+
 	int		m_nline;		//!< current line (used only as temp storage)
     int64_t	m_currentPos;	//!< current file position
 